@@ -0,0 +1,142 @@
+#include <getopt.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "servo_easing.h"
+#include "SE_daemon.h"
+#include "SE_ticks.h"
+#include "SE_def.h"
+#include "SE_logging.h"
+
+#define DEFAULT_DAEMON_TICK_MS 10
+#define DEFAULT_DAEMON_PERIOD_US 20000
+#define DEFAULT_DAEMON_SPEED 90
+
+static volatile sig_atomic_t running = 1;
+static SE_servo_t servos[MAX_CONTROLLER_SERVO];
+
+static void on_signal(int signal)
+{
+    running = 0;
+}
+
+static uint32_t now_ms(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint32_t)(ts.tv_sec * 1000 + ts.tv_nsec / 1000000);
+}
+
+static void usage(const char *name)
+{
+    printf("Usage: %s [-s socket] [-c controller] [-n servos] [-t tick_ms] [-p period_us]\n", name);
+}
+
+int main(int argc, char **argv)
+{
+    const char *socket_path = SE_DAEMON_DEFAULT_SOCKET;
+    int controller_type = eSE_CONTROLLER_LINUX_PCA9685;
+    int servo_count = 16;
+    uint32_t tick_ms = DEFAULT_DAEMON_TICK_MS;
+    uint32_t period_us = DEFAULT_DAEMON_PERIOD_US;
+    int opt;
+    while ((opt = getopt(argc, argv, "s:c:n:t:p:h")) != -1)
+    {
+        switch (opt)
+        {
+        case 's':
+            socket_path = optarg;
+            break;
+        case 'c':
+            controller_type = atoi(optarg);
+            break;
+        case 'n':
+            servo_count = atoi(optarg);
+            break;
+        case 't':
+            tick_ms = atoi(optarg);
+            break;
+        case 'p':
+            period_us = atoi(optarg);
+            break;
+        default:
+            usage(argv[0]);
+            return (opt == 'h') ? 0 : -1;
+        }
+    }
+
+    if (servo_count <= 0 || servo_count > MAX_CONTROLLER_SERVO || tick_ms == 0)
+    {
+        SE_ERROR("Servo count must be 1 to %d and tick not zero", MAX_CONTROLLER_SERVO);
+        return -1;
+    }
+
+    /* The daemon is the only process opening the channels */
+    struct SE_controller *controller = SE_open_controller(controller_type);
+    if (controller == NULL || SE_controller_init(controller) != kSE_SUCCESS)
+    {
+        SE_ERROR("Unable to open controller %d, error %s", controller_type, SE_get_error());
+        return -1;
+    }
+
+    for (int i = 0; i < servo_count; i++)
+    {
+        SE_argument_t args = {
+            .controller_id = controller->get_info_ref(controller)->id,
+            .easing_type = eSE_EASE_QUARACTIC,
+            .move_type = eSE_MOV_IN_OUT,
+            .servo_id = i,
+            .speed = DEFAULT_DAEMON_SPEED,
+            .period_us = period_us,
+        };
+        if (SE_create_servo(&servos[i], args) != kSE_SUCCESS)
+        {
+            SE_ERROR("Unable to create servo %d, error %s", i, SE_get_error());
+            return -1;
+        }
+    }
+
+    if (SE_daemon_open(socket_path, servos, servo_count) != kSE_SUCCESS)
+    {
+        SE_ERROR("Unable to open %s, error %s", socket_path, SE_get_error());
+        return -1;
+    }
+
+    signal(SIGINT, on_signal);
+    signal(SIGTERM, on_signal);
+    uint32_t next_tick = now_ms() + tick_ms;
+    while (running)
+    {
+        /* Commands arriving during a tick are applied together in the next frame */
+        int32_t wait_ms = (int32_t)(next_tick - now_ms());
+        if (wait_ms > 0)
+        {
+            SE_daemon_poll(wait_ms);
+            continue;
+        }
+
+        SE_daemon_poll(0);
+        SE_daemon_tick();
+        SE_tick_update(tick_ms);
+        SE_servo_update_all();
+        next_tick += tick_ms;
+        if ((int32_t)(now_ms() - next_tick) > (int32_t)tick_ms)
+        {
+            /* Overrun, restart the schedule instead of bursting frames */
+            next_tick = now_ms() + tick_ms;
+        }
+    }
+
+    SE_daemon_close();
+    for (int i = 0; i < servo_count; i++)
+    {
+        if (controller->close_servo != NULL)
+        {
+            controller->close_servo(controller, i);
+        }
+        SE_servo_deinit(&servos[i]);
+    }
+    return 0;
+}
@@ -0,0 +1,59 @@
+#ifndef SE_CALIBRATION_H
+#define SE_CALIBRATION_H
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include "stddef.h"
+#include "stdint.h"
+#include "SE_enum.h"
+
+#define SE_CALIBRATION_MAX_POINTS 16
+/* One LUT entry per degree, positions between entries carry SE_CALIBRATION_FRAC_BITS of fraction */
+#define SE_CALIBRATION_LUT_SIZE 181
+#define SE_CALIBRATION_FRAC_BITS 8
+
+/* Blob: "SEC1", table count, then per table servo id, point count and the points as angle
+ * plus little endian pulse us, 3 bytes each */
+#define SE_CALIBRATION_BLOB_MAGIC "SEC1"
+
+typedef struct _se_calibration_point
+{
+    uint8_t angle;
+    uint16_t pulse_us;
+} SE_calibration_point_t;
+
+/* Measured points of one servo, angles strictly increasing. Angles outside the points follow
+ * the nearest segment. */
+typedef struct _se_calibration
+{
+    uint8_t count;
+    SE_calibration_point_t point[SE_CALIBRATION_MAX_POINTS];
+} SE_calibration_t;
+
+SE_ret_t SE_calibration_load(SE_calibration_t *calibration, const uint8_t *blob, size_t size, uint8_t servo_id);
+SE_ret_t SE_calibration_compile(const SE_calibration_t *calibration, uint16_t *lut);
+/* The controller wide map, duty = units * resolution / 100 */
+void SE_calibration_compile_linear(uint32_t units_for_0_degree, uint32_t units_for_180_degree, uint32_t resolution,
+                                   uint16_t *lut);
+
+/* Duty at a position in degrees with SE_CALIBRATION_FRAC_BITS of fraction */
+static inline uint32_t SE_calibration_lookup(const uint16_t *lut, uint32_t position)
+{
+    uint32_t index = position >> SE_CALIBRATION_FRAC_BITS;
+    if (index >= SE_CALIBRATION_LUT_SIZE - 1)
+    {
+        return lut[SE_CALIBRATION_LUT_SIZE - 1];
+    }
+
+    int32_t fraction = position & ((1 << SE_CALIBRATION_FRAC_BITS) - 1);
+    int32_t step = (int32_t)lut[index + 1] - lut[index];
+    return lut[index] + ((step * fraction) >> SE_CALIBRATION_FRAC_BITS);
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /*SE_CALIBRATION_H*/
@@ -7,6 +7,7 @@ extern "C"
 
 #include "SE_enum.h"
 #include "stdint.h"
+#include "stddef.h"
 
 struct SE_controller_info {
     const char *name;
@@ -23,6 +24,9 @@ typedef struct SE_controller {
     SE_ret_t (*close_servo)(struct SE_controller*, uint8_t servo_id);
     SE_ret_t (*set_duty)(struct SE_controller*, uint8_t servo_id, uint32_t duty_us);
     SE_ret_t (*set_period)(struct SE_controller*, uint8_t servo_id, uint32_t preiod_us);
+    /* Optional, NULL falls back to one set_duty / set_period call per channel */
+    SE_ret_t (*set_duty_batch)(struct SE_controller*, const uint8_t *servo_ids, const uint32_t *duties_us, size_t count);
+    SE_ret_t (*set_period_batch)(struct SE_controller*, const uint8_t *servo_ids, const uint32_t *periods_us, size_t count);
     SE_ret_t (*set_id)(struct SE_controller*, int id);
     uint32_t (*get_pulse_resolution)(struct SE_controller*, uint8_t servo_id);
     const struct SE_controller_info *(*get_info_ref)(struct SE_controller*);
@@ -35,6 +39,10 @@ SE_ret_t SE_controller_register(SE_controller_t *controller);
 struct SE_controller* SE_controller_get(int controller_id);
 int SE_controller_get_available_controller(struct SE_controller_info *info);
 SE_ret_t SE_controller_init(SE_controller_t *controller);
+SE_ret_t SE_controller_set_duty_batch(SE_controller_t *controller, const uint8_t *servo_ids, const uint32_t *duties_us,
+                                      size_t count);
+SE_ret_t SE_controller_set_period_batch(SE_controller_t *controller, const uint8_t *servo_ids, const uint32_t *periods_us,
+                                        size_t count);
 
 #ifdef __cplusplus
 }
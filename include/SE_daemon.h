@@ -0,0 +1,27 @@
+#ifndef SE_DAEMON_H
+#define SE_DAEMON_H
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include "SE_enum.h"
+#include "SE_servo.h"
+#include "SE_daemon_proto.h"
+
+#define SE_DAEMON_MAX_CLIENTS 16
+#define SE_DAEMON_MAX_PENDING 1024
+
+/* Server side of servo_easingd: owns the servos, clients only send commands */
+SE_ret_t SE_daemon_open(const char *socket_path, SE_servo_t *servos, uint8_t count);
+void SE_daemon_close(void);
+/* Accepts clients and queues every command received within timeout_ms, returns the count queued */
+int SE_daemon_poll(int timeout_ms);
+/* Applies the commands queued since the last tick in arrival order, returns the count applied */
+int SE_daemon_tick(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /*SE_DAEMON_H*/
@@ -0,0 +1,31 @@
+#ifndef SE_DAEMON_CLIENT_H
+#define SE_DAEMON_CLIENT_H
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include "SE_enum.h"
+#include "SE_daemon_proto.h"
+
+/* Commands are queued locally and leave in one sendmsg on flush */
+typedef struct _se_daemon_client
+{
+    int fd;
+    uint16_t count;
+    SE_daemon_command_t command[SE_DAEMON_MAX_BATCH];
+} SE_daemon_client_t;
+
+SE_ret_t SE_daemon_client_connect(SE_daemon_client_t *client, const char *socket_path);
+void SE_daemon_client_close(SE_daemon_client_t *client);
+/* Queues one command, flushes on its own when the batch is full */
+SE_ret_t SE_daemon_client_queue(SE_daemon_client_t *client, const SE_daemon_command_t *command);
+SE_ret_t SE_daemon_client_move(SE_daemon_client_t *client, uint8_t servo, uint16_t angle, uint8_t speed,
+                               uint8_t easing_type, uint8_t move_type);
+SE_ret_t SE_daemon_client_flush(SE_daemon_client_t *client);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /*SE_DAEMON_CLIENT_H*/
@@ -0,0 +1,50 @@
+#ifndef SE_DAEMON_PROTO_H
+#define SE_DAEMON_PROTO_H
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include "stdint.h"
+
+#define SE_DAEMON_MAGIC 0x44455353 /* "SSED" */
+#define SE_DAEMON_VERSION 1
+#define SE_DAEMON_DEFAULT_SOCKET "/run/servo_easingd.sock"
+/* Commands in one message. SOCK_SEQPACKET keeps one record per sendmsg, a client with more
+ * commands sends more messages */
+#define SE_DAEMON_MAX_BATCH 256
+
+typedef enum _se_daemon_op
+{
+    eSE_DAEMON_OP_MOVE = 1,
+    eSE_DAEMON_OP_STOP,
+    eSE_DAEMON_OP_RESUME,
+    eSE_DAEMON_OP_SPEED,
+} SE_daemon_op_t;
+
+/* One SOCK_SEQPACKET message: the header then count fixed width commands, host endian */
+typedef struct _se_daemon_header
+{
+    uint32_t magic;
+    uint16_t version;
+    uint16_t count;
+} SE_daemon_header_t;
+
+typedef struct _se_daemon_command
+{
+    uint8_t op;
+    uint8_t servo;
+    uint8_t easing_type;
+    uint8_t move_type;
+    uint16_t angle;
+    uint8_t speed;
+    uint8_t reserved;
+} SE_daemon_command_t;
+
+#define SE_DAEMON_MAX_MESSAGE (sizeof(SE_daemon_header_t) + SE_DAEMON_MAX_BATCH * sizeof(SE_daemon_command_t))
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /*SE_DAEMON_PROTO_H*/
@@ -0,0 +1,37 @@
+#ifndef SE_EASING_H
+#define SE_EASING_H
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <stdbool.h>
+
+#include "stdint.h"
+#include "SE_enum.h"
+
+#define SE_EASING_MAX_CUSTOM 8
+/* Curves are compiled to y at evenly spaced x, linearly interpolated in between */
+#define SE_EASING_TABLE_SIZE 65
+/* Curve coordinates are fixed point, 0 to SE_EASING_ONE spans the move */
+#define SE_EASING_FRAC_BITS 16
+#define SE_EASING_ONE (1 << SE_EASING_FRAC_BITS)
+#define SE_EASING_FIXED(value) ((int32_t)((value) * SE_EASING_ONE))
+/* y may overshoot the move, within -limit to 1 + limit */
+#define SE_EASING_OVERSHOOT (2 * SE_EASING_ONE)
+
+/* CSS cubic-bezier(x1, y1, x2, y2) from (0, 0) to (1, 1), x1 and x2 within 0..1 */
+SE_ret_t SE_easing_register_bezier(int32_t x1, int32_t y1, int32_t x2, int32_t y2, SE_easing_t *type);
+/* count samples of y at evenly spaced x from 0 to 1, both ends included */
+SE_ret_t SE_easing_register_table(const int32_t *samples, uint16_t count, SE_easing_t *type);
+SE_ret_t SE_easing_unregister(SE_easing_t type);
+/* Built in or registered */
+bool SE_easing_is_valid(SE_easing_t type);
+/* y at x for a registered curve, x is clamped to 0..SE_EASING_ONE */
+int32_t SE_easing_custom_eval(SE_easing_t type, int32_t x);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /*SE_EASING_H*/
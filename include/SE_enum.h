@@ -9,6 +9,7 @@ typedef enum _servo_easing_ret {
     kSE_BUSY,
     kSE_TRY_AGAIN,
     kSE_NOT_SUPPORTED,
+    kSE_TIMEOUT,
 } SE_ret_t;
 
 typedef enum _servo_easing_type {
@@ -23,6 +24,8 @@ typedef enum _servo_easing_type {
     eSE_EASE_BOUNCE,
     eSE_EASE_PRECISION,
     eSE_EASE_LAST,
+    /* Curves registered at runtime are eSE_EASE_CUSTOM + n */
+    eSE_EASE_CUSTOM = 32,
 } SE_easing_t;
 
 typedef enum _servo_easing_mov {
@@ -40,5 +43,6 @@ typedef enum _supported_controller {
     eSE_CONTROLLER_MTK_9050,
     eSE_CONTROLLER_DC_MTK_9050,
     eSE_DUMMY_CONTROLLER,
+    eSE_SIM_CONTROLLER,
 } SE_supp_controller_t;
 #endif /*SERVO_EASING_ENUM_H*/
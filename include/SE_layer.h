@@ -0,0 +1,74 @@
+#ifndef SE_LAYER_H
+#define SE_LAYER_H
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include "stdint.h"
+#include "SE_enum.h"
+
+#define SE_LAYER_MAX 8
+/* Weights are fixed point, SE_LAYER_WEIGHT_ONE applies a layer in full */
+#define SE_LAYER_WEIGHT_BITS 8
+#define SE_LAYER_WEIGHT_ONE (1 << SE_LAYER_WEIGHT_BITS)
+
+typedef enum _se_layer_blend
+{
+    /* Pulls the pose below toward the layer angle by the weight */
+    eSE_LAYER_OVERRIDE = 0,
+    /* Adds the layer offset times the weight to the pose below */
+    eSE_LAYER_ADDITIVE,
+    eSE_LAYER_BLEND_LAST,
+} SE_layer_blend_t;
+
+/* Eases from to to over duration_ms. Angles are absolute for an override layer and offsets for
+ * an additive one. A looping layer swings back and forth until stopped, otherwise it holds its
+ * end value, and an additive layer that ends on no offset retires by itself. */
+typedef struct _se_layer_desc
+{
+    SE_layer_blend_t blend;
+    SE_easing_t easing_type;
+    SE_easing_mov_t move_type;
+    int16_t from;
+    int16_t to;
+    uint32_t duration_ms;
+    uint16_t weight;
+    uint8_t loop;
+} SE_layer_desc_t;
+
+typedef struct _se_layer
+{
+    SE_layer_desc_t desc;
+    uint32_t start_ms;
+    /* Degrees with SE_CALIBRATION_FRAC_BITS of fraction */
+    int32_t from;
+    int32_t delta;
+    int32_t value;
+    uint8_t done;
+} SE_layer_t;
+
+/* Layers of one servo blended bottom up over a base pose, layer 0 at the bottom. Only the
+ * layers set in active are evaluated. Drive it from the thread that updates the servo. */
+typedef struct _se_layer_stack
+{
+    uint32_t base;
+    uint32_t active;
+    SE_layer_t layer[SE_LAYER_MAX];
+} SE_layer_stack_t;
+
+void SE_layer_init(SE_layer_stack_t *stack);
+/* Pose under the layers, degrees with SE_CALIBRATION_FRAC_BITS of fraction */
+void SE_layer_set_base(SE_layer_stack_t *stack, uint32_t position);
+/* Starts or replaces the layer at index, times are on the servo tick clock */
+SE_ret_t SE_layer_play(SE_layer_stack_t *stack, uint8_t index, const SE_layer_desc_t *desc, uint32_t now_ms);
+SE_ret_t SE_layer_stop(SE_layer_stack_t *stack, uint8_t index);
+SE_ret_t SE_layer_set_weight(SE_layer_stack_t *stack, uint8_t index, uint16_t weight);
+/* Blended position at now_ms, clamped to 0..180 degrees */
+uint32_t SE_layer_eval(SE_layer_stack_t *stack, uint32_t now_ms);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /*SE_LAYER_H*/
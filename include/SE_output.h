@@ -0,0 +1,53 @@
+#ifndef SE_OUTPUT_H
+#define SE_OUTPUT_H
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include "SE_enum.h"
+#include "stdint.h"
+
+struct SE_controller;
+
+typedef struct _se_output_stats {
+    uint32_t published;
+    uint32_t written;
+    uint32_t dropped;
+    uint32_t saved;
+} SE_output_stats_t;
+
+/* Time from a frame commit until the controller writer finished writing it */
+typedef struct _se_output_latency {
+    uint32_t frames;
+    uint32_t last_us;
+    uint32_t max_us;
+    uint32_t average_us;
+    uint32_t deadline_missed;
+} SE_output_latency_t;
+
+/* Publish the newest duty of a channel. In async mode the value lands in the channel
+ * mailbox and the controller writer thread picks it up, an older value that was not
+ * written yet is dropped. Otherwise the controller set_duty is called directly. */
+SE_ret_t SE_output_set_duty(struct SE_controller *controller, uint8_t servo_id, uint32_t duty);
+/* Count an update that needed no write because the hardware could not have latched it */
+void SE_output_record_saved(struct SE_controller *controller, uint8_t servo_id);
+/* Between begin and commit, SE_output_set_duty only stages values. The commit hands each
+ * controller its whole frame through one set_duty_batch call. */
+void SE_output_frame_begin(void);
+SE_ret_t SE_output_frame_commit(void);
+/* With a deadline set, the commit waits for every async writer to finish the frame or for
+ * the deadline to pass, 0 returns as soon as the frame is handed out */
+void SE_output_set_frame_deadline(uint32_t deadline_us);
+SE_ret_t SE_output_frame_wait(uint32_t timeout_us);
+SE_ret_t SE_output_start_async(struct SE_controller *controller);
+void SE_output_stop_async(struct SE_controller *controller);
+SE_ret_t SE_output_start_async_all(void);
+void SE_output_stop_async_all(void);
+SE_ret_t SE_output_get_stats(struct SE_controller *controller, uint8_t servo_id, SE_output_stats_t *stats);
+SE_ret_t SE_output_get_latency(struct SE_controller *controller, SE_output_latency_t *latency);
+
+#ifdef __cplusplus
+}
+#endif
+#endif /*SE_OUTPUT_H*/
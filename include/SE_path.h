@@ -0,0 +1,26 @@
+#ifndef SE_PATH_H
+#define SE_PATH_H
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include "stdint.h"
+#include "SE_enum.h"
+#include "SE_profile.h"
+#include "SE_track.h"
+
+/* Every waypoint can take three track segments, so this many always fit in one track */
+#define SE_PATH_MAX_WAYPOINTS ((SE_TRACK_MAX_KEYS - 1) / 3 + 1)
+
+/* Minimum time path through the waypoints under the velocity and acceleration limits, max_jerk
+ * is not used. The servo only stops where the path turns back and at the last waypoint, and
+ * passes the others at the highest speed both neighbours allow. The result is compiled into
+ * the track, play it with SE_servo_set_track. */
+SE_ret_t SE_path_plan(SE_track_t *track, const uint8_t *waypoints, uint8_t count, const SE_profile_limits_t *limits);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /*SE_PATH_H*/
@@ -0,0 +1,36 @@
+#ifndef SE_PLAN_H
+#define SE_PLAN_H
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include "stdint.h"
+#include "SE_enum.h"
+
+/* One eased move as the engine plays it. Positions are degrees with SE_CALIBRATION_FRAC_BITS of
+ * fraction, times are on the servo tick clock. A duration of 0 is a jump, the plan sits at the end
+ * position at every time, start_ms included. */
+typedef struct _se_plan
+{
+    uint32_t start_ms;
+    uint32_t duration_ms;
+    uint32_t start_position;
+    int32_t delta_position;
+    SE_easing_t easing_type;
+    SE_easing_mov_t move_type;
+} SE_plan_t;
+
+/* Position at time_ms, held at the start before the move and at the end after it. Reads only
+ * the plan, so any thread may ask about any time. */
+uint32_t SE_plan_eval(const SE_plan_t *plan, uint32_t time_ms);
+/* Evaluates every plan at the same time_count times, plan major:
+ * positions[plan * time_count + time]. Equal to SE_plan_eval at each point. */
+SE_ret_t SE_plan_eval_batch(const SE_plan_t *plans, uint16_t plan_count, const uint32_t *times_ms,
+                            uint16_t time_count, uint32_t *positions);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /*SE_PLAN_H*/
@@ -0,0 +1,47 @@
+#ifndef SE_PROFILE_H
+#define SE_PROFILE_H
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include "stdint.h"
+#include "SE_enum.h"
+
+/* Longest move a profile may plan, keeps every tick in 64 bit integers */
+#define SE_PROFILE_MAX_DURATION_MS 1000000
+
+/* Degrees per second, per second squared and per second cubed. A max_jerk of 0 plans a
+ * trapezoidal profile, otherwise a jerk limited S-curve. */
+typedef struct _se_profile_limits
+{
+    uint32_t max_velocity;
+    uint32_t max_acceleration;
+    uint32_t max_jerk;
+} SE_profile_limits_t;
+
+/* Symmetric rest to rest profile: accel_ms to speed up, with jerk_ms ramps at both ends of it,
+ * cruise_ms at constant speed and accel_ms to stop. Phases are whole ms, the profile is scaled
+ * to land on the distance exactly, so rounding only ever lowers the peaks. */
+typedef struct _se_profile
+{
+    uint32_t distance;
+    uint32_t jerk_ms;
+    uint32_t accel_ms;
+    uint32_t cruise_ms;
+    uint32_t duration_ms;
+    uint8_t shift;
+    int64_t peak;
+    int64_t scale;
+} SE_profile_t;
+
+/* Minimum time profile over distance, in degrees with SE_CALIBRATION_FRAC_BITS of fraction */
+SE_ret_t SE_profile_plan(SE_profile_t *profile, const SE_profile_limits_t *limits, uint32_t distance);
+/* Distance covered time_ms after the start, same unit as the planned distance */
+uint32_t SE_profile_eval(const SE_profile_t *profile, uint32_t time_ms);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /*SE_PROFILE_H*/
@@ -0,0 +1,72 @@
+#ifndef SE_RENDER_H
+#define SE_RENDER_H
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include "stdint.h"
+#include "SE_enum.h"
+#include "SE_calibration.h"
+#include "SE_plan.h"
+
+#define SE_RENDER_MAX_CHANNELS 64
+
+/* Eases from the previous angle to angle over duration_ms, moves of a channel play back to back */
+typedef struct _se_render_move
+{
+    uint32_t duration_ms;
+    uint8_t angle;
+    SE_easing_t easing_type;
+    SE_easing_mov_t move_type;
+} SE_render_move_t;
+
+typedef struct _se_render_channel
+{
+    uint8_t controller_id;
+    uint8_t servo_id;
+    uint8_t start_angle;
+    /* NULL keeps the controller wide linear map */
+    const SE_calibration_t *calibration;
+    const SE_render_move_t *moves;
+    uint32_t move_count;
+} SE_render_channel_t;
+
+struct _se_render_cursor
+{
+    uint32_t move;
+    uint32_t end_ms;
+    uint16_t angle;
+    SE_plan_t plan;
+};
+
+/* Renders the duties the servos would emit one PWM period apart on a virtual clock, without
+ * sleeping and without writing to any controller. The render owns no heap memory. */
+typedef struct _se_render
+{
+    const SE_render_channel_t *channel;
+    uint16_t channel_count;
+    uint32_t period_ms;
+    uint32_t frame;
+    struct _se_render_cursor cursor[SE_RENDER_MAX_CHANNELS];
+    uint16_t lut[SE_RENDER_MAX_CHANNELS][SE_CALIBRATION_LUT_SIZE];
+} SE_render_t;
+
+/* Compiles the pulse table of every channel, the controllers are only asked for their map.
+ * The channels are used in place and must outlive the render. */
+SE_ret_t SE_render_init(SE_render_t *render, const SE_render_channel_t *channels, uint16_t channel_count,
+                        uint32_t period_ms);
+/* Renders the next frame_count frames, frame major: duties[frame * channel_count + channel] */
+SE_ret_t SE_render_frames(SE_render_t *render, uint16_t *duties, uint32_t frame_count);
+/* Back to frame 0 */
+void SE_render_rewind(SE_render_t *render);
+/* Virtual time of the next frame */
+uint32_t SE_render_get_time(const SE_render_t *render);
+/* Frames until the last channel holds its last angle, that frame included */
+uint32_t SE_render_get_frame_count(const SE_render_t *render);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /*SE_RENDER_H*/
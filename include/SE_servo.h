@@ -6,6 +6,12 @@ extern "C"
 #endif
 
 #include "SE_enum.h"
+#include "SE_calibration.h"
+#include "SE_track.h"
+#include "SE_profile.h"
+#include "SE_stream.h"
+#include "SE_layer.h"
+#include "SE_plan.h"
 #include "stdint.h"
 
 typedef struct _se_servo_data SE_servo_data_t;
@@ -19,6 +25,8 @@ typedef struct _servo_args {
     uint8_t speed;
     uint8_t init_angle;
     uint8_t reverse;
+    /* NULL keeps the controller wide linear map */
+    const SE_calibration_t *calibration;
 } SE_argument_t;
 
 typedef struct _se_servo
@@ -39,17 +47,44 @@ void SE_servo_deinit(SE_servo_t *servo);
 SE_ret_t SE_servo_set_angle(SE_servo_t *servo, int angle);
 int SE_servo_get_angle(SE_servo_t *servo);
 SE_ret_t SE_servo_update(SE_servo_t *servo);
+/* Update every created servo in one frame, servo handles must stay where they were created */
+SE_ret_t SE_servo_update_all(void);
 uint8_t SE_servo_is_moving(SE_servo_t *servo);
 uint8_t SE_servo_is_stop(SE_servo_t *servo);
 SE_ret_t SE_servo_start(SE_servo_t *servo);
 SE_ret_t SE_servo_stop(SE_servo_t *servo);
 SE_ret_t SE_servo_resume(SE_servo_t *servo);
+/* Replaces the move in progress with an eased move to angle from where the servo is, speed 0
+ * keeps the servo speed */
+SE_ret_t SE_servo_retarget(SE_servo_t *servo, SE_easing_t easing_type, SE_easing_mov_t move_type, uint8_t speed,
+                           int angle);
 SE_ret_t SE_servo_set_speed(SE_servo_t *servo, uint8_t deg_per_sec);
 uint8_t SE_servo_get_speed(SE_servo_t *servo);
 uint32_t SE_servo_get_milis_to_complete_move(SE_servo_t *servo);
 SE_ret_t SE_servo_set_milis_to_complete_move(SE_servo_t *servo, uint32_t milis);
 uint32_t SE_servo_get_delta_unit_to_move(SE_servo_t *servo);
 uint32_t SE_servo_get_start_move_milis(SE_servo_t *servo);
+SE_ret_t SE_servo_set_period(SE_servo_t *servo, uint32_t period_us);
+/* On by default: at most one duty per PWM period, eased at the next latch */
+SE_ret_t SE_servo_set_decimation(SE_servo_t *servo, uint8_t enable);
+/* Compiles the points into the servo pulse table, NULL goes back to the linear map */
+SE_ret_t SE_servo_set_calibration(SE_servo_t *servo, const SE_calibration_t *calibration);
+/* Plays the track on the next start instead of easing to the set angle, NULL detaches it.
+ * The track is used in place and must outlive the move. */
+SE_ret_t SE_servo_set_track(SE_servo_t *servo, SE_track_t *track);
+/* Follows the stream from the next start until stopped, NULL detaches it. The stream is used in
+ * place and must outlive the move, a set track takes precedence. */
+SE_ret_t SE_servo_set_stream(SE_servo_t *servo, SE_stream_t *stream);
+/* Blends the layers over the angle the servo holds from the next start until stopped, NULL
+ * detaches them. Layers can be played and stopped while the servo runs. A set track or stream
+ * takes precedence. */
+SE_ret_t SE_servo_set_layers(SE_servo_t *servo, SE_layer_stack_t *layers);
+/* Moves to the set angle in minimum time under the limits instead of at the easing speed, NULL
+ * goes back to easing. A set track takes precedence. */
+SE_ret_t SE_servo_set_profile(SE_servo_t *servo, const SE_profile_limits_t *limits);
+/* Snapshot of the eased move the servo plays, without touching its state. An idle servo gets a
+ * plan that holds its angle. Evaluate it with SE_plan_eval at any time. */
+SE_ret_t SE_servo_get_plan(SE_servo_t *servo, SE_plan_t *plan);
 SE_ret_t SE_servo_on_destination_reach(SE_servo_t *servo, SE_servo_dest_reach_cb_t cb);
 SE_ret_t SE_servo_on_update(SE_servo_t *servo, SE_servo_update_cb_t cb);
 
@@ -0,0 +1,24 @@
+#ifndef SE_SHM_H
+#define SE_SHM_H
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include "SE_enum.h"
+#include "SE_servo.h"
+#include "SE_shm_layout.h"
+
+/* Consumer side, owned by the process running the update loop */
+SE_ret_t SE_shm_create(const char *name);
+void SE_shm_destroy(void);
+SE_ret_t SE_shm_attach(uint8_t slot, SE_servo_t *servo);
+/* Applies the pending ring commands then the changed blocks, call it before each update.
+ * Returns the number of commands applied. */
+int SE_shm_poll(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /*SE_SHM_H*/
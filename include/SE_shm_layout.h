@@ -0,0 +1,75 @@
+#ifndef SE_SHM_LAYOUT_H
+#define SE_SHM_LAYOUT_H
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include "stdint.h"
+#include "time.h"
+
+#define SE_SHM_MAGIC 0x314d4553 /* "SEM1" */
+#define SE_SHM_VERSION 1
+#define SE_SHM_MAX_SERVO 32
+/* Power of two so indexes wrap with a mask */
+#define SE_SHM_RING_SIZE 256
+#define SE_SHM_CACHE_LINE 64
+
+/* Shared between processes, fields are only touched through __atomic builtins */
+typedef struct _se_shm_command
+{
+    uint64_t sent_ns;
+    uint32_t sequence;
+    uint16_t angle;
+    uint8_t slot;
+    uint8_t speed;
+    uint8_t easing_type;
+    uint8_t move_type;
+    uint16_t reserved;
+} SE_shm_command_t;
+
+/* Latest command wins. sequence is a seqlock, odd while the producer rewrites the command.
+ * The consumer publishes the command sequence it applied and when. */
+struct SE_shm_block
+{
+    uint32_t sequence;
+    uint32_t applied_sequence;
+    uint64_t applied_ns;
+    SE_shm_command_t command;
+    uint8_t reserved[SE_SHM_CACHE_LINE - 16 - sizeof(SE_shm_command_t)];
+};
+
+/* Single producer single consumer, every command pushed is applied in order */
+struct SE_shm_ring
+{
+    uint32_t head;
+    uint8_t head_pad[SE_SHM_CACHE_LINE - sizeof(uint32_t)];
+    uint32_t tail;
+    uint8_t tail_pad[SE_SHM_CACHE_LINE - sizeof(uint32_t)];
+    SE_shm_command_t command[SE_SHM_RING_SIZE];
+};
+
+struct SE_shm_segment
+{
+    uint32_t magic;
+    uint32_t version;
+    uint32_t max_servo;
+    uint32_t ring_size;
+    uint8_t header_pad[SE_SHM_CACHE_LINE - 4 * sizeof(uint32_t)];
+    struct SE_shm_block block[SE_SHM_MAX_SERVO];
+    struct SE_shm_ring ring;
+};
+
+/* Both sides stamp commands on the monotonic clock, which is shared across processes */
+static inline uint64_t SE_shm_now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /*SE_SHM_LAYOUT_H*/
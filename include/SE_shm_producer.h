@@ -0,0 +1,30 @@
+#ifndef SE_SHM_PRODUCER_H
+#define SE_SHM_PRODUCER_H
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include "SE_enum.h"
+#include "SE_shm_layout.h"
+
+/* Producer side, only needs the segment layout and links without the engine */
+typedef struct _se_shm_producer
+{
+    struct SE_shm_segment *segment;
+    uint32_t sequence;
+} SE_shm_producer_t;
+
+SE_ret_t SE_shm_producer_open(SE_shm_producer_t *producer, const char *name);
+void SE_shm_producer_close(SE_shm_producer_t *producer);
+/* Overwrites the slot command block, returns the command sequence */
+uint32_t SE_shm_producer_set(SE_shm_producer_t *producer, SE_shm_command_t *command);
+/* Queues the command behind the previous ones, kSE_TRY_AGAIN while the ring is full */
+SE_ret_t SE_shm_producer_push(SE_shm_producer_t *producer, SE_shm_command_t *command);
+uint32_t SE_shm_producer_get_applied(SE_shm_producer_t *producer, uint8_t slot, uint64_t *applied_ns);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /*SE_SHM_PRODUCER_H*/
@@ -0,0 +1,74 @@
+#ifndef SE_SHOW_H
+#define SE_SHOW_H
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <stddef.h>
+
+#include "SE_enum.h"
+#include "SE_servo.h"
+#include "SE_show_layout.h"
+
+#define SE_SHOW_MAX_TRACKS 64
+
+/* Absolute keys for the writer, each eases to angle over duration_ms */
+typedef struct _se_show_key
+{
+    uint16_t duration_ms;
+    uint16_t angle;
+    SE_easing_t easing_type;
+    SE_easing_mov_t move_type;
+} SE_show_key_t;
+
+typedef struct _se_show_track_desc
+{
+    uint8_t controller_id;
+    uint8_t servo_id;
+    uint16_t start_angle;
+    const SE_show_key_t *keys;
+    uint32_t key_count;
+} SE_show_track_desc_t;
+
+struct _se_show_cursor
+{
+    uint32_t segment;
+    uint32_t end_ms;
+    uint16_t angle;
+};
+
+/* Plays a mapped show in place, the player owns no heap memory */
+typedef struct _se_show_player
+{
+    const uint8_t *map;
+    size_t size;
+    const SE_show_header_t *header;
+    const SE_show_track_t *track;
+    const SE_show_index_t *index;
+    const SE_show_segment_t *segment;
+    SE_servo_t *servo[SE_SHOW_MAX_TRACKS];
+    struct _se_show_cursor cursor[SE_SHOW_MAX_TRACKS];
+} SE_show_player_t;
+
+/* Delta encodes the keys and builds the seek index every index_interval_ms */
+SE_ret_t SE_show_write(const char *path, const SE_show_track_desc_t *tracks, uint16_t track_count,
+                       uint32_t index_interval_ms);
+
+/* Maps the file and checks the header, the tables are only read while playing */
+SE_ret_t SE_show_open(SE_show_player_t *player, const char *path);
+void SE_show_close(SE_show_player_t *player);
+/* Binds the servo to the track with its controller and servo id */
+SE_ret_t SE_show_attach(SE_show_player_t *player, SE_servo_t *servo);
+/* Restarts every attached servo from the segment playing at time_ms */
+SE_ret_t SE_show_seek(SE_show_player_t *player, uint32_t time_ms);
+/* Starts the segments due by time_ms, call it before each servo update.
+ * Returns the number of segments started. */
+int SE_show_update(SE_show_player_t *player, uint32_t time_ms);
+uint32_t SE_show_get_duration(const SE_show_player_t *player);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /*SE_SHOW_H*/
@@ -0,0 +1,63 @@
+#ifndef SE_SHOW_LAYOUT_H
+#define SE_SHOW_LAYOUT_H
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include "stdint.h"
+
+#define SE_SHOW_MAGIC 0x31534553 /* "SES1" */
+#define SE_SHOW_VERSION 1
+
+/* Show file, host byte order, every table naturally aligned:
+ * header | track[track_count] | index[track_count][index_count] | segment[segment_count]
+ * Tracks own a contiguous run of segments. Each segment eases from the previous end angle by
+ * delta degrees, a zero delta holds. */
+typedef struct _se_show_header
+{
+    uint32_t magic;
+    uint16_t version;
+    uint16_t track_count;
+    uint32_t duration_ms;
+    uint32_t index_interval_ms;
+    uint32_t index_count;
+    uint32_t track_offset;
+    uint32_t index_offset;
+    uint32_t segment_offset;
+    uint32_t segment_count;
+    uint32_t reserved[7];
+} SE_show_header_t;
+
+typedef struct _se_show_track
+{
+    uint8_t controller_id;
+    uint8_t servo_id;
+    uint16_t start_angle;
+    uint32_t segment_first;
+    uint32_t segment_count;
+} SE_show_track_t;
+
+/* Segment playing at index_interval_ms * k, relative to the track first segment, with when it
+ * started and the angle it started from. Past the track end it is segment_count. */
+typedef struct _se_show_index
+{
+    uint32_t segment;
+    uint32_t start_ms;
+    uint16_t start_angle;
+    uint16_t reserved;
+} SE_show_index_t;
+
+typedef struct _se_show_segment
+{
+    uint16_t duration_ms;
+    int16_t delta;
+    uint8_t easing_type;
+    uint8_t move_type;
+} SE_show_segment_t;
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /*SE_SHOW_LAYOUT_H*/
@@ -0,0 +1,53 @@
+#ifndef SE_STREAM_H
+#define SE_STREAM_H
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include "stdint.h"
+#include "SE_enum.h"
+
+/* Power of two so indexes wrap with a mask */
+#define SE_STREAM_SAMPLES 16
+
+typedef struct _se_stream_sample
+{
+    uint32_t time_ms;
+    uint32_t position;
+} SE_stream_sample_t;
+
+/* Jitter buffer for one servo. One producer pushes timestamped setpoints, the update loop plays
+ * them back latency_ms late through a Catmull-Rom curve, then clamps velocity and acceleration.
+ * Pushing never waits on the update loop. */
+typedef struct _se_stream
+{
+    SE_stream_sample_t sample[SE_STREAM_SAMPLES];
+    uint32_t head;
+    uint32_t last_push_ms;
+    uint32_t latency_ms;
+    uint32_t max_velocity;
+    uint32_t max_acceleration;
+    /* Playback side, 1/1000 of a position step and position steps per second */
+    int32_t output;
+    int32_t velocity;
+    uint32_t output_ms;
+    uint32_t underruns;
+    uint8_t has_output;
+} SE_stream_t;
+
+/* Limits in degrees per second and per second squared, 0 leaves it free */
+SE_ret_t SE_stream_init(SE_stream_t *stream, uint32_t latency_ms, uint32_t max_velocity, uint32_t max_acceleration);
+/* Producer side. Times are on the servo tick clock and strictly increasing, positions are degrees
+ * with SE_CALIBRATION_FRAC_BITS of fraction. */
+SE_ret_t SE_stream_push(SE_stream_t *stream, uint32_t time_ms, uint32_t position);
+/* Playback side, restarts the output still at position */
+void SE_stream_reset(SE_stream_t *stream, uint32_t position, uint32_t now_ms);
+/* Position to output at now_ms, holds the newest sample when the producer falls behind */
+uint32_t SE_stream_eval(SE_stream_t *stream, uint32_t now_ms);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /*SE_STREAM_H*/
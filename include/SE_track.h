@@ -0,0 +1,71 @@
+#ifndef SE_TRACK_H
+#define SE_TRACK_H
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include "stdint.h"
+#include "SE_enum.h"
+
+#define SE_TRACK_MAX_KEYS 32
+/* Positions are degrees with SE_TRACK_FRAC_BITS of fraction, same scale as the pulse table */
+#define SE_TRACK_FRAC_BITS 8
+/* Fixed point builds keep the segment phase with this many bits */
+#define SE_TRACK_PHASE_BITS 16
+
+#ifdef USE_FLOAT
+typedef float SE_track_coef_t;
+#else
+typedef int32_t SE_track_coef_t;
+#endif /*USE_FLOAT*/
+
+typedef struct _se_track_key
+{
+    uint32_t time_ms;
+    uint8_t angle;
+} SE_track_key_t;
+
+/* Position the track passes at time_ms with its velocity, in degrees and degrees per second
+ * with SE_TRACK_FRAC_BITS of fraction */
+typedef struct _se_track_node
+{
+    uint32_t time_ms;
+    uint32_t position;
+    int32_t velocity;
+} SE_track_node_t;
+
+/* Cubic Hermite segment in its phase s over [0, 1): coef[0] + coef[1] s + coef[2] s^2 + coef[3] s^3,
+ * scale turns the ms into the segment into s */
+typedef struct _se_track_segment
+{
+    uint32_t start_ms;
+    uint32_t duration_ms;
+    SE_track_coef_t scale;
+    SE_track_coef_t coef[4];
+} SE_track_segment_t;
+
+/* Catmull-Rom track through the keys, still at both ends. Evaluation walks a cursor forward,
+ * so a tick costs one Horner evaluation whatever the key count. */
+typedef struct _se_track
+{
+    uint8_t count;
+    uint8_t cursor;
+    uint8_t end_angle;
+    SE_track_segment_t segment[SE_TRACK_MAX_KEYS - 1];
+} SE_track_t;
+
+/* Keys need strictly increasing times, the first one at 0 ms */
+SE_ret_t SE_track_load(SE_track_t *track, const SE_track_key_t *keys, uint8_t count);
+/* Hermite segments through the nodes with their own velocities instead of Catmull-Rom tangents.
+ * Same time rules as the keys, the last node ends on a whole degree. */
+SE_ret_t SE_track_load_nodes(SE_track_t *track, const SE_track_node_t *nodes, uint8_t count);
+/* Position at time_ms since the track start, clamped to 0..180 degrees */
+uint32_t SE_track_eval(SE_track_t *track, uint32_t time_ms);
+uint32_t SE_track_get_duration(const SE_track_t *track);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /*SE_TRACK_H*/
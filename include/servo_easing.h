@@ -7,9 +7,15 @@ extern "C"
 
 #include "SE_enum.h"
 #include "SE_servo.h"
+#include "SE_easing.h"
+#include "SE_render.h"
 #include "SE_controller.h"
 
 struct SE_controller *SE_open_controller(SE_supp_controller_t controller);
+/* One controller per board, each with its own channel state and controller id */
+struct SE_controller *SE_open_controller_instance(SE_supp_controller_t controller, uint8_t instance);
+/* Boards found for this controller type */
+int SE_count_controller_instances(SE_supp_controller_t controller);
 SE_ret_t SE_create_servo(SE_servo_t *new_servo, SE_argument_t args);
 const char *SE_get_error(void);
 
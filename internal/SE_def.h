@@ -13,6 +13,10 @@ extern "C"
 #define MAX_SERVO_INSTANCES 20
 #endif /*MAX_SERVO_INSTANCES*/
 
+#ifndef MAX_CONTROLLER_SERVO
+#define MAX_CONTROLLER_SERVO 16
+#endif /*MAX_CONTROLLER_SERVO*/
+
 #if !defined(USE_PRINTF_LOG) && !defined(USE_OLLI_LOG) && !defined(USE_NONE_LOG)
 #define USE_NONE_LOG
 #endif
@@ -0,0 +1,67 @@
+#ifndef SE_FAST_MATH_H
+#define SE_FAST_MATH_H
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include "stdint.h"
+
+/* Single precision stand-ins for the libm double routines in the float easing kernels.
+ * Minimax polynomials, in float arithmetic sin lands within 1e-6 absolute and exp2 within 2e-7
+ * relative, against 2.6e-3 of a move for one PCA9685 count.
+ * bench_fast_math reports every easing kernel against libm in PCA9685 counts. */
+
+#define SE_FAST_PI 3.14159265f
+#define SE_FAST_PI_2 1.57079633f
+
+/* Folded onto [-pi/2, pi/2], odd polynomial of degree 7 */
+static inline float SE_fast_sinf(float x)
+{
+    float turns = x * (0.5f / SE_FAST_PI);
+    int32_t k = (int32_t)(turns + ((turns < 0) ? -0.5f : 0.5f));
+    x -= (float)k * (2 * SE_FAST_PI);
+    if (x > SE_FAST_PI_2)
+    {
+        x = SE_FAST_PI - x;
+    }
+    else if (x < -SE_FAST_PI_2)
+    {
+        x = -SE_FAST_PI - x;
+    }
+
+    float x2 = x * x;
+    return x * (0.999996616f + x2 * (-0.166648284f + x2 * (0.00830632523f + x2 * -0.000183636540f)));
+}
+
+/* 2^x as 2^k times a degree 5 polynomial on [-0.5, 0.5], exact for the exponent range of float */
+static inline float SE_fast_exp2f(float x)
+{
+    if (x < -126.0f)
+    {
+        return 0.0f;
+    }
+
+    int32_t k = (int32_t)(x + ((x < 0) ? -0.5f : 0.5f));
+    float f = x - (float)k;
+    float p = 1.00000007f +
+              f * (0.693146967f + f * (0.240221197f + f * (0.0555071327f + f * (0.00967554133f + f * 0.00132764720f))));
+    union
+    {
+        uint32_t bits;
+        float value;
+    } scale = {.bits = (uint32_t)(k + 127) << 23};
+    return p * scale.value;
+}
+
+/* Single precision square root is one instruction on VFP and SSE */
+static inline float SE_fast_sqrtf(float x)
+{
+    return __builtin_sqrtf(x);
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /*SE_FAST_MATH_H*/
@@ -0,0 +1,40 @@
+#ifndef SE_MATH_H
+#define SE_MATH_H
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include "stdint.h"
+
+/* Integer square root, rounded down, for builds without floating point */
+static inline uint64_t SE_sqrt64(uint64_t value)
+{
+    uint64_t root = 0;
+    uint64_t bit = 1ULL << 62;
+    while (bit > value)
+    {
+        bit >>= 2;
+    }
+
+    while (bit != 0)
+    {
+        if (value >= root + bit)
+        {
+            value -= root + bit;
+            root = (root >> 1) + bit;
+        }
+        else
+        {
+            root >>= 1;
+        }
+        bit >>= 2;
+    }
+    return root;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /*SE_MATH_H*/
@@ -0,0 +1,29 @@
+#ifndef SE_PWMCHIP_H
+#define SE_PWMCHIP_H
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <stddef.h>
+
+#include "SE_enum.h"
+
+#ifndef MAX_PWMCHIP
+#define MAX_PWMCHIP 128
+#endif /*MAX_PWMCHIP*/
+
+#define PWMCHIP_SYSFS_ROOT "/sys/class/pwm"
+
+/* Every pwmchip is enumerated once and its compatible string cached, all controllers
+ * share the result. Lookups return chips sorted by pwmchip number. */
+SE_ret_t SE_pwmchip_find(const char *compatible, char *dev_path, size_t len);
+int SE_pwmchip_find_all(const char *compatible, const char **dev_paths, int max_paths);
+int SE_pwmchip_count(void);
+void SE_pwmchip_set_root(const char *root);
+void SE_pwmchip_invalidate(void);
+
+#ifdef __cplusplus
+}
+#endif
+#endif /*SE_PWMCHIP_H*/
@@ -27,6 +27,10 @@ static SE_ret_t dummy_open_servo(struct SE_controller *controller, uint8_t servo
 static SE_ret_t dummy_close_servo(struct SE_controller *controller, uint8_t servo_id);
 static SE_ret_t dummy_set_duty(struct SE_controller *controller, uint8_t servo_id, uint32_t duty_us);
 static SE_ret_t dummy_set_period(struct SE_controller *controller, uint8_t servo_id, uint32_t period_us);
+static SE_ret_t dummy_set_duty_batch(struct SE_controller *controller, const uint8_t *servo_ids,
+                                     const uint32_t *duties_us, size_t count);
+static SE_ret_t dummy_set_period_batch(struct SE_controller *controller, const uint8_t *servo_ids,
+                                       const uint32_t *periods_us, size_t count);
 static const struct SE_controller_info *dummy_get_info_ref(struct SE_controller *controller);
 static struct SE_controller_info dummy_get_info_copy(struct SE_controller *controller);
 static SE_ret_t dummy_set_id(struct SE_controller *controller, int id);
@@ -48,7 +52,7 @@ struct dummy_data
     bool is_open;
 };
 
-static struct dummy_data controller_data = {
+static const struct dummy_data controller_data_template = {
     .info = {
         .name = "Dummy servo controller",
         .id = 0,
@@ -67,24 +71,46 @@ static struct dummy_data controller_data = {
     .is_open = false,
 };
 
-static struct SE_controller dummy_controller = {
+static const struct SE_controller dummy_controller_template = {
     .controller_init = dummy_init_device,
     .controller_deinit = dummy_deinit_device,
     .open_servo = dummy_open_servo,
     .close_servo = dummy_close_servo,
     .set_duty = dummy_set_duty,
     .set_period = dummy_set_period,
+    .set_duty_batch = dummy_set_duty_batch,
+    .set_period_batch = dummy_set_period_batch,
     .get_info_ref = dummy_get_info_ref,
     .get_info_copy = dummy_get_info_copy,
     .set_id = dummy_set_id,
     .get_pulse_resolution = dummy_get_pulse_resolution,
     .register_servo_event = dummy_servo_callback_register,
-    .controller_data = (void *)&controller_data,
 };
 
+static struct dummy_data controller_data[DUMMY_MAX_INSTANCES];
+static struct SE_controller dummy_controller[DUMMY_MAX_INSTANCES];
+
 struct SE_controller *Dummy_get_controller()
 {
-    return &dummy_controller;
+    return Dummy_get_controller_instance(0);
+}
+
+struct SE_controller *Dummy_get_controller_instance(uint8_t instance)
+{
+    if (instance >= DUMMY_MAX_INSTANCES)
+    {
+        SE_set_error("Dummy instance is out of range");
+        return NULL;
+    }
+
+    struct SE_controller *controller = &dummy_controller[instance];
+    if (controller->controller_data == NULL)
+    {
+        controller_data[instance] = controller_data_template;
+        *controller = dummy_controller_template;
+        controller->controller_data = (void *)&controller_data[instance];
+    }
+    return controller;
 }
 
 static SE_ret_t dummy_init_device(struct SE_controller *controller)
@@ -140,6 +166,44 @@ static SE_ret_t dummy_set_duty(struct SE_controller *controller, uint8_t servo_i
         return kSE_NULL;
     }
     SE_DEBUG("Servo %d set duty to %u", servo_id, duty);
+    struct dummy_data *data = (struct dummy_data *)controller->controller_data;
+    if (servo_id < data->info.max_servo)
+    {
+        data->servo[servo_id].duty_us = duty;
+    }
+    return kSE_SUCCESS;
+}
+
+static SE_ret_t _dummy_batch_validate(struct dummy_data *data, const uint8_t *servo_ids, size_t count)
+{
+    for (size_t i = 0; i < count; i++)
+    {
+        if (servo_ids[i] >= data->info.max_servo)
+        {
+            SE_set_error("Servo in batch is out of range");
+            return kSE_OUT_OF_RANGE;
+        }
+    }
+    return kSE_SUCCESS;
+}
+
+static SE_ret_t dummy_set_duty_batch(struct SE_controller *controller, const uint8_t *servo_ids,
+                                     const uint32_t *duties_us, size_t count)
+{
+    CONTROLLER_VALIDATE(controller, kSE_NULL);
+
+    struct dummy_data *data = (struct dummy_data *)controller->controller_data;
+    SE_ret_t ret = _dummy_batch_validate(data, servo_ids, count);
+    if (ret != kSE_SUCCESS)
+    {
+        return ret;
+    }
+
+    for (size_t i = 0; i < count; i++)
+    {
+        data->servo[servo_ids[i]].duty_us = duties_us[i];
+    }
+    SE_DEBUG("Set duty of %zu servo(s) in one batch", count);
     return kSE_SUCCESS;
 }
 
@@ -158,6 +222,27 @@ static SE_ret_t dummy_set_period(struct SE_controller *controller, uint8_t servo
     return kSE_SUCCESS;
 }
 
+static SE_ret_t dummy_set_period_batch(struct SE_controller *controller, const uint8_t *servo_ids,
+                                       const uint32_t *periods_us, size_t count)
+{
+    CONTROLLER_VALIDATE(controller, kSE_NULL);
+
+    struct dummy_data *data = (struct dummy_data *)controller->controller_data;
+    SE_ret_t ret = _dummy_batch_validate(data, servo_ids, count);
+    if (ret != kSE_SUCCESS)
+    {
+        return ret;
+    }
+
+    for (size_t i = 0; i < count; i++)
+    {
+        data->servo[servo_ids[i]].period_us = periods_us[i];
+        data->servo[servo_ids[i]].pwm_resolution = PULSE_UNIT_US(periods_us[i]);
+    }
+    SE_DEBUG("Set period of %zu servo(s) in one batch", count);
+    return kSE_SUCCESS;
+}
+
 static const struct SE_controller_info *dummy_get_info_ref(struct SE_controller *controller)
 {
     const struct SE_controller_info *info_ref = NULL;
@@ -2,5 +2,8 @@
 #define DUMMY_CONTROLLER_H
 #include "SE_controller.h"
 
+#define DUMMY_MAX_INSTANCES 4
+
 struct SE_controller *Dummy_get_controller();
-#endif /*DUMMY_CONTROLLER_H*/
\ No newline at end of file
+struct SE_controller *Dummy_get_controller_instance(uint8_t instance);
+#endif /*DUMMY_CONTROLLER_H*/
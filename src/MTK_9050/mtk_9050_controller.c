@@ -3,7 +3,6 @@
 
 #include <stdbool.h>
 #include <stdio.h>
-#include <dirent.h>
 #include <unistd.h>
 #include <malloc.h>
 #include <string.h>
@@ -12,6 +11,7 @@
 #include "SE_servo.h"
 #include "SE_errors.h"
 #include "SE_logging.h"
+#include "SE_pwmchip.h"
 
 #define MTK_9050_MAX_SERVO 16
 
@@ -34,6 +34,10 @@ static SE_ret_t MTK_9050_linux_open_servo(struct SE_controller *controller, uint
 static SE_ret_t MTK_9050_linux_close_servo(struct SE_controller *controller, uint8_t servo_id);
 static SE_ret_t MTK_9050_linux_set_duty(struct SE_controller *controller, uint8_t servo_id, uint32_t duty_us);
 static SE_ret_t MTK_9050_linux_set_period(struct SE_controller *controller, uint8_t servo_id, uint32_t period_us);
+static SE_ret_t MTK_9050_linux_set_duty_batch(struct SE_controller *controller, const uint8_t *servo_ids,
+                                              const uint32_t *duties_us, size_t count);
+static SE_ret_t MTK_9050_linux_set_period_batch(struct SE_controller *controller, const uint8_t *servo_ids,
+                                                const uint32_t *periods_us, size_t count);
 static const struct SE_controller_info *MTK_9050_linux_get_info_ref(struct SE_controller *controller);
 static struct SE_controller_info MTK_9050_linux_get_info_copy(struct SE_controller *controller);
 static SE_ret_t MTK_9050_linux_set_id(struct SE_controller *controller, int id);
@@ -47,6 +51,7 @@ struct mtk_9050_linux_servo_info
     uint32_t duty_us;
     uint32_t pwm_resolution;
     bool is_open;
+    bool has_duty;
 };
 
 struct mtk_9050_linux_data
@@ -79,6 +84,8 @@ static struct SE_controller mtk_9050_linux_controller = {
     .close_servo = MTK_9050_linux_close_servo,
     .set_duty = MTK_9050_linux_set_duty,
     .set_period = MTK_9050_linux_set_period,
+    .set_duty_batch = MTK_9050_linux_set_duty_batch,
+    .set_period_batch = MTK_9050_linux_set_period_batch,
     .get_info_ref = MTK_9050_linux_get_info_ref,
     .get_info_copy = MTK_9050_linux_get_info_copy,
     .set_id = MTK_9050_linux_set_id,
@@ -90,8 +97,6 @@ static struct SE_controller mtk_9050_linux_controller = {
 
 static SE_ret_t MTK_9050_linux_init_device(struct SE_controller *controller)
 {
-    DIR *dir = NULL;
-    struct dirent *entry = NULL;
     SE_ret_t ret = kSE_FAILED;
     CONTROLLER_VALIDATE(controller, kSE_NULL);
 
@@ -101,47 +106,25 @@ static SE_ret_t MTK_9050_linux_init_device(struct SE_controller *controller)
         return kSE_SUCCESS;
     }
 
-    dir = opendir("/sys/class/pwm");
-    if (dir == NULL)
+    char dev_name[128] = "";
+    ret = SE_pwmchip_find(MTK_9050_PWM_COMPATIBLE, dev_name, sizeof(dev_name));
+    if (ret != kSE_SUCCESS)
     {
-        SE_set_error("Unable to open folder /sys/class/pwm");
+        SE_set_error("Not found any MTK_9050 in /sys/class/pwm");
         return ret;
     }
 
-    while ((entry = readdir(dir)) != NULL)
-    {
-        if (!strcmp(entry->d_name, ".") || !strcmp(entry->d_name, ".."))
-        {
-            continue;
-        }
-        SE_DEBUG("Operation on dir %s", entry->d_name);
-        if (mtk_9050_pwm_is_device(entry->d_name))
-        {
-            char dev_name[128] = "";
-            int num_byte = snprintf(dev_name, 128, "/sys/class/pwm/%s", entry->d_name);
-            data->pwm_dev_name = malloc(num_byte + 1);
-            if (data->pwm_dev_name == NULL)
-            {
-                SE_ERROR("Unable to allocate memory for dev path %s", dev_name);
-                SE_set_error("Unable to allocate memory for MTK_9050 dev name");
-                ret = kSE_NULL;
-                break;
-            }
-            strcpy(data->pwm_dev_name, dev_name);
-            SE_DEBUG("Found MTK_9050 at dev name %s", data->pwm_dev_name);
-            data->is_open = true;
-            ret = kSE_SUCCESS;
-            break;
-        }
-    }
-
-    if (ret == kSE_FAILED)
+    data->pwm_dev_name = malloc(strlen(dev_name) + 1);
+    if (data->pwm_dev_name == NULL)
     {
-        SE_set_error("Not found any MTK_9050 in /sys/class/pwm");
+        SE_ERROR("Unable to allocate memory for dev path %s", dev_name);
+        SE_set_error("Unable to allocate memory for MTK_9050 dev name");
+        return kSE_NULL;
     }
-
-    closedir(dir);
-    return ret;
+    strcpy(data->pwm_dev_name, dev_name);
+    SE_DEBUG("Found MTK_9050 at dev name %s", data->pwm_dev_name);
+    data->is_open = true;
+    return kSE_SUCCESS;
 }
 
 static void MTK_9050_linux_deinit_device(struct SE_controller *controller)
@@ -262,7 +245,10 @@ static SE_ret_t _MTK_9050_linux_set_duty(struct mtk_9050_linux_data *data, uint8
         return kSE_FAILED;
     }
 
-    return mtk_9050_pwm_set_duty(data->pwm_dev_name, data->pin_map[servo_id], duty_us);
+    SE_ret_t ret = mtk_9050_pwm_set_duty(data->pwm_dev_name, data->pin_map[servo_id], duty_us);
+    data->servo[servo_id].duty_us = duty_us;
+    data->servo[servo_id].has_duty = (ret == kSE_SUCCESS);
+    return ret;
 }
 
 static SE_ret_t MTK_9050_linux_set_duty(struct SE_controller *controller, uint8_t servo_id, uint32_t duty)
@@ -316,6 +302,105 @@ static SE_ret_t MTK_9050_linux_set_period(struct SE_controller *controller, uint
     return _MTK_9050_linux_set_period(data, servo_id, period_us);
 }
 
+static SE_ret_t _MTK_9050_linux_batch_validate(struct mtk_9050_linux_data *data, const uint8_t *servo_ids, size_t count)
+{
+    if (data->pwm_dev_name == NULL)
+    {
+        SE_set_error("The controller is not initialized");
+        return kSE_TRY_AGAIN;
+    }
+
+    if (count > MTK_9050_MAX_SERVO)
+    {
+        SE_set_error("Batch is larger than the controller");
+        return kSE_OUT_OF_RANGE;
+    }
+
+    for (size_t i = 0; i < count; i++)
+    {
+        if (servo_ids[i] >= data->info.max_servo || !data->servo[servo_ids[i]].enable)
+        {
+            SE_set_error("Servo in batch is out of range or not open");
+            return kSE_OUT_OF_RANGE;
+        }
+    }
+    return kSE_SUCCESS;
+}
+
+/* Channels that already hold the requested duty are left out of the write */
+static SE_ret_t MTK_9050_linux_set_duty_batch(struct SE_controller *controller, const uint8_t *servo_ids,
+                                              const uint32_t *duties_us, size_t count)
+{
+    CONTROLLER_VALIDATE(controller, kSE_NULL);
+
+    struct mtk_9050_linux_data *data = (struct mtk_9050_linux_data *)controller->controller_data;
+    SE_ret_t ret = _MTK_9050_linux_batch_validate(data, servo_ids, count);
+    if (ret != kSE_SUCCESS)
+    {
+        return ret;
+    }
+
+    uint8_t pins[MTK_9050_MAX_SERVO];
+    uint32_t duties[MTK_9050_MAX_SERVO];
+    uint8_t changed[MTK_9050_MAX_SERVO];
+    size_t write_count = 0;
+    for (size_t i = 0; i < count; i++)
+    {
+        struct mtk_9050_linux_servo_info *servo = &data->servo[servo_ids[i]];
+        if (servo->has_duty && servo->duty_us == duties_us[i])
+        {
+            continue;
+        }
+
+        pins[write_count] = data->pin_map[servo_ids[i]];
+        duties[write_count] = duties_us[i];
+        changed[write_count] = servo_ids[i];
+        write_count++;
+    }
+
+    if (write_count == 0)
+    {
+        return kSE_SUCCESS;
+    }
+
+    ret = mtk_9050_pwm_set_duty_batch(data->pwm_dev_name, pins, duties, write_count);
+    for (size_t i = 0; i < write_count; i++)
+    {
+        data->servo[changed[i]].duty_us = duties[i];
+        data->servo[changed[i]].has_duty = (ret == kSE_SUCCESS);
+    }
+    return ret;
+}
+
+static SE_ret_t MTK_9050_linux_set_period_batch(struct SE_controller *controller, const uint8_t *servo_ids,
+                                                const uint32_t *periods_us, size_t count)
+{
+    CONTROLLER_VALIDATE(controller, kSE_NULL);
+
+    struct mtk_9050_linux_data *data = (struct mtk_9050_linux_data *)controller->controller_data;
+    SE_ret_t ret = _MTK_9050_linux_batch_validate(data, servo_ids, count);
+    if (ret != kSE_SUCCESS)
+    {
+        return ret;
+    }
+
+    uint8_t pins[MTK_9050_MAX_SERVO];
+    for (size_t i = 0; i < count; i++)
+    {
+        pins[i] = data->pin_map[servo_ids[i]];
+    }
+
+    ret = mtk_9050_pwm_set_period_batch(data->pwm_dev_name, pins, periods_us, count);
+    if (ret == kSE_SUCCESS)
+    {
+        for (size_t i = 0; i < count; i++)
+        {
+            data->servo[servo_ids[i]].period_us = periods_us[i];
+        }
+    }
+    return ret;
+}
+
 static const struct SE_controller_info *MTK_9050_linux_get_info_ref(struct SE_controller *controller)
 {
     const struct SE_controller_info *ref_info = NULL;
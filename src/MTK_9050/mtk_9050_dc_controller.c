@@ -4,19 +4,21 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <fcntl.h>
-#include <dirent.h>
 #include <unistd.h>
 #include <malloc.h>
 #include <string.h>
 #include <errno.h>
-#include <sys/mman.h>
 
 #include "SE_errors.h"
 #include "SE_servo.h"
 #include "SE_logging.h"
+#include "SE_pwmchip.h"
 #include "SE_controller.h"
 
 #include "mtk_9050_pwm.h"
+#include "mtk_9050_encoder.h"
+#include "mtk_9050_encoder_sampler.h"
+#include "mtk_9050_dc_pid.h"
 
 #define MTK_9050_MAX_MOTOR 4
 
@@ -30,9 +32,21 @@
 #define DEFAULT_MTK_9050_UNITS_FOR_0_DEGREE 0
 #define DEFAULT_MTK_9050_UNITS_FOR_180_DEGREE 400 
 
-#define DEV_NAME "mstar,pwm"
 #define DEFAULT_MTK_9050_PERIOD_US (40000)
 #define PULSE_UNIT_US(period_us) ((float)(period_us * 100) / 400)
+#define DEFAULT_MTK_9050_COUNTS_FOR_180_DEGREE 1800
+#define DEFAULT_MTK_9050_SAMPLE_PERIOD_US 1000
+
+/* Tuned for the 10 ms update tick and the 40 ms period, kff matches a motor doing 360 deg/s at full duty */
+#define DEFAULT_MTK_9050_DC_GAINS                          \
+    {                                                      \
+        .kp = MTK_9050_DC_PID_GAIN(300),                   \
+        .ki = MTK_9050_DC_PID_GAIN(20),                    \
+        .kd = MTK_9050_DC_PID_GAIN(400),                   \
+        .kff = MTK_9050_DC_PID_GAIN(1111),                 \
+        .integral_limit = DEFAULT_MTK_9050_PERIOD_US / 5,  \
+        .output_limit = DEFAULT_MTK_9050_PERIOD_US,        \
+    }
 
 static SE_ret_t MTK_9050_dc_motor_init_device(struct SE_controller *controller);
 static void MTK_9050_dc_motor_deinit_device(struct SE_controller *controller);
@@ -57,36 +71,30 @@ struct mtk_9050_dc_motor_info
     uint32_t duty_us;
     int64_t last_counter;
     uint32_t pwm_resolution;
-    uint16_t delta_move;
+    struct mtk_9050_dc_pid pid;
+    /* Written by the output writer, read by the update tick: the setpoint is stored before
+     * has_setpoint is released, both through __atomic. The flags the two threads touch are
+     * whole bytes, out of the bitfield, so neither rewrites the other's bits. */
+    int32_t setpoint;
+    bool has_setpoint;
+    bool enable;
+    bool is_closed_loop;
+    int32_t position;
+    int32_t position_offset;
     uint8_t current_angle;
     uint8_t direction: 1;
-    uint8_t enable: 1;
     uint8_t is_open: 1;
-    uint8_t reverse: 5;
-};
-
-struct counter_value
-{
-    int64_t a_forward;
-    int64_t b_backward;
-    int64_t v_direction;
-};
-
-struct encoder_data
-{
-    struct counter_value channel_a;
-    struct counter_value channel_b;
-    struct counter_value channel_c;
-    struct counter_value channel_d;
-    struct counter_value channel_e;
-    struct counter_value channel_f;
+    uint8_t reverse: 6;
 };
 
 struct motor_capability
 {
     uint8_t motor_forward;
     uint8_t motor_backward;
+    uint8_t encoder_channel;
     bool has_feedback;
+    int32_t counts_for_180_degree;
+    struct mtk_9050_dc_pid_gains gains;
 };
 
 struct mtk_9050_dc_data
@@ -94,7 +102,8 @@ struct mtk_9050_dc_data
     struct SE_controller_info info;
     struct mtk_9050_dc_motor_info motor[MTK_9050_MAX_MOTOR];
     struct motor_capability motor_cap[MTK_9050_MAX_MOTOR];
-    int encoder_fd;
+    struct mtk_9050_encoder encoder;
+    struct mtk_9050_encoder_sampler sampler;
     bool is_open;
     char *pwm_dev_name;
 };
@@ -109,12 +118,19 @@ static struct mtk_9050_dc_data controller_data = {
     },
     .motor = {{0}},
     .motor_cap = {
-        {.motor_forward = 15, .motor_backward = 14, .has_feedback = true},
+        {
+            .motor_forward = 15,
+            .motor_backward = 14,
+            .encoder_channel = 0,
+            .has_feedback = true,
+            .counts_for_180_degree = DEFAULT_MTK_9050_COUNTS_FOR_180_DEGREE,
+            .gains = DEFAULT_MTK_9050_DC_GAINS,
+        },
         {.motor_forward = 0, .motor_backward = 0, .has_feedback = false},
         {.motor_forward = 0, .motor_backward = 0, .has_feedback = false},
         {.motor_forward = 0, .motor_backward = 0, .has_feedback = false},
     },
-    .encoder_fd = -1,
+    .encoder = {.fd = -1, .region = NULL},
     .is_open = false,
     .pwm_dev_name = NULL,
 };
@@ -136,27 +152,29 @@ static struct SE_controller mtk_9050_dc_controller = {
 
 static SE_ret_t _MTK_9050_dc_motor_encoder_map(struct SE_controller *controller)
 {
-    if (access("/dev/encoder", F_OK) == -1)
+    struct mtk_9050_dc_data *data = (struct mtk_9050_dc_data *)controller->controller_data;
+    if (mtk_9050_encoder_is_open(&data->encoder))
     {
-        SE_ERROR("Not found encoder, ignore");
-        return kSE_FAILED;
+        return kSE_SUCCESS;
     }
 
-    struct mtk_9050_dc_data *data = (struct mtk_9050_dc_data *)controller->controller_data;
-    data->encoder_fd = open("/dev/encoder", O_RDWR);
-    if (data->encoder_fd < 0)
+    SE_ret_t ret = mtk_9050_encoder_open(&data->encoder, MTK_9050_ENCODER_DEV);
+    if (ret != kSE_SUCCESS)
     {
-        SE_ERROR("Unable to open encoder");
-        return kSE_FAILED;
+        return ret;
     }
 
+    /* Without the sampler the update tick falls back to reading the mapped counters directly */
+    if (mtk_9050_encoder_sampler_start(&data->sampler, &data->encoder, DEFAULT_MTK_9050_SAMPLE_PERIOD_US,
+                                       MTK_9050_SAMPLER_DEFAULT_WINDOW) != kSE_SUCCESS)
+    {
+        SE_WARNING("Unable to start encoder sampler, read encoder on update");
+    }
     return kSE_SUCCESS;
 }
 
 static SE_ret_t MTK_9050_dc_motor_init_device(struct SE_controller *controller)
 {
-    DIR *dir = NULL;
-    struct dirent *entry = NULL;
     SE_ret_t ret = kSE_FAILED;
     CONTROLLER_VALIDATE(controller, kSE_NULL);
 
@@ -172,47 +190,25 @@ static SE_ret_t MTK_9050_dc_motor_init_device(struct SE_controller *controller)
         SE_WARNING("Unable to open encoder, ignore");
     }
 
-    dir = opendir("/sys/class/pwm");
-    if (dir == NULL)
+    char dev_name[128] = "";
+    ret = SE_pwmchip_find(MTK_9050_PWM_COMPATIBLE, dev_name, sizeof(dev_name));
+    if (ret != kSE_SUCCESS)
     {
-        SE_set_error("Unable to open folder /sys/class/pwm");
+        SE_set_error("Not found any MTK_9050 in /sys/class/pwm");
         return ret;
     }
 
-    while ((entry = readdir(dir)) != NULL)
-    {
-        if (!strcmp(entry->d_name, ".") || !strcmp(entry->d_name, ".."))
-        {
-            continue;
-        }
-        SE_DEBUG("Operation on dir %s", entry->d_name);
-        if (mtk_9050_pwm_is_device(entry->d_name))
-        {
-            char dev_name[128] = "";
-            int num_byte = snprintf(dev_name, 128, "/sys/class/pwm/%s", entry->d_name);
-            data->pwm_dev_name = malloc(num_byte + 1);
-            if (data->pwm_dev_name == NULL)
-            {
-                SE_ERROR("Unable to allocate memory for dev path %s", dev_name);
-                SE_set_error("Unable to allocate memory for MTK_9050 dev name");
-                ret = kSE_NULL;
-                break;
-            }
-            strcpy(data->pwm_dev_name, dev_name);
-            SE_DEBUG("Found MTK_9050 at dev name %s", data->pwm_dev_name);
-            data->is_open = true;
-            ret = kSE_SUCCESS;
-            break;
-        }
-    }
-
-    if (ret == kSE_FAILED)
+    data->pwm_dev_name = malloc(strlen(dev_name) + 1);
+    if (data->pwm_dev_name == NULL)
     {
-        SE_set_error("Not found any MTK_9050 in /sys/class/pwm");
+        SE_ERROR("Unable to allocate memory for dev path %s", dev_name);
+        SE_set_error("Unable to allocate memory for MTK_9050 dev name");
+        return kSE_NULL;
     }
-
-    closedir(dir);
-    return ret;
+    strcpy(data->pwm_dev_name, dev_name);
+    SE_DEBUG("Found MTK_9050 at dev name %s", data->pwm_dev_name);
+    data->is_open = true;
+    return kSE_SUCCESS;
 }
 
 static void MTK_9050_dc_motor_deinit_device(struct SE_controller *controller)
@@ -235,11 +231,8 @@ static void MTK_9050_dc_motor_deinit_device(struct SE_controller *controller)
 
     free(data->pwm_dev_name);
     data->pwm_dev_name = NULL;
-    if (data->encoder_fd > 0)
-    {
-        close(data->encoder_fd);
-        data->encoder_fd = -1;
-    }
+    mtk_9050_encoder_sampler_stop(&data->sampler);
+    mtk_9050_encoder_close(&data->encoder);
     data->is_open = false;
 }
 
@@ -304,13 +297,18 @@ static SE_ret_t _MTK_9050_dc_motor_open_motor(struct mtk_9050_dc_data *data, uin
         .enable = false,
         .pwm_resolution = PULSE_UNIT_US(DEFAULT_MTK_9050_PERIOD_US),
         .last_counter = 0,
-        .delta_move = 0,
+        .setpoint = 0,
+        .position = 0,
+        .position_offset = 0,
         .direction = eMOVE_DIRECT_CLOCKWISE,
         .current_angle = 0,
+        .has_setpoint = false,
+        .is_closed_loop = false,
     };
 
     data->motor[motor_id] = motor;
     data->motor[motor_id].enable = true;
+    mtk_9050_dc_pid_init(&data->motor[motor_id].pid, &data->motor_cap[motor_id].gains);
 
     ret = _MTK_9050_dc_motor_set_period(data, motor_id, DEFAULT_MTK_9050_PERIOD_US);
     if (ret != kSE_SUCCESS)
@@ -378,9 +376,22 @@ static SE_ret_t MTK_9050_dc_motor_close_motor(struct SE_controller *controller,
     return _MTK_9050_dc_motor_close_motor(data, motor_id);
 }
 
-static uint8_t _MTK_9050_dc_duty_to_angle(uint32_t duty_us)
+static uint32_t _MTK_9050_dc_duty_to_units(struct mtk_9050_dc_data *data, uint8_t motor_id, uint32_t duty_us)
 {
-    return 0;
+    return (uint64_t)duty_us * 100 / data->motor[motor_id].pwm_resolution;
+}
+
+static uint8_t _MTK_9050_dc_duty_to_angle(struct mtk_9050_dc_data *data, uint8_t motor_id, uint32_t duty_us)
+{
+    uint32_t units = _MTK_9050_dc_duty_to_units(data, motor_id, duty_us);
+    return (units - data->info.units_for_0_degree) * 180 / (data->info.units_for_180_degree - data->info.units_for_0_degree);
+}
+
+static int32_t _MTK_9050_dc_duty_to_counts(struct mtk_9050_dc_data *data, uint8_t motor_id, uint32_t duty_us)
+{
+    int64_t units = _MTK_9050_dc_duty_to_units(data, motor_id, duty_us);
+    return (units - data->info.units_for_0_degree) * data->motor_cap[motor_id].counts_for_180_degree /
+           (data->info.units_for_180_degree - data->info.units_for_0_degree);
 }
 
 static void _MTK_9050_on_direction_changed(struct mtk_9050_dc_data *data, uint8_t motor_id, enum move_direction new_direction)
@@ -413,7 +424,16 @@ static SE_ret_t _MTK_9050_dc_motor_set_duty(struct mtk_9050_dc_data *data, uint8
         return kSE_FAILED;
     }
 
-    uint8_t expect_angle = _MTK_9050_dc_duty_to_angle(duty_us);
+    if (data->motor_cap[motor_id].has_feedback && mtk_9050_encoder_is_open(&data->encoder))
+    {
+        /* Closed loop, the duty only carries the eased setpoint, the update tick drives the motor */
+        __atomic_store_n(&data->motor[motor_id].setpoint, _MTK_9050_dc_duty_to_counts(data, motor_id, duty_us),
+                         __ATOMIC_RELAXED);
+        __atomic_store_n(&data->motor[motor_id].has_setpoint, true, __ATOMIC_RELEASE);
+        return kSE_SUCCESS;
+    }
+
+    uint8_t expect_angle = _MTK_9050_dc_duty_to_angle(data, motor_id, duty_us);
     enum move_direction direction = eMOVE_DIRECT_CLOCKWISE;
     if (expect_angle < data->motor[motor_id].current_angle)
     {
@@ -425,9 +445,11 @@ static SE_ret_t _MTK_9050_dc_motor_set_duty(struct mtk_9050_dc_data *data, uint8
     if (direction != data->motor[motor_id].direction)
     {
         _MTK_9050_on_direction_changed(data, motor_id, direction);
+        data->motor[motor_id].direction = direction;
     }
 
     _MTK9050_direction_update_duty(data, motor_id, duty_us);
+    data->motor[motor_id].current_angle = expect_angle;
     return kSE_SUCCESS;
 }
 
@@ -519,40 +541,168 @@ static uint32_t MTK_9050_dc_motor_get_pulse_resolution(struct SE_controller *con
     return data->motor[motor_id].pwm_resolution;
 }
 
-static void _MTK_9050_servo_feedback_handle(struct mtk_9050_dc_data *data, SE_servo_t *servo)
+static bool _MTK_9050_servo_feedback_handle(struct mtk_9050_dc_data *data, SE_servo_t *servo)
 {
-    if (data->encoder_fd < 0)
+    if (!mtk_9050_encoder_is_open(&data->encoder))
     {
-        return;
+        return false;
+    }
+
+    struct mtk_9050_dc_motor_info *motor = &data->motor[servo->id];
+    uint8_t channel = data->motor_cap[servo->id].encoder_channel;
+    if (mtk_9050_encoder_sampler_is_running(&data->sampler))
+    {
+        struct mtk_9050_encoder_state state;
+        if (mtk_9050_encoder_sampler_get_state(&data->sampler, channel, &state) != kSE_SUCCESS)
+        {
+            return false;
+        }
+
+        SE_DEBUG("Encoder channel %d at %lld, %d counts/s", channel, (long long)state.position, state.velocity);
+        motor->last_counter = state.position;
+    }
+    else
+    {
+        struct encoder_data encoder_data;
+        if (mtk_9050_encoder_snapshot(&data->encoder, &encoder_data) != kSE_SUCCESS)
+        {
+            return false;
+        }
+
+        motor->last_counter = mtk_9050_encoder_counts(mtk_9050_encoder_channel(&encoder_data, channel));
+        SE_DEBUG("Encoder channel %d at %lld", channel, (long long)motor->last_counter);
+    }
+
+    motor->position = (int32_t)motor->last_counter + motor->position_offset;
+    return true;
+}
+
+static void _MTK_9050_dc_motor_drive(struct mtk_9050_dc_data *data, uint8_t motor_id, int32_t output)
+{
+    struct mtk_9050_dc_motor_info *motor = &data->motor[motor_id];
+    enum move_direction direction = (output >= 0) ? eMOVE_DIRECT_CLOCKWISE : eMOVE_DIRECT_COUNT_CLOCKWISE;
+    uint32_t duty_us = (output >= 0) ? output : -output;
+    if (direction != motor->direction)
+    {
+        _MTK_9050_on_direction_changed(data, motor_id, direction);
+        motor->direction = direction;
+        motor->duty_us = 0;
     }
 
-    char *address = mmap(NULL, 4096, PROT_READ | PROT_WRITE, MAP_SHARED, data->encoder_fd, 0);
-    if (address == MAP_FAILED)
+    if (duty_us != motor->duty_us)
+    {
+        _MTK9050_direction_update_duty(data, motor_id, duty_us);
+        motor->duty_us = duty_us;
+    }
+}
+
+static void _MTK_9050_dc_motor_closed_loop(struct mtk_9050_dc_data *data, uint8_t motor_id)
+{
+    struct mtk_9050_dc_motor_info *motor = &data->motor[motor_id];
+    if (!__atomic_load_n(&motor->has_setpoint, __ATOMIC_ACQUIRE))
     {
-        SE_WARNING("mmap operation failed");
         return;
     }
 
-    struct encoder_data *encoder_data = (struct encoder_data *)address;
-    SE_INFO("Encoder data is: %lld, %p\n", encoder_data->channel_a.a_forward, address);
-    uint8_t delta = (encoder_data->channel_a.a_forward - data->motor[servo->id].last_counter);
-    data->motor[servo->id].delta_move += delta;
-    SE_INFO("Delta unit is : %d\n", data->motor[servo->id].delta_move);
-    data->motor[servo->id].last_counter = encoder_data->channel_a.a_forward;
-    munmap(address, 4096);
+    int32_t setpoint = __atomic_load_n(&motor->setpoint, __ATOMIC_RELAXED);
+    if (!motor->is_closed_loop)
+    {
+        /* The motor is taken to stand at the first commanded position when the loop engages */
+        motor->position_offset = setpoint - motor->position;
+        motor->position = setpoint;
+        mtk_9050_dc_pid_reset(&motor->pid);
+        motor->is_closed_loop = true;
+    }
+
+    int32_t output = mtk_9050_dc_pid_update(&motor->pid, setpoint, motor->position);
+    SE_DEBUG("Motor %d setpoint %d position %d output %d", motor_id, setpoint, motor->position, output);
+    _MTK_9050_dc_motor_drive(data, motor_id, output);
 }
 
 static void _MTK_9050_servo_update(SE_servo_t *servo)
 {
     struct mtk_9050_dc_data *data = (struct mtk_9050_dc_data *)servo->controller->controller_data;
-    if (data->motor_cap[servo->id].has_feedback)
+    if (data->motor_cap[servo->id].has_feedback && _MTK_9050_servo_feedback_handle(data, servo))
+    {
+        _MTK_9050_dc_motor_closed_loop(data, servo->id);
+    }
+}
+
+SE_ret_t mtk_9050_dc_motor_set_feedback(struct SE_controller *controller, uint8_t motor_id,
+                                        int32_t counts_for_180_degree, const struct mtk_9050_dc_pid_gains *gains)
+{
+    CONTROLLER_VALIDATE(controller, kSE_NULL);
+
+    struct mtk_9050_dc_data *data = (struct mtk_9050_dc_data *)controller->controller_data;
+    if (motor_id >= data->info.max_servo)
+    {
+        SE_set_error("Motor id is out of range");
+        return kSE_OUT_OF_RANGE;
+    }
+
+    if (gains == NULL || counts_for_180_degree == 0)
+    {
+        SE_set_error("Feedback gains are not valid");
+        return kSE_NULL;
+    }
+
+    data->motor_cap[motor_id].counts_for_180_degree = counts_for_180_degree;
+    data->motor_cap[motor_id].gains = *gains;
+    mtk_9050_dc_pid_init(&data->motor[motor_id].pid, gains);
+    data->motor[motor_id].is_closed_loop = false;
+    return kSE_SUCCESS;
+}
+
+SE_ret_t mtk_9050_dc_motor_set_encoder_channel(struct SE_controller *controller, uint8_t motor_id, uint8_t channel)
+{
+    CONTROLLER_VALIDATE(controller, kSE_NULL);
+
+    struct mtk_9050_dc_data *data = (struct mtk_9050_dc_data *)controller->controller_data;
+    if (motor_id >= data->info.max_servo || channel >= MTK_9050_ENCODER_CHANNELS)
+    {
+        SE_set_error("Motor id or encoder channel is out of range");
+        return kSE_OUT_OF_RANGE;
+    }
+
+    data->motor_cap[motor_id].encoder_channel = channel;
+    data->motor[motor_id].is_closed_loop = false;
+    return kSE_SUCCESS;
+}
+
+SE_ret_t mtk_9050_dc_motor_get_motion(struct SE_controller *controller, uint8_t motor_id,
+                                      struct mtk_9050_encoder_state *state)
+{
+    CONTROLLER_VALIDATE(controller, kSE_NULL);
+
+    struct mtk_9050_dc_data *data = (struct mtk_9050_dc_data *)controller->controller_data;
+    if (motor_id >= data->info.max_servo)
+    {
+        SE_set_error("Motor id is out of range");
+        return kSE_OUT_OF_RANGE;
+    }
+
+    if (!mtk_9050_encoder_sampler_is_running(&data->sampler))
     {
-        _MTK_9050_servo_feedback_handle(data, servo);
+        SE_set_error("Encoder sampler is not running");
+        return kSE_FAILED;
     }
+
+    SE_ret_t ret = mtk_9050_encoder_sampler_get_state(&data->sampler, data->motor_cap[motor_id].encoder_channel, state);
+    if (ret == kSE_SUCCESS)
+    {
+        state->position += data->motor[motor_id].position_offset;
+    }
+    return ret;
 }
 
 static SE_ret_t MTK_9050_dc_motor_servo_callback_register(void *servo)
 {
-    SE_ret_t ret = SE_servo_on_update((SE_servo_t *)servo, _MTK_9050_servo_update);
+    /* Duties here are PID setpoints tracked every tick, not pulses latched once per period */
+    SE_ret_t ret = SE_servo_set_decimation((SE_servo_t *)servo, false);
+    if (ret != kSE_SUCCESS)
+    {
+        return ret;
+    }
+    ret = SE_servo_on_update((SE_servo_t *)servo, _MTK_9050_servo_update);
     return ret;
 }
\ No newline at end of file
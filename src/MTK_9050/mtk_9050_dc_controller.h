@@ -1,4 +1,13 @@
 #ifndef MTK_9050_LINUX_DC_CONTROLLER_H
 #define MTK_9050_LINUX_DC_CONTROLLER_H
+#include "SE_controller.h"
+#include "mtk_9050_dc_pid.h"
+#include "mtk_9050_encoder_sampler.h"
+
 struct SE_controller *mtk_9050_dc_motor_get_controller();
+SE_ret_t mtk_9050_dc_motor_set_feedback(struct SE_controller *controller, uint8_t motor_id,
+                                        int32_t counts_for_180_degree, const struct mtk_9050_dc_pid_gains *gains);
+SE_ret_t mtk_9050_dc_motor_set_encoder_channel(struct SE_controller *controller, uint8_t motor_id, uint8_t channel);
+SE_ret_t mtk_9050_dc_motor_get_motion(struct SE_controller *controller, uint8_t motor_id,
+                                      struct mtk_9050_encoder_state *state);
 #endif /*MTK_9050_LINUX_DC_CONTROLLER_H*/
\ No newline at end of file
@@ -0,0 +1,62 @@
+#include "mtk_9050_dc_pid.h"
+
+void mtk_9050_dc_pid_init(struct mtk_9050_dc_pid *pid, const struct mtk_9050_dc_pid_gains *gains)
+{
+    pid->gains = *gains;
+    mtk_9050_dc_pid_reset(pid);
+}
+
+void mtk_9050_dc_pid_reset(struct mtk_9050_dc_pid *pid)
+{
+    pid->integral = 0;
+    pid->last_setpoint = 0;
+    pid->last_measured = 0;
+    pid->is_primed = false;
+}
+
+static inline int64_t _mtk_9050_dc_pid_clamp(int64_t value, int64_t limit)
+{
+    if (value > limit)
+    {
+        return limit;
+    }
+
+    if (value < -limit)
+    {
+        return -limit;
+    }
+    return value;
+}
+
+int32_t mtk_9050_dc_pid_update(struct mtk_9050_dc_pid *pid, int32_t setpoint, int32_t measured)
+{
+    const struct mtk_9050_dc_pid_gains *gains = &pid->gains;
+    if (!pid->is_primed)
+    {
+        pid->last_setpoint = setpoint;
+        pid->last_measured = measured;
+        pid->is_primed = true;
+    }
+
+    int32_t error = setpoint - measured;
+    int64_t proportional = (int64_t)gains->kp * error;
+    /* Derivative on measurement, a setpoint step does not kick the output */
+    int64_t derivative = -(int64_t)gains->kd * (measured - pid->last_measured);
+    int64_t feedforward = (int64_t)gains->kff * (setpoint - pid->last_setpoint);
+    int64_t integral = pid->integral + (int64_t)gains->ki * error;
+    integral = _mtk_9050_dc_pid_clamp(integral, (int64_t)gains->integral_limit << MTK_9050_DC_PID_SHIFT);
+
+    int64_t limit = (int64_t)gains->output_limit << MTK_9050_DC_PID_SHIFT;
+    int64_t output = proportional + integral + derivative + feedforward;
+    if ((output > limit && error > 0) || (output < -limit && error < 0))
+    {
+        /* Anti-windup: stop integrating while the output is saturated in the same direction */
+        integral = pid->integral;
+        output = proportional + integral + derivative + feedforward;
+    }
+
+    pid->integral = integral;
+    pid->last_setpoint = setpoint;
+    pid->last_measured = measured;
+    return (int32_t)(_mtk_9050_dc_pid_clamp(output, limit) >> MTK_9050_DC_PID_SHIFT);
+}
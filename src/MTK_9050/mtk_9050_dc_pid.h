@@ -0,0 +1,34 @@
+#ifndef MTK_9050_DC_PID_H
+#define MTK_9050_DC_PID_H
+#include <stdbool.h>
+#include <stdint.h>
+
+#define MTK_9050_DC_PID_SHIFT 16
+#define MTK_9050_DC_PID_GAIN(value) ((int32_t)((value) * (1 << MTK_9050_DC_PID_SHIFT)))
+
+/* Gains are Q16 duty per encoder count, applied once per update tick:
+ * kp on the position error, ki on the error accumulated per tick, kd on the measured
+ * count change per tick and kff on the setpoint change per tick. */
+struct mtk_9050_dc_pid_gains
+{
+    int32_t kp;
+    int32_t ki;
+    int32_t kd;
+    int32_t kff;
+    int32_t integral_limit;
+    int32_t output_limit;
+};
+
+struct mtk_9050_dc_pid
+{
+    struct mtk_9050_dc_pid_gains gains;
+    int64_t integral;
+    int32_t last_setpoint;
+    int32_t last_measured;
+    bool is_primed;
+};
+
+void mtk_9050_dc_pid_init(struct mtk_9050_dc_pid *pid, const struct mtk_9050_dc_pid_gains *gains);
+void mtk_9050_dc_pid_reset(struct mtk_9050_dc_pid *pid);
+int32_t mtk_9050_dc_pid_update(struct mtk_9050_dc_pid *pid, int32_t setpoint, int32_t measured);
+#endif /*MTK_9050_DC_PID_H*/
@@ -0,0 +1,48 @@
+#include "mtk_9050_dc_sim.h"
+
+#include <string.h>
+
+#define DC_SIM_SHIFT 16
+
+void mtk_9050_dc_sim_init(struct mtk_9050_dc_sim *sim, const struct mtk_9050_dc_sim_params *params)
+{
+    memset(sim, 0, sizeof(struct mtk_9050_dc_sim));
+    sim->params = *params;
+}
+
+void mtk_9050_dc_sim_step(struct mtk_9050_dc_sim *sim, int32_t duty, uint32_t elapse_ms)
+{
+    const struct mtk_9050_dc_sim_params *params = &sim->params;
+    int64_t target_velocity = 0;
+    if (duty >= params->dead_duty || duty <= -params->dead_duty)
+    {
+        target_velocity = ((int64_t)duty * params->max_speed << DC_SIM_SHIFT) / (int64_t)params->period;
+    }
+
+    /* Implicit Euler of the first order lag, stable for any tick length */
+    sim->velocity += (target_velocity - sim->velocity) * elapse_ms / (params->time_constant_ms + elapse_ms);
+
+    int32_t last_count = mtk_9050_dc_sim_position(sim);
+    sim->position += sim->velocity * elapse_ms / 1000;
+    int32_t delta = mtk_9050_dc_sim_position(sim) - last_count;
+    if (delta > 0)
+    {
+        sim->counter.a_forward += delta;
+        sim->counter.v_direction = 0;
+    }
+    else if (delta < 0)
+    {
+        sim->counter.b_backward -= delta;
+        sim->counter.v_direction = 1;
+    }
+}
+
+int32_t mtk_9050_dc_sim_position(const struct mtk_9050_dc_sim *sim)
+{
+    return (int32_t)(sim->position >> DC_SIM_SHIFT);
+}
+
+void mtk_9050_dc_sim_write_encoder(const struct mtk_9050_dc_sim *sim, struct counter_value *counter)
+{
+    *counter = sim->counter;
+}
@@ -0,0 +1,29 @@
+#ifndef MTK_9050_DC_SIM_H
+#define MTK_9050_DC_SIM_H
+#include <stdint.h>
+
+#include "mtk_9050_encoder.h"
+
+/* Host model of a DC motor with encoder: first order velocity response to the signed
+ * duty, with a dead band below which static friction holds the shaft. */
+struct mtk_9050_dc_sim_params
+{
+    uint32_t period;
+    int32_t max_speed;
+    int32_t time_constant_ms;
+    int32_t dead_duty;
+};
+
+struct mtk_9050_dc_sim
+{
+    struct mtk_9050_dc_sim_params params;
+    int64_t velocity;
+    int64_t position;
+    struct counter_value counter;
+};
+
+void mtk_9050_dc_sim_init(struct mtk_9050_dc_sim *sim, const struct mtk_9050_dc_sim_params *params);
+void mtk_9050_dc_sim_step(struct mtk_9050_dc_sim *sim, int32_t duty, uint32_t elapse_ms);
+int32_t mtk_9050_dc_sim_position(const struct mtk_9050_dc_sim *sim);
+void mtk_9050_dc_sim_write_encoder(const struct mtk_9050_dc_sim *sim, struct counter_value *counter);
+#endif /*MTK_9050_DC_SIM_H*/
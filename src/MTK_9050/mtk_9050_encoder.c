@@ -0,0 +1,141 @@
+#include "mtk_9050_encoder.h"
+
+#include <fcntl.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "SE_errors.h"
+#include "SE_logging.h"
+
+#define ENCODER_SNAPSHOT_RETRY 8
+
+SE_ret_t mtk_9050_encoder_open(struct mtk_9050_encoder *encoder, const char *dev_path)
+{
+    encoder->fd = -1;
+    encoder->region = NULL;
+    if (access(dev_path, F_OK) == -1)
+    {
+        SE_ERROR("Not found encoder at %s, ignore", dev_path);
+        return kSE_FAILED;
+    }
+
+    int fd = open(dev_path, O_RDWR);
+    if (fd < 0)
+    {
+        SE_ERROR("Unable to open encoder");
+        return kSE_FAILED;
+    }
+
+    struct stat dev_stat;
+    if (fstat(fd, &dev_stat) == 0 && S_ISREG(dev_stat.st_mode) && dev_stat.st_size < MTK_9050_ENCODER_MAP_SIZE)
+    {
+        SE_ERROR("Encoder file %s is smaller than the encoder region", dev_path);
+        close(fd);
+        return kSE_FAILED;
+    }
+
+    void *address = mmap(NULL, MTK_9050_ENCODER_MAP_SIZE, PROT_READ, MAP_SHARED, fd, 0);
+    if (address == MAP_FAILED)
+    {
+        SE_ERROR("mmap operation failed");
+        close(fd);
+        return kSE_FAILED;
+    }
+
+    encoder->fd = fd;
+    encoder->region = (const volatile struct encoder_region *)address;
+    return kSE_SUCCESS;
+}
+
+void mtk_9050_encoder_close(struct mtk_9050_encoder *encoder)
+{
+    if (encoder->region != NULL)
+    {
+        munmap((void *)encoder->region, MTK_9050_ENCODER_MAP_SIZE);
+        encoder->region = NULL;
+    }
+
+    if (encoder->fd >= 0)
+    {
+        close(encoder->fd);
+        encoder->fd = -1;
+    }
+}
+
+bool mtk_9050_encoder_is_open(const struct mtk_9050_encoder *encoder)
+{
+    return encoder->region != NULL;
+}
+
+static void _mtk_9050_encoder_copy(const volatile struct encoder_data *src, struct encoder_data *dst)
+{
+    const volatile int64_t *from = (const volatile int64_t *)src;
+    int64_t *to = (int64_t *)dst;
+    for (size_t i = 0; i < sizeof(struct encoder_data) / sizeof(int64_t); i++)
+    {
+        to[i] = from[i];
+    }
+}
+
+/* Seqlock read: the copy is accepted when the sequence was even and unchanged around it.
+ * The region is also copied twice and both copies must agree, this covers drivers which
+ * do not maintain the sequence word. */
+SE_ret_t mtk_9050_encoder_snapshot(const struct mtk_9050_encoder *encoder, struct encoder_data *snapshot)
+{
+    if (encoder->region == NULL)
+    {
+        SE_set_error("Encoder is not mapped");
+        return kSE_FAILED;
+    }
+
+    struct encoder_data verify;
+    for (int i = 0; i < ENCODER_SNAPSHOT_RETRY; i++)
+    {
+        uint32_t sequence = encoder->region->sequence;
+        if (sequence & 1)
+        {
+            continue;
+        }
+
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+        _mtk_9050_encoder_copy(&encoder->region->data, snapshot);
+        _mtk_9050_encoder_copy(&encoder->region->data, &verify);
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+        if (encoder->region->sequence == sequence && !memcmp(snapshot, &verify, sizeof(struct encoder_data)))
+        {
+            return kSE_SUCCESS;
+        }
+    }
+
+    SE_WARNING("Encoder keeps changing, snapshot is not consistent");
+    return kSE_TRY_AGAIN;
+}
+
+const struct counter_value *mtk_9050_encoder_channel(const struct encoder_data *data, uint8_t channel)
+{
+    switch (channel)
+    {
+    case 0:
+        return &data->channel_a;
+    case 1:
+        return &data->channel_b;
+    case 2:
+        return &data->channel_c;
+    case 3:
+        return &data->channel_d;
+    case 4:
+        return &data->channel_e;
+    case 5:
+        return &data->channel_f;
+    default:
+        return NULL;
+    }
+}
+
+/* Forward pulses minus backward pulses of one channel */
+int64_t mtk_9050_encoder_counts(const struct counter_value *counter)
+{
+    return counter->a_forward - counter->b_backward;
+}
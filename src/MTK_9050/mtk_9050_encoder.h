@@ -0,0 +1,49 @@
+#ifndef MTK_9050_ENCODER_H
+#define MTK_9050_ENCODER_H
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "SE_enum.h"
+
+#define MTK_9050_ENCODER_DEV "/dev/encoder"
+#define MTK_9050_ENCODER_MAP_SIZE 4096
+#define MTK_9050_ENCODER_CHANNELS 6
+
+struct counter_value
+{
+    int64_t a_forward;
+    int64_t b_backward;
+    int64_t v_direction;
+};
+
+struct encoder_data
+{
+    struct counter_value channel_a;
+    struct counter_value channel_b;
+    struct counter_value channel_c;
+    struct counter_value channel_d;
+    struct counter_value channel_e;
+    struct counter_value channel_f;
+};
+
+/* A driver that supports it bumps sequence to odd before updating the counters and
+ * back to even after, like a kernel seqlock. Older drivers leave it at 0. */
+struct encoder_region
+{
+    struct encoder_data data;
+    uint32_t sequence;
+};
+
+struct mtk_9050_encoder
+{
+    int fd;
+    const volatile struct encoder_region *region;
+};
+
+SE_ret_t mtk_9050_encoder_open(struct mtk_9050_encoder *encoder, const char *dev_path);
+void mtk_9050_encoder_close(struct mtk_9050_encoder *encoder);
+bool mtk_9050_encoder_is_open(const struct mtk_9050_encoder *encoder);
+SE_ret_t mtk_9050_encoder_snapshot(const struct mtk_9050_encoder *encoder, struct encoder_data *snapshot);
+const struct counter_value *mtk_9050_encoder_channel(const struct encoder_data *data, uint8_t channel);
+int64_t mtk_9050_encoder_counts(const struct counter_value *counter);
+#endif /*MTK_9050_ENCODER_H*/
@@ -0,0 +1,202 @@
+#include "mtk_9050_encoder_sampler.h"
+
+#include <errno.h>
+#include <string.h>
+#include <time.h>
+
+#include "SE_errors.h"
+#include "SE_logging.h"
+
+#define SAMPLER_READ_RETRY 4
+#define SAMPLER_MAX_WINDOW ((MTK_9050_SAMPLER_HISTORY - 1) / 2)
+
+static uint64_t _mtk_9050_sampler_now_us(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+static void _mtk_9050_sampler_advance(struct timespec *deadline, uint32_t period_us)
+{
+    deadline->tv_nsec += (long)period_us * 1000;
+    while (deadline->tv_nsec >= 1000000000)
+    {
+        deadline->tv_nsec -= 1000000000;
+        deadline->tv_sec++;
+    }
+}
+
+static void *_mtk_9050_sampler_thread(void *arg)
+{
+    struct mtk_9050_encoder_sampler *sampler = (struct mtk_9050_encoder_sampler *)arg;
+    struct timespec deadline;
+    clock_gettime(CLOCK_MONOTONIC, &deadline);
+    while (atomic_load_explicit(&sampler->running, memory_order_acquire))
+    {
+        struct encoder_data data;
+        uint64_t timestamp_us = _mtk_9050_sampler_now_us();
+        if (mtk_9050_encoder_snapshot(sampler->encoder, &data) == kSE_SUCCESS)
+        {
+            mtk_9050_encoder_sampler_push(sampler, timestamp_us, &data);
+        }
+
+        /* Absolute deadlines keep the rate fixed, an overrun restarts the schedule instead of bursting */
+        _mtk_9050_sampler_advance(&deadline, sampler->period_us);
+        struct timespec now;
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        if (now.tv_sec > deadline.tv_sec || (now.tv_sec == deadline.tv_sec && now.tv_nsec > deadline.tv_nsec))
+        {
+            deadline = now;
+            continue;
+        }
+
+        while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &deadline, NULL) == EINTR)
+        {
+        }
+    }
+    return NULL;
+}
+
+SE_ret_t mtk_9050_encoder_sampler_start(struct mtk_9050_encoder_sampler *sampler, const struct mtk_9050_encoder *encoder,
+                                        uint32_t period_us, uint32_t window)
+{
+    if (sampler == NULL || encoder == NULL)
+    {
+        SE_set_error("Sampler or encoder is null");
+        return kSE_NULL;
+    }
+
+    if (!mtk_9050_encoder_is_open(encoder))
+    {
+        SE_set_error("Encoder is not mapped");
+        return kSE_FAILED;
+    }
+
+    if (period_us == 0 || window == 0 || window > SAMPLER_MAX_WINDOW)
+    {
+        SE_set_error("Sampler period or window is out of range");
+        return kSE_OUT_OF_RANGE;
+    }
+
+    memset(sampler->ring, 0, sizeof(sampler->ring));
+    sampler->encoder = encoder;
+    sampler->period_us = period_us;
+    sampler->window = window;
+    atomic_store(&sampler->running, true);
+    if (pthread_create(&sampler->thread, NULL, _mtk_9050_sampler_thread, sampler) != 0)
+    {
+        atomic_store(&sampler->running, false);
+        SE_set_error("Unable to start encoder sampler thread");
+        return kSE_FAILED;
+    }
+    return kSE_SUCCESS;
+}
+
+void mtk_9050_encoder_sampler_stop(struct mtk_9050_encoder_sampler *sampler)
+{
+    if (sampler == NULL || !atomic_load(&sampler->running))
+    {
+        return;
+    }
+
+    atomic_store(&sampler->running, false);
+    pthread_join(sampler->thread, NULL);
+}
+
+bool mtk_9050_encoder_sampler_is_running(const struct mtk_9050_encoder_sampler *sampler)
+{
+    return atomic_load(&((struct mtk_9050_encoder_sampler *)sampler)->running);
+}
+
+/* Only the sampler thread pushes. The fence orders the already published head before the slot
+ * is rewritten, so a reader that sees new slot data also sees that its index was recycled. */
+void mtk_9050_encoder_sampler_push(struct mtk_9050_encoder_sampler *sampler, uint64_t timestamp_us, const struct encoder_data *data)
+{
+    for (uint8_t channel = 0; channel < MTK_9050_ENCODER_CHANNELS; channel++)
+    {
+        struct mtk_9050_encoder_ring *ring = &sampler->ring[channel];
+        unsigned int head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+        struct mtk_9050_encoder_sample *slot = &ring->sample[head % MTK_9050_SAMPLER_HISTORY];
+        atomic_thread_fence(memory_order_release);
+        __atomic_store_n(&slot->timestamp_us, timestamp_us, __ATOMIC_RELAXED);
+        __atomic_store_n(&slot->counts, mtk_9050_encoder_counts(mtk_9050_encoder_channel(data, channel)), __ATOMIC_RELAXED);
+        atomic_store_explicit(&ring->head, head + 1, memory_order_release);
+    }
+}
+
+static void _mtk_9050_sampler_load(const struct mtk_9050_encoder_ring *ring, unsigned int index,
+                                   struct mtk_9050_encoder_sample *sample)
+{
+    const struct mtk_9050_encoder_sample *slot = &ring->sample[index % MTK_9050_SAMPLER_HISTORY];
+    sample->timestamp_us = __atomic_load_n(&slot->timestamp_us, __ATOMIC_RELAXED);
+    sample->counts = __atomic_load_n(&slot->counts, __ATOMIC_RELAXED);
+}
+
+/* Counts per second between two samples */
+static int64_t _mtk_9050_sampler_velocity(const struct mtk_9050_encoder_sample *newer,
+                                          const struct mtk_9050_encoder_sample *older)
+{
+    int64_t elapse_us = (int64_t)(newer->timestamp_us - older->timestamp_us);
+    if (elapse_us <= 0)
+    {
+        return 0;
+    }
+    return (newer->counts - older->counts) * 1000000 / elapse_us;
+}
+
+/* Velocity is the slope over the last window of samples and acceleration the change between the
+ * last two windows. Averaging over a window filters the count quantization at a fixed cost of
+ * three ring reads, whatever the history length. */
+SE_ret_t mtk_9050_encoder_sampler_get_state(struct mtk_9050_encoder_sampler *sampler, uint8_t channel,
+                                            struct mtk_9050_encoder_state *state)
+{
+    if (sampler == NULL || state == NULL)
+    {
+        SE_set_error("Sampler or state is null");
+        return kSE_NULL;
+    }
+
+    if (channel >= MTK_9050_ENCODER_CHANNELS)
+    {
+        SE_set_error("Encoder channel is out of range");
+        return kSE_OUT_OF_RANGE;
+    }
+
+    struct mtk_9050_encoder_ring *ring = &sampler->ring[channel];
+    for (int i = 0; i < SAMPLER_READ_RETRY; i++)
+    {
+        unsigned int head = atomic_load_explicit(&ring->head, memory_order_acquire);
+        if (head == 0)
+        {
+            SE_set_error("Encoder sampler has no sample yet");
+            return kSE_TRY_AGAIN;
+        }
+
+        unsigned int newest = head - 1;
+        unsigned int span = (newest / 2 < sampler->window) ? newest / 2 : sampler->window;
+        unsigned int oldest = newest - 2 * span;
+        struct mtk_9050_encoder_sample sample[3];
+        _mtk_9050_sampler_load(ring, newest, &sample[0]);
+        _mtk_9050_sampler_load(ring, newest - span, &sample[1]);
+        _mtk_9050_sampler_load(ring, oldest, &sample[2]);
+        atomic_thread_fence(memory_order_acquire);
+        if (atomic_load_explicit(&ring->head, memory_order_relaxed) - oldest >= MTK_9050_SAMPLER_HISTORY)
+        {
+            /* The sampler lapped this reader while it was copying */
+            continue;
+        }
+
+        int64_t velocity = _mtk_9050_sampler_velocity(&sample[0], &sample[1]);
+        int64_t last_velocity = _mtk_9050_sampler_velocity(&sample[1], &sample[2]);
+        int64_t centers_us = (int64_t)(sample[0].timestamp_us - sample[2].timestamp_us) / 2;
+        state->timestamp_us = sample[0].timestamp_us;
+        state->position = sample[0].counts;
+        state->velocity = (int32_t)velocity;
+        state->acceleration = (centers_us > 0) ? (int32_t)((velocity - last_velocity) * 1000000 / centers_us) : 0;
+        return kSE_SUCCESS;
+    }
+
+    SE_set_error("Encoder sampler overran the reader");
+    return kSE_TRY_AGAIN;
+}
@@ -0,0 +1,52 @@
+#ifndef MTK_9050_ENCODER_SAMPLER_H
+#define MTK_9050_ENCODER_SAMPLER_H
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "SE_enum.h"
+#include "mtk_9050_encoder.h"
+
+#define MTK_9050_SAMPLER_HISTORY 64
+#define MTK_9050_SAMPLER_DEFAULT_WINDOW 8
+
+struct mtk_9050_encoder_sample
+{
+    uint64_t timestamp_us;
+    int64_t counts;
+};
+
+/* Single producer ring, the sampler thread writes and publishes head, readers never block it */
+struct mtk_9050_encoder_ring
+{
+    struct mtk_9050_encoder_sample sample[MTK_9050_SAMPLER_HISTORY];
+    atomic_uint head;
+};
+
+struct mtk_9050_encoder_state
+{
+    uint64_t timestamp_us;
+    int64_t position;
+    int32_t velocity;
+    int32_t acceleration;
+};
+
+struct mtk_9050_encoder_sampler
+{
+    const struct mtk_9050_encoder *encoder;
+    struct mtk_9050_encoder_ring ring[MTK_9050_ENCODER_CHANNELS];
+    uint32_t period_us;
+    uint32_t window;
+    pthread_t thread;
+    atomic_bool running;
+};
+
+SE_ret_t mtk_9050_encoder_sampler_start(struct mtk_9050_encoder_sampler *sampler, const struct mtk_9050_encoder *encoder,
+                                        uint32_t period_us, uint32_t window);
+void mtk_9050_encoder_sampler_stop(struct mtk_9050_encoder_sampler *sampler);
+bool mtk_9050_encoder_sampler_is_running(const struct mtk_9050_encoder_sampler *sampler);
+void mtk_9050_encoder_sampler_push(struct mtk_9050_encoder_sampler *sampler, uint64_t timestamp_us, const struct encoder_data *data);
+SE_ret_t mtk_9050_encoder_sampler_get_state(struct mtk_9050_encoder_sampler *sampler, uint8_t channel,
+                                            struct mtk_9050_encoder_state *state);
+#endif /*MTK_9050_ENCODER_SAMPLER_H*/
@@ -1,4 +1,5 @@
 #include "mtk_9050_pwm.h"
+#include <fcntl.h>
 #include <unistd.h>
 #include <stdio.h>
 #include <errno.h>
@@ -8,47 +9,6 @@
 #include "SE_logging.h"
 #include "SE_errors.h"
 
-#define DEV_NAME "mstar,pwm"
-
-bool mtk_9050_pwm_is_device(const char *dev_folder)
-{
-    char file_name[128] = {'\0'};
-    bool ret = false;
-    sprintf(file_name, "/sys/class/pwm/%s/device/of_node/compatible", dev_folder);
-    if (access(file_name, F_OK) == -1)
-    {
-        SE_DEBUG("Unable to open device name %s, ignore", file_name);
-        return ret;
-    }
-    FILE *file = fopen(file_name, "r");
-    fseek(file, 0, SEEK_END);
-    long file_size = ftell(file);
-    fseek(file, 0, SEEK_SET);
-    char *device_name = malloc(file_size + 1);
-    if (device_name == NULL)
-    {
-        fclose(file);
-        return ret;
-    }
-    fread(device_name, sizeof(char), file_size, file);
-    for (int i = 0; i < file_size; i++)
-    {
-        if (device_name[i] == '\n' || device_name[i] == '\r')
-        {
-            device_name[i] = 0;
-        }
-    }
-
-    fclose(file);
-    if (!strcmp(device_name, DEV_NAME))
-    {
-        SE_DEBUG("Found %s", device_name);
-        ret = true;
-    }
-    free(device_name);
-    return ret;
-}
-
 SE_ret_t mtk_9050_pwm_export_pin(const char *dev_folder, uint8_t pin)
 {
     char servo_name[256] = {'\0'};
@@ -198,4 +158,56 @@ SE_ret_t mtk_9050_pwm_set_period(const char *dev_name, uint8_t pin, uint32_t per
     fclose(pwm_period_fd);
     SE_DEBUG("Period for servo %d set to %u", pin, period_us);
     return kSE_SUCCESS;
-}
\ No newline at end of file
+}
+
+/* Writes the same attribute of several pins, the "<dev>/pwm" prefix is formatted once and
+ * values go out with plain write(2) instead of a stdio stream per pin */
+static SE_ret_t _mtk_9050_pwm_write_pins(const char *dev_name, const char *attr, const uint8_t *pins,
+                                         const uint32_t *values, size_t count)
+{
+    char path[128] = "";
+    int prefix_len = snprintf(path, sizeof(path), "%s/pwm", dev_name);
+    if (prefix_len < 0 || prefix_len >= (int)sizeof(path))
+    {
+        SE_set_error("PWM dev name is too long");
+        return kSE_FAILED;
+    }
+
+    SE_ret_t ret = kSE_SUCCESS;
+    for (size_t i = 0; i < count; i++)
+    {
+        snprintf(path + prefix_len, sizeof(path) - prefix_len, "%d/%s", pins[i], attr);
+        int fd = open(path, O_WRONLY);
+        if (fd < 0)
+        {
+            SE_WARNING("Unable to open %s, error_msg = %s", path, strerror(errno));
+            ret = kSE_FAILED;
+            continue;
+        }
+
+        char value_text[16];
+        int len = snprintf(value_text, sizeof(value_text), "%u", values[i]);
+        if (write(fd, value_text, len) != len)
+        {
+            SE_WARNING("Write %s for pwm pin %d error = %d, error_msg = %s", attr, pins[i], errno, strerror(errno));
+            ret = kSE_FAILED;
+        }
+        close(fd);
+    }
+
+    if (ret != kSE_SUCCESS)
+    {
+        SE_set_error("Unable to write every pin of the batch");
+    }
+    return ret;
+}
+
+SE_ret_t mtk_9050_pwm_set_duty_batch(const char *dev_name, const uint8_t *pins, const uint32_t *duties_us, size_t count)
+{
+    return _mtk_9050_pwm_write_pins(dev_name, "duty_cycle", pins, duties_us, count);
+}
+
+SE_ret_t mtk_9050_pwm_set_period_batch(const char *dev_name, const uint8_t *pins, const uint32_t *periods_us, size_t count)
+{
+    return _mtk_9050_pwm_write_pins(dev_name, "period", pins, periods_us, count);
+}
@@ -1,15 +1,19 @@
 #ifndef MTK_9050_LINUX_PWM_H
 #define MTK_9050_LINUX_PWM_H
 #include <stdbool.h>
+#include <stddef.h>
 #include <stdint.h>
 
 #include "SE_enum.h"
 
-bool mtk_9050_pwm_is_device(const char *dev_folder);
+#define MTK_9050_PWM_COMPATIBLE "mstar,pwm"
+
 SE_ret_t mtk_9050_pwm_export_pin(const char *dev_name, uint8_t pin);
 SE_ret_t mtk_9050_pwm_unexport_pin(const char *dev_name, uint8_t pin);
 SE_ret_t mtk_9050_pwm_set_duty(const char *dev_name, uint8_t pin, uint32_t duty_us);
 SE_ret_t mtk_9050_pwm_set_period(const char *dev_name, uint8_t pin, uint32_t duty_us);
+SE_ret_t mtk_9050_pwm_set_duty_batch(const char *dev_name, const uint8_t *pins, const uint32_t *duties_us, size_t count);
+SE_ret_t mtk_9050_pwm_set_period_batch(const char *dev_name, const uint8_t *pins, const uint32_t *periods_us, size_t count);
 SE_ret_t mtk_9050_pwm_enable_pin(const char *dev_name, uint8_t pin);
 SE_ret_t mtk_9050_pwm_disable_pin(const char *dev_name, uint8_t pin);
 #endif /*MTK_9050_LINUX_PWM_H*/
\ No newline at end of file
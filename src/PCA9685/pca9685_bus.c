@@ -0,0 +1,439 @@
+#include "pca9685_bus.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "SE_errors.h"
+#include "SE_logging.h"
+
+#define BUS_ALL_CHIPS 0xFF
+
+enum bus_write_kind
+{
+    eBUS_WRITE_ALLCALL_ALL_LED,
+    eBUS_WRITE_ALLCALL_LED,
+    eBUS_WRITE_ALL_LED,
+    eBUS_WRITE_RUN,
+};
+
+SE_ret_t pca9685_bus_init(struct pca9685_bus *bus, const struct pca9685_bus_ops *ops, uint32_t byte_budget)
+{
+    if (bus == NULL || ops == NULL || ops->write == NULL)
+    {
+        SE_set_error("Bus or bus write is null");
+        return kSE_NULL;
+    }
+
+    if (byte_budget < PCA9685_BUS_WRITE_OVERHEAD + PCA9685_LED_REG_SIZE)
+    {
+        SE_set_error("Bus budget is below one channel write");
+        return kSE_OUT_OF_RANGE;
+    }
+
+    memset(bus, 0, sizeof(*bus));
+    bus->ops = *ops;
+    bus->byte_budget = byte_budget;
+    return kSE_SUCCESS;
+}
+
+int pca9685_bus_add_chip(struct pca9685_bus *bus, uint8_t address, bool allcall)
+{
+    if (bus == NULL)
+    {
+        SE_set_error("Bus is null");
+        return kSE_NULL;
+    }
+
+    if (bus->chip_count >= PCA9685_BUS_MAX_CHIPS || address == PCA9685_ALLCALL_ADDRESS)
+    {
+        SE_set_error("Bus is full or chip address is reserved");
+        return kSE_OUT_OF_RANGE;
+    }
+
+    struct pca9685_bus_chip *chip = &bus->chip[bus->chip_count];
+    memset(chip, 0, sizeof(*chip));
+    chip->address = address;
+    chip->allcall = allcall;
+    return bus->chip_count++;
+}
+
+SE_ret_t pca9685_bus_set(struct pca9685_bus *bus, uint8_t chip, uint8_t channel, uint16_t off, uint32_t deadline_ms,
+                         uint8_t priority)
+{
+    if (bus == NULL)
+    {
+        SE_set_error("Bus is null");
+        return kSE_NULL;
+    }
+
+    if (chip >= bus->chip_count || channel >= PCA9685_CHANNELS || off >= PCA9685_COUNTS)
+    {
+        SE_set_error("Chip, channel or count is out of range");
+        return kSE_OUT_OF_RANGE;
+    }
+
+    struct pca9685_bus_channel *state = &bus->chip[chip].channel[channel];
+    state->off = off;
+    state->dirty = !state->has_written || state->written != off;
+    state->deadline_ms = deadline_ms;
+    state->priority = priority;
+    return kSE_SUCCESS;
+}
+
+uint32_t pca9685_bus_budget(uint32_t speed_hz, uint32_t frame_us)
+{
+    return (uint32_t)((uint64_t)speed_hz * frame_us / 1000000 / 9);
+}
+
+/* Rounded to the nearest prescale, the datasheet rounds osc / (4096 * rate) - 1 the same way */
+static uint32_t _pca9685_bus_prescale(uint32_t period_us)
+{
+    return (uint32_t)(((uint64_t)PCA9685_OSC_HZ * period_us / 1000000 + PCA9685_COUNTS / 2) / PCA9685_COUNTS) - 1;
+}
+
+uint32_t pca9685_bus_actual_period(uint32_t period_us)
+{
+    uint32_t prescale = _pca9685_bus_prescale(period_us);
+    if (period_us == 0 || prescale < PCA9685_PRE_SCALE_MIN || prescale > PCA9685_PRE_SCALE_MAX)
+    {
+        return 0;
+    }
+    return (uint32_t)((uint64_t)(prescale + 1) * PCA9685_COUNTS * 1000000 / PCA9685_OSC_HZ);
+}
+
+SE_ret_t pca9685_bus_set_period(struct pca9685_bus *bus, uint8_t chip, uint32_t period_us)
+{
+    if (bus == NULL)
+    {
+        SE_set_error("Bus is null");
+        return kSE_NULL;
+    }
+
+    if (chip >= bus->chip_count || pca9685_bus_actual_period(period_us) == 0)
+    {
+        SE_set_error("Chip or period is out of range");
+        return kSE_OUT_OF_RANGE;
+    }
+
+    const struct pca9685_bus_chip *target = &bus->chip[chip];
+    uint8_t awake = PCA9685_MODE1_AI | (target->allcall ? PCA9685_MODE1_ALLCALL : 0);
+    uint8_t sleep = awake | PCA9685_MODE1_SLEEP;
+    uint8_t prescale = (uint8_t)_pca9685_bus_prescale(period_us);
+    if (bus->ops.write(bus->ops.context, target->address, PCA9685_REG_MODE1, &sleep, 1) != kSE_SUCCESS ||
+        bus->ops.write(bus->ops.context, target->address, PCA9685_REG_PRE_SCALE, &prescale, 1) != kSE_SUCCESS ||
+        bus->ops.write(bus->ops.context, target->address, PCA9685_REG_MODE1, &awake, 1) != kSE_SUCCESS)
+    {
+        SE_set_error("Chip did not take its prescaler");
+        return kSE_FAILED;
+    }
+
+    SE_DEBUG("Chip 0x%02x prescale %d for %u us", target->address, prescale, period_us);
+    return kSE_SUCCESS;
+}
+
+uint16_t pca9685_bus_duty_to_count(uint32_t duty_us, uint32_t period_us)
+{
+    if (period_us == 0)
+    {
+        return 0;
+    }
+
+    uint32_t count = (uint32_t)((uint64_t)duty_us * PCA9685_COUNTS / period_us);
+    return (count >= PCA9685_COUNTS) ? PCA9685_COUNTS - 1 : count;
+}
+
+uint32_t pca9685_bus_pending(const struct pca9685_bus *bus)
+{
+    uint32_t pending = 0;
+    for (uint8_t c = 0; c < bus->chip_count; c++)
+    {
+        for (uint8_t ch = 0; ch < PCA9685_CHANNELS; ch++)
+        {
+            pending += bus->chip[c].channel[ch].dirty;
+        }
+    }
+    return pending;
+}
+
+static void _pca9685_bus_take(struct pca9685_bus_write *write, const struct pca9685_bus_channel *state)
+{
+    if (write->count == 0 || (int32_t)(state->deadline_ms - write->deadline_ms) < 0)
+    {
+        write->deadline_ms = state->deadline_ms;
+    }
+    if (state->priority > write->priority)
+    {
+        write->priority = state->priority;
+    }
+}
+
+/* Chips that answer ALLCALL share channel ch when they all want the same count */
+static bool _pca9685_bus_allcall_shared(const struct pca9685_bus *bus, uint8_t ch, uint16_t *off, int *dirty)
+{
+    int members = 0;
+    *dirty = 0;
+    for (uint8_t c = 0; c < bus->chip_count; c++)
+    {
+        const struct pca9685_bus_chip *chip = &bus->chip[c];
+        if (!chip->allcall)
+        {
+            continue;
+        }
+
+        if (members > 0 && chip->channel[ch].off != *off)
+        {
+            return false;
+        }
+        *off = chip->channel[ch].off;
+        *dirty += chip->channel[ch].dirty;
+        members++;
+    }
+    return members > 1;
+}
+
+static bool _pca9685_bus_chip_uniform(const struct pca9685_bus_chip *chip, uint16_t off)
+{
+    for (uint8_t ch = 0; ch < PCA9685_CHANNELS; ch++)
+    {
+        if (chip->channel[ch].off != off)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+/* Marks what an ALLCALL write covers and takes the deadline of its dirty channels */
+static void _pca9685_bus_cover(struct pca9685_bus *bus, struct pca9685_bus_write *write, uint8_t first, uint8_t last,
+                               bool covered[][PCA9685_CHANNELS])
+{
+    for (uint8_t c = 0; c < bus->chip_count; c++)
+    {
+        if (!bus->chip[c].allcall)
+        {
+            continue;
+        }
+
+        for (uint8_t ch = first; ch < last; ch++)
+        {
+            covered[c][ch] = true;
+            if (bus->chip[c].channel[ch].dirty)
+            {
+                _pca9685_bus_take(write, &bus->chip[c].channel[ch]);
+                write->count++;
+            }
+        }
+    }
+}
+
+/* Shared writes come first so the channels they cover are not written again per chip */
+static int _pca9685_bus_plan(struct pca9685_bus *bus, bool covered[][PCA9685_CHANNELS])
+{
+    const uint32_t led_write_bytes = PCA9685_BUS_WRITE_OVERHEAD + PCA9685_LED_REG_SIZE;
+    int count = 0;
+    uint16_t shared_off[PCA9685_CHANNELS];
+    int shared_dirty[PCA9685_CHANNELS];
+    bool shared[PCA9685_CHANNELS];
+    bool all_shared = true;
+    int total_dirty = 0;
+    for (uint8_t ch = 0; ch < PCA9685_CHANNELS; ch++)
+    {
+        shared[ch] = _pca9685_bus_allcall_shared(bus, ch, &shared_off[ch], &shared_dirty[ch]);
+        all_shared &= shared[ch] && shared_off[ch] == shared_off[0];
+        total_dirty += shared[ch] ? shared_dirty[ch] : 0;
+    }
+
+    if (all_shared && total_dirty > 1)
+    {
+        struct pca9685_bus_write *write = &bus->write[count++];
+        *write = (struct pca9685_bus_write){
+            .kind = eBUS_WRITE_ALLCALL_ALL_LED, .chip = BUS_ALL_CHIPS, .off = shared_off[0], .bytes = led_write_bytes};
+        _pca9685_bus_cover(bus, write, 0, PCA9685_CHANNELS, covered);
+    }
+
+    for (uint8_t ch = 0; ch < PCA9685_CHANNELS && !(all_shared && total_dirty > 1); ch++)
+    {
+        if (!shared[ch] || shared_dirty[ch] < 2)
+        {
+            continue;
+        }
+
+        struct pca9685_bus_write *write = &bus->write[count++];
+        *write = (struct pca9685_bus_write){.kind = eBUS_WRITE_ALLCALL_LED,
+                                    .chip = BUS_ALL_CHIPS,
+                                    .channel = ch,
+                                    .off = shared_off[ch],
+                                    .bytes = led_write_bytes};
+        _pca9685_bus_cover(bus, write, ch, ch + 1, covered);
+    }
+
+    uint32_t max_run = (bus->byte_budget - PCA9685_BUS_WRITE_OVERHEAD) / PCA9685_LED_REG_SIZE;
+    for (uint8_t c = 0; c < bus->chip_count; c++)
+    {
+        struct pca9685_bus_chip *chip = &bus->chip[c];
+        int dirty = 0;
+        for (uint8_t ch = 0; ch < PCA9685_CHANNELS; ch++)
+        {
+            dirty += chip->channel[ch].dirty && !covered[c][ch];
+        }
+
+        if (dirty > 1 && _pca9685_bus_chip_uniform(chip, chip->channel[0].off))
+        {
+            struct pca9685_bus_write *write = &bus->write[count++];
+            *write = (struct pca9685_bus_write){
+                .kind = eBUS_WRITE_ALL_LED, .chip = c, .off = chip->channel[0].off, .bytes = led_write_bytes};
+            for (uint8_t ch = 0; ch < PCA9685_CHANNELS; ch++)
+            {
+                if (chip->channel[ch].dirty && !covered[c][ch])
+                {
+                    _pca9685_bus_take(write, &chip->channel[ch]);
+                    write->count++;
+                }
+            }
+            continue;
+        }
+
+        /* Adjacent dirty channels share one auto increment write */
+        struct pca9685_bus_write *run = NULL;
+        for (uint8_t ch = 0; ch < PCA9685_CHANNELS; ch++)
+        {
+            if (!chip->channel[ch].dirty || covered[c][ch])
+            {
+                run = NULL;
+                continue;
+            }
+
+            if (run == NULL || run->count == max_run)
+            {
+                run = &bus->write[count++];
+                *run = (struct pca9685_bus_write){.kind = eBUS_WRITE_RUN, .chip = c, .channel = ch, .bytes = PCA9685_BUS_WRITE_OVERHEAD};
+            }
+            _pca9685_bus_take(run, &chip->channel[ch]);
+            run->count++;
+            run->bytes += PCA9685_LED_REG_SIZE;
+        }
+    }
+    return count;
+}
+
+/* Earliest deadline first, higher priority breaks ties, late writes stay earliest. The slack is
+ * taken at flush time, so the order needs no clock of its own. */
+static int _pca9685_bus_compare(const void *a, const void *b)
+{
+    const struct pca9685_bus_write *write_a = (const struct pca9685_bus_write *)a;
+    const struct pca9685_bus_write *write_b = (const struct pca9685_bus_write *)b;
+    if (write_a->slack_ms != write_b->slack_ms)
+    {
+        return (write_a->slack_ms < write_b->slack_ms) ? -1 : 1;
+    }
+    return (int)write_b->priority - (int)write_a->priority;
+}
+
+static void _pca9685_bus_encode(uint8_t *data, uint16_t off)
+{
+    data[0] = 0;
+    data[1] = 0;
+    data[2] = off & 0xFF;
+    data[3] = (off >> 8) & 0x0F;
+}
+
+static void _pca9685_bus_mark_written(struct pca9685_bus_channel *state, uint16_t off)
+{
+    state->written = off;
+    state->has_written = true;
+    state->dirty = (state->off != off);
+}
+
+static SE_ret_t _pca9685_bus_issue(struct pca9685_bus *bus, const struct pca9685_bus_write *write)
+{
+    uint8_t data[PCA9685_CHANNELS * PCA9685_LED_REG_SIZE];
+    SE_ret_t ret = kSE_FAILED;
+    if (write->kind == eBUS_WRITE_RUN)
+    {
+        struct pca9685_bus_chip *chip = &bus->chip[write->chip];
+        for (uint8_t i = 0; i < write->count; i++)
+        {
+            _pca9685_bus_encode(&data[i * PCA9685_LED_REG_SIZE], chip->channel[write->channel + i].off);
+        }
+        ret = bus->ops.write(bus->ops.context, chip->address, PCA9685_REG_LED0_ON_L + PCA9685_LED_REG_SIZE * write->channel,
+                             data, write->count * PCA9685_LED_REG_SIZE);
+        for (uint8_t i = 0; ret == kSE_SUCCESS && i < write->count; i++)
+        {
+            struct pca9685_bus_channel *state = &chip->channel[write->channel + i];
+            _pca9685_bus_mark_written(state, state->off);
+        }
+        return ret;
+    }
+
+    uint8_t first_chip = (write->chip == BUS_ALL_CHIPS) ? 0 : write->chip;
+    uint8_t last_chip = (write->chip == BUS_ALL_CHIPS) ? bus->chip_count : write->chip + 1;
+    uint8_t first = (write->kind == eBUS_WRITE_ALLCALL_LED) ? write->channel : 0;
+    uint8_t last = (write->kind == eBUS_WRITE_ALLCALL_LED) ? write->channel + 1 : PCA9685_CHANNELS;
+    uint8_t address = (write->chip == BUS_ALL_CHIPS) ? PCA9685_ALLCALL_ADDRESS : bus->chip[write->chip].address;
+    uint8_t reg = (write->kind == eBUS_WRITE_ALLCALL_LED) ? PCA9685_REG_LED0_ON_L + PCA9685_LED_REG_SIZE * write->channel
+                                                          : PCA9685_REG_ALL_LED_ON_L;
+    _pca9685_bus_encode(data, write->off);
+    ret = bus->ops.write(bus->ops.context, address, reg, data, PCA9685_LED_REG_SIZE);
+    for (uint8_t c = first_chip; ret == kSE_SUCCESS && c < last_chip; c++)
+    {
+        if (write->chip == BUS_ALL_CHIPS && !bus->chip[c].allcall)
+        {
+            continue;
+        }
+        for (uint8_t ch = first; ch < last; ch++)
+        {
+            _pca9685_bus_mark_written(&bus->chip[c].channel[ch], write->off);
+        }
+    }
+    bus->stats.shared_writes += (ret == kSE_SUCCESS);
+    return ret;
+}
+
+uint32_t pca9685_bus_flush(struct pca9685_bus *bus, uint32_t now_ms)
+{
+    if (bus == NULL)
+    {
+        SE_set_error("Bus is null");
+        return 0;
+    }
+
+    bool covered[PCA9685_BUS_MAX_CHIPS][PCA9685_CHANNELS] = {{false}};
+    int count = _pca9685_bus_plan(bus, covered);
+    for (int w = 0; w < count; w++)
+    {
+        bus->write[w].slack_ms = (int32_t)(bus->write[w].deadline_ms - now_ms);
+    }
+    qsort(bus->write, count, sizeof(struct pca9685_bus_write), _pca9685_bus_compare);
+
+    uint32_t bytes = 0;
+    for (int w = 0; w < count; w++)
+    {
+        const struct pca9685_bus_write *write = &bus->write[w];
+        if (bytes + write->bytes > bus->byte_budget)
+        {
+            /* A smaller write further down may still fit */
+            bus->stats.carried += write->count;
+            continue;
+        }
+
+        if (_pca9685_bus_issue(bus, write) != kSE_SUCCESS)
+        {
+            SE_WARNING("Bus write to chip %d failed, retry next frame", write->chip);
+            continue;
+        }
+        bytes += write->bytes;
+        bus->stats.transactions++;
+        if ((int32_t)(now_ms - write->deadline_ms) > 0)
+        {
+            bus->stats.late += write->count;
+        }
+    }
+
+    bus->stats.frames++;
+    bus->stats.bytes += bytes;
+    if (bytes > bus->stats.max_frame_bytes)
+    {
+        bus->stats.max_frame_bytes = bytes;
+    }
+    return bytes;
+}
@@ -0,0 +1,113 @@
+#ifndef PCA9685_BUS_H
+#define PCA9685_BUS_H
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "SE_enum.h"
+
+#define PCA9685_BUS_MAX_CHIPS 8
+#define PCA9685_CHANNELS 16
+#define PCA9685_COUNTS 4096
+#define PCA9685_ALLCALL_ADDRESS 0x70
+#define PCA9685_OSC_HZ 25000000
+#define PCA9685_REG_MODE1 0x00
+#define PCA9685_REG_PRE_SCALE 0xFE
+#define PCA9685_MODE1_ALLCALL 0x01
+#define PCA9685_MODE1_SLEEP 0x10
+#define PCA9685_MODE1_AI 0x20
+/* The chip ignores prescale values below 3 */
+#define PCA9685_PRE_SCALE_MIN 3
+#define PCA9685_PRE_SCALE_MAX 255
+#define PCA9685_REG_LED0_ON_L 0x06
+#define PCA9685_REG_ALL_LED_ON_L 0xFA
+#define PCA9685_LED_REG_SIZE 4
+/* Address and register byte ahead of the data of every write */
+#define PCA9685_BUS_WRITE_OVERHEAD 2
+
+/* One I2C write transaction, the chip auto increments from reg */
+struct pca9685_bus_ops
+{
+    SE_ret_t (*write)(void *context, uint8_t address, uint8_t reg, const uint8_t *data, size_t len);
+    void *context;
+};
+
+struct pca9685_bus_channel
+{
+    uint16_t off;
+    uint16_t written;
+    uint32_t deadline_ms;
+    uint8_t priority;
+    bool dirty;
+    bool has_written;
+};
+
+struct pca9685_bus_chip
+{
+    uint8_t address;
+    /* ALLCALL enabled in MODE1, the chip also answers PCA9685_ALLCALL_ADDRESS */
+    bool allcall;
+    struct pca9685_bus_channel channel[PCA9685_CHANNELS];
+};
+
+/* Every shared write plus one run per chip and channel is the worst case of one frame */
+#define PCA9685_BUS_MAX_WRITES (1 + PCA9685_CHANNELS + PCA9685_BUS_MAX_CHIPS * (PCA9685_CHANNELS + 1))
+
+/* A candidate transaction of the frame being planned: chip is 0xFF for ALLCALL writes, channel
+ * and count cover the LED registers it carries */
+struct pca9685_bus_write
+{
+    uint8_t kind;
+    uint8_t chip;
+    uint8_t channel;
+    uint8_t count;
+    uint8_t priority;
+    uint16_t off;
+    uint32_t deadline_ms;
+    int32_t slack_ms;
+    uint32_t bytes;
+};
+
+struct pca9685_bus_stats
+{
+    uint32_t frames;
+    uint32_t transactions;
+    uint32_t bytes;
+    uint32_t shared_writes;
+    uint32_t carried;
+    uint32_t late;
+    uint32_t max_frame_bytes;
+};
+
+/* Every chip on one bus: values are staged with a deadline and priority and flushed once per
+ * frame, within a byte budget. What does not fit stays dirty for the next frame. The bus holds
+ * all of its scheduler state, separate buses flush independently. */
+struct pca9685_bus
+{
+    struct pca9685_bus_ops ops;
+    uint32_t byte_budget;
+    uint8_t chip_count;
+    struct pca9685_bus_chip chip[PCA9685_BUS_MAX_CHIPS];
+    struct pca9685_bus_write write[PCA9685_BUS_MAX_WRITES];
+    struct pca9685_bus_stats stats;
+};
+
+SE_ret_t pca9685_bus_init(struct pca9685_bus *bus, const struct pca9685_bus_ops *ops, uint32_t byte_budget);
+/* Returns the chip index on the bus, or a negative SE_ret_t */
+int pca9685_bus_add_chip(struct pca9685_bus *bus, uint8_t address, bool allcall);
+SE_ret_t pca9685_bus_set(struct pca9685_bus *bus, uint8_t chip, uint8_t channel, uint16_t off, uint32_t deadline_ms,
+                         uint8_t priority);
+/* Programs the prescaler of the chip for period_us and wakes it with auto increment, outside the
+ * frame budget. The prescaler only takes a write while the chip sleeps, so MODE1 goes sleep,
+ * prescale, awake. Values already written stay in the LED registers, the caller stages them again
+ * at the counts of the new period. */
+SE_ret_t pca9685_bus_set_period(struct pca9685_bus *bus, uint8_t chip, uint32_t period_us);
+/* Period the chip runs at for a requested period_us, 0 when the prescaler cannot reach it */
+uint32_t pca9685_bus_actual_period(uint32_t period_us);
+/* Writes the most urgent dirty registers that fit in the budget, returns the bytes sent */
+uint32_t pca9685_bus_flush(struct pca9685_bus *bus, uint32_t now_ms);
+uint32_t pca9685_bus_pending(const struct pca9685_bus *bus);
+/* Bytes a bus at speed_hz moves in frame_us, 9 clocks per byte */
+uint32_t pca9685_bus_budget(uint32_t speed_hz, uint32_t frame_us);
+uint16_t pca9685_bus_duty_to_count(uint32_t duty_us, uint32_t period_us);
+#endif /*PCA9685_BUS_H*/
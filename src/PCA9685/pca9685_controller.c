@@ -1,14 +1,27 @@
 #include "pca9685_controller.h"
 
-#define PCA9685_MAX_SERVO 16
+#include <stdbool.h>
+#include "SE_def.h"
+#include "SE_ticks.h"
+#include "SE_errors.h"
+#include "SE_logging.h"
+
+#define PCA9685_MAX_SERVO (PCA9685_BUS_MAX_CHIPS * PCA9685_CHANNELS)
+#define CONTROLLER_VALIDATE(controller, invalid) \
+    if (controller == NULL)                      \
+    {                                            \
+        SE_set_error("Controller is null");      \
+        return invalid;                          \
+    }
+
 #define DEFAULT_PCA9685_UNITS_FOR_0_DEGREE    111 // 111.411 = 544 us
 #define DEFAULT_PCA9685_UNITS_FOR_45_DEGREE  (111 + ((491 - 111) / 4)) // 206
 #define DEFAULT_PCA9685_UNITS_FOR_90_DEGREE  (111 + ((491 - 111) / 2)) // 301 = 1472 us
 #define DEFAULT_PCA9685_UNITS_FOR_135_DEGREE (491 - ((491 - 111) / 4)) // 369
 #define DEFAULT_PCA9685_UNITS_FOR_180_DEGREE  491 // 491.52 = 2400 us
 
-#define PULSE_UNIT_US(period_us) ((period_us * 100) / 4096)
-#define DEFAULT_DMMY_PERIOD_US      (20000)
+#define PULSE_UNIT_US(period_us) ((period_us) * 100 / PCA9685_COUNTS)
+#define DEFAULT_PCA9685_PERIOD_US      (20000)
 
 static SE_ret_t PCA9685_init_device(struct SE_controller *controller);
 static void PCA9685_deinit_device(struct SE_controller *controller);
@@ -16,10 +29,13 @@ static SE_ret_t PCA9685_open_servo(struct SE_controller *controller, uint8_t ser
 static SE_ret_t PCA9685_close_servo(struct SE_controller *controller, uint8_t servo_id);
 static SE_ret_t PCA9685_set_duty(struct SE_controller *controller, uint8_t servo_id, uint32_t duty_us);
 static SE_ret_t PCA9685_set_period(struct SE_controller *controller, uint8_t servo_id, uint32_t period_us);
+static SE_ret_t PCA9685_set_duty_batch(struct SE_controller *controller, const uint8_t *servo_ids,
+                                       const uint32_t *duties_us, size_t count);
 static const struct SE_controller_info *PCA9685_get_info_ref(struct SE_controller *controller);
 static struct SE_controller_info PCA9685_get_info_copy(struct SE_controller *controller);
 static SE_ret_t PCA9685_set_id(struct SE_controller *controller, int id);
 static uint32_t PCA9685_get_pulse_resolution(struct SE_controller *controller, uint8_t servo_id);
+static SE_ret_t PCA9685_servo_callback_register(void *servo);
 
 struct pca9685_servo_info
 {
@@ -34,18 +50,21 @@ struct pca9685_data
     struct SE_controller_info info;
     struct pca9685_servo_info servo[PCA9685_MAX_SERVO];
     bool is_open;
+    bool has_bus;
+    struct pca9685_bus bus;
 };
 
 static struct pca9685_data controller_data = {
     .info = {
         .name = "PCA9685",
         .id = 0,
-        .max_servo = PCA9685_MAX_SERVO,
+        .max_servo = 0,
         .units_for_0_degree = DEFAULT_PCA9685_UNITS_FOR_0_DEGREE,
         .units_for_180_degree = DEFAULT_PCA9685_UNITS_FOR_180_DEGREE,
     },
-    .servo = {0},
+    .servo = {{0}},
     .is_open = false,
+    .has_bus = false,
 };
 
 static struct SE_controller pca9685_controller = {
@@ -55,51 +74,260 @@ static struct SE_controller pca9685_controller = {
     .close_servo = PCA9685_close_servo,
     .set_duty = PCA9685_set_duty,
     .set_period = PCA9685_set_period,
+    .set_duty_batch = PCA9685_set_duty_batch,
     .get_info_ref = PCA9685_get_info_ref,
     .get_info_copy = PCA9685_get_info_copy,
     .set_id = PCA9685_set_id,
     .get_pulse_resolution = PCA9685_get_pulse_resolution,
+    .register_servo_event = PCA9685_servo_callback_register,
     .controller_data = (void *)&controller_data,
 };
 
+struct SE_controller* PCA9685_get_controller(void)
+{
+    return &pca9685_controller;
+}
+
+SE_ret_t PCA9685_attach_bus(struct SE_controller *controller, const struct pca9685_bus_ops *ops,
+                            uint32_t byte_budget)
+{
+    CONTROLLER_VALIDATE(controller, kSE_NULL);
+
+    struct pca9685_data *data = (struct pca9685_data *)controller->controller_data;
+    SE_ret_t ret = pca9685_bus_init(&data->bus, ops, byte_budget);
+    data->has_bus = (ret == kSE_SUCCESS);
+    data->info.max_servo = 0;
+    return ret;
+}
+
+/* The prescaler is shared by the 16 channels of a chip, so is the period */
+static void _PCA9685_set_chip_period(struct pca9685_data *data, int chip, uint32_t period_us)
+{
+    for (uint8_t ch = 0; ch < PCA9685_CHANNELS; ch++)
+    {
+        struct pca9685_servo_info *servo = &data->servo[chip * PCA9685_CHANNELS + ch];
+        servo->period_us = period_us;
+        servo->pwm_resolution = PULSE_UNIT_US(period_us);
+    }
+}
+
+SE_ret_t PCA9685_add_chip(struct SE_controller *controller, uint8_t address, bool allcall)
+{
+    CONTROLLER_VALIDATE(controller, kSE_NULL);
+
+    struct pca9685_data *data = (struct pca9685_data *)controller->controller_data;
+    if (!data->has_bus)
+    {
+        SE_set_error("PCA9685 bus is not attached");
+        return kSE_NULL;
+    }
+
+    int chip = pca9685_bus_add_chip(&data->bus, address, allcall);
+    if (chip < 0)
+    {
+        return (SE_ret_t)chip;
+    }
+
+    _PCA9685_set_chip_period(data, chip, pca9685_bus_actual_period(DEFAULT_PCA9685_PERIOD_US));
+    data->info.max_servo += PCA9685_CHANNELS;
+    return kSE_SUCCESS;
+}
+
+uint32_t PCA9685_flush(struct SE_controller *controller)
+{
+    CONTROLLER_VALIDATE(controller, 0);
+
+    struct pca9685_data *data = (struct pca9685_data *)controller->controller_data;
+    return data->has_bus ? pca9685_bus_flush(&data->bus, SE_tick_get_current_tick()) : 0;
+}
+
+const struct pca9685_bus_stats *PCA9685_get_bus_stats(struct SE_controller *controller)
+{
+    CONTROLLER_VALIDATE(controller, NULL);
+
+    struct pca9685_data *data = (struct pca9685_data *)controller->controller_data;
+    return data->has_bus ? &data->bus.stats : NULL;
+}
+
 static SE_ret_t PCA9685_init_device(struct SE_controller *controller)
 {
+    CONTROLLER_VALIDATE(controller, kSE_NULL);
+
+    struct pca9685_data *data = (struct pca9685_data *)controller->controller_data;
+    if (!data->has_bus)
+    {
+        SE_set_error("PCA9685 bus is not attached");
+        return kSE_NULL;
+    }
+
+    /* Chips power up asleep at about 200 Hz */
+    for (uint8_t chip = 0; chip < data->bus.chip_count; chip++)
+    {
+        SE_ret_t ret = pca9685_bus_set_period(&data->bus, chip, data->servo[chip * PCA9685_CHANNELS].period_us);
+        if (ret != kSE_SUCCESS)
+        {
+            SE_ERROR("PCA9685 chip %d not programmed", chip);
+            return ret;
+        }
+    }
+
+    data->is_open = true;
     return kSE_SUCCESS;
 }
 
+static void PCA9685_deinit_device(struct SE_controller *controller)
+{
+    if (controller == NULL)
+    {
+        SE_set_error("Controller is null, ignore");
+        return;
+    }
+
+    /* Values carried over from the last frames still reach the chips */
+    PCA9685_flush(controller);
+    ((struct pca9685_data *)controller->controller_data)->is_open = false;
+}
+
 static SE_ret_t PCA9685_open_servo(struct SE_controller *controller, uint8_t servo_id)
 {
+    CONTROLLER_VALIDATE(controller, kSE_NULL);
+
+    struct pca9685_data *data = (struct pca9685_data *)controller->controller_data;
+    if (servo_id >= data->info.max_servo)
+    {
+        SE_set_error("Servo id is out of range");
+        return kSE_OUT_OF_RANGE;
+    }
+
+    data->servo[servo_id].enable = true;
     return kSE_SUCCESS;
 }
 
 static SE_ret_t PCA9685_close_servo(struct SE_controller *controller, uint8_t servo_id)
 {
+    CONTROLLER_VALIDATE(controller, kSE_NULL);
+
+    struct pca9685_data *data = (struct pca9685_data *)controller->controller_data;
+    if (servo_id >= data->info.max_servo)
+    {
+        SE_set_error("Servo id is out of range");
+        return kSE_OUT_OF_RANGE;
+    }
+
+    data->servo[servo_id].enable = false;
     return kSE_SUCCESS;
 }
 
+/* Due at the next PWM cycle, the chip latches a new count at the end of the current one */
+static SE_ret_t _PCA9685_stage(struct pca9685_data *data, uint8_t servo_id, uint32_t duty_us, uint32_t now_ms)
+{
+    if (servo_id >= data->info.max_servo)
+    {
+        SE_set_error("Servo id is out of range");
+        return kSE_OUT_OF_RANGE;
+    }
+
+    struct pca9685_servo_info *servo = &data->servo[servo_id];
+    servo->duty = duty_us;
+    return pca9685_bus_set(&data->bus, servo_id / PCA9685_CHANNELS, servo_id % PCA9685_CHANNELS,
+                           pca9685_bus_duty_to_count(duty_us, servo->period_us), now_ms + servo->period_us / 1000, 0);
+}
+
 static SE_ret_t PCA9685_set_duty(struct SE_controller *controller, uint8_t servo_id, uint32_t duty)
 {
-    return kSE_SUCCESS;
+    CONTROLLER_VALIDATE(controller, kSE_NULL);
+
+    struct pca9685_data *data = (struct pca9685_data *)controller->controller_data;
+    uint32_t now_ms = SE_tick_get_current_tick();
+    SE_ret_t ret = _PCA9685_stage(data, servo_id, duty, now_ms);
+    if (ret == kSE_SUCCESS)
+    {
+        pca9685_bus_flush(&data->bus, now_ms);
+    }
+    return ret;
 }
 
-static SE_ret_t PCA9685_set_period(struct SE_controller *controller, uint8_t servo_id, uint32_t freq)
+/* One frame of the engine is one scheduler flush, so channels and chips share transactions */
+static SE_ret_t PCA9685_set_duty_batch(struct SE_controller *controller, const uint8_t *servo_ids,
+                                       const uint32_t *duties_us, size_t count)
 {
-    return kSE_SUCCESS;
+    CONTROLLER_VALIDATE(controller, kSE_NULL);
+
+    struct pca9685_data *data = (struct pca9685_data *)controller->controller_data;
+    uint32_t now_ms = SE_tick_get_current_tick();
+    SE_ret_t ret = kSE_SUCCESS;
+    for (size_t i = 0; i < count; i++)
+    {
+        SE_ret_t stage_ret = _PCA9685_stage(data, servo_ids[i], duties_us[i], now_ms);
+        ret = (ret == kSE_SUCCESS) ? stage_ret : ret;
+    }
+
+    pca9685_bus_flush(&data->bus, now_ms);
+    SE_DEBUG("Set duty of %zu servo(s) in one bus frame", count);
+    return ret;
 }
 
-static SE_ret_t PCA9685_get_info_ref(struct SE_controller *controller)
+/* The period belongs to the chip, setting it for one servo moves the other 15 channels too.
+ * Their last duties are staged again at the counts of the new period. */
+static SE_ret_t PCA9685_set_period(struct SE_controller *controller, uint8_t servo_id, uint32_t period_us)
 {
+    CONTROLLER_VALIDATE(controller, kSE_NULL);
+
+    struct pca9685_data *data = (struct pca9685_data *)controller->controller_data;
+    uint32_t actual_us = pca9685_bus_actual_period(period_us);
+    if (servo_id >= data->info.max_servo || actual_us == 0)
+    {
+        SE_set_error("Servo id or period is out of range");
+        return kSE_OUT_OF_RANGE;
+    }
+
+    uint8_t chip = servo_id / PCA9685_CHANNELS;
+    if (data->servo[servo_id].period_us == actual_us)
+    {
+        return kSE_SUCCESS;
+    }
+
+    if (data->is_open)
+    {
+        SE_ret_t ret = pca9685_bus_set_period(&data->bus, chip, period_us);
+        if (ret != kSE_SUCCESS)
+        {
+            return ret;
+        }
+    }
+
+    SE_INFO("PCA9685 chip %d runs at %u us", chip, actual_us);
+    _PCA9685_set_chip_period(data, chip, actual_us);
+    if (data->is_open)
+    {
+        uint32_t now_ms = SE_tick_get_current_tick();
+        for (uint8_t id = chip * PCA9685_CHANNELS; id < (chip + 1) * PCA9685_CHANNELS; id++)
+        {
+            if (data->servo[id].enable && data->servo[id].duty != 0)
+            {
+                _PCA9685_stage(data, id, data->servo[id].duty, now_ms);
+            }
+        }
+        pca9685_bus_flush(&data->bus, now_ms);
+    }
     return kSE_SUCCESS;
 }
 
-static SE_ret_t PCA9685_get_info_copy(struct SE_controller *controller)
+static const struct SE_controller_info *PCA9685_get_info_ref(struct SE_controller *controller)
 {
-    return kSE_SUCCESS;
+    CONTROLLER_VALIDATE(controller, NULL);
+    return &((struct pca9685_data *)controller->controller_data)->info;
 }
 
-struct SE_controller* PCA9685_get_controller(void)
+static struct SE_controller_info PCA9685_get_info_copy(struct SE_controller *controller)
 {
-    return &pca9685_controller;
+    struct SE_controller_info info = {0};
+    if (controller == NULL)
+    {
+        SE_set_error("Controller is null, ignore");
+        return info;
+    }
+    return ((struct pca9685_data *)controller->controller_data)->info;
 }
 
 static SE_ret_t PCA9685_set_id(struct SE_controller *controller, int id)
@@ -107,13 +335,13 @@ static SE_ret_t PCA9685_set_id(struct SE_controller *controller, int id)
     CONTROLLER_VALIDATE(controller, kSE_NULL);
 
     struct pca9685_data *data = (struct pca9685_data *)controller->controller_data;
-    data->id = id;
+    data->info.id = id;
     return kSE_SUCCESS;
 }
 
 static uint32_t PCA9685_get_pulse_resolution(struct SE_controller *controller, uint8_t servo_id)
 {
-    CONTROLLER_VALIDATE(controller, kSE_NULL);
+    CONTROLLER_VALIDATE(controller, 0);
     struct pca9685_data *data = (struct pca9685_data *)controller->controller_data;
 
     if (servo_id >= data->info.max_servo)
@@ -123,4 +351,9 @@ static uint32_t PCA9685_get_pulse_resolution(struct SE_controller *controller, u
     }
 
     return data->servo[servo_id].pwm_resolution;
-}
\ No newline at end of file
+}
+
+static SE_ret_t PCA9685_servo_callback_register(void *servo)
+{
+    return kSE_SUCCESS;
+}
@@ -1,6 +1,18 @@
 #ifndef PCA9685_CONTROLLER_H
 #define PCA9685_CONTROLLER_H
+#include <stdbool.h>
+
 #include "SE_controller.h"
+#include "pca9685_bus.h"
 
 struct SE_controller *PCA9685_get_controller(void);
-#endif /*PCA9685_CONTROLLER_H*/
\ No newline at end of file
+/* Chip writes of the controller go through ops, at most byte_budget bytes per frame. The
+ * controller owns the scheduler of its bus, chips are added after the bus is attached. */
+SE_ret_t PCA9685_attach_bus(struct SE_controller *controller, const struct pca9685_bus_ops *ops,
+                            uint32_t byte_budget);
+/* Each chip takes the next 16 servo ids, in the order the chips are added */
+SE_ret_t PCA9685_add_chip(struct SE_controller *controller, uint8_t address, bool allcall);
+/* Writes what earlier frames could not fit, for frames that set no duty */
+uint32_t PCA9685_flush(struct SE_controller *controller);
+const struct pca9685_bus_stats *PCA9685_get_bus_stats(struct SE_controller *controller);
+#endif /*PCA9685_CONTROLLER_H*/
@@ -2,7 +2,7 @@
 
 #include <stdbool.h>
 #include <stdio.h>
-#include <dirent.h>
+#include <fcntl.h>
 #include <unistd.h>
 #include <malloc.h>
 #include <string.h>
@@ -11,6 +11,7 @@
 #include "SE_servo.h"
 #include "SE_errors.h"
 #include "SE_logging.h"
+#include "SE_pwmchip.h"
 
 #define PCA9685_MAX_SERVO 16
 
@@ -39,6 +40,10 @@ static SE_ret_t PCA9685_linux_open_servo(struct SE_controller *controller, uint8
 static SE_ret_t PCA9685_linux_close_servo(struct SE_controller *controller, uint8_t servo_id);
 static SE_ret_t PCA9685_linux_set_duty(struct SE_controller *controller, uint8_t servo_id, uint32_t duty_us);
 static SE_ret_t PCA9685_linux_set_period(struct SE_controller *controller, uint8_t servo_id, uint32_t period_us);
+static SE_ret_t PCA9685_linux_set_duty_batch(struct SE_controller *controller, const uint8_t *servo_ids,
+                                             const uint32_t *duties_us, size_t count);
+static SE_ret_t PCA9685_linux_set_period_batch(struct SE_controller *controller, const uint8_t *servo_ids,
+                                               const uint32_t *periods_us, size_t count);
 static const struct SE_controller_info *PCA9685_linux_get_info_ref(struct SE_controller *controller);
 static struct SE_controller_info PCA9685_linux_get_info_copy(struct SE_controller *controller);
 static SE_ret_t PCA9685_linux_set_id(struct SE_controller *controller, int id);
@@ -52,6 +57,7 @@ struct pca9685_linux_servo_info
     uint32_t duty_us;
     uint32_t pwm_resolution;
     bool is_open;
+    bool has_duty;
 };
 
 struct pca9685_linux_data
@@ -60,9 +66,13 @@ struct pca9685_linux_data
     struct pca9685_linux_servo_info servo[PCA9685_MAX_SERVO];
     bool is_open;
     char *pwm_dev_name;
+    /* Board index among the matching pwmchips, unless bound to a chip path */
+    uint8_t instance;
+    char *bind_dev_name;
 };
 
-static struct pca9685_linux_data controller_data = {
+/* Every board owns one controller and its channel state, copied from the templates on first use */
+static const struct pca9685_linux_data controller_data_template = {
     .info = {
         .name = "PCA9685_linux",
         .id = 0,
@@ -74,64 +84,27 @@ static struct pca9685_linux_data controller_data = {
     .is_open = false,
 };
 
-static struct SE_controller pca9685_linux_controller = {
+static const struct SE_controller pca9685_linux_controller_template = {
     .controller_init = PCA9685_linux_init_device,
     .controller_deinit = PCA9685_linux_deinit_device,
     .open_servo = PCA9685_linux_open_servo,
     .close_servo = PCA9685_linux_close_servo,
     .set_duty = PCA9685_linux_set_duty,
     .set_period = PCA9685_linux_set_period,
+    .set_duty_batch = PCA9685_linux_set_duty_batch,
+    .set_period_batch = PCA9685_linux_set_period_batch,
     .get_info_ref = PCA9685_linux_get_info_ref,
     .get_info_copy = PCA9685_linux_get_info_copy,
     .set_id = PCA9685_linux_set_id,
     .get_pulse_resolution = PCA9685_linux_get_pulse_resolution,
     .register_servo_event = PCA9685_linux_servo_callback_register,
-    .controller_data = (void *)&controller_data,
 };
 
-static bool is_pca9685_device(const char *dev_folder)
-{
-    char file_name[128] = {'\0'};
-    bool ret = false;
-    sprintf(file_name, "/sys/class/pwm/%s/device/of_node/compatible", dev_folder);
-    if (access(file_name, F_OK) == -1)
-    {
-        SE_DEBUG("Unable to open device name %s, ignore", file_name);
-        return ret;
-    }
-    FILE *file = fopen(file_name, "r");
-    fseek(file, 0, SEEK_END);
-    long file_size = ftell(file);
-    fseek(file, 0, SEEK_SET);
-    char *device_name = malloc(file_size + 1);
-    if (device_name == NULL)
-    {
-        fclose(file);
-        return ret;
-    }
-    fread(device_name, sizeof(char), file_size, file);
-    for (int i = 0; i < file_size; i++)
-    {
-        if (device_name[i] == '\n' || device_name[i] == '\r')
-        {
-            device_name[i] = 0;
-        }
-    }
-
-    fclose(file);
-    if (!strcmp(device_name, DEV_NAME))
-    {
-        SE_DEBUG("Found %s", device_name);
-        ret = true;
-    }
-    free(device_name);
-    return ret;
-}
+static struct pca9685_linux_data controller_data[PCA9685_LINUX_MAX_INSTANCES];
+static struct SE_controller pca9685_linux_controller[PCA9685_LINUX_MAX_INSTANCES];
 
 static SE_ret_t PCA9685_linux_init_device(struct SE_controller *controller)
 {
-    DIR *dir = NULL;
-    struct dirent *entry = NULL;
     SE_ret_t ret = kSE_FAILED;
     CONTROLLER_VALIDATE(controller, kSE_NULL);
 
@@ -141,47 +114,31 @@ static SE_ret_t PCA9685_linux_init_device(struct SE_controller *controller)
         return kSE_SUCCESS;
     }
 
-    dir = opendir("/sys/class/pwm");
-    if (dir == NULL)
-    {
-        SE_set_error("Unable to open folder /sys/class/pwm");
-        return ret;
-    }
-
-    while ((entry = readdir(dir)) != NULL)
+    const char *dev_name = data->bind_dev_name;
+    if (dev_name == NULL)
     {
-        if (!strcmp(entry->d_name, ".") || !strcmp(entry->d_name, ".."))
-        {
-            continue;
-        }
-        SE_DEBUG("Operation on dir %s", entry->d_name);
-        if (is_pca9685_device(entry->d_name))
+        const char *dev_paths[PCA9685_LINUX_MAX_INSTANCES];
+        int found = SE_pwmchip_find_all(DEV_NAME, dev_paths, PCA9685_LINUX_MAX_INSTANCES);
+        if (found <= data->instance)
         {
-            char dev_name[128] = "";
-            int num_byte = snprintf(dev_name, 128, "/sys/class/pwm/%s", entry->d_name);
-            data->pwm_dev_name = malloc(num_byte + 1);
-            if (data->pwm_dev_name == NULL)
-            {
-                SE_ERROR("Unable to allocate memory for dev path %s", dev_name);
-                SE_set_error("Unable to allocate memory for PCA9685 dev name");
-                ret = kSE_NULL;
-                break;
-            }
-            strcpy(data->pwm_dev_name, dev_name);
-            SE_DEBUG("Found PCA9685 at dev name %s", data->pwm_dev_name);
-            data->is_open = true;
-            ret = kSE_SUCCESS;
-            break;
+            SE_ERROR("Found %d pca9685, board %d is missing", found, data->instance);
+            SE_set_error("Not found the pca9685 board in /sys/class/pwm");
+            return ret;
         }
+        dev_name = dev_paths[data->instance];
     }
 
-    if (ret == kSE_FAILED)
+    data->pwm_dev_name = malloc(strlen(dev_name) + 1);
+    if (data->pwm_dev_name == NULL)
     {
-        SE_set_error("Not found any pca9685 in /sys/class/pwm");
+        SE_ERROR("Unable to allocate memory for dev path %s", dev_name);
+        SE_set_error("Unable to allocate memory for PCA9685 dev name");
+        return kSE_NULL;
     }
-
-    closedir(dir);
-    return ret;
+    strcpy(data->pwm_dev_name, dev_name);
+    SE_DEBUG("Found PCA9685 board %d at dev name %s", data->instance, data->pwm_dev_name);
+    data->is_open = true;
+    return kSE_SUCCESS;
 }
 
 static void PCA9685_linux_deinit_device(struct SE_controller *controller)
@@ -350,6 +307,7 @@ static SE_ret_t _PCA9685_linux_set_duty(struct pca9685_linux_data *data, uint8_t
     fclose(servo_duty);
     SE_DEBUG("Duty servo %d set to %u us", servo_id, duty_us * 1000);
     data->servo[servo_id].duty_us = duty_us;
+    data->servo[servo_id].has_duty = true;
     return kSE_SUCCESS;
 }
 
@@ -422,6 +380,115 @@ static SE_ret_t PCA9685_linux_set_period(struct SE_controller *controller, uint8
     return _PCA9685_linux_set_period(data, servo_id, period_us);
 }
 
+/* Write one attribute of a channel, path holds the "<dev>/pwm" prefix up to prefix_len */
+static SE_ret_t _PCA9685_linux_write_attr(char *path, size_t path_len, int prefix_len, uint8_t servo_id,
+                                          const char *attr, uint32_t value)
+{
+    snprintf(path + prefix_len, path_len - prefix_len, "%d/%s", servo_id, attr);
+    int fd = open(path, O_WRONLY);
+    if (fd < 0)
+    {
+        SE_WARNING("Unable to open %s, error_msg = %s", path, strerror(errno));
+        return kSE_FAILED;
+    }
+
+    char value_text[16];
+    int len = snprintf(value_text, sizeof(value_text), "%u", value);
+    SE_ret_t ret = kSE_SUCCESS;
+    if (write(fd, value_text, len) != len)
+    {
+        SE_WARNING("Write %s error = %d, error_msg = %s", path, errno, strerror(errno));
+        ret = kSE_FAILED;
+    }
+    close(fd);
+    return ret;
+}
+
+/* The whole frame shares one validation and path prefix, channels that already hold the
+ * requested duty are not written again */
+static SE_ret_t PCA9685_linux_set_duty_batch(struct SE_controller *controller, const uint8_t *servo_ids,
+                                             const uint32_t *duties_us, size_t count)
+{
+    CONTROLLER_VALIDATE(controller, kSE_NULL);
+
+    struct pca9685_linux_data *data = (struct pca9685_linux_data *)controller->controller_data;
+    if (data->pwm_dev_name == NULL)
+    {
+        SE_set_error("The controller is not initialized");
+        return kSE_TRY_AGAIN;
+    }
+
+    char path[128] = "";
+    int prefix_len = snprintf(path, sizeof(path), "%s/pwm", data->pwm_dev_name);
+    SE_ret_t ret = kSE_SUCCESS;
+    for (size_t i = 0; i < count; i++)
+    {
+        uint8_t servo_id = servo_ids[i];
+        if (servo_id >= data->info.max_servo || !data->servo[servo_id].enable)
+        {
+            SE_set_error("Servo in batch is out of range or not open");
+            ret = kSE_FAILED;
+            continue;
+        }
+
+        struct pca9685_linux_servo_info *servo = &data->servo[servo_id];
+        if (servo->has_duty && servo->duty_us == duties_us[i])
+        {
+            continue;
+        }
+
+        SE_ret_t write_ret = _PCA9685_linux_write_attr(path, sizeof(path), prefix_len, servo_id, "duty_cycle",
+                                                       duties_us[i] * 1000);
+        if (write_ret != kSE_SUCCESS)
+        {
+            SE_set_error("Servo unable to write duty");
+            ret = kSE_FAILED;
+            continue;
+        }
+        servo->duty_us = duties_us[i];
+        servo->has_duty = true;
+    }
+    return ret;
+}
+
+static SE_ret_t PCA9685_linux_set_period_batch(struct SE_controller *controller, const uint8_t *servo_ids,
+                                               const uint32_t *periods_us, size_t count)
+{
+    CONTROLLER_VALIDATE(controller, kSE_NULL);
+
+    struct pca9685_linux_data *data = (struct pca9685_linux_data *)controller->controller_data;
+    if (data->pwm_dev_name == NULL)
+    {
+        SE_set_error("The controller is not initialized");
+        return kSE_TRY_AGAIN;
+    }
+
+    char path[128] = "";
+    int prefix_len = snprintf(path, sizeof(path), "%s/pwm", data->pwm_dev_name);
+    SE_ret_t ret = kSE_SUCCESS;
+    for (size_t i = 0; i < count; i++)
+    {
+        uint8_t servo_id = servo_ids[i];
+        if (servo_id >= data->info.max_servo || !data->servo[servo_id].enable)
+        {
+            SE_set_error("Servo in batch is out of range or not open");
+            ret = kSE_FAILED;
+            continue;
+        }
+
+        SE_ret_t write_ret = _PCA9685_linux_write_attr(path, sizeof(path), prefix_len, servo_id, "period",
+                                                       periods_us[i] * 1000);
+        if (write_ret != kSE_SUCCESS)
+        {
+            SE_set_error("Servo unable to write period");
+            ret = kSE_FAILED;
+            continue;
+        }
+        data->servo[servo_id].period_us = periods_us[i];
+    }
+    return ret;
+}
+
 static const struct SE_controller_info *PCA9685_linux_get_info_ref(struct SE_controller *controller)
 {
     const struct SE_controller_info *ref_info = NULL;
@@ -444,7 +511,57 @@ static struct SE_controller_info PCA9685_linux_get_info_copy(struct SE_controlle
 
 struct SE_controller *PCA9685_linux_get_controller(void)
 {
-    return &pca9685_linux_controller;
+    return PCA9685_linux_get_controller_instance(0);
+}
+
+struct SE_controller *PCA9685_linux_get_controller_instance(uint8_t instance)
+{
+    if (instance >= PCA9685_LINUX_MAX_INSTANCES)
+    {
+        SE_set_error("PCA9685 instance is out of range");
+        return NULL;
+    }
+
+    struct SE_controller *controller = &pca9685_linux_controller[instance];
+    if (controller->controller_data == NULL)
+    {
+        controller_data[instance] = controller_data_template;
+        controller_data[instance].instance = instance;
+        *controller = pca9685_linux_controller_template;
+        controller->controller_data = (void *)&controller_data[instance];
+    }
+    return controller;
+}
+
+int PCA9685_linux_count_devices(void)
+{
+    const char *dev_paths[PCA9685_LINUX_MAX_INSTANCES];
+    return SE_pwmchip_find_all(DEV_NAME, dev_paths, PCA9685_LINUX_MAX_INSTANCES);
+}
+
+SE_ret_t PCA9685_linux_bind(struct SE_controller *controller, const char *dev_name)
+{
+    CONTROLLER_VALIDATE(controller, kSE_NULL);
+
+    struct pca9685_linux_data *data = (struct pca9685_linux_data *)controller->controller_data;
+    if (data->is_open)
+    {
+        SE_set_error("Controller is already initialized");
+        return kSE_FAILED;
+    }
+
+    free(data->bind_dev_name);
+    data->bind_dev_name = NULL;
+    if (dev_name != NULL)
+    {
+        data->bind_dev_name = strdup(dev_name);
+        if (data->bind_dev_name == NULL)
+        {
+            SE_set_error("Unable to allocate memory for PCA9685 dev name");
+            return kSE_NO_MEM;
+        }
+    }
+    return kSE_SUCCESS;
 }
 
 static SE_ret_t PCA9685_linux_set_id(struct SE_controller *controller, int id)
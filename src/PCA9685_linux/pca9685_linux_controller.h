@@ -2,5 +2,12 @@
 #define PCA9685_LINUX_CONTROLLER_H
 #include "SE_controller.h"
 
+#define PCA9685_LINUX_MAX_INSTANCES 8
+
 struct SE_controller *PCA9685_linux_get_controller(void);
-#endif /*PCA9685_LINUX_CONTROLLER_H*/
\ No newline at end of file
+/* Board n is the n-th nxp,pca9685-pwm pwmchip by chip number */
+struct SE_controller *PCA9685_linux_get_controller_instance(uint8_t instance);
+int PCA9685_linux_count_devices(void);
+/* Pins the board to one pwmchip path before init, NULL goes back to discovery order */
+SE_ret_t PCA9685_linux_bind(struct SE_controller *controller, const char *dev_name);
+#endif /*PCA9685_LINUX_CONTROLLER_H*/
@@ -2,122 +2,149 @@
 
 #include <math.h>
 
+#include "SE_easing.h"
 #include "SE_logging.h"
 #include "SE_errors.h"
 #include "SE_ticks.h"
 
-static float SE_move_in_update(SE_servo_t *servo);
-static float SE_move_out_update(SE_servo_t *servo);
-static float SE_move_in_out_update(SE_servo_t *servo);
-static float SE_move_bouncing_out_in_update(SE_servo_t *servo);
-static inline float SE_easing_function(SE_servo_t *servo, float time_factor);
+#ifdef USE_FAST_MATH
+#include "SE_fast_math.h"
+#define SE_SIN(x) SE_fast_sinf(x)
+#define SE_SQRT(x) SE_fast_sqrtf(x)
+#define SE_EXP2(x) SE_fast_exp2f(x)
+#define SE_PI SE_FAST_PI
+#define SE_PI_2 SE_FAST_PI_2
+#else
+#define SE_SIN(x) sin(x)
+#define SE_SQRT(x) sqrt(x)
+#define SE_EXP2(x) pow(2, x)
+#define SE_PI M_PI
+#define SE_PI_2 M_PI_2
+#endif /*USE_FAST_MATH*/
+
+static float SE_move_in_update(SE_easing_t easing, uint32_t milis_since_start, uint32_t milis_to_move);
+static float SE_move_out_update(SE_easing_t easing, uint32_t milis_since_start, uint32_t milis_to_move);
+static float SE_move_in_out_update(SE_easing_t easing, uint32_t milis_since_start, uint32_t milis_to_move);
+static float SE_move_bouncing_out_in_update(SE_easing_t easing, uint32_t milis_since_start, uint32_t milis_to_move);
+static inline float SE_easing_function(SE_easing_t easing, float time_factor);
+
+int32_t SE_algorithm_update(SE_servo_t *servo)
+{
+    return SE_algorithm_update_at(servo, SE_tick_get_current_tick());
+}
+
+static uint32_t _SE_get_elapse_ticks(SE_servo_t *servo, uint32_t tick)
+{
+    uint32_t milis_since_start = 0;
+    if (tick < SE_servo_get_start_move_milis(servo))
+    {
+        milis_since_start = (0xffffffff - SE_servo_get_start_move_milis(servo)) + tick; 
+    } else
+    {
+        milis_since_start = tick - SE_servo_get_start_move_milis(servo);
+    }
+
+    return milis_since_start;
+}
+
+/* Eases the move as it stands at tick, which may lie ahead of the current tick */
+int32_t SE_algorithm_update_at(SE_servo_t *servo, uint32_t tick)
+{
+    return SE_algorithm_eval(servo->easing_type, servo->mov_type, _SE_get_elapse_ticks(servo, tick),
+                             SE_servo_get_milis_to_complete_move(servo));
+}
 
-uint32_t SE_algorithm_update(SE_servo_t *servo)
+int32_t SE_algorithm_eval(SE_easing_t easing, SE_easing_mov_t move, uint32_t elapse_ms, uint32_t duration_ms)
 {
     float servo_value = 0;
-    switch (servo->mov_type)
+    switch (move)
     {
     case eSE_MOV_IN:
-        servo_value = SE_move_in_update(servo) * 100;
+        servo_value = SE_move_in_update(easing, elapse_ms, duration_ms) * 100;
         break;
     case eSE_MOV_OUT:
-        servo_value = SE_move_out_update(servo) * 100;
+        servo_value = SE_move_out_update(easing, elapse_ms, duration_ms) * 100;
         break;
     case eSE_MOV_IN_OUT:
-        servo_value = SE_move_in_out_update(servo) * 100;
+        servo_value = SE_move_in_out_update(easing, elapse_ms, duration_ms) * 100;
         break;
     case eSE_MOV_BOUNCING_OUT_IN:
-        servo_value = SE_move_bouncing_out_in_update(servo) * 100;
+        servo_value = SE_move_bouncing_out_in_update(easing, elapse_ms, duration_ms) * 100;
         break;
     default:
         break;
     }
-    return (uint32_t)servo_value;
+    return (int32_t)servo_value;
 }
 
-static uint32_t _SE_get_elapse_ticks(SE_servo_t *servo)
+float SE_algorithm_ease_in(SE_easing_t easing, float time_factor)
 {
-    uint32_t milis_since_start = 0;
-    if (SE_tick_get_current_tick() < SE_servo_get_start_move_milis(servo))
-    {
-        milis_since_start = (0xffffffff - SE_servo_get_start_move_milis(servo)) + SE_tick_get_current_tick(); 
-    } else
-    {
-        milis_since_start = SE_tick_get_current_tick() - SE_servo_get_start_move_milis(servo);
-    }
-
-    return milis_since_start;
+    return SE_easing_function(easing, time_factor);
 }
 
-static float SE_move_in_update(SE_servo_t *servo)
+static float SE_move_in_update(SE_easing_t easing, uint32_t milis_since_start, uint32_t milis_to_move)
 {
-    uint32_t milis_since_start = _SE_get_elapse_ticks(servo);
     SE_DEBUG("Milis since start %ld", milis_since_start);
-    if (milis_since_start > SE_servo_get_milis_to_complete_move(servo))
+    if (milis_since_start > milis_to_move)
     {
         return 1;
     }
 
-    float time_factor = (float)milis_since_start / SE_servo_get_milis_to_complete_move(servo);
-    float movement_completed = SE_easing_function(servo, time_factor);
+    float time_factor = (float)milis_since_start / milis_to_move;
+    float movement_completed = SE_easing_function(easing, time_factor);
     SE_DEBUG("Easing movement completed value %0.2f", movement_completed);
     return movement_completed;
 }
 
-static float SE_move_out_update(SE_servo_t *servo)
+static float SE_move_out_update(SE_easing_t easing, uint32_t milis_since_start, uint32_t milis_to_move)
 {
-    uint32_t milis_since_start = _SE_get_elapse_ticks(servo);
-
-    if (milis_since_start > SE_servo_get_milis_to_complete_move(servo))
+    if (milis_since_start > milis_to_move)
     {
         return 1;
     }
-    float time_factor = (float)milis_since_start / SE_servo_get_milis_to_complete_move(servo);
-    float movement_completed = 1.0f - (float)SE_easing_function(servo, (1.0f - time_factor));
+    float time_factor = (float)milis_since_start / milis_to_move;
+    float movement_completed = 1.0f - (float)SE_easing_function(easing, (1.0f - time_factor));
     return movement_completed;
 }
 
-static float SE_move_in_out_update(SE_servo_t *servo)
+static float SE_move_in_out_update(SE_easing_t easing, uint32_t milis_since_start, uint32_t milis_to_move)
 {
-    uint32_t milis_since_start = _SE_get_elapse_ticks(servo);
-
-    if (milis_since_start > SE_servo_get_milis_to_complete_move(servo))
+    if (milis_since_start > milis_to_move)
     {
         return 1;
     }
 
-    float time_factor = (float)milis_since_start / SE_servo_get_milis_to_complete_move(servo);
+    float time_factor = (float)milis_since_start / milis_to_move;
     float movement_completed = 0.0f;
     if (time_factor <= 0.5f)
     {
-        movement_completed = 0.5f * SE_easing_function(servo, 2.0f * time_factor);
+        movement_completed = 0.5f * SE_easing_function(easing, 2.0f * time_factor);
     }
     else
     {
-        movement_completed = 1.0f - (0.5f * SE_easing_function(servo, 2.0f - (2.0f * time_factor)));
+        movement_completed = 1.0f - (0.5f * SE_easing_function(easing, 2.0f - (2.0f * time_factor)));
     }
     SE_DEBUG("Easing movement completed value %0.2f", movement_completed);
 
     return movement_completed;
 }
 
-static float SE_move_bouncing_out_in_update(SE_servo_t *servo)
+static float SE_move_bouncing_out_in_update(SE_easing_t easing, uint32_t milis_since_start, uint32_t milis_to_move)
 {
-    uint32_t milis_since_start = _SE_get_elapse_ticks(servo);
     SE_DEBUG("Milis since start %ld", milis_since_start);
-    if (milis_since_start > SE_servo_get_milis_to_complete_move(servo))
+    if (milis_since_start > milis_to_move)
     {
         return 1;
     }
-    float time_factor = (float)milis_since_start / SE_servo_get_milis_to_complete_move(servo);
+    float time_factor = (float)milis_since_start / milis_to_move;
     float movement_completed = 0.0f;
     if (time_factor <= 0.5f)
     {
-        movement_completed = 1.0f - SE_easing_function(servo, (1.0f - 2.0f * time_factor));
+        movement_completed = 1.0f - SE_easing_function(easing, (1.0f - 2.0f * time_factor));
     }
     else
     {
-        movement_completed = 1.0f - SE_easing_function(servo, (2.0f * time_factor) - 1.0f);
+        movement_completed = 1.0f - SE_easing_function(easing, (2.0f * time_factor) - 1.0f);
     }
     return movement_completed;
 }
@@ -139,12 +166,12 @@ static inline float SE_quartic_in(float time_factor)
 
 static inline float SE_sine_in(float time_factor)
 {
-    return sin((time_factor - 1) * M_PI_2) + 1;
+    return SE_SIN((time_factor - 1) * SE_PI_2) + 1;
 }
 
 static inline float SE_cicular_in(float time_factor)
 {
-    return 1 - sqrt(1 - (time_factor * time_factor));
+    return 1 - SE_SQRT(1 - (time_factor * time_factor));
 }
 
 static inline float SE_cubic_in(float time_factor)
@@ -160,18 +187,23 @@ static inline float SE_precision_in(float time_factor)
 
 static inline float SE_elastic_in(float time_factor)
 {
-    return sin(13 * M_PI_2 * time_factor) * pow(2, 10 * (time_factor - 1));
+    return SE_SIN(13 * SE_PI_2 * time_factor) * SE_EXP2(10 * (time_factor - 1));
 }
 
 static inline float SE_back_in(float time_factor)
 {
-    return (time_factor * time_factor * time_factor) - (time_factor * sin(time_factor * M_PI));
+    return (time_factor * time_factor * time_factor) - (time_factor * SE_SIN(time_factor * SE_PI));
+}
+
+static inline float SE_custom_in(SE_easing_t type, float time_factor)
+{
+    return (float)SE_easing_custom_eval(type, (int32_t)(time_factor * SE_EASING_ONE)) / SE_EASING_ONE;
 }
 
-static inline float SE_easing_function(SE_servo_t *servo, float time_factor)
+static inline float SE_easing_function(SE_easing_t easing, float time_factor)
 {
     float percent = 0.0f;
-    switch (servo->easing_type)
+    switch (easing)
     {
     case eSE_EASE_LINEAR:
         percent = SE_linear_easing(time_factor);
@@ -198,7 +230,12 @@ static inline float SE_easing_function(SE_servo_t *servo, float time_factor)
         percent = SE_precision_in(time_factor);
         break;
     default:
-        SE_WARNING("Easing type %d is not supported", servo->easing_type);
+        if (easing >= eSE_EASE_CUSTOM)
+        {
+            percent = SE_custom_in(easing, time_factor);
+            break;
+        }
+        SE_WARNING("Easing type %d is not supported", easing);
         SE_set_error("Easing method not implement");
         break;
     }
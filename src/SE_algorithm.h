@@ -3,5 +3,12 @@
 #include "SE_enum.h"
 #include "servo_easing.h"
 
-uint32_t SE_algorithm_update(SE_servo_t *servo);
-#endif /*SE_ALGORITHM_H*/
\ No newline at end of file
+int32_t SE_algorithm_update(SE_servo_t *servo);
+int32_t SE_algorithm_update_at(SE_servo_t *servo, uint32_t tick);
+/* Percent of the move covered elapse_ms into a move of duration_ms, reads no servo state */
+int32_t SE_algorithm_eval(SE_easing_t easing, SE_easing_mov_t move, uint32_t elapse_ms, uint32_t duration_ms);
+#ifdef USE_FLOAT
+/* Fraction of an in move covered at time_factor, the curve every move type is built from */
+float SE_algorithm_ease_in(SE_easing_t easing, float time_factor);
+#endif /*USE_FLOAT*/
+#endif /*SE_ALGORITHM_H*/
@@ -1,31 +1,59 @@
 #include "SE_algorithm.h"
 
+#include "SE_easing.h"
 #include "SE_logging.h"
 #include "SE_errors.h"
 #include "SE_ticks.h"
 
-static uint32_t SE_move_in_update(SE_servo_t *servo);
-static uint32_t SE_move_out_update(SE_servo_t *servo);
-static uint32_t SE_move_in_out_update(SE_servo_t *servo);
-static uint32_t SE_move_bouncing_out_in_update(SE_servo_t *servo);
-static inline uint32_t SE_easing_function(SE_servo_t *servo, uint32_t completed_percent);
+static int32_t SE_move_in_update(SE_easing_t easing, uint32_t milis_since_start, uint32_t milis_to_move);
+static int32_t SE_move_out_update(SE_easing_t easing, uint32_t milis_since_start, uint32_t milis_to_move);
+static int32_t SE_move_in_out_update(SE_easing_t easing, uint32_t milis_since_start, uint32_t milis_to_move);
+static int32_t SE_move_bouncing_out_in_update(SE_easing_t easing, uint32_t milis_since_start, uint32_t milis_to_move);
+static inline int32_t SE_easing_function(SE_easing_t easing, uint32_t completed_percent);
 
-uint32_t SE_algorithm_update(SE_servo_t *servo)
+int32_t SE_algorithm_update(SE_servo_t *servo)
 {
-    uint32_t servo_value = 0;
-    switch (servo->mov_type)
+    return SE_algorithm_update_at(servo, SE_tick_get_current_tick());
+}
+
+static uint32_t _SE_get_elapse_ticks(SE_servo_t *servo, uint32_t tick)
+{
+    uint32_t milis_since_start = 0;
+    if (tick < SE_servo_get_start_move_milis(servo))
+    {
+        milis_since_start = (0xffffffff - SE_servo_get_start_move_milis(servo)) + tick;
+    }
+    else
+    {
+        milis_since_start = tick - SE_servo_get_start_move_milis(servo);
+    }
+
+    return milis_since_start;
+}
+
+/* Eases the move as it stands at tick, which may lie ahead of the current tick */
+int32_t SE_algorithm_update_at(SE_servo_t *servo, uint32_t tick)
+{
+    return SE_algorithm_eval(servo->easing_type, servo->mov_type, _SE_get_elapse_ticks(servo, tick),
+                             SE_servo_get_milis_to_complete_move(servo));
+}
+
+int32_t SE_algorithm_eval(SE_easing_t easing, SE_easing_mov_t move, uint32_t elapse_ms, uint32_t duration_ms)
+{
+    int32_t servo_value = 0;
+    switch (move)
     {
     case eSE_MOV_IN:
-        servo_value = SE_move_in_update(servo);
+        servo_value = SE_move_in_update(easing, elapse_ms, duration_ms);
         break;
     case eSE_MOV_OUT:
-        servo_value = SE_move_out_update(servo);
+        servo_value = SE_move_out_update(easing, elapse_ms, duration_ms);
         break;
     case eSE_MOV_IN_OUT:
-        servo_value = SE_move_in_out_update(servo);
+        servo_value = SE_move_in_out_update(easing, elapse_ms, duration_ms);
         break;
     case eSE_MOV_BOUNCING_OUT_IN:
-        servo_value = SE_move_bouncing_out_in_update(servo);
+        servo_value = SE_move_bouncing_out_in_update(easing, elapse_ms, duration_ms);
         break;
     default:
         break;
@@ -33,91 +61,67 @@ uint32_t SE_algorithm_update(SE_servo_t *servo)
     return servo_value;
 }
 
-static uint32_t _SE_get_elapse_ticks(SE_servo_t *servo)
-{
-    uint32_t milis_since_start = 0;
-    if (SE_tick_get_current_tick() < SE_servo_get_start_move_milis(servo))
-    {
-        milis_since_start = (0xffffffff - SE_servo_get_start_move_milis(servo)) + SE_tick_get_current_tick();
-    }
-    else
-    {
-        milis_since_start = SE_tick_get_current_tick() - SE_servo_get_start_move_milis(servo);
-    }
-
-    return milis_since_start;
-}
-
-static uint32_t SE_move_in_update(SE_servo_t *servo)
+static int32_t SE_move_in_update(SE_easing_t easing, uint32_t milis_since_start, uint32_t milis_to_move)
 {
-    uint32_t milis_since_start = _SE_get_elapse_ticks(servo);
-    uint32_t milis_to_move = SE_servo_get_milis_to_complete_move(servo);
-
-    if (milis_since_start > SE_servo_get_milis_to_complete_move(servo))
+    if (milis_since_start > milis_to_move)
     {
         return 100;
     }
 
     uint32_t completed_percent = milis_since_start * 100 / milis_to_move;
-    uint32_t movement_completed = SE_easing_function(servo, completed_percent);
+    int32_t movement_completed = SE_easing_function(easing, completed_percent);
     return movement_completed;
 }
 
-static uint32_t SE_move_out_update(SE_servo_t *servo)
+static int32_t SE_move_out_update(SE_easing_t easing, uint32_t milis_since_start, uint32_t milis_to_move)
 {
-    uint32_t milis_since_start = _SE_get_elapse_ticks(servo);
-    if (milis_since_start > SE_servo_get_milis_to_complete_move(servo))
+    if (milis_since_start > milis_to_move)
     {
         return 100;
     }
 
-    uint32_t milis_to_move = SE_servo_get_milis_to_complete_move(servo);
     uint32_t completed_percent = milis_since_start * 100 / milis_to_move;
-    uint32_t movement_completed = 100 - SE_easing_function(servo, (100 - completed_percent));
+    int32_t movement_completed = 100 - SE_easing_function(easing, (100 - completed_percent));
     return movement_completed;
 }
 
-static uint32_t SE_move_in_out_update(SE_servo_t *servo)
+static int32_t SE_move_in_out_update(SE_easing_t easing, uint32_t milis_since_start, uint32_t milis_to_move)
 {
-    uint32_t milis_since_start = _SE_get_elapse_ticks(servo);
-    if (milis_since_start > SE_servo_get_milis_to_complete_move(servo))
+    if (milis_since_start > milis_to_move)
     {
         return 100;
     }
 
-    uint32_t milis_to_move = SE_servo_get_milis_to_complete_move(servo);
     uint32_t completed_percent = milis_since_start * 100 / milis_to_move;
-    uint32_t movement_completed = 0;
+    int32_t movement_completed = 0;
     if (completed_percent <= 50)
     {
-        movement_completed = 0.5 * SE_easing_function(servo, 2 * completed_percent);
+        movement_completed = 0.5 * SE_easing_function(easing, 2 * completed_percent);
     }
     else
     {
-        movement_completed = 100 - (0.5 * SE_easing_function(servo, 200 - (2 * completed_percent)));
+        movement_completed = 100 - (0.5 * SE_easing_function(easing, 200 - (2 * completed_percent)));
     }
 
     return movement_completed;
 }
 
-static uint32_t SE_move_bouncing_out_in_update(SE_servo_t *servo)
+static int32_t SE_move_bouncing_out_in_update(SE_easing_t easing, uint32_t milis_since_start, uint32_t milis_to_move)
 {
-    uint32_t milis_since_start = _SE_get_elapse_ticks(servo);
-    if (milis_since_start > SE_servo_get_milis_to_complete_move(servo))
+    if (milis_since_start > milis_to_move)
     {
         return 100;
     }
 
-    uint32_t milis_to_move = SE_servo_get_milis_to_complete_move(servo);
     uint32_t completed_percent = milis_since_start * 100 / milis_to_move;
-    uint32_t movement_completed = 0;
+    int32_t movement_completed = 0;
     if (completed_percent <= 50)
     {
-        movement_completed = 100 - SE_easing_function(servo, (100 - 2 * completed_percent));
+        movement_completed = 100 - SE_easing_function(easing, (100 - 2 * completed_percent));
     }
     else
     {
-        movement_completed = 100 - SE_easing_function(servo, (2 * completed_percent) - 100);
+        movement_completed = 100 - SE_easing_function(easing, (2 * completed_percent) - 100);
     }
     return movement_completed;
 }
@@ -132,10 +136,17 @@ static inline uint32_t SE_quartic_in(uint32_t completed_percent)
     return SE_quaractic_in(SE_quaractic_in(completed_percent));
 }
 
-static inline uint32_t SE_easing_function(SE_servo_t *servo, uint32_t completed_percent)
+/* Percents are signed, a curve may dip below the start or pass the end and the caller clamps */
+static inline int32_t SE_custom_in(SE_easing_t type, uint32_t completed_percent)
+{
+    int32_t y = SE_easing_custom_eval(type, (int32_t)(completed_percent * SE_EASING_ONE / 100));
+    return (int32_t)(((int64_t)y * 100 + SE_EASING_ONE / 2) >> SE_EASING_FRAC_BITS);
+}
+
+static inline int32_t SE_easing_function(SE_easing_t easing, uint32_t completed_percent)
 {
-    uint32_t percent = 0;
-    switch (servo->easing_type)
+    int32_t percent = 0;
+    switch (easing)
     {
     case eSE_EASE_QUARACTIC:
         percent = SE_quaractic_in(completed_percent);
@@ -144,7 +155,12 @@ static inline uint32_t SE_easing_function(SE_servo_t *servo, uint32_t completed_
         percent = SE_quartic_in(completed_percent);
         break;
     default:
-        SE_WARNING("Easing type %d is not supported or disable due to no FP", servo->easing_type);
+        if (easing >= eSE_EASE_CUSTOM)
+        {
+            percent = SE_custom_in(easing, completed_percent);
+            break;
+        }
+        SE_WARNING("Easing type %d is not supported or disable due to no FP", easing);
         SE_set_error("Easing method not support");
         break;
     }
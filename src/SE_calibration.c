@@ -0,0 +1,150 @@
+#include "SE_calibration.h"
+
+#include <string.h>
+
+#include "SE_errors.h"
+#include "SE_logging.h"
+
+#define BLOB_HEADER_SIZE 5
+#define BLOB_TABLE_HEADER_SIZE 2
+#define BLOB_POINT_SIZE 3
+
+static uint16_t _SE_calibration_clamp(int32_t duty)
+{
+    if (duty < 0)
+    {
+        return 0;
+    }
+    if (duty > UINT16_MAX)
+    {
+        return UINT16_MAX;
+    }
+    return (uint16_t)duty;
+}
+
+static SE_ret_t _SE_calibration_validate(const SE_calibration_t *calibration)
+{
+    if (calibration->count < 2 || calibration->count > SE_CALIBRATION_MAX_POINTS)
+    {
+        SE_set_error("Calibration needs 2 to 16 points");
+        return kSE_OUT_OF_RANGE;
+    }
+
+    for (uint8_t i = 0; i < calibration->count; i++)
+    {
+        if (calibration->point[i].angle >= SE_CALIBRATION_LUT_SIZE)
+        {
+            SE_set_error("Calibration angle is out of range");
+            return kSE_OUT_OF_RANGE;
+        }
+
+        if (i > 0 && calibration->point[i].angle <= calibration->point[i - 1].angle)
+        {
+            SE_set_error("Calibration angles must be strictly increasing");
+            return kSE_OUT_OF_RANGE;
+        }
+    }
+    return kSE_SUCCESS;
+}
+
+SE_ret_t SE_calibration_load(SE_calibration_t *calibration, const uint8_t *blob, size_t size, uint8_t servo_id)
+{
+    if (calibration == NULL || blob == NULL)
+    {
+        SE_set_error("Calibration or blob is null");
+        return kSE_NULL;
+    }
+
+    if (size < BLOB_HEADER_SIZE || memcmp(blob, SE_CALIBRATION_BLOB_MAGIC, 4) != 0)
+    {
+        SE_set_error("Calibration blob has no valid header");
+        return kSE_FAILED;
+    }
+
+    size_t offset = BLOB_HEADER_SIZE;
+    for (uint8_t table = 0; table < blob[4]; table++)
+    {
+        if (offset + BLOB_TABLE_HEADER_SIZE > size)
+        {
+            SE_set_error("Calibration blob is truncated");
+            return kSE_OUT_OF_RANGE;
+        }
+
+        uint8_t id = blob[offset];
+        uint8_t count = blob[offset + 1];
+        offset += BLOB_TABLE_HEADER_SIZE;
+        if (offset + (size_t)count * BLOB_POINT_SIZE > size)
+        {
+            SE_set_error("Calibration blob is truncated");
+            return kSE_OUT_OF_RANGE;
+        }
+
+        if (id != servo_id)
+        {
+            offset += (size_t)count * BLOB_POINT_SIZE;
+            continue;
+        }
+
+        if (count > SE_CALIBRATION_MAX_POINTS)
+        {
+            SE_set_error("Calibration table has too many points");
+            return kSE_OUT_OF_RANGE;
+        }
+
+        calibration->count = count;
+        for (uint8_t i = 0; i < count; i++, offset += BLOB_POINT_SIZE)
+        {
+            calibration->point[i].angle = blob[offset];
+            calibration->point[i].pulse_us = blob[offset + 1] | (blob[offset + 2] << 8);
+        }
+        return _SE_calibration_validate(calibration);
+    }
+
+    SE_DEBUG("No calibration for servo %d in blob of %d bytes", servo_id, (int)size);
+    SE_set_error("Calibration blob has no table for servo");
+    return kSE_FAILED;
+}
+
+/* Piecewise linear between the points, rounded to the nearest us. Compiled once so a move only
+ * costs a table read and an interpolation per update. */
+SE_ret_t SE_calibration_compile(const SE_calibration_t *calibration, uint16_t *lut)
+{
+    if (calibration == NULL || lut == NULL)
+    {
+        SE_set_error("Calibration or lut is null");
+        return kSE_NULL;
+    }
+
+    SE_ret_t ret = _SE_calibration_validate(calibration);
+    if (ret != kSE_SUCCESS)
+    {
+        return ret;
+    }
+
+    uint8_t segment = 0;
+    for (int32_t angle = 0; angle < SE_CALIBRATION_LUT_SIZE; angle++)
+    {
+        while (segment + 2 < calibration->count && angle > calibration->point[segment + 1].angle)
+        {
+            segment++;
+        }
+
+        const SE_calibration_point_t *from = &calibration->point[segment];
+        const SE_calibration_point_t *to = &calibration->point[segment + 1];
+        int32_t span = to->angle - from->angle;
+        int32_t rise = ((int32_t)to->pulse_us - from->pulse_us) * (angle - from->angle);
+        int32_t half = (rise < 0) ? -span / 2 : span / 2;
+        lut[angle] = _SE_calibration_clamp(from->pulse_us + (rise + half) / span);
+    }
+    return kSE_SUCCESS;
+}
+
+void SE_calibration_compile_linear(uint32_t units_for_0_degree, uint32_t units_for_180_degree, uint32_t resolution,
+                                   uint16_t *lut)
+{
+    uint32_t unit_per_deg = (units_for_180_degree - units_for_0_degree) / 180;
+    for (uint32_t angle = 0; angle < SE_CALIBRATION_LUT_SIZE; angle++)
+    {
+        lut[angle] = _SE_calibration_clamp((units_for_0_degree + angle * unit_per_deg) * resolution / 100);
+    }
+}
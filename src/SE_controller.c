@@ -7,6 +7,15 @@ static struct SE_controller *p_controller[MAX_CONTROLLER] = {0};
 
 SE_ret_t SE_controller_register(SE_controller_t *controller)
 {
+    /* Opening the same instance again keeps its id */
+    for (int i = 0; i < MAX_CONTROLLER; i++)
+    {
+        if (p_controller[i] == controller)
+        {
+            return kSE_SUCCESS;
+        }
+    }
+
     for (int i = 0; i < MAX_CONTROLLER; i++)
     {
         if (p_controller[i] == 0)
@@ -38,6 +47,47 @@ SE_ret_t SE_controller_init(SE_controller_t *controller)
     return controller->controller_init(controller);
 }
 
+SE_ret_t SE_controller_set_duty_batch(SE_controller_t *controller, const uint8_t *servo_ids, const uint32_t *duties_us,
+                                      size_t count)
+{
+    if (controller->set_duty_batch != NULL)
+    {
+        return controller->set_duty_batch(controller, servo_ids, duties_us, count);
+    }
+
+    /* Every channel is still written when one fails, the first error is reported */
+    SE_ret_t ret = kSE_SUCCESS;
+    for (size_t i = 0; i < count; i++)
+    {
+        SE_ret_t channel_ret = controller->set_duty(controller, servo_ids[i], duties_us[i]);
+        if (ret == kSE_SUCCESS)
+        {
+            ret = channel_ret;
+        }
+    }
+    return ret;
+}
+
+SE_ret_t SE_controller_set_period_batch(SE_controller_t *controller, const uint8_t *servo_ids, const uint32_t *periods_us,
+                                        size_t count)
+{
+    if (controller->set_period_batch != NULL)
+    {
+        return controller->set_period_batch(controller, servo_ids, periods_us, count);
+    }
+
+    SE_ret_t ret = kSE_SUCCESS;
+    for (size_t i = 0; i < count; i++)
+    {
+        SE_ret_t channel_ret = controller->set_period(controller, servo_ids[i], periods_us[i]);
+        if (ret == kSE_SUCCESS)
+        {
+            ret = channel_ret;
+        }
+    }
+    return ret;
+}
+
 struct SE_controller* SE_controller_get(int id)
 {
     if (id >= MAX_CONTROLLER)
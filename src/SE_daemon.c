@@ -0,0 +1,285 @@
+#define _GNU_SOURCE
+#include "SE_daemon.h"
+
+#include <errno.h>
+#include <poll.h>
+#include <stdbool.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+#include "servo_easing.h"
+#include "SE_errors.h"
+#include "SE_logging.h"
+
+/* Messages taken from one client per recvmmsg */
+#define DAEMON_RECV_BURST 8
+
+struct _se_daemon
+{
+    int listen_fd;
+    int client_fd[SE_DAEMON_MAX_CLIENTS];
+    char socket_path[sizeof(((struct sockaddr_un *)0)->sun_path)];
+    SE_servo_t *servo;
+    uint8_t servo_count;
+    uint32_t pending_count;
+    uint32_t dropped;
+    SE_daemon_command_t pending[SE_DAEMON_MAX_PENDING];
+};
+
+static struct _se_daemon daemon_data = {.listen_fd = -1};
+static uint8_t recv_buffer[DAEMON_RECV_BURST][SE_DAEMON_MAX_MESSAGE];
+
+SE_ret_t SE_daemon_open(const char *socket_path, SE_servo_t *servos, uint8_t count)
+{
+    if (socket_path == NULL || servos == NULL)
+    {
+        SE_set_error("Socket path or servos is null");
+        return kSE_NULL;
+    }
+
+    if (strlen(socket_path) >= sizeof(daemon_data.socket_path))
+    {
+        SE_set_error("Socket path is too long");
+        return kSE_OUT_OF_RANGE;
+    }
+
+    int fd = socket(AF_UNIX, SOCK_SEQPACKET | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd < 0)
+    {
+        SE_set_error("Unable to create daemon socket");
+        return kSE_FAILED;
+    }
+
+    struct sockaddr_un addr = {.sun_family = AF_UNIX};
+    strcpy(addr.sun_path, socket_path);
+    unlink(socket_path);
+    if (bind(fd, (struct sockaddr *)&addr, sizeof(addr)) != 0 || listen(fd, SE_DAEMON_MAX_CLIENTS) != 0)
+    {
+        SE_set_error("Unable to listen on daemon socket");
+        close(fd);
+        return kSE_FAILED;
+    }
+
+    daemon_data.listen_fd = fd;
+    strcpy(daemon_data.socket_path, socket_path);
+    for (int i = 0; i < SE_DAEMON_MAX_CLIENTS; i++)
+    {
+        daemon_data.client_fd[i] = -1;
+    }
+    daemon_data.servo = servos;
+    daemon_data.servo_count = count;
+    daemon_data.pending_count = 0;
+    daemon_data.dropped = 0;
+    SE_INFO("Daemon listening on %s for %d servo(s)", socket_path, count);
+    return kSE_SUCCESS;
+}
+
+void SE_daemon_close(void)
+{
+    if (daemon_data.listen_fd < 0)
+    {
+        return;
+    }
+
+    for (int i = 0; i < SE_DAEMON_MAX_CLIENTS; i++)
+    {
+        if (daemon_data.client_fd[i] >= 0)
+        {
+            close(daemon_data.client_fd[i]);
+            daemon_data.client_fd[i] = -1;
+        }
+    }
+    close(daemon_data.listen_fd);
+    unlink(daemon_data.socket_path);
+    daemon_data.listen_fd = -1;
+}
+
+static void _SE_daemon_accept(void)
+{
+    int fd;
+    while ((fd = accept4(daemon_data.listen_fd, NULL, NULL, SOCK_NONBLOCK | SOCK_CLOEXEC)) >= 0)
+    {
+        int i = 0;
+        for (; i < SE_DAEMON_MAX_CLIENTS && daemon_data.client_fd[i] >= 0; i++)
+        {
+        }
+
+        if (i == SE_DAEMON_MAX_CLIENTS)
+        {
+            SE_WARNING("Daemon is full, client refused");
+            close(fd);
+            continue;
+        }
+        daemon_data.client_fd[i] = fd;
+        SE_DEBUG("Client %d connected", i);
+    }
+}
+
+static int _SE_daemon_queue_message(const uint8_t *message, size_t size)
+{
+    const SE_daemon_header_t *header = (const SE_daemon_header_t *)message;
+    if (size < sizeof(*header) || header->magic != SE_DAEMON_MAGIC || header->version != SE_DAEMON_VERSION ||
+        size != sizeof(*header) + (size_t)header->count * sizeof(SE_daemon_command_t))
+    {
+        SE_WARNING("Malformed message of %d bytes dropped", (int)size);
+        return 0;
+    }
+
+    const SE_daemon_command_t *command = (const SE_daemon_command_t *)(header + 1);
+    uint32_t room = SE_DAEMON_MAX_PENDING - daemon_data.pending_count;
+    uint32_t count = (header->count < room) ? header->count : room;
+    memcpy(&daemon_data.pending[daemon_data.pending_count], command, count * sizeof(*command));
+    daemon_data.pending_count += count;
+    daemon_data.dropped += header->count - count;
+    return count;
+}
+
+/* Drains every message a client has queued, DAEMON_RECV_BURST per syscall */
+static int _SE_daemon_read_client(int slot)
+{
+    struct mmsghdr msg[DAEMON_RECV_BURST];
+    struct iovec iov[DAEMON_RECV_BURST];
+    int queued = 0;
+    for (;;)
+    {
+        for (int i = 0; i < DAEMON_RECV_BURST; i++)
+        {
+            iov[i] = (struct iovec){.iov_base = recv_buffer[i], .iov_len = SE_DAEMON_MAX_MESSAGE};
+            msg[i] = (struct mmsghdr){.msg_hdr = {.msg_iov = &iov[i], .msg_iovlen = 1}};
+        }
+
+        int received = recvmmsg(daemon_data.client_fd[slot], msg, DAEMON_RECV_BURST, MSG_DONTWAIT, NULL);
+        if (received <= 0)
+        {
+            if (received == 0 || (errno != EAGAIN && errno != EWOULDBLOCK))
+            {
+                close(daemon_data.client_fd[slot]);
+                daemon_data.client_fd[slot] = -1;
+                SE_DEBUG("Client %d disconnected", slot);
+            }
+            return queued;
+        }
+
+        for (int i = 0; i < received; i++)
+        {
+            if (msg[i].msg_len == 0)
+            {
+                close(daemon_data.client_fd[slot]);
+                daemon_data.client_fd[slot] = -1;
+                return queued;
+            }
+            queued += _SE_daemon_queue_message(recv_buffer[i], msg[i].msg_len);
+        }
+
+        if (received < DAEMON_RECV_BURST)
+        {
+            return queued;
+        }
+    }
+}
+
+int SE_daemon_poll(int timeout_ms)
+{
+    if (daemon_data.listen_fd < 0)
+    {
+        return 0;
+    }
+
+    struct pollfd fds[SE_DAEMON_MAX_CLIENTS + 1];
+    int slot_of[SE_DAEMON_MAX_CLIENTS + 1];
+    nfds_t nfds = 0;
+    fds[nfds++] = (struct pollfd){.fd = daemon_data.listen_fd, .events = POLLIN};
+    for (int i = 0; i < SE_DAEMON_MAX_CLIENTS; i++)
+    {
+        if (daemon_data.client_fd[i] >= 0)
+        {
+            slot_of[nfds] = i;
+            fds[nfds++] = (struct pollfd){.fd = daemon_data.client_fd[i], .events = POLLIN};
+        }
+    }
+
+    if (poll(fds, nfds, timeout_ms) <= 0)
+    {
+        return 0;
+    }
+
+    int queued = 0;
+    for (nfds_t i = 1; i < nfds; i++)
+    {
+        if (fds[i].revents != 0)
+        {
+            queued += _SE_daemon_read_client(slot_of[i]);
+        }
+    }
+
+    if (fds[0].revents & POLLIN)
+    {
+        _SE_daemon_accept();
+    }
+    return queued;
+}
+
+static bool _SE_daemon_apply(const SE_daemon_command_t *command)
+{
+    if (command->servo >= daemon_data.servo_count)
+    {
+        SE_WARNING("Command for unknown servo %d", command->servo);
+        return false;
+    }
+
+    SE_servo_t *servo = &daemon_data.servo[command->servo];
+    SE_ret_t ret;
+    switch (command->op)
+    {
+    case eSE_DAEMON_OP_MOVE:
+        ret = SE_servo_retarget(servo, command->easing_type, command->move_type, command->speed, command->angle);
+        break;
+    case eSE_DAEMON_OP_STOP:
+        ret = SE_servo_stop(servo);
+        break;
+    case eSE_DAEMON_OP_RESUME:
+        ret = SE_servo_resume(servo);
+        break;
+    case eSE_DAEMON_OP_SPEED:
+        /* A still servo would divide its next move by it */
+        if (command->speed == 0)
+        {
+            SE_WARNING("Speed 0 for servo %d rejected", command->servo);
+            return false;
+        }
+        ret = SE_servo_set_speed(servo, command->speed);
+        break;
+    default:
+        SE_WARNING("Unknown daemon op %d", command->op);
+        return false;
+    }
+
+    if (ret != kSE_SUCCESS)
+    {
+        SE_WARNING("Command for servo %d rejected, error %s", command->servo, SE_get_error());
+        return false;
+    }
+    return true;
+}
+
+int SE_daemon_tick(void)
+{
+    int applied = 0;
+    for (uint32_t i = 0; i < daemon_data.pending_count; i++)
+    {
+        if (_SE_daemon_apply(&daemon_data.pending[i]))
+        {
+            applied++;
+        }
+    }
+
+    if (daemon_data.dropped > 0)
+    {
+        SE_WARNING("%u command(s) over the tick queue dropped", daemon_data.dropped);
+        daemon_data.dropped = 0;
+    }
+    daemon_data.pending_count = 0;
+    return applied;
+}
@@ -0,0 +1,110 @@
+#include "SE_daemon_client.h"
+
+#include <string.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+SE_ret_t SE_daemon_client_connect(SE_daemon_client_t *client, const char *socket_path)
+{
+    if (client == NULL || socket_path == NULL)
+    {
+        return kSE_NULL;
+    }
+
+    struct sockaddr_un addr = {.sun_family = AF_UNIX};
+    if (strlen(socket_path) >= sizeof(addr.sun_path))
+    {
+        return kSE_OUT_OF_RANGE;
+    }
+    strcpy(addr.sun_path, socket_path);
+
+    int fd = socket(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0);
+    if (fd < 0)
+    {
+        return kSE_FAILED;
+    }
+
+    if (connect(fd, (struct sockaddr *)&addr, sizeof(addr)) != 0)
+    {
+        close(fd);
+        return kSE_TRY_AGAIN;
+    }
+
+    client->fd = fd;
+    client->count = 0;
+    return kSE_SUCCESS;
+}
+
+void SE_daemon_client_close(SE_daemon_client_t *client)
+{
+    if (client == NULL || client->fd < 0)
+    {
+        return;
+    }
+
+    close(client->fd);
+    client->fd = -1;
+}
+
+SE_ret_t SE_daemon_client_flush(SE_daemon_client_t *client)
+{
+    if (client == NULL || client->fd < 0)
+    {
+        return kSE_NULL;
+    }
+
+    if (client->count == 0)
+    {
+        return kSE_SUCCESS;
+    }
+
+    /* Header and commands leave as one message straight from the client buffers */
+    SE_daemon_header_t header = {.magic = SE_DAEMON_MAGIC, .version = SE_DAEMON_VERSION, .count = client->count};
+    struct iovec iov[2] = {
+        {.iov_base = &header, .iov_len = sizeof(header)},
+        {.iov_base = client->command, .iov_len = client->count * sizeof(SE_daemon_command_t)},
+    };
+    struct msghdr msg = {.msg_iov = iov, .msg_iovlen = 2};
+    ssize_t sent = sendmsg(client->fd, &msg, MSG_NOSIGNAL);
+    client->count = 0;
+    if (sent != (ssize_t)(iov[0].iov_len + iov[1].iov_len))
+    {
+        return kSE_FAILED;
+    }
+    return kSE_SUCCESS;
+}
+
+SE_ret_t SE_daemon_client_queue(SE_daemon_client_t *client, const SE_daemon_command_t *command)
+{
+    if (client == NULL || command == NULL)
+    {
+        return kSE_NULL;
+    }
+
+    if (client->count == SE_DAEMON_MAX_BATCH)
+    {
+        SE_ret_t ret = SE_daemon_client_flush(client);
+        if (ret != kSE_SUCCESS)
+        {
+            return ret;
+        }
+    }
+
+    client->command[client->count++] = *command;
+    return kSE_SUCCESS;
+}
+
+SE_ret_t SE_daemon_client_move(SE_daemon_client_t *client, uint8_t servo, uint16_t angle, uint8_t speed,
+                               uint8_t easing_type, uint8_t move_type)
+{
+    SE_daemon_command_t command = {
+        .op = eSE_DAEMON_OP_MOVE,
+        .servo = servo,
+        .easing_type = easing_type,
+        .move_type = move_type,
+        .angle = angle,
+        .speed = speed,
+    };
+    return SE_daemon_client_queue(client, &command);
+}
@@ -0,0 +1,195 @@
+#include "SE_easing.h"
+
+#include <stddef.h>
+
+#include "SE_errors.h"
+#include "SE_logging.h"
+
+#define EASING_SEGMENTS (SE_EASING_TABLE_SIZE - 1)
+/* Enough halvings to pin s to one fixed point step */
+#define EASING_BISECT_STEPS (SE_EASING_FRAC_BITS + 1)
+
+struct _se_easing_curve
+{
+    bool used;
+    int32_t y[SE_EASING_TABLE_SIZE];
+};
+
+static struct _se_easing_curve easing_curves[SE_EASING_MAX_CUSTOM] = {0};
+
+static struct _se_easing_curve *_SE_easing_get_curve(SE_easing_t type)
+{
+    int index = (int)type - eSE_EASE_CUSTOM;
+    if (index < 0 || index >= SE_EASING_MAX_CUSTOM || !easing_curves[index].used)
+    {
+        return NULL;
+    }
+    return &easing_curves[index];
+}
+
+static SE_ret_t _SE_easing_alloc(SE_easing_t *type, struct _se_easing_curve **curve)
+{
+    if (type == NULL)
+    {
+        SE_set_error("Easing type output is null");
+        return kSE_NULL;
+    }
+
+    for (int i = 0; i < SE_EASING_MAX_CUSTOM; i++)
+    {
+        if (!easing_curves[i].used)
+        {
+            *type = (SE_easing_t)(eSE_EASE_CUSTOM + i);
+            *curve = &easing_curves[i];
+            return kSE_SUCCESS;
+        }
+    }
+
+    SE_set_error("No free custom easing slot");
+    return kSE_NO_MEM;
+}
+
+static bool _SE_easing_in_range(int32_t y)
+{
+    return y >= -SE_EASING_OVERSHOOT && y <= SE_EASING_ONE + SE_EASING_OVERSHOOT;
+}
+
+/* One coordinate of the curve at s: 3 (1-s)^2 s p1 + 3 (1-s) s^2 p2 + s^3 */
+static int64_t _SE_easing_bezier(int64_t s, int64_t p1, int64_t p2)
+{
+    int64_t r = SE_EASING_ONE - s;
+    int64_t a = (((3 * r * r) >> SE_EASING_FRAC_BITS) * s) >> SE_EASING_FRAC_BITS;
+    int64_t b = (((3 * r * s) >> SE_EASING_FRAC_BITS) * s) >> SE_EASING_FRAC_BITS;
+    int64_t c = (((s * s) >> SE_EASING_FRAC_BITS) * s) >> SE_EASING_FRAC_BITS;
+    return ((a * p1 + b * p2) >> SE_EASING_FRAC_BITS) + c;
+}
+
+SE_ret_t SE_easing_register_bezier(int32_t x1, int32_t y1, int32_t x2, int32_t y2, SE_easing_t *type)
+{
+    if (x1 < 0 || x1 > SE_EASING_ONE || x2 < 0 || x2 > SE_EASING_ONE || !_SE_easing_in_range(y1) ||
+        !_SE_easing_in_range(y2))
+    {
+        SE_set_error("Bezier control points are out of range");
+        return kSE_OUT_OF_RANGE;
+    }
+
+    struct _se_easing_curve *curve = NULL;
+    SE_ret_t ret = _SE_easing_alloc(type, &curve);
+    if (ret != kSE_SUCCESS)
+    {
+        return ret;
+    }
+
+    /* x rises with s when x1 and x2 stay within 0..1, so each table x is found by bisection */
+    for (int i = 0; i < SE_EASING_TABLE_SIZE; i++)
+    {
+        int64_t x = (int64_t)i * SE_EASING_ONE / EASING_SEGMENTS;
+        int64_t low = 0;
+        int64_t high = SE_EASING_ONE;
+        for (int step = 0; step < EASING_BISECT_STEPS; step++)
+        {
+            int64_t s = (low + high) / 2;
+            if (_SE_easing_bezier(s, x1, x2) < x)
+            {
+                low = s;
+            }
+            else
+            {
+                high = s;
+            }
+        }
+        curve->y[i] = (int32_t)_SE_easing_bezier(high, y1, y2);
+    }
+    curve->y[0] = 0;
+    curve->y[EASING_SEGMENTS] = SE_EASING_ONE;
+    curve->used = true;
+    SE_DEBUG("Custom easing %d from cubic-bezier", *type);
+    return kSE_SUCCESS;
+}
+
+SE_ret_t SE_easing_register_table(const int32_t *samples, uint16_t count, SE_easing_t *type)
+{
+    if (samples == NULL)
+    {
+        SE_set_error("Easing samples are null");
+        return kSE_NULL;
+    }
+
+    if (count < 2)
+    {
+        SE_set_error("Easing table needs at least 2 samples");
+        return kSE_OUT_OF_RANGE;
+    }
+
+    for (uint16_t k = 0; k < count; k++)
+    {
+        if (!_SE_easing_in_range(samples[k]))
+        {
+            SE_set_error("Easing sample is out of range");
+            return kSE_OUT_OF_RANGE;
+        }
+    }
+
+    struct _se_easing_curve *curve = NULL;
+    SE_ret_t ret = _SE_easing_alloc(type, &curve);
+    if (ret != kSE_SUCCESS)
+    {
+        return ret;
+    }
+
+    /* Resampled onto the table grid, straight lines between the given samples */
+    for (int i = 0; i < SE_EASING_TABLE_SIZE; i++)
+    {
+        int64_t position = (int64_t)i * (count - 1) * SE_EASING_ONE / EASING_SEGMENTS;
+        int64_t k = position >> SE_EASING_FRAC_BITS;
+        int64_t fraction = position & (SE_EASING_ONE - 1);
+        int64_t next = (k + 1 < count) ? samples[k + 1] : samples[k];
+        curve->y[i] = (int32_t)(samples[k] + (((next - samples[k]) * fraction) >> SE_EASING_FRAC_BITS));
+    }
+    curve->used = true;
+    SE_DEBUG("Custom easing %d from %d samples", *type, count);
+    return kSE_SUCCESS;
+}
+
+SE_ret_t SE_easing_unregister(SE_easing_t type)
+{
+    struct _se_easing_curve *curve = _SE_easing_get_curve(type);
+    if (curve == NULL)
+    {
+        SE_set_error("Easing type is not registered");
+        return kSE_OUT_OF_RANGE;
+    }
+
+    curve->used = false;
+    return kSE_SUCCESS;
+}
+
+bool SE_easing_is_valid(SE_easing_t type)
+{
+    return ((int)type >= 0 && type < eSE_EASE_LAST) || _SE_easing_get_curve(type) != NULL;
+}
+
+int32_t SE_easing_custom_eval(SE_easing_t type, int32_t x)
+{
+    struct _se_easing_curve *curve = _SE_easing_get_curve(type);
+    if (curve == NULL)
+    {
+        return x;
+    }
+
+    if (x <= 0)
+    {
+        return curve->y[0];
+    }
+
+    if (x >= SE_EASING_ONE)
+    {
+        return curve->y[EASING_SEGMENTS];
+    }
+
+    uint32_t position = (uint32_t)x * EASING_SEGMENTS;
+    uint32_t index = position >> SE_EASING_FRAC_BITS;
+    int64_t fraction = position & (SE_EASING_ONE - 1);
+    int64_t step = (int64_t)curve->y[index + 1] - curve->y[index];
+    return curve->y[index] + (int32_t)((step * fraction) >> SE_EASING_FRAC_BITS);
+}
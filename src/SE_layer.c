@@ -0,0 +1,153 @@
+#include "SE_layer.h"
+
+#include <stdbool.h>
+#include <string.h>
+
+#include "SE_algorithm.h"
+#include "SE_calibration.h"
+#include "SE_easing.h"
+#include "SE_errors.h"
+#include "SE_logging.h"
+
+#define LAYER_MAX_POSITION (180 << SE_CALIBRATION_FRAC_BITS)
+#define LAYER_MAX_ANGLE 180
+
+#define LAYER_VALIDATE(stack, index)                   \
+    if (stack == NULL)                                 \
+    {                                                  \
+        SE_set_error("Layer stack is null");           \
+        return kSE_NULL;                               \
+    }                                                  \
+    if (index >= SE_LAYER_MAX)                         \
+    {                                                  \
+        SE_set_error("Layer index is out of range");   \
+        return kSE_OUT_OF_RANGE;                       \
+    }
+
+void SE_layer_init(SE_layer_stack_t *stack)
+{
+    if (stack != NULL)
+    {
+        memset(stack, 0, sizeof(*stack));
+    }
+}
+
+void SE_layer_set_base(SE_layer_stack_t *stack, uint32_t position)
+{
+    if (stack != NULL)
+    {
+        stack->base = (position > LAYER_MAX_POSITION) ? LAYER_MAX_POSITION : position;
+    }
+}
+
+SE_ret_t SE_layer_play(SE_layer_stack_t *stack, uint8_t index, const SE_layer_desc_t *desc, uint32_t now_ms)
+{
+    LAYER_VALIDATE(stack, index);
+    if (desc == NULL)
+    {
+        SE_set_error("Layer description is null");
+        return kSE_NULL;
+    }
+
+    if (desc->blend >= eSE_LAYER_BLEND_LAST || desc->duration_ms == 0 || !SE_easing_is_valid(desc->easing_type) ||
+        desc->move_type >= eSE_MOV_LAST || desc->weight > SE_LAYER_WEIGHT_ONE)
+    {
+        SE_set_error("Layer description is out of range");
+        return kSE_OUT_OF_RANGE;
+    }
+
+    int16_t low = (desc->blend == eSE_LAYER_OVERRIDE) ? 0 : -LAYER_MAX_ANGLE;
+    if (desc->from < low || desc->from > LAYER_MAX_ANGLE || desc->to < low || desc->to > LAYER_MAX_ANGLE)
+    {
+        SE_set_error("Layer angles are out of range");
+        return kSE_OUT_OF_RANGE;
+    }
+
+    SE_layer_t *layer = &stack->layer[index];
+    layer->desc = *desc;
+    layer->start_ms = now_ms;
+    layer->from = (int32_t)desc->from << SE_CALIBRATION_FRAC_BITS;
+    layer->delta = (int32_t)(desc->to - desc->from) << SE_CALIBRATION_FRAC_BITS;
+    layer->value = layer->from;
+    layer->done = false;
+    stack->active |= 1u << index;
+    return kSE_SUCCESS;
+}
+
+SE_ret_t SE_layer_stop(SE_layer_stack_t *stack, uint8_t index)
+{
+    LAYER_VALIDATE(stack, index);
+    stack->active &= ~(1u << index);
+    return kSE_SUCCESS;
+}
+
+SE_ret_t SE_layer_set_weight(SE_layer_stack_t *stack, uint8_t index, uint16_t weight)
+{
+    LAYER_VALIDATE(stack, index);
+    if (weight > SE_LAYER_WEIGHT_ONE)
+    {
+        SE_set_error("Layer weight is out of range");
+        return kSE_OUT_OF_RANGE;
+    }
+
+    stack->layer[index].desc.weight = weight;
+    return kSE_SUCCESS;
+}
+
+/* A looping layer runs its ease forward then backward, a finished one keeps its end value
+ * without easing again */
+static int32_t _SE_layer_value(SE_layer_t *layer, uint32_t now_ms)
+{
+    if (layer->done)
+    {
+        return layer->value;
+    }
+
+    uint32_t duration = layer->desc.duration_ms;
+    uint32_t elapse = now_ms - layer->start_ms;
+    if (layer->desc.loop)
+    {
+        uint32_t phase = elapse % (2 * duration);
+        elapse = (phase < duration) ? phase : 2 * duration - phase;
+    }
+    else if (elapse >= duration)
+    {
+        elapse = duration;
+        layer->done = true;
+    }
+
+    int32_t percent = SE_algorithm_eval(layer->desc.easing_type, layer->desc.move_type, elapse, duration);
+    layer->value = layer->from + layer->delta * percent / 100;
+    return layer->value;
+}
+
+/* Bottom up over the active bits only, so an idle layer costs nothing */
+uint32_t SE_layer_eval(SE_layer_stack_t *stack, uint32_t now_ms)
+{
+    int32_t position = (int32_t)stack->base;
+    uint32_t active = stack->active;
+    while (active != 0)
+    {
+        uint8_t index = __builtin_ctz(active);
+        active &= active - 1;
+        SE_layer_t *layer = &stack->layer[index];
+        int32_t value = _SE_layer_value(layer, now_ms);
+        if (layer->desc.blend == eSE_LAYER_OVERRIDE)
+        {
+            position += ((value - position) * layer->desc.weight) >> SE_LAYER_WEIGHT_BITS;
+            continue;
+        }
+
+        position += (value * layer->desc.weight) >> SE_LAYER_WEIGHT_BITS;
+        if (layer->done && value == 0)
+        {
+            stack->active &= ~(1u << index);
+        }
+    }
+
+    if (position < 0)
+    {
+        return 0;
+    }
+    return (position > LAYER_MAX_POSITION) ? LAYER_MAX_POSITION : (uint32_t)position;
+}
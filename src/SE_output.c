@@ -0,0 +1,643 @@
+#include "SE_output.h"
+
+#include <stdbool.h>
+#include <string.h>
+
+#include "SE_def.h"
+#include "SE_controller.h"
+#include "SE_errors.h"
+#include "SE_logging.h"
+
+/* Channels staged during a frame, slot holds the index in servo_ids plus one */
+struct _se_output_frame
+{
+    uint8_t servo_ids[MAX_CONTROLLER_SERVO];
+    uint32_t duties[MAX_CONTROLLER_SERVO];
+    uint8_t slot[MAX_CONTROLLER_SERVO];
+    uint8_t count;
+};
+
+#ifdef USE_ASYNC_OUTPUT
+#include <errno.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <time.h>
+
+#define OUTPUT_SLOT_PENDING (1ULL << 32)
+#define OUTPUT_COUNT(channel, counter, n) atomic_fetch_add_explicit(&(channel)->counter, n, memory_order_relaxed)
+
+struct _se_output_channel
+{
+    atomic_uint_fast64_t slot;
+    atomic_uint published;
+    atomic_uint written;
+    atomic_uint dropped;
+    atomic_uint saved;
+};
+
+struct _se_output_latency_counter
+{
+    atomic_uint frames;
+    atomic_uint last_us;
+    atomic_uint max_us;
+    atomic_uint_fast64_t total_us;
+    atomic_uint deadline_missed;
+};
+
+/* Frames are numbered per writer: the commit bumps posted_generation, the writer thread
+ * publishes done_generation once the frame it picked up reached the controller */
+struct _se_output_writer
+{
+    struct SE_controller *controller;
+    struct _se_output_channel channel[MAX_CONTROLLER_SERVO];
+    struct _se_output_frame frame;
+    struct _se_output_latency_counter latency;
+    pthread_t thread;
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+    pthread_cond_t done_cond;
+    atomic_uint posted_generation;
+    atomic_uint done_generation;
+    atomic_uint_fast64_t posted_us;
+    atomic_bool pending;
+    atomic_bool running;
+    bool is_async;
+};
+#else
+#define OUTPUT_COUNT(channel, counter, n) ((channel)->counter += (n))
+
+struct _se_output_channel
+{
+    uint32_t published;
+    uint32_t written;
+    uint32_t dropped;
+    uint32_t saved;
+};
+
+struct _se_output_writer
+{
+    struct SE_controller *controller;
+    struct _se_output_channel channel[MAX_CONTROLLER_SERVO];
+    struct _se_output_frame frame;
+};
+#endif /*USE_ASYNC_OUTPUT*/
+
+static struct _se_output_writer output_writers[MAX_CONTROLLER] = {0};
+static bool output_in_frame = false;
+
+static struct _se_output_writer *_SE_output_get_writer(struct SE_controller *controller, uint8_t servo_id)
+{
+    if (controller == NULL)
+    {
+        SE_set_error("Controller is null");
+        return NULL;
+    }
+
+    uint8_t id = controller->get_info_ref(controller)->id;
+    if (id >= MAX_CONTROLLER || servo_id >= MAX_CONTROLLER_SERVO)
+    {
+        SE_set_error("Output channel is out of range");
+        return NULL;
+    }
+
+    return &output_writers[id];
+}
+
+static void _SE_output_stage(struct _se_output_writer *writer, uint8_t servo_id, uint32_t duty)
+{
+    struct _se_output_frame *frame = &writer->frame;
+    uint8_t slot = frame->slot[servo_id];
+    if (slot == 0)
+    {
+        frame->servo_ids[frame->count] = servo_id;
+        slot = ++frame->count;
+        frame->slot[servo_id] = slot;
+    }
+    else
+    {
+        /* Latest value of the frame wins */
+        OUTPUT_COUNT(&writer->channel[servo_id], dropped, 1);
+    }
+    frame->duties[slot - 1] = duty;
+}
+
+static void _SE_output_frame_reset(struct _se_output_frame *frame)
+{
+    for (int i = 0; i < frame->count; i++)
+    {
+        frame->slot[frame->servo_ids[i]] = 0;
+    }
+    frame->count = 0;
+}
+
+static SE_ret_t _SE_output_write_frame(struct _se_output_writer *writer, const uint8_t *servo_ids,
+                                       const uint32_t *duties, size_t count)
+{
+    SE_ret_t ret = SE_controller_set_duty_batch(writer->controller, servo_ids, duties, count);
+    for (size_t i = 0; i < count; i++)
+    {
+        OUTPUT_COUNT(&writer->channel[servo_ids[i]], written, 1);
+    }
+    return ret;
+}
+
+void SE_output_record_saved(struct SE_controller *controller, uint8_t servo_id)
+{
+    struct _se_output_writer *writer = _SE_output_get_writer(controller, servo_id);
+    if (writer != NULL)
+    {
+        OUTPUT_COUNT(&writer->channel[servo_id], saved, 1);
+    }
+}
+
+void SE_output_frame_begin(void)
+{
+    output_in_frame = true;
+}
+
+#ifdef USE_ASYNC_OUTPUT
+static uint32_t output_frame_deadline_us = 0;
+
+static void _SE_output_drain(struct _se_output_writer *writer)
+{
+    uint8_t servo_ids[MAX_CONTROLLER_SERVO];
+    uint32_t duties[MAX_CONTROLLER_SERVO];
+    size_t count = 0;
+    for (int i = 0; i < MAX_CONTROLLER_SERVO; i++)
+    {
+        uint64_t slot = atomic_exchange_explicit(&writer->channel[i].slot, 0, memory_order_acquire);
+        if (slot & OUTPUT_SLOT_PENDING)
+        {
+            servo_ids[count] = i;
+            duties[count] = (uint32_t)slot;
+            count++;
+        }
+    }
+
+    if (count > 0)
+    {
+        _SE_output_write_frame(writer, servo_ids, duties, count);
+    }
+}
+
+static uint64_t _SE_output_now_us(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+static void _SE_output_frame_done(struct _se_output_writer *writer, unsigned int generation, uint64_t posted_us)
+{
+    if (generation == atomic_load_explicit(&writer->done_generation, memory_order_relaxed))
+    {
+        return;
+    }
+
+    /* Latency runs from the newest commit this drain covered to the end of the batch write */
+    struct _se_output_latency_counter *latency = &writer->latency;
+    uint32_t elapse_us = (uint32_t)(_SE_output_now_us() - posted_us);
+    atomic_fetch_add_explicit(&latency->frames, 1, memory_order_relaxed);
+    atomic_fetch_add_explicit(&latency->total_us, elapse_us, memory_order_relaxed);
+    atomic_store_explicit(&latency->last_us, elapse_us, memory_order_relaxed);
+    if (elapse_us > atomic_load_explicit(&latency->max_us, memory_order_relaxed))
+    {
+        atomic_store_explicit(&latency->max_us, elapse_us, memory_order_relaxed);
+    }
+
+    pthread_mutex_lock(&writer->lock);
+    atomic_store_explicit(&writer->done_generation, generation, memory_order_release);
+    pthread_cond_broadcast(&writer->done_cond);
+    pthread_mutex_unlock(&writer->lock);
+}
+
+static void *_SE_output_writer_thread(void *arg)
+{
+    struct _se_output_writer *writer = (struct _se_output_writer *)arg;
+    while (atomic_load(&writer->running))
+    {
+        pthread_mutex_lock(&writer->lock);
+        while (!atomic_load(&writer->pending) && atomic_load(&writer->running))
+        {
+            pthread_cond_wait(&writer->cond, &writer->lock);
+        }
+        pthread_mutex_unlock(&writer->lock);
+
+        atomic_store(&writer->pending, false);
+        unsigned int generation = atomic_load_explicit(&writer->posted_generation, memory_order_acquire);
+        uint64_t posted_us = atomic_load_explicit(&writer->posted_us, memory_order_relaxed);
+        _SE_output_drain(writer);
+        _SE_output_frame_done(writer, generation, posted_us);
+    }
+    return NULL;
+}
+
+static void _SE_output_wakeup(struct _se_output_writer *writer)
+{
+    pthread_mutex_lock(&writer->lock);
+    pthread_cond_signal(&writer->cond);
+    pthread_mutex_unlock(&writer->lock);
+}
+
+static void _SE_output_post(struct _se_output_writer *writer, uint8_t servo_id, uint32_t duty)
+{
+    struct _se_output_channel *channel = &writer->channel[servo_id];
+    uint64_t previous = atomic_exchange_explicit(&channel->slot, OUTPUT_SLOT_PENDING | duty, memory_order_release);
+    if (previous & OUTPUT_SLOT_PENDING)
+    {
+        OUTPUT_COUNT(channel, dropped, 1);
+    }
+}
+
+SE_ret_t SE_output_set_duty(struct SE_controller *controller, uint8_t servo_id, uint32_t duty)
+{
+    struct _se_output_writer *writer = _SE_output_get_writer(controller, servo_id);
+    if (writer == NULL)
+    {
+        return kSE_OUT_OF_RANGE;
+    }
+
+    struct _se_output_channel *channel = &writer->channel[servo_id];
+    OUTPUT_COUNT(channel, published, 1);
+    if (output_in_frame)
+    {
+        if (writer->controller != controller)
+        {
+            writer->controller = controller;
+        }
+        _SE_output_stage(writer, servo_id, duty);
+        return kSE_SUCCESS;
+    }
+
+    if (!writer->is_async)
+    {
+        SE_ret_t ret = controller->set_duty(controller, servo_id, duty);
+        OUTPUT_COUNT(channel, written, 1);
+        return ret;
+    }
+
+    _SE_output_post(writer, servo_id, duty);
+    if (!atomic_exchange(&writer->pending, true))
+    {
+        _SE_output_wakeup(writer);
+    }
+    return kSE_SUCCESS;
+}
+
+/* A staged frame goes to the hardware in one batch. Async controllers get their frame
+ * posted first so their writer threads run while the synchronous ones are written here. */
+SE_ret_t SE_output_frame_commit(void)
+{
+    SE_ret_t ret = kSE_SUCCESS;
+    output_in_frame = false;
+    uint64_t commit_us = _SE_output_now_us();
+    for (int i = 0; i < MAX_CONTROLLER; i++)
+    {
+        struct _se_output_writer *writer = &output_writers[i];
+        struct _se_output_frame *frame = &writer->frame;
+        if (frame->count == 0 || !writer->is_async)
+        {
+            continue;
+        }
+
+        for (int j = 0; j < frame->count; j++)
+        {
+            _SE_output_post(writer, frame->servo_ids[j], frame->duties[j]);
+        }
+        atomic_store_explicit(&writer->posted_us, commit_us, memory_order_relaxed);
+        atomic_fetch_add_explicit(&writer->posted_generation, 1, memory_order_release);
+        if (!atomic_exchange(&writer->pending, true))
+        {
+            _SE_output_wakeup(writer);
+        }
+        _SE_output_frame_reset(frame);
+    }
+
+    for (int i = 0; i < MAX_CONTROLLER; i++)
+    {
+        struct _se_output_writer *writer = &output_writers[i];
+        struct _se_output_frame *frame = &writer->frame;
+        if (frame->count == 0)
+        {
+            continue;
+        }
+
+        SE_ret_t frame_ret = _SE_output_write_frame(writer, frame->servo_ids, frame->duties, frame->count);
+        if (ret == kSE_SUCCESS)
+        {
+            ret = frame_ret;
+        }
+        _SE_output_frame_reset(frame);
+    }
+
+    if (output_frame_deadline_us > 0)
+    {
+        SE_ret_t wait_ret = SE_output_frame_wait(output_frame_deadline_us);
+        if (ret == kSE_SUCCESS)
+        {
+            ret = wait_ret;
+        }
+    }
+    return ret;
+}
+
+void SE_output_set_frame_deadline(uint32_t deadline_us)
+{
+    output_frame_deadline_us = deadline_us;
+}
+
+/* Barrier over every async writer with a shared deadline. A writer that misses it keeps
+ * writing in the background, newer frames simply replace what it has not picked up yet. */
+SE_ret_t SE_output_frame_wait(uint32_t timeout_us)
+{
+    struct timespec deadline;
+    clock_gettime(CLOCK_MONOTONIC, &deadline);
+    deadline.tv_sec += timeout_us / 1000000;
+    deadline.tv_nsec += (long)(timeout_us % 1000000) * 1000;
+    if (deadline.tv_nsec >= 1000000000)
+    {
+        deadline.tv_nsec -= 1000000000;
+        deadline.tv_sec++;
+    }
+
+    SE_ret_t ret = kSE_SUCCESS;
+    for (int i = 0; i < MAX_CONTROLLER; i++)
+    {
+        struct _se_output_writer *writer = &output_writers[i];
+        if (!writer->is_async)
+        {
+            continue;
+        }
+
+        unsigned int target = atomic_load_explicit(&writer->posted_generation, memory_order_relaxed);
+        pthread_mutex_lock(&writer->lock);
+        while ((int)(atomic_load(&writer->done_generation) - target) < 0)
+        {
+            if (pthread_cond_timedwait(&writer->done_cond, &writer->lock, &deadline) == ETIMEDOUT)
+            {
+                break;
+            }
+        }
+        bool missed = (int)(atomic_load(&writer->done_generation) - target) < 0;
+        pthread_mutex_unlock(&writer->lock);
+
+        if (missed)
+        {
+            atomic_fetch_add_explicit(&writer->latency.deadline_missed, 1, memory_order_relaxed);
+            SE_WARNING("Controller %s missed the frame deadline", writer->controller->get_info_ref(writer->controller)->name);
+            SE_set_error("Controller missed the frame deadline");
+            ret = kSE_TIMEOUT;
+        }
+    }
+    return ret;
+}
+
+SE_ret_t SE_output_get_latency(struct SE_controller *controller, SE_output_latency_t *latency)
+{
+    if (latency == NULL)
+    {
+        SE_set_error("Latency output is null");
+        return kSE_NULL;
+    }
+
+    struct _se_output_writer *writer = _SE_output_get_writer(controller, 0);
+    if (writer == NULL)
+    {
+        return kSE_OUT_OF_RANGE;
+    }
+
+    latency->frames = atomic_load_explicit(&writer->latency.frames, memory_order_relaxed);
+    latency->last_us = atomic_load_explicit(&writer->latency.last_us, memory_order_relaxed);
+    latency->max_us = atomic_load_explicit(&writer->latency.max_us, memory_order_relaxed);
+    latency->average_us = latency->frames ? atomic_load_explicit(&writer->latency.total_us, memory_order_relaxed) /
+                                                latency->frames
+                                          : 0;
+    latency->deadline_missed = atomic_load_explicit(&writer->latency.deadline_missed, memory_order_relaxed);
+    return kSE_SUCCESS;
+}
+
+SE_ret_t SE_output_start_async(struct SE_controller *controller)
+{
+    struct _se_output_writer *writer = _SE_output_get_writer(controller, 0);
+    if (writer == NULL)
+    {
+        return kSE_NULL;
+    }
+
+    if (writer->is_async)
+    {
+        return kSE_SUCCESS;
+    }
+
+    writer->controller = controller;
+    atomic_store(&writer->pending, false);
+    atomic_store(&writer->running, true);
+    atomic_store(&writer->done_generation, atomic_load(&writer->posted_generation));
+    pthread_mutex_init(&writer->lock, NULL);
+    pthread_cond_init(&writer->cond, NULL);
+    pthread_condattr_t done_attr;
+    pthread_condattr_init(&done_attr);
+    pthread_condattr_setclock(&done_attr, CLOCK_MONOTONIC);
+    pthread_cond_init(&writer->done_cond, &done_attr);
+    pthread_condattr_destroy(&done_attr);
+    if (pthread_create(&writer->thread, NULL, _SE_output_writer_thread, writer) != 0)
+    {
+        SE_set_error("Unable to create output writer thread");
+        SE_ERROR("Unable to create writer thread for controller %s", controller->get_info_ref(controller)->name);
+        atomic_store(&writer->running, false);
+        pthread_cond_destroy(&writer->done_cond);
+        pthread_cond_destroy(&writer->cond);
+        pthread_mutex_destroy(&writer->lock);
+        return kSE_FAILED;
+    }
+
+    writer->is_async = true;
+    return kSE_SUCCESS;
+}
+
+void SE_output_stop_async(struct SE_controller *controller)
+{
+    struct _se_output_writer *writer = _SE_output_get_writer(controller, 0);
+    if (writer == NULL || !writer->is_async)
+    {
+        return;
+    }
+
+    atomic_store(&writer->running, false);
+    _SE_output_wakeup(writer);
+    pthread_join(writer->thread, NULL);
+    writer->is_async = false;
+
+    /* Latest values published after the last wakeup still reach the hardware */
+    _SE_output_drain(writer);
+    atomic_store(&writer->done_generation, atomic_load(&writer->posted_generation));
+    pthread_cond_destroy(&writer->done_cond);
+    pthread_cond_destroy(&writer->cond);
+    pthread_mutex_destroy(&writer->lock);
+}
+
+/* One writer thread for every registered controller. All or nothing: when one writer fails,
+ * the writers started by this call are stopped again, those already running are kept. */
+SE_ret_t SE_output_start_async_all(void)
+{
+    bool started[MAX_CONTROLLER] = {false};
+    for (int i = 0; i < MAX_CONTROLLER; i++)
+    {
+        struct SE_controller *controller = SE_controller_get(i);
+        if (controller == NULL || _SE_output_get_writer(controller, 0)->is_async)
+        {
+            continue;
+        }
+
+        SE_ret_t ret = SE_output_start_async(controller);
+        if (ret != kSE_SUCCESS)
+        {
+            for (int j = 0; j < i; j++)
+            {
+                if (started[j])
+                {
+                    SE_output_stop_async(SE_controller_get(j));
+                }
+            }
+            return ret;
+        }
+        started[i] = true;
+    }
+    return kSE_SUCCESS;
+}
+
+void SE_output_stop_async_all(void)
+{
+    for (int i = 0; i < MAX_CONTROLLER; i++)
+    {
+        struct SE_controller *controller = SE_controller_get(i);
+        if (controller != NULL)
+        {
+            SE_output_stop_async(controller);
+        }
+    }
+}
+
+SE_ret_t SE_output_get_stats(struct SE_controller *controller, uint8_t servo_id, SE_output_stats_t *stats)
+{
+    if (stats == NULL)
+    {
+        SE_set_error("Stats output is null");
+        return kSE_NULL;
+    }
+
+    struct _se_output_writer *writer = _SE_output_get_writer(controller, servo_id);
+    if (writer == NULL)
+    {
+        return kSE_OUT_OF_RANGE;
+    }
+
+    struct _se_output_channel *channel = &writer->channel[servo_id];
+    stats->published = atomic_load_explicit(&channel->published, memory_order_relaxed);
+    stats->written = atomic_load_explicit(&channel->written, memory_order_relaxed);
+    stats->dropped = atomic_load_explicit(&channel->dropped, memory_order_relaxed);
+    stats->saved = atomic_load_explicit(&channel->saved, memory_order_relaxed);
+    return kSE_SUCCESS;
+}
+#else
+SE_ret_t SE_output_set_duty(struct SE_controller *controller, uint8_t servo_id, uint32_t duty)
+{
+    struct _se_output_writer *writer = _SE_output_get_writer(controller, servo_id);
+    if (writer == NULL)
+    {
+        return kSE_OUT_OF_RANGE;
+    }
+
+    writer->channel[servo_id].published++;
+    if (output_in_frame)
+    {
+        writer->controller = controller;
+        _SE_output_stage(writer, servo_id, duty);
+        return kSE_SUCCESS;
+    }
+
+    SE_ret_t ret = controller->set_duty(controller, servo_id, duty);
+    writer->channel[servo_id].written++;
+    return ret;
+}
+
+SE_ret_t SE_output_frame_commit(void)
+{
+    SE_ret_t ret = kSE_SUCCESS;
+    output_in_frame = false;
+    for (int i = 0; i < MAX_CONTROLLER; i++)
+    {
+        struct _se_output_writer *writer = &output_writers[i];
+        if (writer->frame.count == 0)
+        {
+            continue;
+        }
+
+        SE_ret_t frame_ret = _SE_output_write_frame(writer, writer->frame.servo_ids, writer->frame.duties,
+                                                    writer->frame.count);
+        if (ret == kSE_SUCCESS)
+        {
+            ret = frame_ret;
+        }
+        _SE_output_frame_reset(&writer->frame);
+    }
+    return ret;
+}
+
+void SE_output_set_frame_deadline(uint32_t deadline_us)
+{
+}
+
+/* Frames are written during the commit, nothing is left to wait for */
+SE_ret_t SE_output_frame_wait(uint32_t timeout_us)
+{
+    return kSE_SUCCESS;
+}
+
+SE_ret_t SE_output_get_latency(struct SE_controller *controller, SE_output_latency_t *latency)
+{
+    SE_set_error("Async output is disabled in this build");
+    return kSE_NOT_SUPPORTED;
+}
+
+SE_ret_t SE_output_start_async(struct SE_controller *controller)
+{
+    SE_set_error("Async output is disabled in this build");
+    return kSE_NOT_SUPPORTED;
+}
+
+void SE_output_stop_async(struct SE_controller *controller)
+{
+}
+
+SE_ret_t SE_output_start_async_all(void)
+{
+    SE_set_error("Async output is disabled in this build");
+    return kSE_NOT_SUPPORTED;
+}
+
+void SE_output_stop_async_all(void)
+{
+}
+
+SE_ret_t SE_output_get_stats(struct SE_controller *controller, uint8_t servo_id, SE_output_stats_t *stats)
+{
+    if (stats == NULL)
+    {
+        SE_set_error("Stats output is null");
+        return kSE_NULL;
+    }
+
+    struct _se_output_writer *writer = _SE_output_get_writer(controller, servo_id);
+    if (writer == NULL)
+    {
+        return kSE_OUT_OF_RANGE;
+    }
+
+    stats->published = writer->channel[servo_id].published;
+    stats->written = writer->channel[servo_id].written;
+    stats->dropped = writer->channel[servo_id].dropped;
+    stats->saved = writer->channel[servo_id].saved;
+    return kSE_SUCCESS;
+}
+#endif /*USE_ASYNC_OUTPUT*/
@@ -0,0 +1,160 @@
+#include "SE_path.h"
+
+#include <stdbool.h>
+
+#include "SE_calibration.h"
+#include "SE_errors.h"
+#include "SE_logging.h"
+#include "SE_math.h"
+
+#define US_PER_S 1000000LL
+#define PATH_MAX_ANGLE 180
+
+/* Positions are degrees with SE_CALIBRATION_FRAC_BITS of fraction, velocities the same per
+ * second and accelerations per second squared */
+struct _se_path_point
+{
+    int64_t position;
+    int64_t speed;
+    int8_t direction;
+};
+
+struct _se_path_builder
+{
+    SE_track_node_t node[SE_TRACK_MAX_KEYS];
+    uint8_t count;
+    /* The last node is a waypoint, the track must pass it */
+    bool pinned;
+    int64_t elapse_us;
+};
+
+/* Node times are rounded from the exact elapse, so rounding never adds up over the path. A phase
+ * shorter than half a ms lands on the time of the node before it: a waypoint wins over a phase
+ * node, otherwise the later node replaces the earlier one. */
+static void _SE_path_add_node(struct _se_path_builder *builder, int64_t phase_us, int64_t position, int64_t velocity,
+                              bool waypoint)
+{
+    builder->elapse_us += phase_us;
+    uint32_t time_ms = (uint32_t)((builder->elapse_us + 500) / 1000);
+    if (builder->count > 0 && builder->node[builder->count - 1].time_ms >= time_ms)
+    {
+        if (builder->pinned && !waypoint)
+        {
+            return;
+        }
+        builder->count--;
+        time_ms = (builder->count == 0) ? 0 : time_ms;
+    }
+
+    SE_track_node_t *node = &builder->node[builder->count++];
+    node->time_ms = time_ms;
+    node->position = (uint32_t)position;
+    node->velocity = (int32_t)velocity;
+    builder->pinned = waypoint;
+}
+
+/* Fastest speed profile from entry to exit over the distance: speed up to the peak, cruise if
+ * the peak is capped, slow down. The passes before guarantee the exit is reachable. */
+static void _SE_path_add_interval(struct _se_path_builder *builder, const struct _se_path_point *from,
+                                  const struct _se_path_point *to, int64_t v, int64_t a)
+{
+    int64_t distance = (to->position > from->position) ? to->position - from->position
+                                                        : from->position - to->position;
+    int8_t direction = from->direction;
+    int64_t u = from->speed;
+    int64_t w = to->speed;
+    int64_t peak = (int64_t)SE_sqrt64((uint64_t)((2 * a * distance + u * u + w * w) / 2));
+    peak = (peak > v) ? v : peak;
+    peak = (peak < u) ? u : peak;
+    peak = (peak < w) ? w : peak;
+
+    int64_t accel_distance = (peak * peak - u * u) / (2 * a);
+    int64_t decel_distance = (peak * peak - w * w) / (2 * a);
+    int64_t cruise_distance = distance - accel_distance - decel_distance;
+    cruise_distance = (cruise_distance < 0) ? 0 : cruise_distance;
+
+    int64_t position = from->position + direction * accel_distance;
+    _SE_path_add_node(builder, (peak - u) * US_PER_S / a, position, direction * peak, false);
+    if (cruise_distance > 0)
+    {
+        position += direction * cruise_distance;
+        _SE_path_add_node(builder, cruise_distance * US_PER_S / peak, position, direction * peak, false);
+    }
+    _SE_path_add_node(builder, (peak - w) * US_PER_S / a, to->position, direction * w, true);
+}
+
+SE_ret_t SE_path_plan(SE_track_t *track, const uint8_t *waypoints, uint8_t count, const SE_profile_limits_t *limits)
+{
+    if (track == NULL || waypoints == NULL || limits == NULL)
+    {
+        SE_set_error("Track, waypoints or limits is null");
+        return kSE_NULL;
+    }
+
+    if (count < 2 || count > SE_PATH_MAX_WAYPOINTS || limits->max_velocity == 0 || limits->max_acceleration == 0)
+    {
+        SE_set_error("Path needs 2 to SE_PATH_MAX_WAYPOINTS waypoints and both limits");
+        return kSE_OUT_OF_RANGE;
+    }
+
+    /* Repeated waypoints add nothing to the path */
+    struct _se_path_point point[SE_PATH_MAX_WAYPOINTS];
+    uint8_t points = 0;
+    for (uint8_t i = 0; i < count; i++)
+    {
+        if (waypoints[i] > PATH_MAX_ANGLE)
+        {
+            SE_set_error("Path waypoint is out of range");
+            return kSE_OUT_OF_RANGE;
+        }
+
+        int64_t position = (int64_t)waypoints[i] << SE_CALIBRATION_FRAC_BITS;
+        if (points == 0 || point[points - 1].position != position)
+        {
+            point[points++] = (struct _se_path_point){.position = position};
+        }
+    }
+
+    if (points < 2)
+    {
+        SE_set_error("Path does not move");
+        return kSE_OUT_OF_RANGE;
+    }
+
+    /* Rest at both ends and wherever the path turns back, full speed elsewhere until the
+     * backward then forward pass lower each speed to what braking and speeding up allow */
+    int64_t v = (int64_t)limits->max_velocity << SE_CALIBRATION_FRAC_BITS;
+    int64_t a = (int64_t)limits->max_acceleration << SE_CALIBRATION_FRAC_BITS;
+    for (uint8_t i = 0; i < points - 1; i++)
+    {
+        point[i].direction = (point[i + 1].position > point[i].position) ? 1 : -1;
+        bool turns = i > 0 && point[i].direction != point[i - 1].direction;
+        point[i].speed = (i == 0 || turns) ? 0 : v;
+    }
+    point[points - 1].speed = 0;
+
+    for (int i = points - 2; i >= 0; i--)
+    {
+        int64_t distance = (point[i + 1].position - point[i].position) * point[i].direction;
+        int64_t reach = (int64_t)SE_sqrt64((uint64_t)(point[i + 1].speed * point[i + 1].speed + 2 * a * distance));
+        point[i].speed = (reach < point[i].speed) ? reach : point[i].speed;
+    }
+
+    for (uint8_t i = 0; i < points - 1; i++)
+    {
+        int64_t distance = (point[i + 1].position - point[i].position) * point[i].direction;
+        int64_t reach = (int64_t)SE_sqrt64((uint64_t)(point[i].speed * point[i].speed + 2 * a * distance));
+        point[i + 1].speed = (reach < point[i + 1].speed) ? reach : point[i + 1].speed;
+    }
+
+    struct _se_path_builder builder = {0};
+    _SE_path_add_node(&builder, 0, point[0].position, 0, true);
+    for (uint8_t i = 0; i < points - 1; i++)
+    {
+        _SE_path_add_interval(&builder, &point[i], &point[i + 1], v, a);
+    }
+
+    SE_DEBUG("Path through %d waypoints takes %d ms in %d segments", points,
+             builder.node[builder.count - 1].time_ms, builder.count - 1);
+    return SE_track_load_nodes(track, builder.node, builder.count);
+}
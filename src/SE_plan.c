@@ -0,0 +1,89 @@
+#include "SE_plan.h"
+
+#include "SE_algorithm.h"
+#include "SE_calibration.h"
+#include "SE_errors.h"
+
+#define PLAN_MAX_POSITION (180 << SE_CALIBRATION_FRAC_BITS)
+
+static inline uint32_t _SE_plan_clamp(int32_t position)
+{
+    if (position < 0)
+    {
+        return 0;
+    }
+    return (position > PLAN_MAX_POSITION) ? PLAN_MAX_POSITION : (uint32_t)position;
+}
+
+/* Offset truncates toward zero like the engine does for both directions */
+static inline uint32_t _SE_plan_at(const SE_plan_t *plan, uint32_t elapse_ms)
+{
+    if (elapse_ms >= plan->duration_ms)
+    {
+        return _SE_plan_clamp((int32_t)plan->start_position + plan->delta_position);
+    }
+
+    int32_t percent = SE_algorithm_eval(plan->easing_type, plan->move_type, elapse_ms, plan->duration_ms);
+    return _SE_plan_clamp((int32_t)plan->start_position + plan->delta_position * percent / 100);
+}
+
+static inline uint32_t _SE_plan_elapse(uint32_t start_ms, uint32_t time_ms)
+{
+    int32_t elapse = (int32_t)(time_ms - start_ms);
+    return (elapse < 0) ? 0 : (uint32_t)elapse;
+}
+
+uint32_t SE_plan_eval(const SE_plan_t *plan, uint32_t time_ms)
+{
+    if (plan == NULL)
+    {
+        SE_set_error("Plan is null");
+        return 0;
+    }
+    return _SE_plan_at(plan, _SE_plan_elapse(plan->start_ms, time_ms));
+}
+
+/* The plan invariants are hoisted out of the time loop. The first pass turns the times into
+ * clamped elapses with no branch, which the compiler vectorizes. The second only eases the
+ * samples inside the move, the held ends are filled without an easing call. */
+SE_ret_t SE_plan_eval_batch(const SE_plan_t *plans, uint16_t plan_count, const uint32_t *times_ms,
+                            uint16_t time_count, uint32_t *positions)
+{
+    if (plans == NULL || times_ms == NULL || positions == NULL)
+    {
+        SE_set_error("Plans, times or positions are null");
+        return kSE_NULL;
+    }
+
+    for (uint16_t p = 0; p < plan_count; p++)
+    {
+        const SE_plan_t *plan = &plans[p];
+        uint32_t *row = &positions[(uint32_t)p * time_count];
+        uint32_t start_ms = plan->start_ms;
+        uint32_t duration_ms = plan->duration_ms;
+        uint32_t inside = 0;
+        for (uint16_t k = 0; k < time_count; k++)
+        {
+            int32_t elapse = (int32_t)(times_ms[k] - start_ms);
+            elapse = (elapse < 0) ? 0 : elapse;
+            row[k] = ((uint32_t)elapse > duration_ms) ? duration_ms : (uint32_t)elapse;
+            inside |= duration_ms - row[k];
+        }
+
+        uint32_t end = _SE_plan_clamp((int32_t)plan->start_position + plan->delta_position);
+        if (inside == 0)
+        {
+            for (uint16_t k = 0; k < time_count; k++)
+            {
+                row[k] = end;
+            }
+            continue;
+        }
+
+        for (uint16_t k = 0; k < time_count; k++)
+        {
+            row[k] = (row[k] == duration_ms) ? end : _SE_plan_at(plan, row[k]);
+        }
+    }
+    return kSE_SUCCESS;
+}
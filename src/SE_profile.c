@@ -0,0 +1,193 @@
+#include "SE_profile.h"
+
+#include <stddef.h>
+
+#include "SE_calibration.h"
+#include "SE_errors.h"
+#include "SE_logging.h"
+#include "SE_math.h"
+
+/* Profiles are planned in us and run in ms, the same integer code serves both algorithm builds */
+#define US_PER_S 1000000ULL
+#define US2_PER_S2 1000000000000ULL
+#define POSITION_SCALE (1ULL << SE_CALIBRATION_FRAC_BITS)
+#define PROFILE_SCALE_BITS 40
+
+static uint64_t _SE_profile_cbrt(uint64_t value)
+{
+    uint64_t root = 0;
+    for (int shift = 63; shift >= 0; shift -= 3)
+    {
+        root <<= 1;
+        uint64_t next = 3 * root * (root + 1) + 1;
+        if ((value >> shift) >= next)
+        {
+            value -= next << shift;
+            root++;
+        }
+    }
+    return root;
+}
+
+static uint32_t _SE_profile_ceil_ms(uint64_t us)
+{
+    return (uint32_t)((us + 999) / 1000);
+}
+
+/* Six times the distance covered after t ms of the speed up phase, for a unit jerk or a unit
+ * acceleration when there is no jerk phase */
+static int64_t _SE_profile_accel_phase(const SE_profile_t *profile, int64_t t)
+{
+    int64_t tj = profile->jerk_ms;
+    int64_t ta = profile->accel_ms;
+    if (tj == 0)
+    {
+        return 3 * t * t;
+    }
+
+    if (t < tj)
+    {
+        return t * t * t;
+    }
+
+    if (t < ta - tj)
+    {
+        int64_t d = t - tj;
+        return tj * tj * tj + 3 * tj * tj * d + 3 * tj * d * d;
+    }
+
+    /* The speed up is symmetric, the last ramp mirrors the first one */
+    int64_t tau = ta - t;
+    return 3 * profile->peak * ta - 6 * profile->peak * tau + tau * tau * tau;
+}
+
+/* Continuous phase lengths in us for the limits, max_jerk 0 gives no jerk phase */
+static void _SE_profile_phases(const SE_profile_limits_t *limits, uint64_t distance, uint64_t *tj, uint64_t *ta,
+                               uint64_t *tv)
+{
+    uint64_t v = limits->max_velocity;
+    uint64_t a = limits->max_acceleration;
+    uint64_t j = limits->max_jerk;
+    *tj = (j == 0) ? 0 : US_PER_S * a / j;
+    if (j == 0 || *tj == 0)
+    {
+        *tj = 0;
+        *ta = US_PER_S * v / a;
+        if (distance * a >= POSITION_SCALE * v * v)
+        {
+            *tv = US_PER_S * distance / (POSITION_SCALE * v) - *ta;
+            return;
+        }
+        *ta = SE_sqrt64(US2_PER_S2 * distance / (POSITION_SCALE * a));
+        *tv = 0;
+        return;
+    }
+
+    if (v * j >= a * a)
+    {
+        *ta = *tj + US_PER_S * v / a;
+    }
+    else
+    {
+        /* Max speed comes before max acceleration */
+        *tj = SE_sqrt64(US2_PER_S2 * v / j);
+        *ta = 2 * *tj;
+    }
+
+    if (distance * US_PER_S >= POSITION_SCALE * v * *ta)
+    {
+        *tv = US_PER_S * distance / (POSITION_SCALE * v) - *ta;
+        return;
+    }
+
+    /* Too short to cruise: reach max acceleration if there is room, else only ramp the jerk */
+    *tv = 0;
+    *tj = US_PER_S * a / j;
+    *ta = *tj / 2 + SE_sqrt64(*tj * *tj / 4 + US2_PER_S2 * distance / (POSITION_SCALE * a));
+    if (*ta < 2 * *tj)
+    {
+        /* cube root in units of 10 us keeps the operand within 64 bits */
+        *tj = 10 * _SE_profile_cbrt(1000000000000000ULL / (2 * POSITION_SCALE) * distance / j);
+        *ta = 2 * *tj;
+    }
+}
+
+SE_ret_t SE_profile_plan(SE_profile_t *profile, const SE_profile_limits_t *limits, uint32_t distance)
+{
+    if (profile == NULL || limits == NULL)
+    {
+        SE_set_error("Profile or limits is null");
+        return kSE_NULL;
+    }
+
+    if (limits->max_velocity == 0 || limits->max_acceleration == 0)
+    {
+        SE_set_error("Profile needs a velocity and an acceleration limit");
+        return kSE_OUT_OF_RANGE;
+    }
+
+    *profile = (SE_profile_t){.distance = distance};
+    if (distance == 0)
+    {
+        return kSE_SUCCESS;
+    }
+
+    uint64_t tj_us = 0;
+    uint64_t ta_us = 0;
+    uint64_t tv_us = 0;
+    _SE_profile_phases(limits, distance, &tj_us, &ta_us, &tv_us);
+
+    /* Rounding every phase up only stretches the move, the scale below brings the distance back */
+    profile->jerk_ms = _SE_profile_ceil_ms(tj_us);
+    if (profile->jerk_ms > 0)
+    {
+        profile->accel_ms = 2 * profile->jerk_ms + _SE_profile_ceil_ms(ta_us - 2 * tj_us);
+        profile->peak = (int64_t)profile->jerk_ms * (profile->accel_ms - profile->jerk_ms);
+    }
+    else
+    {
+        profile->accel_ms = _SE_profile_ceil_ms(ta_us);
+        profile->accel_ms = (profile->accel_ms == 0) ? 1 : profile->accel_ms;
+        profile->peak = profile->accel_ms;
+    }
+    profile->cruise_ms = _SE_profile_ceil_ms(tv_us);
+    uint64_t duration_ms = 2ULL * profile->accel_ms + profile->cruise_ms;
+    if (duration_ms > SE_PROFILE_MAX_DURATION_MS)
+    {
+        SE_set_error("Profile is longer than the supported duration");
+        return kSE_OUT_OF_RANGE;
+    }
+
+    profile->duration_ms = (uint32_t)duration_ms;
+    profile->scale = 6 * profile->peak * (profile->accel_ms + profile->cruise_ms);
+    while ((profile->scale >> profile->shift) >= (1LL << PROFILE_SCALE_BITS))
+    {
+        profile->shift++;
+    }
+    SE_DEBUG("Profile over %u: jerk %u ms, accel %u ms, cruise %u ms", distance, profile->jerk_ms, profile->accel_ms,
+             profile->cruise_ms);
+    return kSE_SUCCESS;
+}
+
+uint32_t SE_profile_eval(const SE_profile_t *profile, uint32_t time_ms)
+{
+    if (time_ms >= profile->duration_ms)
+    {
+        return profile->distance;
+    }
+
+    int64_t covered = 0;
+    if (time_ms <= profile->accel_ms)
+    {
+        covered = _SE_profile_accel_phase(profile, time_ms);
+    }
+    else if (time_ms <= profile->accel_ms + profile->cruise_ms)
+    {
+        covered = 3 * profile->peak * profile->accel_ms + 6 * profile->peak * (time_ms - profile->accel_ms);
+    }
+    else
+    {
+        covered = profile->scale - _SE_profile_accel_phase(profile, profile->duration_ms - time_ms);
+    }
+    return (uint32_t)((int64_t)profile->distance * (covered >> profile->shift) / (profile->scale >> profile->shift));
+}
@@ -0,0 +1,192 @@
+#define _GNU_SOURCE
+#include "SE_pwmchip.h"
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <dirent.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "SE_errors.h"
+#include "SE_logging.h"
+
+#define PWMCHIP_PATH_LEN 128
+#define PWMCHIP_COMPATIBLE_LEN 128
+
+struct _se_pwmchip_entry
+{
+    char dev_path[PWMCHIP_PATH_LEN];
+    char compatible[PWMCHIP_COMPATIBLE_LEN];
+    int compatible_len;
+};
+
+struct _se_pwmchip_cache
+{
+    struct _se_pwmchip_entry entry[MAX_PWMCHIP];
+    int count;
+    bool is_scanned;
+    char root[PWMCHIP_PATH_LEN];
+};
+
+static struct _se_pwmchip_cache pwmchip_cache = {
+    .count = 0,
+    .is_scanned = false,
+    .root = PWMCHIP_SYSFS_ROOT,
+};
+
+static int _SE_pwmchip_compare(const void *a, const void *b)
+{
+    const struct _se_pwmchip_entry *entry_a = (const struct _se_pwmchip_entry *)a;
+    const struct _se_pwmchip_entry *entry_b = (const struct _se_pwmchip_entry *)b;
+    return strverscmp(entry_a->dev_path, entry_b->dev_path);
+}
+
+static bool _SE_pwmchip_read_compatible(struct _se_pwmchip_entry *entry)
+{
+    char file_name[PWMCHIP_PATH_LEN + 32] = {'\0'};
+    snprintf(file_name, sizeof(file_name), "%s/device/of_node/compatible", entry->dev_path);
+    int fd = open(file_name, O_RDONLY);
+    if (fd < 0)
+    {
+        SE_DEBUG("Unable to open device name %s, ignore", file_name);
+        return false;
+    }
+
+    ssize_t num_byte = read(fd, entry->compatible, PWMCHIP_COMPATIBLE_LEN - 1);
+    close(fd);
+    if (num_byte <= 0)
+    {
+        return false;
+    }
+
+    /* Device tree compatible is a list of NUL separated strings, sysfs fakes may end with new line */
+    for (int i = 0; i < num_byte; i++)
+    {
+        if (entry->compatible[i] == '\n' || entry->compatible[i] == '\r')
+        {
+            entry->compatible[i] = '\0';
+        }
+    }
+    entry->compatible[num_byte] = '\0';
+    entry->compatible_len = num_byte;
+    return true;
+}
+
+static SE_ret_t _SE_pwmchip_scan(struct _se_pwmchip_cache *cache)
+{
+    DIR *dir = opendir(cache->root);
+    if (dir == NULL)
+    {
+        SE_set_error("Unable to open pwm class folder");
+        SE_ERROR("Unable to open folder %s", cache->root);
+        return kSE_FAILED;
+    }
+
+    cache->count = 0;
+    struct dirent *dir_entry = NULL;
+    while ((dir_entry = readdir(dir)) != NULL)
+    {
+        if (dir_entry->d_name[0] == '.')
+        {
+            continue;
+        }
+
+        if (cache->count >= MAX_PWMCHIP)
+        {
+            SE_WARNING("More than %d pwmchip, ignore %s", MAX_PWMCHIP, dir_entry->d_name);
+            continue;
+        }
+
+        struct _se_pwmchip_entry *entry = &cache->entry[cache->count];
+        int num_byte = snprintf(entry->dev_path, PWMCHIP_PATH_LEN, "%s/%s", cache->root, dir_entry->d_name);
+        if (num_byte >= PWMCHIP_PATH_LEN)
+        {
+            SE_WARNING("Path of %s is too long, ignore", dir_entry->d_name);
+            continue;
+        }
+
+        if (_SE_pwmchip_read_compatible(entry))
+        {
+            SE_DEBUG("Found pwmchip %s compatible %s", entry->dev_path, entry->compatible);
+            cache->count++;
+        }
+    }
+    closedir(dir);
+
+    qsort(cache->entry, cache->count, sizeof(struct _se_pwmchip_entry), _SE_pwmchip_compare);
+    cache->is_scanned = true;
+    return kSE_SUCCESS;
+}
+
+static bool _SE_pwmchip_is_compatible(const struct _se_pwmchip_entry *entry, const char *compatible)
+{
+    int offset = 0;
+    while (offset < entry->compatible_len)
+    {
+        const char *name = &entry->compatible[offset];
+        if (!strcmp(name, compatible))
+        {
+            return true;
+        }
+        offset += strlen(name) + 1;
+    }
+    return false;
+}
+
+int SE_pwmchip_find_all(const char *compatible, const char **dev_paths, int max_paths)
+{
+    if (!pwmchip_cache.is_scanned && _SE_pwmchip_scan(&pwmchip_cache) != kSE_SUCCESS)
+    {
+        return 0;
+    }
+
+    int found = 0;
+    for (int i = 0; i < pwmchip_cache.count && found < max_paths; i++)
+    {
+        if (_SE_pwmchip_is_compatible(&pwmchip_cache.entry[i], compatible))
+        {
+            dev_paths[found] = pwmchip_cache.entry[i].dev_path;
+            found++;
+        }
+    }
+    return found;
+}
+
+SE_ret_t SE_pwmchip_find(const char *compatible, char *dev_path, size_t len)
+{
+    const char *path = NULL;
+    if (SE_pwmchip_find_all(compatible, &path, 1) == 0)
+    {
+        return kSE_FAILED;
+    }
+
+    if (snprintf(dev_path, len, "%s", path) >= (int)len)
+    {
+        SE_set_error("Buffer is too small for pwmchip path");
+        return kSE_NO_MEM;
+    }
+    return kSE_SUCCESS;
+}
+
+int SE_pwmchip_count(void)
+{
+    if (!pwmchip_cache.is_scanned)
+    {
+        _SE_pwmchip_scan(&pwmchip_cache);
+    }
+    return pwmchip_cache.count;
+}
+
+void SE_pwmchip_set_root(const char *root)
+{
+    snprintf(pwmchip_cache.root, PWMCHIP_PATH_LEN, "%s", root);
+    SE_pwmchip_invalidate();
+}
+
+void SE_pwmchip_invalidate(void)
+{
+    pwmchip_cache.count = 0;
+    pwmchip_cache.is_scanned = false;
+}
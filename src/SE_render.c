@@ -0,0 +1,214 @@
+#include "SE_render.h"
+
+#include <string.h>
+
+#include "servo_easing.h"
+#include "SE_easing.h"
+#include "SE_errors.h"
+#include "SE_logging.h"
+
+#define RENDER_MAX_ANGLE 180
+
+static SE_ret_t _SE_render_check_channel(const SE_render_channel_t *channel)
+{
+    if (channel->move_count > 0 && channel->moves == NULL)
+    {
+        SE_set_error("Render channel moves are null");
+        return kSE_NULL;
+    }
+
+    if (channel->start_angle > RENDER_MAX_ANGLE)
+    {
+        SE_set_error("Render channel starts out of range");
+        return kSE_OUT_OF_RANGE;
+    }
+
+    uint64_t end_ms = 0;
+    for (uint32_t m = 0; m < channel->move_count; m++)
+    {
+        const SE_render_move_t *move = &channel->moves[m];
+        if (move->duration_ms == 0 || move->angle > RENDER_MAX_ANGLE || !SE_easing_is_valid(move->easing_type) ||
+            move->move_type >= eSE_MOV_LAST)
+        {
+            SE_set_error("Render move is out of range");
+            return kSE_OUT_OF_RANGE;
+        }
+        end_ms += move->duration_ms;
+    }
+
+    if (end_ms > UINT32_MAX)
+    {
+        SE_set_error("Render channel runs past the virtual clock");
+        return kSE_OUT_OF_RANGE;
+    }
+    return kSE_SUCCESS;
+}
+
+/* Same map a servo on this channel would compile, asking the controller for nothing else */
+static SE_ret_t _SE_render_compile(const SE_render_channel_t *channel, uint16_t *lut)
+{
+    if (channel->calibration != NULL)
+    {
+        return SE_calibration_compile(channel->calibration, lut);
+    }
+
+    struct SE_controller *controller = SE_controller_get(channel->controller_id);
+    if (controller == NULL)
+    {
+        SE_set_error("Render channel controller is not registered");
+        return kSE_NULL;
+    }
+
+    const struct SE_controller_info *info_ref = controller->get_info_ref(controller);
+    uint32_t resolution = controller->get_pulse_resolution(controller, channel->servo_id);
+    SE_calibration_compile_linear(info_ref->units_for_0_degree, info_ref->units_for_180_degree, resolution, lut);
+    return kSE_SUCCESS;
+}
+
+static void _SE_render_load(struct _se_render_cursor *cursor, const SE_render_channel_t *channel)
+{
+    if (cursor->move >= channel->move_count)
+    {
+        return;
+    }
+
+    const SE_render_move_t *move = &channel->moves[cursor->move];
+    cursor->plan = (SE_plan_t){
+        .start_ms = cursor->end_ms,
+        .duration_ms = move->duration_ms,
+        .start_position = (uint32_t)cursor->angle << SE_CALIBRATION_FRAC_BITS,
+        .delta_position = ((int32_t)move->angle - cursor->angle) << SE_CALIBRATION_FRAC_BITS,
+        .easing_type = move->easing_type,
+        .move_type = move->move_type,
+    };
+    cursor->end_ms += move->duration_ms;
+}
+
+static void _SE_render_reset(SE_render_t *render)
+{
+    render->frame = 0;
+    for (uint16_t c = 0; c < render->channel_count; c++)
+    {
+        struct _se_render_cursor *cursor = &render->cursor[c];
+        memset(cursor, 0, sizeof(*cursor));
+        cursor->angle = render->channel[c].start_angle;
+        _SE_render_load(cursor, &render->channel[c]);
+    }
+}
+
+SE_ret_t SE_render_init(SE_render_t *render, const SE_render_channel_t *channels, uint16_t channel_count,
+                        uint32_t period_ms)
+{
+    if (render == NULL || channels == NULL)
+    {
+        SE_set_error("Render or channels are null");
+        return kSE_NULL;
+    }
+
+    if (channel_count == 0 || channel_count > SE_RENDER_MAX_CHANNELS || period_ms == 0)
+    {
+        SE_set_error("Render channel count or period is out of range");
+        return kSE_OUT_OF_RANGE;
+    }
+
+    for (uint16_t c = 0; c < channel_count; c++)
+    {
+        SE_ret_t ret = _SE_render_check_channel(&channels[c]);
+        if (ret == kSE_SUCCESS)
+        {
+            ret = _SE_render_compile(&channels[c], render->lut[c]);
+        }
+
+        if (ret != kSE_SUCCESS)
+        {
+            SE_ERROR("Render channel %d rejected, error %s", c, SE_get_error());
+            return ret;
+        }
+    }
+
+    render->channel = channels;
+    render->channel_count = channel_count;
+    render->period_ms = period_ms;
+    _SE_render_reset(render);
+    return kSE_SUCCESS;
+}
+
+/* Eased like a moving servo at its latch, a finished channel holds its last angle */
+static inline uint32_t _SE_render_position(struct _se_render_cursor *cursor, const SE_render_channel_t *channel,
+                                           uint32_t time_ms)
+{
+    while (cursor->move < channel->move_count && time_ms >= cursor->end_ms)
+    {
+        cursor->angle = channel->moves[cursor->move].angle;
+        cursor->move++;
+        _SE_render_load(cursor, channel);
+    }
+
+    if (cursor->move >= channel->move_count)
+    {
+        return (uint32_t)cursor->angle << SE_CALIBRATION_FRAC_BITS;
+    }
+
+    return SE_plan_eval(&cursor->plan, time_ms);
+}
+
+/* Channel by channel, so each cursor stays hot while it walks the frames, a held channel
+ * costs one store per frame */
+SE_ret_t SE_render_frames(SE_render_t *render, uint16_t *duties, uint32_t frame_count)
+{
+    if (render == NULL || duties == NULL)
+    {
+        SE_set_error("Render or duties are null");
+        return kSE_NULL;
+    }
+
+    uint16_t stride = render->channel_count;
+    for (uint16_t c = 0; c < stride; c++)
+    {
+        struct _se_render_cursor *cursor = &render->cursor[c];
+        const SE_render_channel_t *channel = &render->channel[c];
+        const uint16_t *lut = render->lut[c];
+        uint32_t time_ms = render->frame * render->period_ms;
+        uint16_t *out = &duties[c];
+        for (uint32_t f = 0; f < frame_count; f++, time_ms += render->period_ms, out += stride)
+        {
+            *out = SE_calibration_lookup(lut, _SE_render_position(cursor, channel, time_ms));
+        }
+    }
+
+    render->frame += frame_count;
+    return kSE_SUCCESS;
+}
+
+void SE_render_rewind(SE_render_t *render)
+{
+    if (render != NULL)
+    {
+        _SE_render_reset(render);
+    }
+}
+
+uint32_t SE_render_get_time(const SE_render_t *render)
+{
+    return (render == NULL) ? 0 : render->frame * render->period_ms;
+}
+
+uint32_t SE_render_get_frame_count(const SE_render_t *render)
+{
+    if (render == NULL)
+    {
+        return 0;
+    }
+
+    uint32_t end_ms = 0;
+    for (uint16_t c = 0; c < render->channel_count; c++)
+    {
+        uint32_t channel_ms = 0;
+        for (uint32_t m = 0; m < render->channel[c].move_count; m++)
+        {
+            channel_ms += render->channel[c].moves[m].duration_ms;
+        }
+        end_ms = (channel_ms > end_ms) ? channel_ms : end_ms;
+    }
+    return (end_ms + render->period_ms - 1) / render->period_ms + 1;
+}
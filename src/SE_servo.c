@@ -8,9 +8,13 @@
 #include "servo_easing.h"
 #include "SE_ticks.h"
 #include "SE_algorithm.h"
+#include "SE_output.h"
+#include "SE_calibration.h"
+#include "SE_easing.h"
 #include "SE_errors.h"
 #include "SE_logging.h"
 
+#define SERVO_MAX_POSITION (180 << SE_CALIBRATION_FRAC_BITS)
 #define SERVO_VALIDATE(servo, invalid)       \
     if (servo == NULL)                       \
     {                                        \
@@ -44,14 +48,26 @@ struct _se_servo_data
     uint32_t milis_start;
     uint32_t milis_stop;
     uint32_t start_units;
-    uint32_t current_units;
     uint32_t delta_units;
     uint32_t end_units;
+    uint32_t start_position;
+    uint32_t delta_position;
     uint32_t milis_to_complete_move;
+    uint32_t period_ms;
+    uint32_t latch_origin;
+    uint32_t emitted_latch;
+    uint32_t last_duty;
     uint16_t current_angle;
     uint16_t expect_angle;
+    uint16_t lut[SE_CALIBRATION_LUT_SIZE];
+    SE_track_t *track;
+    SE_stream_t *stream;
+    SE_layer_stack_t *layers;
+    SE_profile_limits_t limits;
+    SE_profile_t profile;
     SE_servo_dest_reach_cb_t reach_cb;
     SE_servo_update_cb_t update_cb;
+    SE_servo_t *owner;
     uint8_t speed;
     uint8_t await_action : 2;
     uint8_t is_moving : 1;
@@ -59,6 +75,11 @@ struct _se_servo_data
     uint8_t is_inuse : 1;
     uint8_t direction : 1;
     uint8_t reverse : 2;
+    uint8_t decimate : 1;
+    uint8_t has_latch : 1;
+    uint8_t has_duty : 1;
+    uint8_t calibrated : 1;
+    uint8_t has_profile : 1;
 };
 
 static struct _se_servo_data servo_data_instances[MAX_SERVO_INSTANCES] = {0};
@@ -110,6 +131,7 @@ SE_ret_t SE_servo_init(SE_servo_t *servo, SE_argument_t *args)
         return kSE_NO_MEM;
     }
     servo->servo_data = servo_data;
+    servo->servo_data->owner = servo;
     servo->mov_type = args->move_type;
     servo->easing_type = args->easing_type;
     servo->controller = NULL;
@@ -123,11 +145,20 @@ SE_ret_t SE_servo_init(SE_servo_t *servo, SE_argument_t *args)
     servo->servo_data->await_action = eSERVO_ASYNC_NONE;
     servo->servo_data->reach_cb = _SE_servo_default_reach_callback;
     servo->servo_data->update_cb = _SE_servo_default_update_calback;
-    servo->servo_data->current_units = 0;
     servo->servo_data->start_units = 0;
     servo->servo_data->end_units = 0;
     servo->servo_data->delta_units = 0;
     servo->servo_data->speed = args->speed;
+    servo->servo_data->period_ms = args->period_us / 1000;
+    servo->servo_data->latch_origin = SE_tick_get_current_tick();
+    servo->servo_data->decimate = true;
+    servo->servo_data->has_latch = false;
+    servo->servo_data->has_duty = false;
+    servo->servo_data->calibrated = false;
+    servo->servo_data->track = NULL;
+    servo->servo_data->stream = NULL;
+    servo->servo_data->layers = NULL;
+    servo->servo_data->has_profile = false;
     return kSE_SUCCESS;
 }
 
@@ -154,7 +185,7 @@ SE_ret_t SE_servo_set_angle(SE_servo_t *servo, int angle)
     SERVO_DATA_VALIDATE(servo, kSE_NULL);
 
     SE_DEBUG("Expect angle %d, current angle %d", servo->servo_data->expect_angle, servo->servo_data->current_angle);
-    SE_DEBUG("Servo current unit %ld end units %ld", servo->servo_data->current_units, servo->servo_data->end_units);
+    SE_DEBUG("Servo end units %ld", servo->servo_data->end_units);
 
     if (servo->servo_data->is_moving)
     {
@@ -204,30 +235,128 @@ static bool _SE_servo_is_destination_reach(struct _se_servo_data *data)
     return false;
 }
 
+/* When decimating, a duty equal to the one already on the channel is not written again */
+static void _SE_servo_write_duty(SE_servo_t *servo, uint32_t duty)
+{
+    struct _se_servo_data *data = (struct _se_servo_data *)servo->servo_data;
+    if (data->decimate && data->has_duty && data->last_duty == duty)
+    {
+        SE_output_record_saved(servo->controller, servo->id);
+        return;
+    }
+
+    SE_output_set_duty(servo->controller, servo->id, duty);
+    data->last_duty = duty;
+    data->has_duty = true;
+}
+
+/* The channel only latches a new pulse once per PWM period, counted from when the period was
+ * programmed. Finds the first latch at or after now, false when a value was already emitted
+ * for it. */
+static bool _SE_servo_next_latch(struct _se_servo_data *data, uint32_t now, uint32_t *latch)
+{
+    if (!data->decimate || data->period_ms == 0)
+    {
+        *latch = now;
+        return true;
+    }
+
+    uint32_t since_origin = now - data->latch_origin;
+    uint32_t next = data->latch_origin + (since_origin + data->period_ms - 1) / data->period_ms * data->period_ms;
+    if (data->has_latch && next == data->emitted_latch)
+    {
+        return false;
+    }
+
+    *latch = next;
+    return true;
+}
+
+static uint32_t _SE_servo_timed_position(struct _se_servo_data *data, uint32_t latch)
+{
+    if (data->track != NULL)
+    {
+        return SE_track_eval(data->track, latch - data->milis_start);
+    }
+
+    if (data->stream != NULL)
+    {
+        return SE_stream_eval(data->stream, latch);
+    }
+
+    if (data->layers != NULL)
+    {
+        return SE_layer_eval(data->layers, latch);
+    }
+
+    uint32_t covered = SE_profile_eval(&data->profile, latch - data->milis_start);
+    return (data->direction == eSERVO_DIRECT_CLOCK_WISE) ? data->start_position + covered
+                                                         : data->start_position - covered;
+}
+
+/* Tracks and profiles end on time, the last key may be passed through on the way. Streams
+ * and layers play until they are detached or the servo is stopped. */
+static void _SE_servo_timed_update(SE_servo_t *servo)
+{
+    struct _se_servo_data *data = (struct _se_servo_data *)servo->servo_data;
+    uint32_t latch = 0;
+    if (!_SE_servo_next_latch(data, SE_tick_get_current_tick(), &latch))
+    {
+        SE_output_record_saved(servo->controller, servo->id);
+        return;
+    }
+
+    uint32_t elapse_ms = latch - data->milis_start;
+    uint32_t position = _SE_servo_timed_position(data, latch);
+    data->current_angle = position >> SE_CALIBRATION_FRAC_BITS;
+    data->emitted_latch = latch;
+    data->has_latch = true;
+    _SE_servo_write_duty(servo, SE_calibration_lookup(data->lut, position));
+    if (elapse_ms >= data->milis_to_complete_move)
+    {
+        data->await_action = eSERVO_ASYNC_STOP;
+        data->reach_cb(servo);
+    }
+}
+
 static void _SE_servo_moving_update(SE_servo_t *servo)
 {
     struct _se_servo_data *data = (struct _se_servo_data *)servo->servo_data;
+    if (data->track != NULL || data->stream != NULL || data->layers != NULL || data->has_profile)
+    {
+        _SE_servo_timed_update(servo);
+        return;
+    }
+
     if (_SE_servo_is_destination_reach(data))
     {
-        uint32_t unit_per_us = servo->controller->get_pulse_resolution(servo->controller, servo->id);
-        uint32_t duty = data->end_units * unit_per_us / 100;
-        servo->controller->set_duty(servo->controller, servo->id, duty);
+        _SE_servo_write_duty(servo, SE_calibration_lookup(data->lut, data->expect_angle << SE_CALIBRATION_FRAC_BITS));
         data->await_action = eSERVO_ASYNC_STOP;
         data->reach_cb(servo);
         return;
     }
 
-    const struct SE_controller_info *info_ref = servo->controller->get_info_ref(servo->controller);
-    uint32_t easing_value = SE_algorithm_update(servo);
+    uint32_t latch = 0;
+    if (!_SE_servo_next_latch(data, SE_tick_get_current_tick(), &latch))
+    {
+        SE_output_record_saved(servo->controller, servo->id);
+        return;
+    }
+
+    /* Sampled at the latch the value will be emitted at, not at the update tick. Custom curves
+     * may leave 0..100 percent, the position is clamped to the servo range. */
+    int32_t easing_value = SE_algorithm_update_at(servo, latch);
     SE_DEBUG("Easing value %d", easing_value);
+    int32_t offset = easing_value * (int32_t)data->delta_position / 100;
+    int32_t signed_position = (int32_t)data->start_position;
     switch (data->direction)
     {
     case eSERVO_DIRECT_CLOCK_WISE:
-        data->current_units = (easing_value * data->delta_units / 100) + data->start_units;
+        signed_position += offset;
         break;
 
     case eSERVO_DIRECT_COUNTER_CLOCKWISE:
-        data->current_units = data->start_units - (easing_value * data->delta_units / 100);
+        signed_position -= offset;
         break;
 
     default:
@@ -235,11 +364,12 @@ static void _SE_servo_moving_update(SE_servo_t *servo)
         break;
     }
 
-    uint32_t unit_per_deg = (info_ref->units_for_180_degree - info_ref->units_for_0_degree) / 180;
-    uint32_t unit_per_us = servo->controller->get_pulse_resolution(servo->controller, servo->id);
-    uint32_t duty = data->current_units * unit_per_us / 100;
-    data->current_angle = (data->current_units - info_ref->units_for_0_degree) / unit_per_deg;
-    servo->controller->set_duty(servo->controller, servo->id, duty);
+    uint32_t position = (signed_position < 0) ? 0 : (uint32_t)signed_position;
+    position = (position > SERVO_MAX_POSITION) ? SERVO_MAX_POSITION : position;
+    data->current_angle = position >> SE_CALIBRATION_FRAC_BITS;
+    data->emitted_latch = latch;
+    data->has_latch = true;
+    _SE_servo_write_duty(servo, SE_calibration_lookup(data->lut, position));
 }
 
 static void _SE_servo_await_action_update(SE_servo_t *servo)
@@ -270,20 +400,54 @@ static void _SE_servo_await_action_update(SE_servo_t *servo)
     data->await_action = eSERVO_ASYNC_NONE;
 }
 
-SE_ret_t SE_servo_update(SE_servo_t *servo)
+static void _SE_servo_step(SE_servo_t *servo)
 {
-    SERVO_VALIDATE(servo, kSE_NULL);
-    SERVO_DATA_VALIDATE(servo, kSE_NULL);
-
     _SE_servo_await_action_update(servo);
     if (servo->servo_data->is_moving)
     {
         _SE_servo_moving_update(servo);
     }
+}
+
+SE_ret_t SE_servo_update(SE_servo_t *servo)
+{
+    SERVO_VALIDATE(servo, kSE_NULL);
+    SERVO_DATA_VALIDATE(servo, kSE_NULL);
+
+    _SE_servo_step(servo);
     servo->servo_data->update_cb(servo);
     return kSE_SUCCESS;
 }
 
+static inline bool _SE_servo_is_attached(struct _se_servo_data *data)
+{
+    return data->is_inuse && data->owner != NULL && data->owner->controller != NULL;
+}
+
+/* One frame for every servo: the new duties are staged and committed as one batch per
+ * controller, then the update callbacks run so controllers see the whole frame */
+SE_ret_t SE_servo_update_all(void)
+{
+    SE_output_frame_begin();
+    for (int i = 0; i < MAX_SERVO_INSTANCES; i++)
+    {
+        if (_SE_servo_is_attached(&servo_data_instances[i]))
+        {
+            _SE_servo_step(servo_data_instances[i].owner);
+        }
+    }
+    SE_ret_t ret = SE_output_frame_commit();
+
+    for (int i = 0; i < MAX_SERVO_INSTANCES; i++)
+    {
+        if (_SE_servo_is_attached(&servo_data_instances[i]))
+        {
+            servo_data_instances[i].update_cb(servo_data_instances[i].owner);
+        }
+    }
+    return ret;
+}
+
 uint8_t SE_servo_is_moving(SE_servo_t *servo)
 {
     SERVO_VALIDATE(servo, false);
@@ -300,6 +464,33 @@ uint8_t SE_servo_is_stop(SE_servo_t *servo)
     return servo->servo_data->is_stop;
 }
 
+SE_ret_t SE_servo_retarget(SE_servo_t *servo, SE_easing_t easing_type, SE_easing_mov_t move_type, uint8_t speed,
+                           int angle)
+{
+    SERVO_VALIDATE(servo, kSE_NULL);
+    SERVO_DATA_VALIDATE(servo, kSE_NULL);
+
+    if (!SE_easing_is_valid(easing_type) || move_type >= eSE_MOV_LAST)
+    {
+        SE_set_error("Unknown easing for the new target");
+        return kSE_OUT_OF_RANGE;
+    }
+
+    if (SE_servo_is_moving(servo))
+    {
+        SE_servo_stop(servo);
+    }
+    servo->easing_type = easing_type;
+    servo->mov_type = move_type;
+    if (speed > 0)
+    {
+        SE_servo_set_speed(servo, speed);
+    }
+
+    SE_ret_t ret = SE_servo_set_angle(servo, angle);
+    return (ret == kSE_SUCCESS) ? SE_servo_start(servo) : ret;
+}
+
 SE_ret_t SE_servo_stop(SE_servo_t *servo)
 {
     SERVO_VALIDATE(servo, kSE_NULL);
@@ -325,6 +516,12 @@ SE_ret_t SE_servo_set_speed(SE_servo_t *servo, uint8_t speed)
     SERVO_VALIDATE(servo, kSE_NULL);
     SERVO_DATA_VALIDATE(servo, kSE_NULL);
 
+    if (speed == 0)
+    {
+        SE_set_error("Servo speed must not be 0");
+        return kSE_OUT_OF_RANGE;
+    }
+
     servo->servo_data->speed = speed;
     return kSE_SUCCESS;
 }
@@ -371,10 +568,52 @@ SE_ret_t SE_servo_start(SE_servo_t *servo)
     SERVO_DATA_VALIDATE(servo, kSE_NULL);
     const struct SE_controller_info *info_ref = servo->controller->get_info_ref(servo->controller);
     SE_servo_data_t *data = servo->servo_data;
+    if (data->track != NULL)
+    {
+        data->expect_angle = data->track->end_angle;
+        data->milis_to_complete_move = SE_track_get_duration(data->track);
+        data->track->cursor = 0;
+        data->await_action = eSERVO_ASYNC_MOVE;
+        return kSE_SUCCESS;
+    }
+
+    if (data->stream != NULL)
+    {
+        SE_stream_reset(data->stream, (uint32_t)data->current_angle << SE_CALIBRATION_FRAC_BITS,
+                        SE_tick_get_current_tick());
+        data->milis_to_complete_move = UINT32_MAX;
+        data->await_action = eSERVO_ASYNC_MOVE;
+        return kSE_SUCCESS;
+    }
+
+    if (data->layers != NULL)
+    {
+        SE_layer_set_base(data->layers, (uint32_t)data->current_angle << SE_CALIBRATION_FRAC_BITS);
+        data->milis_to_complete_move = UINT32_MAX;
+        data->await_action = eSERVO_ASYNC_MOVE;
+        return kSE_SUCCESS;
+    }
 
     data->direction = _SE_servo_get_direction(data);
     uint32_t delta_angle = abs(data->expect_angle - data->current_angle);
-    data->milis_to_complete_move = delta_angle * 1000 / data->speed;
+    if (data->has_profile)
+    {
+        SE_ret_t ret = SE_profile_plan(&data->profile, &data->limits, delta_angle << SE_CALIBRATION_FRAC_BITS);
+        if (ret != kSE_SUCCESS)
+        {
+            return ret;
+        }
+        data->milis_to_complete_move = data->profile.duration_ms;
+    }
+    else if (data->speed == 0)
+    {
+        SE_set_error("Servo speed is 0");
+        return kSE_OUT_OF_RANGE;
+    }
+    else
+    {
+        data->milis_to_complete_move = delta_angle * 1000 / data->speed;
+    }
 
     SE_DEBUG("Start angle %d end angle %d", data->current_angle, data->expect_angle);
     uint32_t unit_per_deg = (info_ref->units_for_180_degree - info_ref->units_for_0_degree) / 180;
@@ -382,12 +621,52 @@ SE_ret_t SE_servo_start(SE_servo_t *servo)
     data->end_units = info_ref->units_for_0_degree + data->expect_angle * unit_per_deg;
     SE_DEBUG("Start units %d end units %d", data->start_units, data->end_units);
     data->delta_units = (data->end_units > data->start_units) ? (data->end_units - data->start_units) : (data->start_units - data->end_units);
+    data->start_position = (uint32_t)data->current_angle << SE_CALIBRATION_FRAC_BITS;
+    data->delta_position = delta_angle << SE_CALIBRATION_FRAC_BITS;
     SE_DEBUG("ms to complete move %d, delta units: %d", data->milis_to_complete_move,
              data->delta_units);
     data->await_action = eSERVO_ASYNC_MOVE;
     return kSE_SUCCESS;
 }
 
+/* Only reads the servo, a pending start is planned from the current tick */
+SE_ret_t SE_servo_get_plan(SE_servo_t *servo, SE_plan_t *plan)
+{
+    SERVO_VALIDATE(servo, kSE_NULL);
+    SERVO_DATA_VALIDATE(servo, kSE_NULL);
+    if (plan == NULL)
+    {
+        SE_set_error("Plan is null");
+        return kSE_NULL;
+    }
+
+    const struct _se_servo_data *data = servo->servo_data;
+    if (data->track != NULL || data->stream != NULL || data->layers != NULL || data->has_profile)
+    {
+        SE_set_error("Servo follows a timed path, not an eased move");
+        return kSE_NOT_SUPPORTED;
+    }
+
+    plan->easing_type = servo->easing_type;
+    plan->move_type = servo->mov_type;
+    bool starting = data->await_action == eSERVO_ASYNC_MOVE;
+    if (!starting && !data->is_moving)
+    {
+        plan->start_ms = SE_tick_get_current_tick();
+        plan->duration_ms = 0;
+        plan->start_position = (uint32_t)data->current_angle << SE_CALIBRATION_FRAC_BITS;
+        plan->delta_position = 0;
+        return kSE_SUCCESS;
+    }
+
+    plan->start_ms = starting ? SE_tick_get_current_tick() : data->milis_start;
+    plan->duration_ms = data->milis_to_complete_move;
+    plan->start_position = data->start_position;
+    plan->delta_position = (data->direction == eSERVO_DIRECT_CLOCK_WISE) ? (int32_t)data->delta_position
+                                                                         : -(int32_t)data->delta_position;
+    return kSE_SUCCESS;
+}
+
 SE_ret_t SE_servo_pause(SE_servo_t *servo)
 {
     SERVO_VALIDATE(servo, kSE_NULL);
@@ -412,6 +691,166 @@ uint32_t SE_servo_get_start_move_milis(SE_servo_t *servo)
     return servo->servo_data->milis_start;
 }
 
+/* The controller wide map depends on the pulse resolution, so it follows the period the
+ * controller runs, whether or not the last period write went through */
+static void _SE_servo_compile_linear(SE_servo_t *servo)
+{
+    const struct SE_controller_info *info_ref = servo->controller->get_info_ref(servo->controller);
+    uint32_t resolution = servo->controller->get_pulse_resolution(servo->controller, servo->id);
+    SE_calibration_compile_linear(info_ref->units_for_0_degree, info_ref->units_for_180_degree, resolution,
+                                  servo->servo_data->lut);
+}
+
+SE_ret_t SE_servo_set_period(SE_servo_t *servo, uint32_t period_us)
+{
+    SERVO_VALIDATE(servo, kSE_NULL);
+    SERVO_DATA_VALIDATE(servo, kSE_NULL);
+
+    if (servo->controller == NULL)
+    {
+        SE_set_error("Servo has no controller");
+        return kSE_NULL;
+    }
+
+    SE_ret_t ret = servo->controller->set_period(servo->controller, servo->id, period_us);
+    if (!servo->servo_data->calibrated)
+    {
+        _SE_servo_compile_linear(servo);
+    }
+
+    if (ret != kSE_SUCCESS)
+    {
+        return ret;
+    }
+
+    /* Writing the period restarts the PWM cycle, latches count from here */
+    servo->servo_data->period_ms = period_us / 1000;
+    servo->servo_data->latch_origin = SE_tick_get_current_tick();
+    servo->servo_data->has_latch = false;
+    return kSE_SUCCESS;
+}
+
+SE_ret_t SE_servo_set_calibration(SE_servo_t *servo, const SE_calibration_t *calibration)
+{
+    SERVO_VALIDATE(servo, kSE_NULL);
+    SERVO_DATA_VALIDATE(servo, kSE_NULL);
+
+    if (servo->servo_data->is_moving)
+    {
+        SE_set_error("Servo is moving, stop it first");
+        return kSE_BUSY;
+    }
+
+    if (calibration == NULL)
+    {
+        if (servo->controller == NULL)
+        {
+            SE_set_error("Servo has no controller");
+            return kSE_NULL;
+        }
+        servo->servo_data->calibrated = false;
+        _SE_servo_compile_linear(servo);
+        return kSE_SUCCESS;
+    }
+
+    SE_ret_t ret = SE_calibration_compile(calibration, servo->servo_data->lut);
+    if (ret != kSE_SUCCESS)
+    {
+        return ret;
+    }
+    servo->servo_data->calibrated = true;
+    return kSE_SUCCESS;
+}
+
+SE_ret_t SE_servo_set_decimation(SE_servo_t *servo, uint8_t enable)
+{
+    SERVO_VALIDATE(servo, kSE_NULL);
+    SERVO_DATA_VALIDATE(servo, kSE_NULL);
+
+    servo->servo_data->decimate = enable ? true : false;
+    servo->servo_data->has_latch = false;
+    return kSE_SUCCESS;
+}
+
+SE_ret_t SE_servo_set_track(SE_servo_t *servo, SE_track_t *track)
+{
+    SERVO_VALIDATE(servo, kSE_NULL);
+    SERVO_DATA_VALIDATE(servo, kSE_NULL);
+
+    if (servo->servo_data->is_moving)
+    {
+        SE_set_error("Servo is moving, stop it first");
+        return kSE_BUSY;
+    }
+
+    if (track != NULL && track->count < 2)
+    {
+        SE_set_error("Track is not loaded");
+        return kSE_OUT_OF_RANGE;
+    }
+
+    servo->servo_data->track = track;
+    return kSE_SUCCESS;
+}
+
+SE_ret_t SE_servo_set_stream(SE_servo_t *servo, SE_stream_t *stream)
+{
+    SERVO_VALIDATE(servo, kSE_NULL);
+    SERVO_DATA_VALIDATE(servo, kSE_NULL);
+
+    if (servo->servo_data->is_moving)
+    {
+        SE_set_error("Servo is moving, stop it first");
+        return kSE_BUSY;
+    }
+
+    servo->servo_data->stream = stream;
+    return kSE_SUCCESS;
+}
+
+SE_ret_t SE_servo_set_layers(SE_servo_t *servo, SE_layer_stack_t *layers)
+{
+    SERVO_VALIDATE(servo, kSE_NULL);
+    SERVO_DATA_VALIDATE(servo, kSE_NULL);
+
+    if (servo->servo_data->is_moving)
+    {
+        SE_set_error("Servo is moving, stop it first");
+        return kSE_BUSY;
+    }
+
+    servo->servo_data->layers = layers;
+    return kSE_SUCCESS;
+}
+
+SE_ret_t SE_servo_set_profile(SE_servo_t *servo, const SE_profile_limits_t *limits)
+{
+    SERVO_VALIDATE(servo, kSE_NULL);
+    SERVO_DATA_VALIDATE(servo, kSE_NULL);
+
+    if (servo->servo_data->is_moving)
+    {
+        SE_set_error("Servo is moving, stop it first");
+        return kSE_BUSY;
+    }
+
+    if (limits == NULL)
+    {
+        servo->servo_data->has_profile = false;
+        return kSE_SUCCESS;
+    }
+
+    if (limits->max_velocity == 0 || limits->max_acceleration == 0)
+    {
+        SE_set_error("Profile needs a velocity and an acceleration limit");
+        return kSE_OUT_OF_RANGE;
+    }
+
+    servo->servo_data->limits = *limits;
+    servo->servo_data->has_profile = true;
+    return kSE_SUCCESS;
+}
+
 SE_ret_t SE_servo_on_destination_reach(SE_servo_t *servo, SE_servo_dest_reach_cb_t callback)
 {
     SERVO_VALIDATE(servo, kSE_NULL);
@@ -0,0 +1,175 @@
+#include "SE_shm.h"
+
+#include <fcntl.h>
+#include <stdbool.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+
+#include "servo_easing.h"
+#include "SE_errors.h"
+#include "SE_logging.h"
+
+struct _se_shm_consumer
+{
+    struct SE_shm_segment *segment;
+    char name[64];
+    SE_servo_t *servo[SE_SHM_MAX_SERVO];
+    uint32_t seen_sequence[SE_SHM_MAX_SERVO];
+};
+
+static struct _se_shm_consumer shm = {0};
+
+SE_ret_t SE_shm_create(const char *name)
+{
+    if (name == NULL)
+    {
+        SE_set_error("Shared memory name is null");
+        return kSE_NULL;
+    }
+
+    if (shm.segment != NULL)
+    {
+        SE_set_error("Shared memory segment is already created");
+        return kSE_BUSY;
+    }
+
+    int fd = shm_open(name, O_RDWR | O_CREAT, 0660);
+    if (fd < 0)
+    {
+        SE_set_error("Unable to open shared memory segment");
+        return kSE_FAILED;
+    }
+
+    if (ftruncate(fd, sizeof(struct SE_shm_segment)) != 0)
+    {
+        SE_set_error("Unable to size shared memory segment");
+        close(fd);
+        return kSE_NO_MEM;
+    }
+
+    void *map = mmap(NULL, sizeof(struct SE_shm_segment), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED)
+    {
+        SE_set_error("Unable to map shared memory segment");
+        return kSE_NO_MEM;
+    }
+
+    memset(map, 0, sizeof(struct SE_shm_segment));
+    memset(&shm, 0, sizeof(shm));
+    shm.segment = (struct SE_shm_segment *)map;
+    strncpy(shm.name, name, sizeof(shm.name) - 1);
+    shm.segment->version = SE_SHM_VERSION;
+    shm.segment->max_servo = SE_SHM_MAX_SERVO;
+    shm.segment->ring_size = SE_SHM_RING_SIZE;
+    /* Magic last, a producer attaching early waits for a complete header */
+    __atomic_store_n(&shm.segment->magic, SE_SHM_MAGIC, __ATOMIC_RELEASE);
+    SE_INFO("Shared memory command segment %s, %d bytes", name, (int)sizeof(struct SE_shm_segment));
+    return kSE_SUCCESS;
+}
+
+void SE_shm_destroy(void)
+{
+    if (shm.segment == NULL)
+    {
+        return;
+    }
+
+    munmap(shm.segment, sizeof(struct SE_shm_segment));
+    shm_unlink(shm.name);
+    memset(&shm, 0, sizeof(shm));
+}
+
+SE_ret_t SE_shm_attach(uint8_t slot, SE_servo_t *servo)
+{
+    if (slot >= SE_SHM_MAX_SERVO)
+    {
+        SE_set_error("Shared memory slot is out of range");
+        return kSE_OUT_OF_RANGE;
+    }
+
+    shm.servo[slot] = servo;
+    return kSE_SUCCESS;
+}
+
+static bool _SE_shm_apply(const SE_shm_command_t *command)
+{
+    if (command->slot >= SE_SHM_MAX_SERVO || shm.servo[command->slot] == NULL)
+    {
+        SE_WARNING("Command for unattached slot %d", command->slot);
+        return false;
+    }
+
+    /* A new target replaces the move in progress from where the servo is */
+    if (SE_servo_retarget(shm.servo[command->slot], command->easing_type, command->move_type, command->speed,
+                          command->angle) != kSE_SUCCESS)
+    {
+        SE_WARNING("Command for slot %d rejected, error %s", command->slot, SE_get_error());
+        return false;
+    }
+
+    struct SE_shm_block *block = &shm.segment->block[command->slot];
+    __atomic_store_n(&block->applied_ns, SE_shm_now_ns(), __ATOMIC_RELAXED);
+    __atomic_store_n(&block->applied_sequence, command->sequence, __ATOMIC_RELEASE);
+    return true;
+}
+
+static int _SE_shm_drain_ring(struct SE_shm_ring *ring)
+{
+    int applied = 0;
+    uint32_t tail = __atomic_load_n(&ring->tail, __ATOMIC_RELAXED);
+    uint32_t head = __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE);
+    for (; tail != head; tail++)
+    {
+        /* Read in place, the producer does not reuse the entry before tail moves past it */
+        if (_SE_shm_apply(&ring->command[tail & (SE_SHM_RING_SIZE - 1)]))
+        {
+            applied++;
+        }
+    }
+    __atomic_store_n(&ring->tail, tail, __ATOMIC_RELEASE);
+    return applied;
+}
+
+static int _SE_shm_read_blocks(struct SE_shm_segment *segment)
+{
+    int applied = 0;
+    for (uint8_t slot = 0; slot < SE_SHM_MAX_SERVO; slot++)
+    {
+        struct SE_shm_block *block = &segment->block[slot];
+        uint32_t begin = __atomic_load_n(&block->sequence, __ATOMIC_ACQUIRE);
+        if (begin == shm.seen_sequence[slot] || (begin & 1))
+        {
+            continue;
+        }
+
+        SE_shm_command_t command;
+        memcpy(&command, &block->command, sizeof(command));
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+        if (__atomic_load_n(&block->sequence, __ATOMIC_RELAXED) != begin)
+        {
+            /* Rewritten while read, picked up on the next poll */
+            continue;
+        }
+
+        shm.seen_sequence[slot] = begin;
+        command.slot = slot;
+        if (_SE_shm_apply(&command))
+        {
+            applied++;
+        }
+    }
+    return applied;
+}
+
+int SE_shm_poll(void)
+{
+    if (shm.segment == NULL)
+    {
+        return 0;
+    }
+
+    int applied = _SE_shm_drain_ring(&shm.segment->ring);
+    return applied + _SE_shm_read_blocks(shm.segment);
+}
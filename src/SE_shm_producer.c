@@ -0,0 +1,121 @@
+#include "SE_shm_producer.h"
+
+#include <fcntl.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+SE_ret_t SE_shm_producer_open(SE_shm_producer_t *producer, const char *name)
+{
+    if (producer == NULL || name == NULL)
+    {
+        return kSE_NULL;
+    }
+
+    int fd = shm_open(name, O_RDWR, 0);
+    if (fd < 0)
+    {
+        /* The consumer has not created the segment yet */
+        return kSE_TRY_AGAIN;
+    }
+
+    /* Between shm_open and ftruncate in SE_shm_create the object is empty, touching the
+     * mapping would raise SIGBUS */
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size < (off_t)sizeof(struct SE_shm_segment))
+    {
+        close(fd);
+        return kSE_TRY_AGAIN;
+    }
+
+    void *map = mmap(NULL, sizeof(struct SE_shm_segment), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED)
+    {
+        return kSE_NO_MEM;
+    }
+
+    struct SE_shm_segment *segment = (struct SE_shm_segment *)map;
+    if (__atomic_load_n(&segment->magic, __ATOMIC_ACQUIRE) != SE_SHM_MAGIC)
+    {
+        munmap(map, sizeof(struct SE_shm_segment));
+        return kSE_TRY_AGAIN;
+    }
+
+    if (segment->version != SE_SHM_VERSION || segment->ring_size != SE_SHM_RING_SIZE)
+    {
+        munmap(map, sizeof(struct SE_shm_segment));
+        return kSE_NOT_SUPPORTED;
+    }
+
+    producer->segment = segment;
+    producer->sequence = 0;
+    return kSE_SUCCESS;
+}
+
+void SE_shm_producer_close(SE_shm_producer_t *producer)
+{
+    if (producer == NULL || producer->segment == NULL)
+    {
+        return;
+    }
+
+    munmap(producer->segment, sizeof(struct SE_shm_segment));
+    producer->segment = NULL;
+}
+
+uint32_t SE_shm_producer_set(SE_shm_producer_t *producer, SE_shm_command_t *command)
+{
+    if (producer == NULL || producer->segment == NULL || command == NULL || command->slot >= SE_SHM_MAX_SERVO)
+    {
+        return 0;
+    }
+
+    struct SE_shm_block *block = &producer->segment->block[command->slot];
+    command->sequence = ++producer->sequence;
+    command->sent_ns = SE_shm_now_ns();
+    uint32_t sequence = __atomic_load_n(&block->sequence, __ATOMIC_RELAXED);
+    __atomic_store_n(&block->sequence, sequence + 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    memcpy(&block->command, command, sizeof(*command));
+    __atomic_store_n(&block->sequence, sequence + 2, __ATOMIC_RELEASE);
+    return command->sequence;
+}
+
+SE_ret_t SE_shm_producer_push(SE_shm_producer_t *producer, SE_shm_command_t *command)
+{
+    if (producer == NULL || producer->segment == NULL || command == NULL)
+    {
+        return kSE_NULL;
+    }
+
+    struct SE_shm_ring *ring = &producer->segment->ring;
+    uint32_t head = __atomic_load_n(&ring->head, __ATOMIC_RELAXED);
+    if (head - __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE) >= SE_SHM_RING_SIZE)
+    {
+        return kSE_TRY_AGAIN;
+    }
+
+    command->sequence = ++producer->sequence;
+    command->sent_ns = SE_shm_now_ns();
+    ring->command[head & (SE_SHM_RING_SIZE - 1)] = *command;
+    __atomic_store_n(&ring->head, head + 1, __ATOMIC_RELEASE);
+    return kSE_SUCCESS;
+}
+
+uint32_t SE_shm_producer_get_applied(SE_shm_producer_t *producer, uint8_t slot, uint64_t *applied_ns)
+{
+    if (producer == NULL || producer->segment == NULL || slot >= SE_SHM_MAX_SERVO)
+    {
+        return 0;
+    }
+
+    struct SE_shm_block *block = &producer->segment->block[slot];
+    uint32_t sequence = __atomic_load_n(&block->applied_sequence, __ATOMIC_ACQUIRE);
+    if (applied_ns != NULL)
+    {
+        *applied_ns = __atomic_load_n(&block->applied_ns, __ATOMIC_RELAXED);
+    }
+    return sequence;
+}
@@ -0,0 +1,394 @@
+#include "SE_show.h"
+
+#include <fcntl.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "servo_easing.h"
+#include "SE_errors.h"
+#include "SE_logging.h"
+
+#define SHOW_MAX_ANGLE 180
+
+static SE_ret_t _SE_show_check_tracks(const SE_show_track_desc_t *tracks, uint16_t track_count,
+                                      uint32_t *segment_count, uint32_t *duration_ms)
+{
+    *segment_count = 0;
+    *duration_ms = 0;
+    for (uint16_t i = 0; i < track_count; i++)
+    {
+        const SE_show_track_desc_t *track = &tracks[i];
+        if (track->key_count > 0 && track->keys == NULL)
+        {
+            SE_set_error("Show track keys are null");
+            return kSE_NULL;
+        }
+
+        if (track->start_angle > SHOW_MAX_ANGLE)
+        {
+            SE_set_error("Show track starts out of range");
+            return kSE_OUT_OF_RANGE;
+        }
+
+        uint32_t end_ms = 0;
+        for (uint32_t k = 0; k < track->key_count; k++)
+        {
+            const SE_show_key_t *key = &track->keys[k];
+            if (key->duration_ms == 0 || key->angle > SHOW_MAX_ANGLE || !SE_easing_is_valid(key->easing_type) ||
+                key->move_type >= eSE_MOV_LAST)
+            {
+                SE_set_error("Show key is out of range");
+                return kSE_OUT_OF_RANGE;
+            }
+            end_ms += key->duration_ms;
+        }
+        *segment_count += track->key_count;
+        *duration_ms = (end_ms > *duration_ms) ? end_ms : *duration_ms;
+    }
+    return kSE_SUCCESS;
+}
+
+static bool _SE_show_write_index(FILE *file, const SE_show_track_desc_t *track, const SE_show_header_t *header)
+{
+    uint32_t key = 0;
+    uint32_t start_ms = 0;
+    uint16_t angle = track->start_angle;
+    for (uint32_t k = 0; k < header->index_count; k++)
+    {
+        uint32_t time_ms = k * header->index_interval_ms;
+        while (key < track->key_count && start_ms + track->keys[key].duration_ms <= time_ms)
+        {
+            start_ms += track->keys[key].duration_ms;
+            angle = track->keys[key].angle;
+            key++;
+        }
+
+        SE_show_index_t index = {.segment = key, .start_ms = start_ms, .start_angle = angle};
+        if (fwrite(&index, sizeof(index), 1, file) != 1)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool _SE_show_write_segments(FILE *file, const SE_show_track_desc_t *track)
+{
+    uint16_t angle = track->start_angle;
+    for (uint32_t k = 0; k < track->key_count; k++)
+    {
+        const SE_show_key_t *key = &track->keys[k];
+        SE_show_segment_t segment = {
+            .duration_ms = key->duration_ms,
+            .delta = (int16_t)(key->angle - angle),
+            .easing_type = key->easing_type,
+            .move_type = key->move_type,
+        };
+        angle = key->angle;
+        if (fwrite(&segment, sizeof(segment), 1, file) != 1)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+SE_ret_t SE_show_write(const char *path, const SE_show_track_desc_t *tracks, uint16_t track_count,
+                       uint32_t index_interval_ms)
+{
+    if (path == NULL || tracks == NULL)
+    {
+        SE_set_error("Show path or tracks is null");
+        return kSE_NULL;
+    }
+
+    if (track_count == 0 || track_count > SE_SHOW_MAX_TRACKS || index_interval_ms == 0)
+    {
+        SE_set_error("Show track count or index interval is out of range");
+        return kSE_OUT_OF_RANGE;
+    }
+
+    SE_show_header_t header = {
+        .magic = SE_SHOW_MAGIC,
+        .version = SE_SHOW_VERSION,
+        .track_count = track_count,
+        .index_interval_ms = index_interval_ms,
+    };
+    SE_ret_t ret = _SE_show_check_tracks(tracks, track_count, &header.segment_count, &header.duration_ms);
+    if (ret != kSE_SUCCESS)
+    {
+        return ret;
+    }
+
+    header.index_count = header.duration_ms / index_interval_ms + 1;
+    header.track_offset = sizeof(SE_show_header_t);
+    header.index_offset = header.track_offset + track_count * sizeof(SE_show_track_t);
+    header.segment_offset = header.index_offset + track_count * header.index_count * sizeof(SE_show_index_t);
+
+    FILE *file = fopen(path, "wb");
+    if (file == NULL)
+    {
+        SE_set_error("Unable to create show file");
+        return kSE_FAILED;
+    }
+
+    bool written = fwrite(&header, sizeof(header), 1, file) == 1;
+    uint32_t segment_first = 0;
+    for (uint16_t i = 0; i < track_count && written; i++)
+    {
+        SE_show_track_t track = {
+            .controller_id = tracks[i].controller_id,
+            .servo_id = tracks[i].servo_id,
+            .start_angle = tracks[i].start_angle,
+            .segment_first = segment_first,
+            .segment_count = tracks[i].key_count,
+        };
+        segment_first += tracks[i].key_count;
+        written = fwrite(&track, sizeof(track), 1, file) == 1;
+    }
+
+    for (uint16_t i = 0; i < track_count && written; i++)
+    {
+        written = _SE_show_write_index(file, &tracks[i], &header);
+    }
+
+    for (uint16_t i = 0; i < track_count && written; i++)
+    {
+        written = _SE_show_write_segments(file, &tracks[i]);
+    }
+
+    if (fclose(file) != 0 || !written)
+    {
+        SE_set_error("Unable to write show file");
+        return kSE_FAILED;
+    }
+    SE_INFO("Show %s: %d tracks, %u segments, %u ms", path, track_count, header.segment_count, header.duration_ms);
+    return kSE_SUCCESS;
+}
+
+/* Bounds only, the per segment content is checked when it is played */
+static bool _SE_show_check_layout(const SE_show_header_t *header, size_t size)
+{
+    if (header->magic != SE_SHOW_MAGIC || header->version != SE_SHOW_VERSION || header->track_count == 0 ||
+        header->track_count > SE_SHOW_MAX_TRACKS || header->index_count == 0 || header->index_interval_ms == 0)
+    {
+        return false;
+    }
+
+    if (header->track_offset % sizeof(uint32_t) != 0 || header->index_offset % sizeof(uint32_t) != 0 ||
+        header->segment_offset % sizeof(uint16_t) != 0)
+    {
+        return false;
+    }
+
+    uint64_t track_end = header->track_offset + (uint64_t)header->track_count * sizeof(SE_show_track_t);
+    uint64_t index_end =
+        header->index_offset + (uint64_t)header->track_count * header->index_count * sizeof(SE_show_index_t);
+    uint64_t segment_end = header->segment_offset + (uint64_t)header->segment_count * sizeof(SE_show_segment_t);
+    return track_end <= size && index_end <= size && segment_end <= size;
+}
+
+SE_ret_t SE_show_open(SE_show_player_t *player, const char *path)
+{
+    if (player == NULL || path == NULL)
+    {
+        SE_set_error("Show player or path is null");
+        return kSE_NULL;
+    }
+
+    int fd = open(path, O_RDONLY);
+    if (fd < 0)
+    {
+        SE_set_error("Unable to open show file");
+        return kSE_FAILED;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(SE_show_header_t))
+    {
+        SE_set_error("Show file is too short");
+        close(fd);
+        return kSE_OUT_OF_RANGE;
+    }
+
+    void *map = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED)
+    {
+        SE_set_error("Unable to map show file");
+        return kSE_NO_MEM;
+    }
+
+    const SE_show_header_t *header = (const SE_show_header_t *)map;
+    if (!_SE_show_check_layout(header, st.st_size))
+    {
+        SE_set_error("Show file header is invalid");
+        munmap(map, st.st_size);
+        return kSE_OUT_OF_RANGE;
+    }
+
+    const SE_show_track_t *track = (const SE_show_track_t *)((const uint8_t *)map + header->track_offset);
+    for (uint16_t i = 0; i < header->track_count; i++)
+    {
+        if ((uint64_t)track[i].segment_first + track[i].segment_count > header->segment_count)
+        {
+            SE_set_error("Show track segments are out of range");
+            munmap(map, st.st_size);
+            return kSE_OUT_OF_RANGE;
+        }
+    }
+
+    /* Segments are read front to back while playing */
+    posix_madvise(map, st.st_size, POSIX_MADV_SEQUENTIAL);
+    memset(player, 0, sizeof(SE_show_player_t));
+    player->map = (const uint8_t *)map;
+    player->size = st.st_size;
+    player->header = header;
+    player->track = track;
+    player->index = (const SE_show_index_t *)(player->map + header->index_offset);
+    player->segment = (const SE_show_segment_t *)(player->map + header->segment_offset);
+    for (uint16_t i = 0; i < header->track_count; i++)
+    {
+        player->cursor[i].angle = track[i].start_angle;
+    }
+    return kSE_SUCCESS;
+}
+
+void SE_show_close(SE_show_player_t *player)
+{
+    if (player == NULL || player->map == NULL)
+    {
+        return;
+    }
+
+    munmap((void *)player->map, player->size);
+    memset(player, 0, sizeof(SE_show_player_t));
+}
+
+SE_ret_t SE_show_attach(SE_show_player_t *player, SE_servo_t *servo)
+{
+    if (player == NULL || servo == NULL || player->map == NULL)
+    {
+        SE_set_error("Show player or servo is null");
+        return kSE_NULL;
+    }
+
+    int controller_id = servo->controller->get_info_ref(servo->controller)->id;
+    for (uint16_t i = 0; i < player->header->track_count; i++)
+    {
+        if (player->track[i].controller_id == controller_id && player->track[i].servo_id == servo->id)
+        {
+            player->servo[i] = servo;
+            return kSE_SUCCESS;
+        }
+    }
+
+    SE_set_error("Show has no track for the servo");
+    return kSE_OUT_OF_RANGE;
+}
+
+/* A new segment replaces the move in progress from where the servo is */
+static bool _SE_show_apply(SE_servo_t *servo, const SE_show_segment_t *segment, int angle, uint32_t milis)
+{
+    angle = (angle < 0) ? 0 : ((angle > SHOW_MAX_ANGLE) ? SHOW_MAX_ANGLE : angle);
+    if (SE_servo_retarget(servo, segment->easing_type, segment->move_type, 0, angle) != kSE_SUCCESS)
+    {
+        SE_WARNING("Show segment for servo %d rejected, error %s", servo->id, SE_get_error());
+        return false;
+    }
+    SE_servo_set_milis_to_complete_move(servo, milis);
+    return true;
+}
+
+/* Steps the cursor over every segment started by time_ms and plays the last one. The cursor
+ * holds the next segment, when it starts and the angle it starts from. */
+static int _SE_show_advance(SE_show_player_t *player, uint16_t i, uint32_t time_ms, bool force)
+{
+    const SE_show_track_t *track = &player->track[i];
+    struct _se_show_cursor *cursor = &player->cursor[i];
+    const SE_show_segment_t *segment = NULL;
+    while (cursor->segment < track->segment_count && time_ms >= cursor->end_ms)
+    {
+        segment = &player->segment[track->segment_first + cursor->segment];
+        cursor->angle += segment->delta;
+        cursor->end_ms += segment->duration_ms;
+        cursor->segment++;
+    }
+
+    if (segment == NULL && force && cursor->segment > 0)
+    {
+        /* Seek past the track end, settle on its last angle */
+        segment = &player->segment[track->segment_first + cursor->segment - 1];
+    }
+
+    if (segment == NULL)
+    {
+        return 0;
+    }
+
+    uint32_t milis = (time_ms < cursor->end_ms) ? cursor->end_ms - time_ms : 1;
+    return _SE_show_apply(player->servo[i], segment, (int16_t)cursor->angle, milis) ? 1 : 0;
+}
+
+SE_ret_t SE_show_seek(SE_show_player_t *player, uint32_t time_ms)
+{
+    if (player == NULL || player->map == NULL)
+    {
+        SE_set_error("Show player is not open");
+        return kSE_NULL;
+    }
+
+    const SE_show_header_t *header = player->header;
+    uint32_t k = time_ms / header->index_interval_ms;
+    k = (k < header->index_count) ? k : header->index_count - 1;
+    for (uint16_t i = 0; i < header->track_count; i++)
+    {
+        /* Only the segments inside one index interval are walked */
+        const SE_show_index_t *index = &player->index[(uint32_t)i * header->index_count + k];
+        if (index->segment > player->track[i].segment_count)
+        {
+            SE_set_error("Show index is out of range");
+            return kSE_OUT_OF_RANGE;
+        }
+
+        player->cursor[i].segment = index->segment;
+        player->cursor[i].end_ms = index->start_ms;
+        player->cursor[i].angle = index->start_angle;
+        if (player->servo[i] != NULL)
+        {
+            _SE_show_advance(player, i, time_ms, true);
+        }
+    }
+    return kSE_SUCCESS;
+}
+
+int SE_show_update(SE_show_player_t *player, uint32_t time_ms)
+{
+    if (player == NULL || player->map == NULL)
+    {
+        return 0;
+    }
+
+    int started = 0;
+    for (uint16_t i = 0; i < player->header->track_count; i++)
+    {
+        if (player->servo[i] != NULL)
+        {
+            started += _SE_show_advance(player, i, time_ms, false);
+        }
+    }
+    return started;
+}
+
+uint32_t SE_show_get_duration(const SE_show_player_t *player)
+{
+    if (player == NULL || player->header == NULL)
+    {
+        return 0;
+    }
+    return player->header->duration_ms;
+}
@@ -0,0 +1,190 @@
+#include "SE_stream.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+
+#include "SE_calibration.h"
+#include "SE_errors.h"
+#include "SE_logging.h"
+#include "SE_math.h"
+
+#define STREAM_MAX_POSITION (180 << SE_CALIBRATION_FRAC_BITS)
+#define STREAM_READ_RETRY 4
+#define STREAM_PHASE_BITS 16
+/* The slot at head may be rewritten while it is read, keep it out of the window */
+#define STREAM_WINDOW (SE_STREAM_SAMPLES - 1)
+
+SE_ret_t SE_stream_init(SE_stream_t *stream, uint32_t latency_ms, uint32_t max_velocity, uint32_t max_acceleration)
+{
+    if (stream == NULL)
+    {
+        SE_set_error("Stream is null");
+        return kSE_NULL;
+    }
+
+    memset(stream, 0, sizeof(SE_stream_t));
+    stream->latency_ms = latency_ms;
+    stream->max_velocity = max_velocity;
+    stream->max_acceleration = max_acceleration;
+    return kSE_SUCCESS;
+}
+
+/* Only the producer pushes. The fence orders the already published head before the slot is
+ * rewritten, so a reader that sees new slot data also sees that its index was recycled. */
+SE_ret_t SE_stream_push(SE_stream_t *stream, uint32_t time_ms, uint32_t position)
+{
+    if (stream == NULL)
+    {
+        SE_set_error("Stream is null");
+        return kSE_NULL;
+    }
+
+    uint32_t head = __atomic_load_n(&stream->head, __ATOMIC_RELAXED);
+    if (position > STREAM_MAX_POSITION || (head > 0 && time_ms <= stream->last_push_ms))
+    {
+        SE_set_error("Stream sample is out of range or out of order");
+        return kSE_OUT_OF_RANGE;
+    }
+
+    SE_stream_sample_t *slot = &stream->sample[head & (SE_STREAM_SAMPLES - 1)];
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    __atomic_store_n(&slot->time_ms, time_ms, __ATOMIC_RELAXED);
+    __atomic_store_n(&slot->position, position, __ATOMIC_RELAXED);
+    __atomic_store_n(&stream->head, head + 1, __ATOMIC_RELEASE);
+    stream->last_push_ms = time_ms;
+    return kSE_SUCCESS;
+}
+
+void SE_stream_reset(SE_stream_t *stream, uint32_t position, uint32_t now_ms)
+{
+    stream->output = (int32_t)position * 1000;
+    stream->velocity = 0;
+    stream->output_ms = now_ms;
+    stream->has_output = true;
+}
+
+/* Copies the published window oldest first, returns how many samples it holds */
+static uint32_t _SE_stream_snapshot(SE_stream_t *stream, SE_stream_sample_t *window)
+{
+    for (int i = 0; i < STREAM_READ_RETRY; i++)
+    {
+        uint32_t head = __atomic_load_n(&stream->head, __ATOMIC_ACQUIRE);
+        uint32_t count = (head < STREAM_WINDOW) ? head : STREAM_WINDOW;
+        uint32_t oldest = head - count;
+        for (uint32_t k = 0; k < count; k++)
+        {
+            const SE_stream_sample_t *slot = &stream->sample[(oldest + k) & (SE_STREAM_SAMPLES - 1)];
+            window[k].time_ms = __atomic_load_n(&slot->time_ms, __ATOMIC_RELAXED);
+            window[k].position = __atomic_load_n(&slot->position, __ATOMIC_RELAXED);
+        }
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+        if (__atomic_load_n(&stream->head, __ATOMIC_RELAXED) - oldest <= STREAM_WINDOW)
+        {
+            return count;
+        }
+        /* The producer lapped this reader while it was copying */
+    }
+    return 0;
+}
+
+/* Finite difference tangent at k, times the span of the segment it is used for */
+static int64_t _SE_stream_tangent(const SE_stream_sample_t *window, uint32_t count, uint32_t k, uint32_t span_ms)
+{
+    uint32_t before = (k > 0) ? k - 1 : k;
+    uint32_t after = (k + 1 < count) ? k + 1 : k;
+    int64_t rise = (int64_t)window[after].position - window[before].position;
+    return rise * span_ms / (window[after].time_ms - window[before].time_ms);
+}
+
+static uint32_t _SE_stream_interpolate(const SE_stream_sample_t *window, uint32_t count, uint32_t play_ms,
+                                       SE_stream_t *stream)
+{
+    if (play_ms <= window[0].time_ms)
+    {
+        return window[0].position;
+    }
+
+    if (play_ms >= window[count - 1].time_ms)
+    {
+        stream->underruns += (play_ms > window[count - 1].time_ms) ? 1 : 0;
+        return window[count - 1].position;
+    }
+
+    uint32_t k = count - 2;
+    while (window[k].time_ms > play_ms)
+    {
+        k--;
+    }
+
+    uint32_t span_ms = window[k + 1].time_ms - window[k].time_ms;
+    int64_t p0 = window[k].position;
+    int64_t p1 = window[k + 1].position;
+    int64_t m0 = _SE_stream_tangent(window, count, k, span_ms);
+    int64_t m1 = _SE_stream_tangent(window, count, k + 1, span_ms);
+    int64_t phase = ((int64_t)(play_ms - window[k].time_ms) << STREAM_PHASE_BITS) / span_ms;
+    int64_t value = 2 * (p0 - p1) + m0 + m1;
+    value = ((value * phase) >> STREAM_PHASE_BITS) + 3 * (p1 - p0) - 2 * m0 - m1;
+    value = ((value * phase) >> STREAM_PHASE_BITS) + m0;
+    value = ((value * phase) >> STREAM_PHASE_BITS) + p0;
+    value = (value < 0) ? 0 : value;
+    return (value > STREAM_MAX_POSITION) ? STREAM_MAX_POSITION : (uint32_t)value;
+}
+
+/* Steps the output toward target with the limits. Speed is also capped to what the acceleration
+ * can still stop before the target, so a step input lands without overshoot. */
+static void _SE_stream_clamp(SE_stream_t *stream, uint32_t target, uint32_t dt_ms)
+{
+    int64_t distance = (int64_t)target * 1000 - stream->output;
+    int64_t velocity = distance / dt_ms;
+    if (stream->max_velocity > 0)
+    {
+        int64_t limit = (int64_t)stream->max_velocity << SE_CALIBRATION_FRAC_BITS;
+        velocity = (velocity > limit) ? limit : ((velocity < -limit) ? -limit : velocity);
+    }
+
+    if (stream->max_acceleration > 0)
+    {
+        int64_t acceleration = (int64_t)stream->max_acceleration << SE_CALIBRATION_FRAC_BITS;
+        int64_t stop = SE_sqrt64(2 * acceleration * (uint64_t)((distance < 0 ? -distance : distance) / 1000));
+        velocity = (velocity > stop) ? stop : ((velocity < -stop) ? -stop : velocity);
+        int64_t change = acceleration * dt_ms / 1000;
+        int64_t low = stream->velocity - change;
+        int64_t high = stream->velocity + change;
+        velocity = (velocity > high) ? high : ((velocity < low) ? low : velocity);
+    }
+
+    stream->velocity = (int32_t)velocity;
+    stream->output += (int32_t)(velocity * dt_ms);
+}
+
+uint32_t SE_stream_eval(SE_stream_t *stream, uint32_t now_ms)
+{
+    SE_stream_sample_t window[STREAM_WINDOW];
+    uint32_t count = _SE_stream_snapshot(stream, window);
+    if (count == 0)
+    {
+        return stream->output / 1000;
+    }
+
+    uint32_t play_ms = (now_ms > stream->latency_ms) ? now_ms - stream->latency_ms : 0;
+    uint32_t target = _SE_stream_interpolate(window, count, play_ms, stream);
+    /* Without a reset the output starts on the curve */
+    if (!stream->has_output)
+    {
+        stream->output = (int32_t)target * 1000;
+        stream->output_ms = now_ms;
+        stream->has_output = true;
+        return target;
+    }
+
+    uint32_t dt_ms = now_ms - stream->output_ms;
+    if (dt_ms > 0)
+    {
+        _SE_stream_clamp(stream, target, dt_ms);
+        stream->output_ms = now_ms;
+    }
+    int32_t output = stream->output / 1000;
+    output = (output < 0) ? 0 : output;
+    return (output > STREAM_MAX_POSITION) ? STREAM_MAX_POSITION : (uint32_t)output;
+}
@@ -0,0 +1,191 @@
+#include "SE_track.h"
+
+#include <stddef.h>
+
+#include "SE_errors.h"
+#include "SE_logging.h"
+
+#define TRACK_MAX_POSITION (180 << SE_TRACK_FRAC_BITS)
+
+static SE_ret_t _SE_track_validate(const SE_track_key_t *keys, uint8_t count)
+{
+    if (count < 2 || count > SE_TRACK_MAX_KEYS)
+    {
+        SE_set_error("Track needs 2 to 32 keys");
+        return kSE_OUT_OF_RANGE;
+    }
+
+    if (keys[0].time_ms != 0)
+    {
+        SE_set_error("Track must start at 0 ms");
+        return kSE_OUT_OF_RANGE;
+    }
+
+    for (uint8_t i = 0; i < count; i++)
+    {
+        if (keys[i].angle > 180 || (i > 0 && keys[i].time_ms <= keys[i - 1].time_ms))
+        {
+            SE_set_error("Track angles must be 0..180 and times strictly increasing");
+            return kSE_OUT_OF_RANGE;
+        }
+    }
+    return kSE_SUCCESS;
+}
+
+static SE_ret_t _SE_track_validate_nodes(const SE_track_node_t *nodes, uint8_t count)
+{
+    if (count < 2 || count > SE_TRACK_MAX_KEYS)
+    {
+        SE_set_error("Track needs 2 to 32 nodes");
+        return kSE_OUT_OF_RANGE;
+    }
+
+    if (nodes[0].time_ms != 0 || (nodes[count - 1].position & ((1 << SE_TRACK_FRAC_BITS) - 1)) != 0)
+    {
+        SE_set_error("Track must start at 0 ms and end on a whole degree");
+        return kSE_OUT_OF_RANGE;
+    }
+
+    for (uint8_t i = 0; i < count; i++)
+    {
+        if (nodes[i].position > TRACK_MAX_POSITION || (i > 0 && nodes[i].time_ms <= nodes[i - 1].time_ms))
+        {
+            SE_set_error("Track positions must be 0..180 degrees and times strictly increasing");
+            return kSE_OUT_OF_RANGE;
+        }
+    }
+    return kSE_SUCCESS;
+}
+
+/* Catmull-Rom tangent at key k times the duration of the segment it is used for */
+static float _SE_track_tangent(const SE_track_key_t *keys, uint8_t count, uint8_t k, uint32_t duration_ms)
+{
+    if (k == 0 || k == count - 1)
+    {
+        return 0.0f;
+    }
+
+    float rise = (float)keys[k + 1].angle - keys[k - 1].angle;
+    return rise * duration_ms / (keys[k + 1].time_ms - keys[k - 1].time_ms);
+}
+
+SE_ret_t SE_track_load(SE_track_t *track, const SE_track_key_t *keys, uint8_t count)
+{
+    if (track == NULL || keys == NULL)
+    {
+        SE_set_error("Track or keys is null");
+        return kSE_NULL;
+    }
+
+    SE_ret_t ret = _SE_track_validate(keys, count);
+    if (ret != kSE_SUCCESS)
+    {
+        track->count = 0;
+        return ret;
+    }
+
+    for (uint8_t k = 0; k < count - 1; k++)
+    {
+        SE_track_segment_t *segment = &track->segment[k];
+        uint32_t duration_ms = keys[k + 1].time_ms - keys[k].time_ms;
+        float p0 = keys[k].angle;
+        float p1 = keys[k + 1].angle;
+        float m0 = _SE_track_tangent(keys, count, k, duration_ms);
+        float m1 = _SE_track_tangent(keys, count, k + 1, duration_ms);
+        segment->start_ms = keys[k].time_ms;
+        segment->duration_ms = duration_ms;
+        segment->scale = 1.0f / duration_ms;
+        segment->coef[0] = p0;
+        segment->coef[1] = m0;
+        segment->coef[2] = 3.0f * (p1 - p0) - 2.0f * m0 - m1;
+        segment->coef[3] = 2.0f * (p0 - p1) + m0 + m1;
+    }
+    track->count = count;
+    track->cursor = 0;
+    track->end_angle = keys[count - 1].angle;
+    return kSE_SUCCESS;
+}
+
+SE_ret_t SE_track_load_nodes(SE_track_t *track, const SE_track_node_t *nodes, uint8_t count)
+{
+    if (track == NULL || nodes == NULL)
+    {
+        SE_set_error("Track or nodes is null");
+        return kSE_NULL;
+    }
+
+    SE_ret_t ret = _SE_track_validate_nodes(nodes, count);
+    if (ret != kSE_SUCCESS)
+    {
+        track->count = 0;
+        return ret;
+    }
+
+    const float unit = 1.0f / (1 << SE_TRACK_FRAC_BITS);
+    for (uint8_t k = 0; k < count - 1; k++)
+    {
+        SE_track_segment_t *segment = &track->segment[k];
+        uint32_t duration_ms = nodes[k + 1].time_ms - nodes[k].time_ms;
+        float p0 = nodes[k].position * unit;
+        float p1 = nodes[k + 1].position * unit;
+        float m0 = nodes[k].velocity * unit * duration_ms / 1000.0f;
+        float m1 = nodes[k + 1].velocity * unit * duration_ms / 1000.0f;
+        segment->start_ms = nodes[k].time_ms;
+        segment->duration_ms = duration_ms;
+        segment->scale = 1.0f / duration_ms;
+        segment->coef[0] = p0;
+        segment->coef[1] = m0;
+        segment->coef[2] = 3.0f * (p1 - p0) - 2.0f * m0 - m1;
+        segment->coef[3] = 2.0f * (p0 - p1) + m0 + m1;
+    }
+    track->count = count;
+    track->cursor = 0;
+    track->end_angle = nodes[count - 1].position >> SE_TRACK_FRAC_BITS;
+    return kSE_SUCCESS;
+}
+
+uint32_t SE_track_get_duration(const SE_track_t *track)
+{
+    /* A track that never loaded has no segment */
+    if (track->count < 2)
+    {
+        return 0;
+    }
+
+    const SE_track_segment_t *last = &track->segment[track->count - 2];
+    return last->start_ms + last->duration_ms;
+}
+
+uint32_t SE_track_eval(SE_track_t *track, uint32_t time_ms)
+{
+    if (track->count < 2)
+    {
+        return (uint32_t)track->end_angle << SE_TRACK_FRAC_BITS;
+    }
+
+    if (time_ms >= SE_track_get_duration(track))
+    {
+        track->cursor = track->count - 2;
+        return (uint32_t)track->end_angle << SE_TRACK_FRAC_BITS;
+    }
+
+    /* Ticks only move forward, a rewind is the only time the cursor restarts */
+    if (time_ms < track->segment[track->cursor].start_ms)
+    {
+        track->cursor = 0;
+    }
+    while (time_ms >= track->segment[track->cursor].start_ms + track->segment[track->cursor].duration_ms)
+    {
+        track->cursor++;
+    }
+
+    const SE_track_segment_t *segment = &track->segment[track->cursor];
+    float phase = (time_ms - segment->start_ms) * segment->scale;
+    float degree = ((segment->coef[3] * phase + segment->coef[2]) * phase + segment->coef[1]) * phase + segment->coef[0];
+    float position = degree * (1 << SE_TRACK_FRAC_BITS) + 0.5f;
+    if (position < 0.0f)
+    {
+        return 0;
+    }
+    return (position > TRACK_MAX_POSITION) ? TRACK_MAX_POSITION : (uint32_t)position;
+}
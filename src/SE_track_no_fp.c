@@ -0,0 +1,194 @@
+#include "SE_track.h"
+
+#include <stddef.h>
+
+#include "SE_errors.h"
+#include "SE_logging.h"
+
+#define TRACK_MAX_POSITION (180 << SE_TRACK_FRAC_BITS)
+/* scale is 2^TRACK_SCALE_BITS / duration, ms times scale gives the phase */
+#define TRACK_SCALE_BITS 24
+
+static SE_ret_t _SE_track_validate(const SE_track_key_t *keys, uint8_t count)
+{
+    if (count < 2 || count > SE_TRACK_MAX_KEYS)
+    {
+        SE_set_error("Track needs 2 to 32 keys");
+        return kSE_OUT_OF_RANGE;
+    }
+
+    if (keys[0].time_ms != 0)
+    {
+        SE_set_error("Track must start at 0 ms");
+        return kSE_OUT_OF_RANGE;
+    }
+
+    for (uint8_t i = 0; i < count; i++)
+    {
+        if (keys[i].angle > 180 || (i > 0 && keys[i].time_ms <= keys[i - 1].time_ms))
+        {
+            SE_set_error("Track angles must be 0..180 and times strictly increasing");
+            return kSE_OUT_OF_RANGE;
+        }
+    }
+    return kSE_SUCCESS;
+}
+
+static SE_ret_t _SE_track_validate_nodes(const SE_track_node_t *nodes, uint8_t count)
+{
+    if (count < 2 || count > SE_TRACK_MAX_KEYS)
+    {
+        SE_set_error("Track needs 2 to 32 nodes");
+        return kSE_OUT_OF_RANGE;
+    }
+
+    if (nodes[0].time_ms != 0 || (nodes[count - 1].position & ((1 << SE_TRACK_FRAC_BITS) - 1)) != 0)
+    {
+        SE_set_error("Track must start at 0 ms and end on a whole degree");
+        return kSE_OUT_OF_RANGE;
+    }
+
+    for (uint8_t i = 0; i < count; i++)
+    {
+        if (nodes[i].position > TRACK_MAX_POSITION || (i > 0 && nodes[i].time_ms <= nodes[i - 1].time_ms))
+        {
+            SE_set_error("Track positions must be 0..180 degrees and times strictly increasing");
+            return kSE_OUT_OF_RANGE;
+        }
+    }
+    return kSE_SUCCESS;
+}
+
+/* Catmull-Rom tangent at key k times the duration of the segment it is used for */
+static int64_t _SE_track_tangent(const SE_track_key_t *keys, uint8_t count, uint8_t k, uint32_t duration_ms)
+{
+    if (k == 0 || k == count - 1)
+    {
+        return 0;
+    }
+
+    int64_t rise = ((int64_t)keys[k + 1].angle - keys[k - 1].angle) << SE_TRACK_FRAC_BITS;
+    return rise * duration_ms / (keys[k + 1].time_ms - keys[k - 1].time_ms);
+}
+
+SE_ret_t SE_track_load(SE_track_t *track, const SE_track_key_t *keys, uint8_t count)
+{
+    if (track == NULL || keys == NULL)
+    {
+        SE_set_error("Track or keys is null");
+        return kSE_NULL;
+    }
+
+    SE_ret_t ret = _SE_track_validate(keys, count);
+    if (ret != kSE_SUCCESS)
+    {
+        track->count = 0;
+        return ret;
+    }
+
+    for (uint8_t k = 0; k < count - 1; k++)
+    {
+        SE_track_segment_t *segment = &track->segment[k];
+        uint32_t duration_ms = keys[k + 1].time_ms - keys[k].time_ms;
+        int64_t p0 = (int64_t)keys[k].angle << SE_TRACK_FRAC_BITS;
+        int64_t p1 = (int64_t)keys[k + 1].angle << SE_TRACK_FRAC_BITS;
+        int64_t m0 = _SE_track_tangent(keys, count, k, duration_ms);
+        int64_t m1 = _SE_track_tangent(keys, count, k + 1, duration_ms);
+        segment->start_ms = keys[k].time_ms;
+        segment->duration_ms = duration_ms;
+        segment->scale = (int32_t)((1 << TRACK_SCALE_BITS) / duration_ms);
+        segment->coef[0] = (int32_t)p0;
+        segment->coef[1] = (int32_t)m0;
+        segment->coef[2] = (int32_t)(3 * (p1 - p0) - 2 * m0 - m1);
+        segment->coef[3] = (int32_t)(2 * (p0 - p1) + m0 + m1);
+    }
+    track->count = count;
+    track->cursor = 0;
+    track->end_angle = keys[count - 1].angle;
+    return kSE_SUCCESS;
+}
+
+SE_ret_t SE_track_load_nodes(SE_track_t *track, const SE_track_node_t *nodes, uint8_t count)
+{
+    if (track == NULL || nodes == NULL)
+    {
+        SE_set_error("Track or nodes is null");
+        return kSE_NULL;
+    }
+
+    SE_ret_t ret = _SE_track_validate_nodes(nodes, count);
+    if (ret != kSE_SUCCESS)
+    {
+        track->count = 0;
+        return ret;
+    }
+
+    for (uint8_t k = 0; k < count - 1; k++)
+    {
+        SE_track_segment_t *segment = &track->segment[k];
+        uint32_t duration_ms = nodes[k + 1].time_ms - nodes[k].time_ms;
+        int64_t p0 = nodes[k].position;
+        int64_t p1 = nodes[k + 1].position;
+        int64_t m0 = (int64_t)nodes[k].velocity * duration_ms / 1000;
+        int64_t m1 = (int64_t)nodes[k + 1].velocity * duration_ms / 1000;
+        segment->start_ms = nodes[k].time_ms;
+        segment->duration_ms = duration_ms;
+        segment->scale = (int32_t)((1 << TRACK_SCALE_BITS) / duration_ms);
+        segment->coef[0] = (int32_t)p0;
+        segment->coef[1] = (int32_t)m0;
+        segment->coef[2] = (int32_t)(3 * (p1 - p0) - 2 * m0 - m1);
+        segment->coef[3] = (int32_t)(2 * (p0 - p1) + m0 + m1);
+    }
+    track->count = count;
+    track->cursor = 0;
+    track->end_angle = nodes[count - 1].position >> SE_TRACK_FRAC_BITS;
+    return kSE_SUCCESS;
+}
+
+uint32_t SE_track_get_duration(const SE_track_t *track)
+{
+    /* A track that never loaded has no segment */
+    if (track->count < 2)
+    {
+        return 0;
+    }
+
+    const SE_track_segment_t *last = &track->segment[track->count - 2];
+    return last->start_ms + last->duration_ms;
+}
+
+uint32_t SE_track_eval(SE_track_t *track, uint32_t time_ms)
+{
+    if (track->count < 2)
+    {
+        return (uint32_t)track->end_angle << SE_TRACK_FRAC_BITS;
+    }
+
+    if (time_ms >= SE_track_get_duration(track))
+    {
+        track->cursor = track->count - 2;
+        return (uint32_t)track->end_angle << SE_TRACK_FRAC_BITS;
+    }
+
+    /* Ticks only move forward, a rewind is the only time the cursor restarts */
+    if (time_ms < track->segment[track->cursor].start_ms)
+    {
+        track->cursor = 0;
+    }
+    while (time_ms >= track->segment[track->cursor].start_ms + track->segment[track->cursor].duration_ms)
+    {
+        track->cursor++;
+    }
+
+    const SE_track_segment_t *segment = &track->segment[track->cursor];
+    int64_t phase = ((int64_t)(time_ms - segment->start_ms) * segment->scale) >> (TRACK_SCALE_BITS - SE_TRACK_PHASE_BITS);
+    int64_t position = segment->coef[3];
+    position = ((position * phase) >> SE_TRACK_PHASE_BITS) + segment->coef[2];
+    position = ((position * phase) >> SE_TRACK_PHASE_BITS) + segment->coef[1];
+    position = ((position * phase) >> SE_TRACK_PHASE_BITS) + segment->coef[0];
+    if (position < 0)
+    {
+        return 0;
+    }
+    return (position > TRACK_MAX_POSITION) ? TRACK_MAX_POSITION : (uint32_t)position;
+}
@@ -0,0 +1,400 @@
+#include "sim_controller.h"
+
+#include <stdbool.h>
+#include <string.h>
+
+#include "SE_servo.h"
+#include "SE_ticks.h"
+#include "SE_errors.h"
+#include "SE_logging.h"
+
+#define SIM_MAX_SERVO (16)
+#define CONTROLLER_VALIDATE(controller, invalid) \
+    if (controller == NULL)                      \
+    {                                            \
+        SE_set_error("Controller is null");      \
+        return invalid;                          \
+    }
+
+#define DEFAULT_SIM_UNITS_FOR_0_DEGREE 111   // 541 us at 20 ms
+#define DEFAULT_SIM_UNITS_FOR_180_DEGREE 491 // 2397 us at 20 ms
+#define PULSE_UNIT_US(period_us) ((period_us) * 100 / 4096)
+#define DEFAULT_SIM_PERIOD_US (20000)
+/* A hobby servo: 0.12 s / 60 deg, 1 deg dead band */
+#define DEFAULT_SIM_DEAD_BAND_MDEG 1000
+#define DEFAULT_SIM_MAX_SPEED_MDEG_S 500000
+#define DEFAULT_SIM_TIME_CONSTANT_MS 15
+#define DEFAULT_SIM_GAIN 40
+
+static SE_ret_t sim_init_device(struct SE_controller *controller);
+static void sim_deinit_device(struct SE_controller *controller);
+static SE_ret_t sim_open_servo(struct SE_controller *controller, uint8_t servo_id);
+static SE_ret_t sim_close_servo(struct SE_controller *controller, uint8_t servo_id);
+static SE_ret_t sim_set_duty(struct SE_controller *controller, uint8_t servo_id, uint32_t duty_us);
+static SE_ret_t sim_set_period(struct SE_controller *controller, uint8_t servo_id, uint32_t period_us);
+static const struct SE_controller_info *sim_get_info_ref(struct SE_controller *controller);
+static struct SE_controller_info sim_get_info_copy(struct SE_controller *controller);
+static SE_ret_t sim_set_id(struct SE_controller *controller, int id);
+static uint32_t sim_get_pulse_resolution(struct SE_controller *controller, uint8_t servo_id);
+static SE_ret_t sim_servo_callback_register(void *servo);
+
+struct sim_move
+{
+    bool active;
+    uint32_t start_tick;
+    uint32_t command_tick;
+    uint32_t samples;
+    uint64_t error_sum;
+    uint32_t max_error;
+};
+
+struct sim_servo
+{
+    bool enable;
+    bool has_command;
+    struct sim_servo_params params;
+    uint32_t period_us;
+    uint32_t period_origin;
+    uint32_t pwm_resolution;
+    uint32_t pending_duty;
+    int32_t command_mdeg;
+    int32_t latched_mdeg;
+    int64_t position_udeg;
+    int64_t velocity_mdeg_s;
+    struct sim_move move;
+    struct sim_move_stats stats;
+};
+
+struct sim_data
+{
+    struct SE_controller_info info;
+    struct sim_servo servo[SIM_MAX_SERVO];
+    uint32_t tick;
+};
+
+static struct sim_data controller_data = {
+    .info = {
+        .name = "Simulated servo plant",
+        .id = 0,
+        .max_servo = SIM_MAX_SERVO,
+        .units_for_0_degree = DEFAULT_SIM_UNITS_FOR_0_DEGREE,
+        .units_for_180_degree = DEFAULT_SIM_UNITS_FOR_180_DEGREE,
+    },
+};
+
+static struct SE_controller sim_controller = {
+    .controller_init = sim_init_device,
+    .controller_deinit = sim_deinit_device,
+    .open_servo = sim_open_servo,
+    .close_servo = sim_close_servo,
+    .set_duty = sim_set_duty,
+    .set_period = sim_set_period,
+    .get_info_ref = sim_get_info_ref,
+    .get_info_copy = sim_get_info_copy,
+    .set_id = sim_set_id,
+    .get_pulse_resolution = sim_get_pulse_resolution,
+    .register_servo_event = sim_servo_callback_register,
+    .controller_data = (void *)&controller_data,
+};
+
+struct SE_controller *Sim_get_controller()
+{
+    return &sim_controller;
+}
+
+static inline uint32_t _sim_abs(int64_t value)
+{
+    return (uint32_t)((value < 0) ? -value : value);
+}
+
+static int32_t _sim_duty_to_mdeg(struct sim_servo *servo, uint32_t duty_us)
+{
+    int64_t pulse_0 = (int64_t)DEFAULT_SIM_UNITS_FOR_0_DEGREE * servo->pwm_resolution / 100;
+    int64_t pulse_180 = (int64_t)DEFAULT_SIM_UNITS_FOR_180_DEGREE * servo->pwm_resolution / 100;
+    return (int32_t)(((int64_t)duty_us - pulse_0) * 180000 / (pulse_180 - pulse_0));
+}
+
+static void _sim_finish_move(uint8_t servo_id, struct sim_servo *servo, uint32_t tick)
+{
+    struct sim_move *move = &servo->move;
+    servo->stats.moves++;
+    servo->stats.duration_ms = tick - move->start_tick;
+    servo->stats.settle_ms = tick - move->command_tick;
+    servo->stats.max_error_mdeg = move->max_error;
+    servo->stats.mean_error_mdeg = (move->samples > 0) ? move->error_sum / move->samples : 0;
+    servo->stats.final_error_mdeg = servo->command_mdeg - (int32_t)(servo->position_udeg / 1000);
+    move->active = false;
+    SE_INFO("Sim servo %d move in %u ms, settled %u ms after last command, error max %u mean %u final %d mdeg",
+            servo_id, servo->stats.duration_ms, servo->stats.settle_ms, servo->stats.max_error_mdeg,
+            servo->stats.mean_error_mdeg, servo->stats.final_error_mdeg);
+}
+
+/* One simulated ms */
+static void _sim_servo_step(uint8_t servo_id, struct sim_servo *servo, uint32_t tick)
+{
+    uint32_t period_ms = servo->period_us / 1000;
+    if (period_ms == 0 || (tick - servo->period_origin) % period_ms == 0)
+    {
+        servo->latched_mdeg = _sim_duty_to_mdeg(servo, servo->pending_duty);
+    }
+
+    const struct sim_servo_params *params = &servo->params;
+    int64_t error_mdeg = servo->latched_mdeg - servo->position_udeg / 1000;
+    int64_t drive = 0;
+    if (_sim_abs(error_mdeg) > params->dead_band_mdeg)
+    {
+        drive = error_mdeg * params->gain;
+        if (drive > params->max_speed_mdeg_s)
+        {
+            drive = params->max_speed_mdeg_s;
+        }
+        else if (drive < -(int64_t)params->max_speed_mdeg_s)
+        {
+            drive = -(int64_t)params->max_speed_mdeg_s;
+        }
+    }
+
+    /* Implicit Euler of the inertia lag, mdeg/s over one ms is udeg */
+    int64_t velocity_step = (drive - servo->velocity_mdeg_s) / (params->time_constant_ms + 1);
+    servo->velocity_mdeg_s = (velocity_step == 0) ? drive : servo->velocity_mdeg_s + velocity_step;
+    servo->position_udeg += servo->velocity_mdeg_s;
+
+    struct sim_move *move = &servo->move;
+    if (!move->active)
+    {
+        return;
+    }
+
+    uint32_t error = _sim_abs(servo->latched_mdeg - servo->position_udeg / 1000);
+    move->samples++;
+    move->error_sum += error;
+    if (error > move->max_error)
+    {
+        move->max_error = error;
+    }
+
+    bool settled = servo->latched_mdeg == servo->command_mdeg && drive == 0 && _sim_abs(servo->velocity_mdeg_s) < 1000;
+    if (settled && tick - move->command_tick >= period_ms)
+    {
+        _sim_finish_move(servo_id, servo, tick);
+    }
+}
+
+void sim_controller_advance(uint32_t tick)
+{
+    struct sim_data *data = &controller_data;
+    while ((int32_t)(tick - data->tick) > 0)
+    {
+        data->tick++;
+        for (uint8_t i = 0; i < SIM_MAX_SERVO; i++)
+        {
+            if (data->servo[i].enable && data->servo[i].has_command)
+            {
+                _sim_servo_step(i, &data->servo[i], data->tick);
+            }
+        }
+    }
+}
+
+SE_ret_t sim_controller_set_params(uint8_t servo_id, const struct sim_servo_params *params)
+{
+    if (params == NULL)
+    {
+        SE_set_error("Sim params are null");
+        return kSE_NULL;
+    }
+
+    if (servo_id >= SIM_MAX_SERVO)
+    {
+        SE_set_error("Servo id is out of range");
+        return kSE_OUT_OF_RANGE;
+    }
+
+    controller_data.servo[servo_id].params = *params;
+    return kSE_SUCCESS;
+}
+
+int32_t sim_controller_get_position(uint8_t servo_id)
+{
+    if (servo_id >= SIM_MAX_SERVO)
+    {
+        return 0;
+    }
+    return (int32_t)(controller_data.servo[servo_id].position_udeg / 1000);
+}
+
+SE_ret_t sim_controller_get_move_stats(uint8_t servo_id, struct sim_move_stats *stats)
+{
+    if (stats == NULL)
+    {
+        SE_set_error("Stats is null");
+        return kSE_NULL;
+    }
+
+    if (servo_id >= SIM_MAX_SERVO)
+    {
+        SE_set_error("Servo id is out of range");
+        return kSE_OUT_OF_RANGE;
+    }
+
+    *stats = controller_data.servo[servo_id].stats;
+    return kSE_SUCCESS;
+}
+
+static SE_ret_t sim_init_device(struct SE_controller *controller)
+{
+    CONTROLLER_VALIDATE(controller, kSE_NULL);
+    struct sim_data *data = (struct sim_data *)controller->controller_data;
+    data->tick = SE_tick_get_current_tick();
+    return kSE_SUCCESS;
+}
+
+static void sim_deinit_device(struct SE_controller *controller)
+{
+    if (controller == NULL)
+    {
+        return;
+    }
+    SE_DEBUG("Deinit controller id %p", controller);
+}
+
+static SE_ret_t sim_open_servo(struct SE_controller *controller, uint8_t servo_id)
+{
+    CONTROLLER_VALIDATE(controller, kSE_NULL);
+    struct sim_data *data = (struct sim_data *)controller->controller_data;
+    if (servo_id >= data->info.max_servo)
+    {
+        SE_set_error("Servo id is out of range");
+        return kSE_OUT_OF_RANGE;
+    }
+
+    sim_controller_advance(SE_tick_get_current_tick());
+    struct sim_servo *servo = &data->servo[servo_id];
+    struct sim_servo_params params = servo->params;
+    memset(servo, 0, sizeof(*servo));
+    servo->params = params;
+    if (servo->params.max_speed_mdeg_s == 0)
+    {
+        servo->params = (struct sim_servo_params){
+            .dead_band_mdeg = DEFAULT_SIM_DEAD_BAND_MDEG,
+            .max_speed_mdeg_s = DEFAULT_SIM_MAX_SPEED_MDEG_S,
+            .time_constant_ms = DEFAULT_SIM_TIME_CONSTANT_MS,
+            .gain = DEFAULT_SIM_GAIN,
+        };
+    }
+    servo->period_us = DEFAULT_SIM_PERIOD_US;
+    servo->pwm_resolution = PULSE_UNIT_US(DEFAULT_SIM_PERIOD_US);
+    servo->period_origin = data->tick;
+    servo->enable = true;
+    return kSE_SUCCESS;
+}
+
+static SE_ret_t sim_close_servo(struct SE_controller *controller, uint8_t servo_id)
+{
+    CONTROLLER_VALIDATE(controller, kSE_NULL);
+    struct sim_data *data = (struct sim_data *)controller->controller_data;
+    if (servo_id < data->info.max_servo)
+    {
+        data->servo[servo_id].enable = false;
+    }
+    return kSE_SUCCESS;
+}
+
+static SE_ret_t sim_set_duty(struct SE_controller *controller, uint8_t servo_id, uint32_t duty)
+{
+    CONTROLLER_VALIDATE(controller, kSE_NULL);
+    struct sim_data *data = (struct sim_data *)controller->controller_data;
+    if (servo_id >= data->info.max_servo)
+    {
+        SE_set_error("Servo id is out of range");
+        return kSE_OUT_OF_RANGE;
+    }
+
+    /* Time up to now ran on the previous pulse */
+    sim_controller_advance(SE_tick_get_current_tick());
+    struct sim_servo *servo = &data->servo[servo_id];
+    int32_t command = _sim_duty_to_mdeg(servo, duty);
+    if (!servo->has_command)
+    {
+        /* The first pulse places the horn, as a servo powered up at its init angle */
+        servo->has_command = true;
+        servo->position_udeg = (int64_t)command * 1000;
+        servo->latched_mdeg = command;
+    }
+    else if (command != servo->command_mdeg)
+    {
+        if (!servo->move.active)
+        {
+            memset(&servo->move, 0, sizeof(servo->move));
+            servo->move.active = true;
+            servo->move.start_tick = data->tick;
+        }
+        servo->move.command_tick = data->tick;
+    }
+    servo->pending_duty = duty;
+    servo->command_mdeg = command;
+    return kSE_SUCCESS;
+}
+
+static SE_ret_t sim_set_period(struct SE_controller *controller, uint8_t servo_id, uint32_t period_us)
+{
+    CONTROLLER_VALIDATE(controller, kSE_NULL);
+    struct sim_data *data = (struct sim_data *)controller->controller_data;
+    if (servo_id >= data->info.max_servo)
+    {
+        SE_set_error("Servo id is out of range");
+        return kSE_OUT_OF_RANGE;
+    }
+
+    sim_controller_advance(SE_tick_get_current_tick());
+    data->servo[servo_id].period_us = period_us;
+    data->servo[servo_id].pwm_resolution = PULSE_UNIT_US(period_us);
+    data->servo[servo_id].period_origin = data->tick;
+    return kSE_SUCCESS;
+}
+
+static const struct SE_controller_info *sim_get_info_ref(struct SE_controller *controller)
+{
+    CONTROLLER_VALIDATE(controller, NULL);
+    return &((struct sim_data *)controller->controller_data)->info;
+}
+
+static struct SE_controller_info sim_get_info_copy(struct SE_controller *controller)
+{
+    struct SE_controller_info info = {0};
+    if (controller == NULL)
+    {
+        SE_set_error("Controller is null, ignore");
+        return info;
+    }
+    return ((struct sim_data *)controller->controller_data)->info;
+}
+
+static SE_ret_t sim_set_id(struct SE_controller *controller, int id)
+{
+    CONTROLLER_VALIDATE(controller, kSE_NULL);
+    ((struct sim_data *)controller->controller_data)->info.id = id;
+    return kSE_SUCCESS;
+}
+
+static uint32_t sim_get_pulse_resolution(struct SE_controller *controller, uint8_t servo_id)
+{
+    CONTROLLER_VALIDATE(controller, 0);
+    struct sim_data *data = (struct sim_data *)controller->controller_data;
+    if (servo_id >= data->info.max_servo)
+    {
+        SE_set_error("Servo id is out of range");
+        return 0;
+    }
+    return data->servo[servo_id].pwm_resolution;
+}
+
+static void _sim_servo_update_callback(SE_servo_t *servo)
+{
+    sim_controller_advance(SE_tick_get_current_tick());
+}
+
+static SE_ret_t sim_servo_callback_register(void *servo)
+{
+    return SE_servo_on_update((SE_servo_t *)servo, _sim_servo_update_callback);
+}
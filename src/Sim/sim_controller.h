@@ -0,0 +1,38 @@
+#ifndef SIM_CONTROLLER_H
+#define SIM_CONTROLLER_H
+#include <stdint.h>
+
+#include "SE_controller.h"
+
+/* Per servo plant: a pulse only takes effect at the next PWM period boundary, the horn then
+ * chases it with a proportional drive clamped to the slew rate, through a first order
+ * inertia lag, and stops once inside the dead band. */
+struct sim_servo_params
+{
+    uint32_t dead_band_mdeg;
+    uint32_t max_speed_mdeg_s;
+    uint32_t time_constant_ms;
+    uint32_t gain;
+};
+
+/* A move starts when the commanded angle changes and ends once the plant settled in the dead
+ * band of an unchanged command. Errors are the commanded angle in effect, the last latched
+ * pulse, minus the achieved angle, sampled every simulated ms. */
+struct sim_move_stats
+{
+    uint32_t moves;
+    uint32_t duration_ms;
+    uint32_t settle_ms;
+    uint32_t max_error_mdeg;
+    uint32_t mean_error_mdeg;
+    int32_t final_error_mdeg;
+};
+
+struct SE_controller *Sim_get_controller();
+SE_ret_t sim_controller_set_params(uint8_t servo_id, const struct sim_servo_params *params);
+/* Integrates every servo up to tick, writes and update callbacks already advance to the current tick */
+void sim_controller_advance(uint32_t tick);
+int32_t sim_controller_get_position(uint8_t servo_id);
+/* Stats of the last finished move */
+SE_ret_t sim_controller_get_move_stats(uint8_t servo_id, struct sim_move_stats *stats);
+#endif /*SIM_CONTROLLER_H*/
@@ -0,0 +1,43 @@
+#ifndef TRACE_FORMAT_H
+#define TRACE_FORMAT_H
+#include <stdint.h>
+
+#define TRACE_MAGIC "SETR"
+#define TRACE_VERSION 1
+#define DEFAULT_TRACE_MAX_RECORDS (1 << 20)
+/* Every channel a record can name */
+#define TRACE_MAX_CHANNELS (UINT8_MAX + 1)
+
+enum trace_record_kind
+{
+    eTRACE_RECORD_NONE = 0,
+    eTRACE_RECORD_DUTY,
+    eTRACE_RECORD_PERIOD,
+};
+
+/* Fixed width, host endian. count is written on close, a trace left by a crashed recorder
+ * ends at the first record of kind eTRACE_RECORD_NONE. */
+struct trace_header
+{
+    char magic[4];
+    uint16_t version;
+    uint16_t record_size;
+    uint32_t capacity;
+    uint32_t count;
+};
+
+/* Every record carries both the duty and the period of the channel after the write */
+struct trace_record
+{
+    uint32_t tick;
+    uint8_t controller_id;
+    uint8_t channel;
+    uint8_t kind;
+    uint8_t reserved;
+    uint32_t duty_us;
+    uint32_t period_us;
+};
+
+_Static_assert(sizeof(struct trace_header) == 16, "Trace header must stay 16 bytes");
+_Static_assert(sizeof(struct trace_record) == 16, "Trace record must stay 16 bytes");
+#endif /*TRACE_FORMAT_H*/
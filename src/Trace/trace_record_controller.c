@@ -0,0 +1,351 @@
+#include "trace_record_controller.h"
+
+#include <fcntl.h>
+#include <stdatomic.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+
+#include "SE_def.h"
+#include "SE_ticks.h"
+#include "SE_errors.h"
+#include "SE_logging.h"
+
+#define CONTROLLER_VALIDATE(controller, invalid) \
+    if (controller == NULL)                      \
+    {                                            \
+        SE_set_error("Controller is null");      \
+        return invalid;                          \
+    }
+
+static SE_ret_t trace_init_device(struct SE_controller *controller);
+static void trace_deinit_device(struct SE_controller *controller);
+static SE_ret_t trace_open_servo(struct SE_controller *controller, uint8_t servo_id);
+static SE_ret_t trace_close_servo(struct SE_controller *controller, uint8_t servo_id);
+static SE_ret_t trace_set_duty(struct SE_controller *controller, uint8_t servo_id, uint32_t duty_us);
+static SE_ret_t trace_set_period(struct SE_controller *controller, uint8_t servo_id, uint32_t period_us);
+static SE_ret_t trace_set_duty_batch(struct SE_controller *controller, const uint8_t *servo_ids,
+                                     const uint32_t *duties_us, size_t count);
+static SE_ret_t trace_set_period_batch(struct SE_controller *controller, const uint8_t *servo_ids,
+                                       const uint32_t *periods_us, size_t count);
+static const struct SE_controller_info *trace_get_info_ref(struct SE_controller *controller);
+static struct SE_controller_info trace_get_info_copy(struct SE_controller *controller);
+static SE_ret_t trace_set_id(struct SE_controller *controller, int id);
+static uint32_t trace_get_pulse_resolution(struct SE_controller *controller, uint8_t servo_id);
+
+struct trace_wrapper_data
+{
+    struct SE_controller *target;
+    /* Indexed by servo id, any id the target takes fits a record channel */
+    uint32_t duty_us[TRACE_MAX_CHANNELS];
+    uint32_t period_us[TRACE_MAX_CHANNELS];
+};
+
+/* One trace for every wrapped controller. Writers reserve a slot with one atomic add and fill
+ * it in the mapping, the file is only touched again on close. */
+struct trace_file
+{
+    int fd;
+    struct trace_header *header;
+    struct trace_record *record;
+    size_t map_size;
+    uint32_t capacity;
+    atomic_uint next;
+    atomic_uint dropped;
+};
+
+static struct trace_file trace = {.fd = -1};
+static struct trace_wrapper_data wrapper_data[MAX_CONTROLLER];
+static struct SE_controller wrapper[MAX_CONTROLLER];
+static uint8_t wrapper_count = 0;
+
+SE_ret_t trace_record_open(const char *path, uint32_t max_records)
+{
+    if (path == NULL)
+    {
+        SE_set_error("Trace path is null");
+        return kSE_NULL;
+    }
+
+    if (trace.header != NULL)
+    {
+        SE_set_error("Trace is already recording");
+        return kSE_BUSY;
+    }
+
+    uint32_t capacity = (max_records == 0) ? DEFAULT_TRACE_MAX_RECORDS : max_records;
+    size_t map_size = sizeof(struct trace_header) + (size_t)capacity * sizeof(struct trace_record);
+    int fd = open(path, O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0)
+    {
+        SE_set_error("Unable to create trace file");
+        return kSE_FAILED;
+    }
+
+    if (ftruncate(fd, map_size) != 0)
+    {
+        SE_set_error("Unable to size trace file");
+        close(fd);
+        return kSE_NO_MEM;
+    }
+
+    void *map = mmap(NULL, map_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (map == MAP_FAILED)
+    {
+        SE_set_error("Unable to map trace file");
+        close(fd);
+        return kSE_NO_MEM;
+    }
+
+    trace.fd = fd;
+    trace.header = (struct trace_header *)map;
+    trace.record = (struct trace_record *)(trace.header + 1);
+    trace.map_size = map_size;
+    trace.capacity = capacity;
+    atomic_store(&trace.next, 0);
+    atomic_store(&trace.dropped, 0);
+    memcpy(trace.header->magic, TRACE_MAGIC, sizeof(trace.header->magic));
+    trace.header->version = TRACE_VERSION;
+    trace.header->record_size = sizeof(struct trace_record);
+    trace.header->capacity = capacity;
+    trace.header->count = 0;
+    SE_INFO("Trace %s open for %u records", path, capacity);
+    return kSE_SUCCESS;
+}
+
+SE_ret_t trace_record_close(void)
+{
+    if (trace.header == NULL)
+    {
+        SE_set_error("Trace is not recording");
+        return kSE_FAILED;
+    }
+
+    uint32_t count = trace_record_get_count();
+    trace.header->count = count;
+    trace.header->capacity = count;
+    munmap(trace.header, trace.map_size);
+    SE_ret_t ret = kSE_SUCCESS;
+    if (ftruncate(trace.fd, sizeof(struct trace_header) + (size_t)count * sizeof(struct trace_record)) != 0)
+    {
+        SE_set_error("Unable to trim trace file");
+        ret = kSE_FAILED;
+    }
+    close(trace.fd);
+    trace.fd = -1;
+    trace.header = NULL;
+    trace.record = NULL;
+    return ret;
+}
+
+uint32_t trace_record_get_count(void)
+{
+    uint32_t next = atomic_load(&trace.next);
+    return (next < trace.capacity) ? next : trace.capacity;
+}
+
+uint32_t trace_record_get_dropped(void)
+{
+    return atomic_load(&trace.dropped);
+}
+
+static void _trace_append(struct SE_controller *controller, uint8_t channel, enum trace_record_kind kind)
+{
+    if (trace.header == NULL)
+    {
+        return;
+    }
+
+    uint32_t index = atomic_fetch_add_explicit(&trace.next, 1, memory_order_relaxed);
+    if (index >= trace.capacity)
+    {
+        atomic_fetch_add_explicit(&trace.dropped, 1, memory_order_relaxed);
+        return;
+    }
+
+    struct trace_wrapper_data *data = (struct trace_wrapper_data *)controller->controller_data;
+    struct trace_record *record = &trace.record[index];
+    record->tick = SE_tick_get_current_tick();
+    record->controller_id = data->target->get_info_ref(data->target)->id;
+    record->channel = channel;
+    record->reserved = 0;
+    record->duty_us = data->duty_us[channel];
+    record->period_us = data->period_us[channel];
+    /* kind last, a scan of an unclosed trace stops at the first record not yet filled */
+    __atomic_store_n(&record->kind, kind, __ATOMIC_RELEASE);
+}
+
+struct SE_controller *trace_record_wrap(struct SE_controller *target)
+{
+    if (target == NULL)
+    {
+        SE_set_error("Target controller is null");
+        return NULL;
+    }
+
+    if (wrapper_count >= MAX_CONTROLLER)
+    {
+        SE_set_error("Out of trace wrappers");
+        return NULL;
+    }
+
+    struct trace_wrapper_data *data = &wrapper_data[wrapper_count];
+    struct SE_controller *controller = &wrapper[wrapper_count];
+    wrapper_count++;
+    memset(data, 0, sizeof(*data));
+    data->target = target;
+    *controller = (struct SE_controller){
+        .controller_init = trace_init_device,
+        .controller_deinit = trace_deinit_device,
+        .open_servo = trace_open_servo,
+        .close_servo = trace_close_servo,
+        .set_duty = trace_set_duty,
+        .set_period = trace_set_period,
+        .set_duty_batch = (target->set_duty_batch != NULL) ? trace_set_duty_batch : NULL,
+        .set_period_batch = (target->set_period_batch != NULL) ? trace_set_period_batch : NULL,
+        .get_info_ref = trace_get_info_ref,
+        .get_info_copy = trace_get_info_copy,
+        .set_id = trace_set_id,
+        .get_pulse_resolution = trace_get_pulse_resolution,
+        .register_servo_event = target->register_servo_event,
+        .controller_data = data,
+    };
+    return controller;
+}
+
+static inline struct SE_controller *_trace_target(struct SE_controller *controller)
+{
+    return ((struct trace_wrapper_data *)controller->controller_data)->target;
+}
+
+static SE_ret_t trace_init_device(struct SE_controller *controller)
+{
+    CONTROLLER_VALIDATE(controller, kSE_NULL);
+    struct SE_controller *target = _trace_target(controller);
+    return (target->controller_init != NULL) ? target->controller_init(target) : kSE_SUCCESS;
+}
+
+static void trace_deinit_device(struct SE_controller *controller)
+{
+    if (controller == NULL)
+    {
+        return;
+    }
+
+    struct SE_controller *target = _trace_target(controller);
+    if (target->controller_deinit != NULL)
+    {
+        target->controller_deinit(target);
+    }
+}
+
+static SE_ret_t trace_open_servo(struct SE_controller *controller, uint8_t servo_id)
+{
+    CONTROLLER_VALIDATE(controller, kSE_NULL);
+    struct SE_controller *target = _trace_target(controller);
+    return target->open_servo(target, servo_id);
+}
+
+static SE_ret_t trace_close_servo(struct SE_controller *controller, uint8_t servo_id)
+{
+    CONTROLLER_VALIDATE(controller, kSE_NULL);
+    struct SE_controller *target = _trace_target(controller);
+    return (target->close_servo != NULL) ? target->close_servo(target, servo_id) : kSE_SUCCESS;
+}
+
+/* Only writes the target accepted are recorded, so a replay sends exactly what reached it */
+static SE_ret_t trace_set_duty(struct SE_controller *controller, uint8_t servo_id, uint32_t duty_us)
+{
+    CONTROLLER_VALIDATE(controller, kSE_NULL);
+    struct trace_wrapper_data *data = (struct trace_wrapper_data *)controller->controller_data;
+    SE_ret_t ret = data->target->set_duty(data->target, servo_id, duty_us);
+    if (ret == kSE_SUCCESS)
+    {
+        data->duty_us[servo_id] = duty_us;
+        _trace_append(controller, servo_id, eTRACE_RECORD_DUTY);
+    }
+    return ret;
+}
+
+static SE_ret_t trace_set_period(struct SE_controller *controller, uint8_t servo_id, uint32_t period_us)
+{
+    CONTROLLER_VALIDATE(controller, kSE_NULL);
+    struct trace_wrapper_data *data = (struct trace_wrapper_data *)controller->controller_data;
+    SE_ret_t ret = data->target->set_period(data->target, servo_id, period_us);
+    if (ret == kSE_SUCCESS)
+    {
+        data->period_us[servo_id] = period_us;
+        _trace_append(controller, servo_id, eTRACE_RECORD_PERIOD);
+    }
+    return ret;
+}
+
+static SE_ret_t trace_set_duty_batch(struct SE_controller *controller, const uint8_t *servo_ids,
+                                     const uint32_t *duties_us, size_t count)
+{
+    CONTROLLER_VALIDATE(controller, kSE_NULL);
+    struct trace_wrapper_data *data = (struct trace_wrapper_data *)controller->controller_data;
+    SE_ret_t ret = data->target->set_duty_batch(data->target, servo_ids, duties_us, count);
+    if (ret != kSE_SUCCESS)
+    {
+        return ret;
+    }
+
+    for (size_t i = 0; i < count; i++)
+    {
+        data->duty_us[servo_ids[i]] = duties_us[i];
+        _trace_append(controller, servo_ids[i], eTRACE_RECORD_DUTY);
+    }
+    return ret;
+}
+
+static SE_ret_t trace_set_period_batch(struct SE_controller *controller, const uint8_t *servo_ids,
+                                       const uint32_t *periods_us, size_t count)
+{
+    CONTROLLER_VALIDATE(controller, kSE_NULL);
+    struct trace_wrapper_data *data = (struct trace_wrapper_data *)controller->controller_data;
+    SE_ret_t ret = data->target->set_period_batch(data->target, servo_ids, periods_us, count);
+    if (ret != kSE_SUCCESS)
+    {
+        return ret;
+    }
+
+    for (size_t i = 0; i < count; i++)
+    {
+        data->period_us[servo_ids[i]] = periods_us[i];
+        _trace_append(controller, servo_ids[i], eTRACE_RECORD_PERIOD);
+    }
+    return ret;
+}
+
+static const struct SE_controller_info *trace_get_info_ref(struct SE_controller *controller)
+{
+    CONTROLLER_VALIDATE(controller, NULL);
+    struct SE_controller *target = _trace_target(controller);
+    return target->get_info_ref(target);
+}
+
+static struct SE_controller_info trace_get_info_copy(struct SE_controller *controller)
+{
+    struct SE_controller *target = _trace_target(controller);
+    if (target->get_info_copy != NULL)
+    {
+        return target->get_info_copy(target);
+    }
+    return *target->get_info_ref(target);
+}
+
+/* The wrapper is registered in place of the target, which takes its id */
+static SE_ret_t trace_set_id(struct SE_controller *controller, int id)
+{
+    CONTROLLER_VALIDATE(controller, kSE_NULL);
+    struct SE_controller *target = _trace_target(controller);
+    return target->set_id(target, id);
+}
+
+static uint32_t trace_get_pulse_resolution(struct SE_controller *controller, uint8_t servo_id)
+{
+    CONTROLLER_VALIDATE(controller, 0);
+    struct SE_controller *target = _trace_target(controller);
+    return target->get_pulse_resolution(target, servo_id);
+}
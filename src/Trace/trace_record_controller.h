@@ -0,0 +1,14 @@
+#ifndef TRACE_RECORD_CONTROLLER_H
+#define TRACE_RECORD_CONTROLLER_H
+#include "SE_controller.h"
+#include "trace_format.h"
+
+/* max_records 0 uses DEFAULT_TRACE_MAX_RECORDS, the file is sparse until written */
+SE_ret_t trace_record_open(const char *path, uint32_t max_records);
+SE_ret_t trace_record_close(void);
+/* Returns a controller that forwards to target and appends every duty and period it writes,
+ * register it in place of target */
+struct SE_controller *trace_record_wrap(struct SE_controller *target);
+uint32_t trace_record_get_count(void);
+uint32_t trace_record_get_dropped(void);
+#endif /*TRACE_RECORD_CONTROLLER_H*/
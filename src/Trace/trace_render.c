@@ -0,0 +1,118 @@
+#include "trace_render.h"
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "SE_errors.h"
+#include "SE_logging.h"
+
+#define TRACE_RENDER_CHUNK_FRAMES 64
+#define TRACE_RENDER_BATCH_RECORDS 256
+
+struct trace_render_writer
+{
+    FILE *file;
+    uint32_t count;
+    uint32_t batched;
+    struct trace_record batch[TRACE_RENDER_BATCH_RECORDS];
+};
+
+static bool _trace_render_flush(struct trace_render_writer *writer)
+{
+    size_t written = fwrite(writer->batch, sizeof(struct trace_record), writer->batched, writer->file);
+    bool ok = written == writer->batched;
+    writer->count += written;
+    writer->batched = 0;
+    return ok;
+}
+
+static bool _trace_render_append(struct trace_render_writer *writer, const struct trace_record *record)
+{
+    writer->batch[writer->batched++] = *record;
+    return writer->batched < TRACE_RENDER_BATCH_RECORDS || _trace_render_flush(writer);
+}
+
+static bool _trace_render_chunk(struct trace_render_writer *writer, const SE_render_t *render, const uint16_t *duties,
+                                uint32_t frames, uint32_t first_frame, uint32_t start_frame,
+                                uint16_t *last_duty)
+{
+    uint16_t stride = render->channel_count;
+    for (uint32_t f = 0; f < frames; f++)
+    {
+        uint32_t frame = first_frame + f;
+        for (uint16_t c = 0; c < stride; c++)
+        {
+            uint16_t duty = duties[f * stride + c];
+            if (frame > start_frame && duty == last_duty[c])
+            {
+                continue;
+            }
+
+            struct trace_record record = {
+                .tick = frame * render->period_ms,
+                .controller_id = render->channel[c].controller_id,
+                .channel = render->channel[c].servo_id,
+                .kind = eTRACE_RECORD_DUTY,
+                .duty_us = duty,
+                .period_us = render->period_ms * 1000,
+            };
+            last_duty[c] = duty;
+            if (!_trace_render_append(writer, &record))
+            {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+SE_ret_t trace_render_write(const char *path, SE_render_t *render, uint32_t frame_count)
+{
+    if (path == NULL || render == NULL)
+    {
+        SE_set_error("Trace path or render is null");
+        return kSE_NULL;
+    }
+
+    struct trace_render_writer writer = {0};
+    writer.file = fopen(path, "wb");
+    if (writer.file == NULL)
+    {
+        SE_set_error("Unable to create trace file");
+        return kSE_FAILED;
+    }
+
+    struct trace_header header = {.version = TRACE_VERSION, .record_size = sizeof(struct trace_record)};
+    memcpy(header.magic, TRACE_MAGIC, sizeof(header.magic));
+    bool ok = fwrite(&header, sizeof(header), 1, writer.file) == 1;
+
+    uint16_t duties[TRACE_RENDER_CHUNK_FRAMES * SE_RENDER_MAX_CHANNELS];
+    uint16_t last_duty[SE_RENDER_MAX_CHANNELS] = {0};
+    uint32_t start_frame = render->frame;
+    uint32_t end_frame = SE_render_get_frame_count(render);
+    uint32_t total = (frame_count > 0) ? frame_count : (end_frame > start_frame) ? end_frame - start_frame : 0;
+    for (uint32_t done = 0; ok && done < total;)
+    {
+        uint32_t frames = (total - done < TRACE_RENDER_CHUNK_FRAMES) ? total - done : TRACE_RENDER_CHUNK_FRAMES;
+        uint32_t first_frame = render->frame;
+        SE_render_frames(render, duties, frames);
+        ok = _trace_render_chunk(&writer, render, duties, frames, first_frame, start_frame, last_duty);
+        done += frames;
+    }
+    ok = ok && _trace_render_flush(&writer);
+
+    /* The count goes in last, as the record controller does on close */
+    header.capacity = writer.count;
+    header.count = writer.count;
+    ok = ok && fseek(writer.file, 0, SEEK_SET) == 0 && fwrite(&header, sizeof(header), 1, writer.file) == 1;
+    ok = (fclose(writer.file) == 0) && ok;
+    if (!ok)
+    {
+        SE_set_error("Unable to write trace file");
+        return kSE_FAILED;
+    }
+
+    SE_INFO("Trace %s rendered with %u records", path, writer.count);
+    return kSE_SUCCESS;
+}
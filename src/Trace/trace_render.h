@@ -0,0 +1,9 @@
+#ifndef TRACE_RENDER_H
+#define TRACE_RENDER_H
+#include "SE_render.h"
+#include "trace_format.h"
+
+/* Renders frame_count frames into a trace the replay controller can play, 0 renders until every
+ * channel holds. Like a decimating servo, a record is only written when a channel duty changes. */
+SE_ret_t trace_render_write(const char *path, SE_render_t *render, uint32_t frame_count);
+#endif /*TRACE_RENDER_H*/
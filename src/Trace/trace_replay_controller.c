@@ -0,0 +1,209 @@
+#include "trace_replay_controller.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "SE_errors.h"
+#include "SE_logging.h"
+
+SE_ret_t trace_replay_open(struct trace_replay *replay, const char *path, struct SE_controller *target)
+{
+    if (replay == NULL || path == NULL)
+    {
+        SE_set_error("Replay or trace path is null");
+        return kSE_NULL;
+    }
+
+    int fd = open(path, O_RDONLY);
+    if (fd < 0)
+    {
+        SE_set_error("Unable to open trace file");
+        return kSE_FAILED;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(struct trace_header))
+    {
+        SE_set_error("Trace file has no header");
+        close(fd);
+        return kSE_FAILED;
+    }
+
+    void *map = mmap(NULL, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED)
+    {
+        SE_set_error("Unable to map trace file");
+        return kSE_NO_MEM;
+    }
+
+    const struct trace_header *header = (const struct trace_header *)map;
+    if (memcmp(header->magic, TRACE_MAGIC, sizeof(header->magic)) != 0 || header->version != TRACE_VERSION ||
+        header->record_size != sizeof(struct trace_record))
+    {
+        SE_set_error("Trace file format is not supported");
+        munmap(map, st.st_size);
+        return kSE_NOT_SUPPORTED;
+    }
+
+    uint32_t available = (st.st_size - sizeof(struct trace_header)) / sizeof(struct trace_record);
+    const struct trace_record *record = (const struct trace_record *)(header + 1);
+    uint32_t count = header->count;
+    if (count == 0 || count > available)
+    {
+        /* Not closed by its recorder, the filled records end at the first empty one */
+        for (count = 0; count < available && record[count].kind != eTRACE_RECORD_NONE; count++)
+        {
+        }
+    }
+
+    memset(replay, 0, sizeof(*replay));
+    replay->map = map;
+    replay->map_size = st.st_size;
+    replay->record = record;
+    replay->count = count;
+    replay->target = target;
+    replay->speed_percent = 100;
+    SE_INFO("Trace %s holds %u records", path, count);
+    return kSE_SUCCESS;
+}
+
+void trace_replay_close(struct trace_replay *replay)
+{
+    if (replay == NULL || replay->map == NULL)
+    {
+        return;
+    }
+
+    munmap(replay->map, replay->map_size);
+    replay->map = NULL;
+    replay->record = NULL;
+}
+
+SE_ret_t trace_replay_start(struct trace_replay *replay, uint32_t now_tick, uint32_t speed_percent)
+{
+    if (replay == NULL || replay->map == NULL)
+    {
+        SE_set_error("Replay is not open");
+        return kSE_NULL;
+    }
+
+    if (speed_percent == 0)
+    {
+        SE_set_error("Replay speed must not be zero");
+        return kSE_OUT_OF_RANGE;
+    }
+
+    replay->next = 0;
+    replay->speed_percent = speed_percent;
+    replay->first_tick = (replay->count > 0) ? replay->record[0].tick : 0;
+    replay->start_tick = now_tick;
+    return kSE_SUCCESS;
+}
+
+static SE_ret_t _trace_replay_write(struct trace_replay *replay, const struct trace_record *record)
+{
+    struct SE_controller *target = (replay->target != NULL) ? replay->target : SE_controller_get(record->controller_id);
+    if (target == NULL)
+    {
+        SE_set_error("No controller for recorded id");
+        return kSE_FAILED;
+    }
+
+    switch (record->kind)
+    {
+    case eTRACE_RECORD_DUTY:
+        return target->set_duty(target, record->channel, record->duty_us);
+    case eTRACE_RECORD_PERIOD:
+        return target->set_period(target, record->channel, record->period_us);
+    default:
+        SE_WARNING("Unknown trace record kind %d", record->kind);
+        return kSE_FAILED;
+    }
+}
+
+/* Recorded time is scaled, the values written are the recorded ones */
+static inline uint32_t _trace_replay_due_tick(const struct trace_replay *replay, const struct trace_record *record)
+{
+    uint64_t offset = (uint64_t)(record->tick - replay->first_tick) * 100 / replay->speed_percent;
+    return replay->start_tick + (uint32_t)offset;
+}
+
+SE_ret_t trace_replay_step(struct trace_replay *replay, uint32_t now_tick)
+{
+    if (replay == NULL || replay->map == NULL)
+    {
+        SE_set_error("Replay is not open");
+        return kSE_NULL;
+    }
+
+    SE_ret_t ret = kSE_SUCCESS;
+    while (replay->next < replay->count)
+    {
+        const struct trace_record *record = &replay->record[replay->next];
+        if ((int32_t)(now_tick - _trace_replay_due_tick(replay, record)) < 0)
+        {
+            return kSE_TRY_AGAIN;
+        }
+
+        SE_ret_t write_ret = _trace_replay_write(replay, record);
+        if (ret == kSE_SUCCESS)
+        {
+            ret = write_ret;
+        }
+        replay->next++;
+    }
+    return ret;
+}
+
+static uint32_t _trace_replay_now_ms(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint32_t)(ts.tv_sec * 1000 + ts.tv_nsec / 1000000);
+}
+
+SE_ret_t trace_replay_run(struct trace_replay *replay, uint32_t speed_percent)
+{
+    if (speed_percent == 0)
+    {
+        SE_ret_t ret = trace_replay_start(replay, 0, 100);
+        if (ret != kSE_SUCCESS)
+        {
+            return ret;
+        }
+        /* Every record is due at the last recorded tick */
+        uint32_t last = (replay->count > 0) ? replay->record[replay->count - 1].tick - replay->first_tick : 0;
+        return trace_replay_step(replay, last);
+    }
+
+    SE_ret_t ret = trace_replay_start(replay, _trace_replay_now_ms(), speed_percent);
+    while (ret == kSE_SUCCESS || ret == kSE_TRY_AGAIN)
+    {
+        ret = trace_replay_step(replay, _trace_replay_now_ms());
+        if (ret != kSE_TRY_AGAIN)
+        {
+            break;
+        }
+
+        uint32_t wait_ms = _trace_replay_due_tick(replay, &replay->record[replay->next]) - _trace_replay_now_ms();
+        if ((int32_t)wait_ms > 0)
+        {
+            struct timespec delay = {.tv_sec = wait_ms / 1000, .tv_nsec = (long)(wait_ms % 1000) * 1000000};
+            while (nanosleep(&delay, &delay) == -1 && errno == EINTR)
+            {
+            }
+        }
+    }
+    return ret;
+}
+
+bool trace_replay_is_done(const struct trace_replay *replay)
+{
+    return replay == NULL || replay->next >= replay->count;
+}
@@ -0,0 +1,32 @@
+#ifndef TRACE_REPLAY_CONTROLLER_H
+#define TRACE_REPLAY_CONTROLLER_H
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "SE_controller.h"
+#include "trace_format.h"
+
+struct trace_replay
+{
+    const struct trace_record *record;
+    void *map;
+    size_t map_size;
+    uint32_t count;
+    uint32_t next;
+    struct SE_controller *target;
+    uint32_t speed_percent;
+    uint32_t first_tick;
+    uint32_t start_tick;
+};
+
+/* target NULL writes each record to the registered controller with the recorded id */
+SE_ret_t trace_replay_open(struct trace_replay *replay, const char *path, struct SE_controller *target);
+void trace_replay_close(struct trace_replay *replay);
+/* speed_percent 100 replays at the recorded rate, 400 four times faster */
+SE_ret_t trace_replay_start(struct trace_replay *replay, uint32_t now_tick, uint32_t speed_percent);
+/* Writes every record due at now_tick, kSE_TRY_AGAIN while records remain */
+SE_ret_t trace_replay_step(struct trace_replay *replay, uint32_t now_tick);
+/* Blocks on the monotonic clock until the trace is played, speed_percent 0 does not wait */
+SE_ret_t trace_replay_run(struct trace_replay *replay, uint32_t speed_percent);
+bool trace_replay_is_done(const struct trace_replay *replay);
+#endif /*TRACE_REPLAY_CONTROLLER_H*/
@@ -11,6 +11,10 @@
 #include "Dummy/dummy_controller.h"
 #endif /*USE_DUMMY_CONTROLLER*/
 
+#ifdef USE_SIM_CONTROLLER
+#include "Sim/sim_controller.h"
+#endif /*USE_SIM_CONTROLLER*/
+
 #ifdef USE_PCA9685_CONTROLLER
 #include "PCA9685/pca9685_controller.h"
 #endif /*USE_PCA9685_CONTROLLER*/
@@ -34,6 +38,12 @@ SE_ret_t SE_init(void)
 }
 
 struct SE_controller *SE_open_controller(SE_supp_controller_t controller)
+{
+    return SE_open_controller_instance(controller, 0);
+}
+
+/* Controllers without instance support only have board 0 */
+struct SE_controller *SE_open_controller_instance(SE_supp_controller_t controller, uint8_t instance)
 {
     struct SE_controller *controller_instance = NULL;
     switch (controller)
@@ -43,47 +53,101 @@ struct SE_controller *SE_open_controller(SE_supp_controller_t controller)
 
 #ifdef USE_PCA9685_CONTROLLER
     case eSE_CONTROLLER_PCA9685:
-        controller_instance = PCA9685_get_controller());
+        controller_instance = (instance == 0) ? PCA9685_get_controller() : NULL;
         break;
 #endif /*USE_PCA9685_CONTROLLER*/
 
 #ifdef USE_PCA9685_LINUX_CONTROLLER
     case eSE_CONTROLLER_LINUX_PCA9685:
-        controller_instance = PCA9685_linux_get_controller();
+        controller_instance = PCA9685_linux_get_controller_instance(instance);
         break;
 #endif /*USE_PCA9685_LINUX_CONTROLLER*/
 
 #ifdef USE_MTK_9050_LINUX_CONTROLLER
     case eSE_CONTROLLER_MTK_9050:
-        controller_instance = mtk_9050_linux_get_controller();
+        controller_instance = (instance == 0) ? mtk_9050_linux_get_controller() : NULL;
         break;
 #endif /*USE_MTK_9050_LINUX_CONTROLLER*/
 
 #ifdef USE_MTK_9050_DC_CONTROLLER
     case eSE_CONTROLLER_DC_MTK_9050:
-        controller_instance = mtk_9050_dc_motor_get_controller();
+        controller_instance = (instance == 0) ? mtk_9050_dc_motor_get_controller() : NULL;
         break;
 #endif
 
 #ifdef USE_DUMMY_CONTROLLER
     case eSE_DUMMY_CONTROLLER:
-        controller_instance = Dummy_get_controller();
+        controller_instance = Dummy_get_controller_instance(instance);
         break;
 #endif /*USE_DUMMY_CONTROLLER*/
 
+#ifdef USE_SIM_CONTROLLER
+    case eSE_SIM_CONTROLLER:
+        controller_instance = (instance == 0) ? Sim_get_controller() : NULL;
+        break;
+#endif /*USE_SIM_CONTROLLER*/
+
     default:
         SE_WARNING("Controller %d is not supported by library", controller);
         break;
     }
 
-    if (controller_instance != NULL)
+    if (controller_instance == NULL)
     {
-        SE_controller_register(controller_instance);
+        SE_WARNING("Controller %d has no instance %d", controller, instance);
+        return NULL;
     }
 
+    if (SE_controller_register(controller_instance) != kSE_SUCCESS)
+    {
+        SE_set_error("No free controller slot");
+        return NULL;
+    }
     return controller_instance;
 }
 
+int SE_count_controller_instances(SE_supp_controller_t controller)
+{
+    switch (controller)
+    {
+#ifdef USE_PCA9685_LINUX_CONTROLLER
+    case eSE_CONTROLLER_LINUX_PCA9685:
+        return PCA9685_linux_count_devices();
+#endif /*USE_PCA9685_LINUX_CONTROLLER*/
+
+#ifdef USE_DUMMY_CONTROLLER
+    case eSE_DUMMY_CONTROLLER:
+        return DUMMY_MAX_INSTANCES;
+#endif /*USE_DUMMY_CONTROLLER*/
+
+#ifdef USE_PCA9685_CONTROLLER
+    case eSE_CONTROLLER_PCA9685:
+#endif /*USE_PCA9685_CONTROLLER*/
+#ifdef USE_MTK_9050_LINUX_CONTROLLER
+    case eSE_CONTROLLER_MTK_9050:
+#endif /*USE_MTK_9050_LINUX_CONTROLLER*/
+#ifdef USE_MTK_9050_DC_CONTROLLER
+    case eSE_CONTROLLER_DC_MTK_9050:
+#endif /*USE_MTK_9050_DC_CONTROLLER*/
+#ifdef USE_SIM_CONTROLLER
+    case eSE_SIM_CONTROLLER:
+#endif /*USE_SIM_CONTROLLER*/
+        return 1;
+
+    default:
+        return 0;
+    }
+}
+
+/* A servo that failed to come up gives its channel back, so a retry can open it again */
+static void _SE_close_channel(struct SE_controller *controller, uint8_t servo_id)
+{
+    if (controller->close_servo != NULL && controller->close_servo(controller, servo_id) != kSE_SUCCESS)
+    {
+        SE_WARNING("Servo %d channel not closed, error %s", servo_id, SE_get_error());
+    }
+}
+
 SE_ret_t SE_create_servo(SE_servo_t *new_inst, SE_argument_t args)
 {
     struct SE_controller *controller = SE_controller_get(args.controller_id);
@@ -112,11 +176,27 @@ SE_ret_t SE_create_servo(SE_servo_t *new_inst, SE_argument_t args)
         ret_code = SE_servo_init(new_inst, &args);
         if (ret_code != kSE_SUCCESS)
         {
+            _SE_close_channel(controller, args.servo_id);
             break;
         }
         new_inst->id = args.servo_id;
         new_inst->controller = controller;
-        controller->set_period(controller, args.servo_id, args.period_us);
+        /* The servo still drives at the period the controller runs, as it always did */
+        if (SE_servo_set_period(new_inst, args.period_us) != kSE_SUCCESS)
+        {
+            SE_WARNING("Servo period rejected, error %s", SE_get_error());
+        }
+        if (args.calibration != NULL)
+        {
+            ret_code = SE_servo_set_calibration(new_inst, args.calibration);
+            if (ret_code != kSE_SUCCESS)
+            {
+                SE_ERROR("Servo calibration rejected, error %s", SE_get_error());
+                SE_servo_deinit(new_inst);
+                _SE_close_channel(controller, args.servo_id);
+                break;
+            }
+        }
         controller->register_servo_event((void*) new_inst);
         break;
     default:
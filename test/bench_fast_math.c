@@ -0,0 +1,89 @@
+#include <math.h>
+#include <stdint.h>
+#include <time.h>
+
+#include "SE_algorithm.h"
+#include "SE_logging.h"
+
+#define BENCH_POINTS 1000000
+/* PCA9685 counts between 0 and 180 degrees with the default 544 to 2400 us pulses */
+#define BENCH_COUNTS_PER_MOVE (491 - 111)
+
+typedef double (*bench_reference_t)(double);
+
+/* The curves from their definitions on libm doubles, the library runs its USE_FAST_MATH path */
+static double sine_reference(double t) { return sin((t - 1) * M_PI_2) + 1; }
+static double circular_reference(double t) { return 1 - sqrt(1 - (t * t)); }
+static double elastic_reference(double t) { return sin(13 * M_PI_2 * t) * pow(2, 10 * (t - 1)); }
+static double back_reference(double t) { return (t * t * t) - (t * sin(t * M_PI)); }
+
+struct bench_case
+{
+    const char *name;
+    SE_easing_t easing;
+    bench_reference_t reference;
+};
+
+static const struct bench_case bench_cases[] = {
+    {"sine", eSE_EASE_SINE, sine_reference},
+    {"circular", eSE_EASE_CIRCULAR, circular_reference},
+    {"elastic", eSE_EASE_ELASTIC, elastic_reference},
+    {"back", eSE_EASE_BACK, back_reference},
+};
+
+static uint64_t now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+static uint64_t bench_library_ps(SE_easing_t easing)
+{
+    volatile float sink = 0;
+    uint64_t start = now_ns();
+    for (int i = 0; i < BENCH_POINTS; i++)
+    {
+        sink += SE_algorithm_ease_in(easing, (float)i / BENCH_POINTS);
+    }
+    return (now_ns() - start) * 1000 / BENCH_POINTS;
+}
+
+static uint64_t bench_reference_ps(bench_reference_t reference)
+{
+    volatile double sink = 0;
+    uint64_t start = now_ns();
+    for (int i = 0; i < BENCH_POINTS; i++)
+    {
+        sink += reference((double)i / BENCH_POINTS);
+    }
+    return (now_ns() - start) * 1000 / BENCH_POINTS;
+}
+
+int main()
+{
+    int ret = 0;
+    for (size_t c = 0; c < sizeof(bench_cases) / sizeof(bench_cases[0]); c++)
+    {
+        const struct bench_case *bench = &bench_cases[c];
+        double max_error = 0;
+        for (int i = 0; i <= BENCH_POINTS; i++)
+        {
+            float t = (float)i / BENCH_POINTS;
+            double error = fabs((double)SE_algorithm_ease_in(bench->easing, t) - bench->reference(t));
+            max_error = (error > max_error) ? error : max_error;
+        }
+
+        uint64_t reference_ps = bench_reference_ps(bench->reference);
+        uint64_t library_ps = bench_library_ps(bench->easing);
+        double counts = max_error * BENCH_COUNTS_PER_MOVE;
+        SE_INFO("%-8s libm %5.1f ns, library %5.1f ns, max error %.2e = %.4f PCA9685 count", bench->name,
+                reference_ps / 1000.0, library_ps / 1000.0, max_error, counts);
+        if (counts >= 1.0)
+        {
+            SE_ERROR("%s approximation is off by a PCA9685 count", bench->name);
+            ret = -1;
+        }
+    }
+    return ret;
+}
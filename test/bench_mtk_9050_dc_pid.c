@@ -0,0 +1,60 @@
+#include <stdint.h>
+#include <time.h>
+
+#include "MTK_9050/mtk_9050_dc_pid.h"
+#include "MTK_9050/mtk_9050_dc_sim.h"
+#include "SE_logging.h"
+
+#define BENCH_TICKS 10000000
+#define BENCH_TICK_MS 10
+
+static uint64_t now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+int main()
+{
+    const struct mtk_9050_dc_sim_params params = {
+        .period = 40000,
+        .max_speed = 3600,
+        .time_constant_ms = 80,
+        .dead_duty = 4000,
+    };
+    const struct mtk_9050_dc_pid_gains gains = {
+        .kp = MTK_9050_DC_PID_GAIN(300),
+        .ki = MTK_9050_DC_PID_GAIN(20),
+        .kd = MTK_9050_DC_PID_GAIN(400),
+        .kff = MTK_9050_DC_PID_GAIN(1111),
+        .integral_limit = 8000,
+        .output_limit = 40000,
+    };
+
+    struct mtk_9050_dc_pid pid;
+    struct mtk_9050_dc_sim sim;
+    mtk_9050_dc_pid_init(&pid, &gains);
+    mtk_9050_dc_sim_init(&sim, &params);
+
+    /* Triangle setpoint between 0 and 1800 counts keeps the loop busy */
+    int32_t duty = 0;
+    int64_t checksum = 0;
+    uint64_t pid_ns = 0;
+    uint64_t start = now_ns();
+    for (uint32_t i = 0; i < BENCH_TICKS; i++)
+    {
+        mtk_9050_dc_sim_step(&sim, duty, BENCH_TICK_MS);
+        int32_t setpoint = (int32_t)(i % 360);
+        setpoint = (setpoint < 180 ? setpoint : 360 - setpoint) * 10;
+        uint64_t pid_start = now_ns();
+        duty = mtk_9050_dc_pid_update(&pid, setpoint, mtk_9050_dc_sim_position(&sim));
+        pid_ns += now_ns() - pid_start;
+        checksum += duty;
+    }
+    uint64_t total_ns = now_ns() - start;
+
+    SE_INFO("%d ticks, pid+sim %.1f ns/tick, pid %.1f ns/tick (includes clock read), checksum %lld",
+            BENCH_TICKS, (double)total_ns / BENCH_TICKS, (double)pid_ns / BENCH_TICKS, (long long)checksum);
+    return 0;
+}
@@ -0,0 +1,72 @@
+#include <stdint.h>
+
+#include "servo_easing.h"
+#include "SE_path.h"
+#include "SE_profile.h"
+#include "SE_logging.h"
+
+#define BENCH_MAX_WAYPOINTS 8
+
+struct bench_case
+{
+    const char *name;
+    SE_profile_limits_t limits;
+    uint8_t count;
+    uint8_t waypoints[BENCH_MAX_WAYPOINTS];
+};
+
+/* Pick and place cycles of an arm joint: via points around obstacles, then back */
+static const struct bench_case bench_cases[] = {
+    {"reach over", {.max_velocity = 180, .max_acceleration = 600}, 5, {10, 45, 80, 120, 170}},
+    {"pick, lift, place", {.max_velocity = 240, .max_acceleration = 1200}, 6, {20, 30, 90, 150, 160, 20}},
+    {"fine approach", {.max_velocity = 120, .max_acceleration = 400}, 7, {0, 60, 100, 120, 130, 135, 137}},
+    {"zig zag", {.max_velocity = 200, .max_acceleration = 800}, 5, {30, 150, 40, 140, 50}},
+};
+#define BENCH_CASE_COUNT (sizeof(bench_cases) / sizeof(bench_cases[0]))
+
+/* Chained rest to rest moves, what the servo does when it stops at each waypoint */
+static uint32_t stop_at_each(const struct bench_case *bench)
+{
+    uint32_t total = 0;
+    for (uint8_t i = 1; i < bench->count; i++)
+    {
+        int32_t delta = (int32_t)bench->waypoints[i] - bench->waypoints[i - 1];
+        SE_profile_t profile;
+        SE_profile_plan(&profile, &bench->limits, (uint32_t)(delta < 0 ? -delta : delta) << SE_CALIBRATION_FRAC_BITS);
+        total += profile.duration_ms;
+    }
+    return total;
+}
+
+int main()
+{
+    uint32_t stop_total = 0;
+    uint32_t path_total = 0;
+    SE_INFO("%-18s %10s %10s %8s", "cycle", "stop ms", "path ms", "saved");
+    for (uint32_t c = 0; c < BENCH_CASE_COUNT; c++)
+    {
+        const struct bench_case *bench = &bench_cases[c];
+        SE_track_t track;
+        if (SE_path_plan(&track, bench->waypoints, bench->count, &bench->limits) != kSE_SUCCESS)
+        {
+            SE_ERROR("Plan of %s failed, error %s", bench->name, SE_get_error());
+            return -1;
+        }
+
+        uint32_t stop_ms = stop_at_each(bench);
+        uint32_t path_ms = SE_track_get_duration(&track);
+        SE_INFO("%-18s %10u %10u %7u%%", bench->name, stop_ms, path_ms, (stop_ms - path_ms) * 100 / stop_ms);
+        /* Stopping is one of the paths the planner may pick, it can never be faster */
+        if (path_ms > stop_ms)
+        {
+            SE_ERROR("Planned path is slower than stopping at each waypoint");
+            return -1;
+        }
+        stop_total += stop_ms;
+        path_total += path_ms;
+    }
+
+    SE_INFO("All cycles: %u ms stopping, %u ms planned, %u%% saved", stop_total, path_total,
+            (stop_total - path_total) * 100 / stop_total);
+    return 0;
+}
@@ -0,0 +1,156 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "servo_easing.h"
+#include "SE_shm.h"
+#include "SE_shm_producer.h"
+#include "SE_ticks.h"
+#include "SE_logging.h"
+
+#define BENCH_COMMANDS 2000
+#define BENCH_INTERVAL_US 500
+
+/* Stamps the first duty written after each command, from the producer send time */
+struct bench_sink
+{
+    struct SE_controller_info info;
+    uint32_t measured_sequence;
+    uint64_t total_ns;
+    uint64_t max_ns;
+    uint32_t samples;
+};
+
+static struct bench_sink sink = {
+    .info = {.name = "Latency sink", .max_servo = 1, .units_for_0_degree = 100, .units_for_180_degree = 460},
+};
+
+static SE_servo_t servo;
+static volatile const struct SE_shm_block *block;
+
+static SE_ret_t bench_open_servo(struct SE_controller *controller, uint8_t servo_id)
+{
+    return kSE_SUCCESS;
+}
+
+static SE_ret_t bench_set_period(struct SE_controller *controller, uint8_t servo_id, uint32_t period_us)
+{
+    return kSE_SUCCESS;
+}
+
+static SE_ret_t bench_set_duty(struct SE_controller *controller, uint8_t servo_id, uint32_t duty)
+{
+    uint32_t sequence = __atomic_load_n(&block->applied_sequence, __ATOMIC_ACQUIRE);
+    if (sequence != sink.measured_sequence)
+    {
+        uint64_t latency = SE_shm_now_ns() - block->command.sent_ns;
+        sink.measured_sequence = sequence;
+        sink.total_ns += latency;
+        sink.samples++;
+        if (latency > sink.max_ns)
+        {
+            sink.max_ns = latency;
+        }
+    }
+    return kSE_SUCCESS;
+}
+
+static SE_ret_t bench_set_id(struct SE_controller *controller, int id)
+{
+    sink.info.id = id;
+    return kSE_SUCCESS;
+}
+
+static uint32_t bench_get_pulse_resolution(struct SE_controller *controller, uint8_t servo_id)
+{
+    return 500;
+}
+
+static const struct SE_controller_info *bench_get_info_ref(struct SE_controller *controller)
+{
+    return &sink.info;
+}
+
+static SE_ret_t bench_register_servo_event(void *servo)
+{
+    return kSE_SUCCESS;
+}
+
+static struct SE_controller bench_controller = {
+    .open_servo = bench_open_servo,
+    .set_duty = bench_set_duty,
+    .set_period = bench_set_period,
+    .set_id = bench_set_id,
+    .get_pulse_resolution = bench_get_pulse_resolution,
+    .get_info_ref = bench_get_info_ref,
+    .register_servo_event = bench_register_servo_event,
+};
+
+/* Out of process animation engine: sweeps the target every BENCH_INTERVAL_US */
+static int run_producer(const char *name)
+{
+    SE_shm_producer_t producer;
+    while (SE_shm_producer_open(&producer, name) == kSE_TRY_AGAIN)
+    {
+        usleep(1000);
+    }
+
+    SE_shm_command_t command = {.slot = 0, .speed = 255, .easing_type = eSE_EASE_QUARACTIC};
+    for (int i = 0; i < BENCH_COMMANDS; i++)
+    {
+        command.angle = (i & 1) ? 170 : 10;
+        SE_shm_producer_set(&producer, &command);
+        usleep(BENCH_INTERVAL_US);
+    }
+    SE_shm_producer_close(&producer);
+    return 0;
+}
+
+int main()
+{
+    char name[32];
+    snprintf(name, sizeof(name), "/se_shm_bench_%d", (int)getpid());
+    SE_controller_register(&bench_controller);
+    SE_argument_t args = {
+        .controller_id = sink.info.id,
+        .easing_type = eSE_EASE_QUARACTIC,
+        .move_type = eSE_MOV_IN,
+        .servo_id = 0,
+        .speed = 255,
+        .period_us = 20000,
+    };
+    SE_create_servo(&servo, args);
+    SE_servo_set_decimation(&servo, 0);
+    if (SE_shm_create(name) != kSE_SUCCESS)
+    {
+        SE_ERROR("Unable to create segment, error %s", SE_get_error());
+        return -1;
+    }
+    SE_shm_attach(0, &servo);
+
+    pid_t child = fork();
+    if (child == 0)
+    {
+        exit(run_producer(name));
+    }
+
+    /* The consumer maps the segment itself, look the block up through a producer view */
+    SE_shm_producer_t view;
+    SE_shm_producer_open(&view, name);
+    block = &view.segment->block[0];
+
+    int status = 0;
+    while (waitpid(child, &status, WNOHANG) == 0)
+    {
+        SE_shm_poll();
+        SE_tick_update(1);
+        SE_servo_update_all();
+    }
+
+    SE_shm_producer_close(&view);
+    SE_shm_destroy();
+    SE_INFO("%u commands to output, average %llu ns, max %llu ns", sink.samples,
+            (unsigned long long)(sink.samples ? sink.total_ns / sink.samples : 0), (unsigned long long)sink.max_ns);
+    return 0;
+}
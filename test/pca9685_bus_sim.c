@@ -0,0 +1,69 @@
+#include "pca9685_bus_sim.h"
+
+#include <string.h>
+
+/* Start, stop and the ack of every byte on top of the 8 data bits */
+#define BUS_SIM_CLOCKS_PER_BYTE 9
+#define BUS_SIM_START_STOP_CLOCKS 2
+
+void pca9685_bus_sim_init(struct pca9685_bus_sim *sim, uint32_t speed_hz)
+{
+    memset(sim, 0, sizeof(struct pca9685_bus_sim));
+    sim->speed_hz = speed_hz;
+}
+
+void pca9685_bus_sim_add_chip(struct pca9685_bus_sim *sim, uint8_t address, bool allcall)
+{
+    if (sim->chip_count < PCA9685_BUS_MAX_CHIPS)
+    {
+        sim->chip[sim->chip_count].address = address;
+        sim->chip[sim->chip_count].allcall = allcall;
+        sim->chip_count++;
+    }
+}
+
+static void _pca9685_bus_sim_store(struct pca9685_bus_sim_chip *chip, uint8_t reg, const uint8_t *data, size_t len)
+{
+    for (size_t i = 0; i < len; i++)
+    {
+        uint8_t target = reg + i;
+        if (target >= PCA9685_REG_ALL_LED_ON_L && target < PCA9685_REG_ALL_LED_ON_L + PCA9685_LED_REG_SIZE)
+        {
+            /* ALL_LED registers fan out to every channel */
+            uint8_t byte = target - PCA9685_REG_ALL_LED_ON_L;
+            for (uint8_t ch = 0; ch < PCA9685_CHANNELS; ch++)
+            {
+                chip->reg[PCA9685_REG_LED0_ON_L + PCA9685_LED_REG_SIZE * ch + byte] = data[i];
+            }
+            continue;
+        }
+        chip->reg[target] = data[i];
+    }
+}
+
+SE_ret_t pca9685_bus_sim_write(void *context, uint8_t address, uint8_t reg, const uint8_t *data, size_t len)
+{
+    struct pca9685_bus_sim *sim = (struct pca9685_bus_sim *)context;
+    bool acked = false;
+    for (uint8_t c = 0; c < sim->chip_count; c++)
+    {
+        struct pca9685_bus_sim_chip *chip = &sim->chip[c];
+        if (chip->address == address || (address == PCA9685_ALLCALL_ADDRESS && chip->allcall))
+        {
+            _pca9685_bus_sim_store(chip, reg, data, len);
+            acked = true;
+        }
+    }
+
+    uint32_t bytes = PCA9685_BUS_WRITE_OVERHEAD + len;
+    sim->busy_ns += (uint64_t)(bytes * BUS_SIM_CLOCKS_PER_BYTE + BUS_SIM_START_STOP_CLOCKS) * 1000000000 / sim->speed_hz;
+    sim->writes++;
+    sim->bytes += bytes;
+    return acked ? kSE_SUCCESS : kSE_FAILED;
+}
+
+uint16_t pca9685_bus_sim_get_off(const struct pca9685_bus_sim *sim, uint8_t chip, uint8_t channel)
+{
+    const uint8_t *led = &sim->chip[chip].reg[PCA9685_REG_LED0_ON_L + PCA9685_LED_REG_SIZE * channel];
+    return led[2] | ((led[3] & 0x0F) << 8);
+}
@@ -0,0 +1,34 @@
+#ifndef PCA9685_BUS_SIM_H
+#define PCA9685_BUS_SIM_H
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "PCA9685/pca9685_bus.h"
+
+#define PCA9685_BUS_SIM_REGS 256
+
+/* Host model of an I2C bus of PCA9685 chips: register files with auto increment, ALLCALL
+ * and ALL_LED, and the time each write holds the bus at speed_hz */
+struct pca9685_bus_sim_chip
+{
+    uint8_t address;
+    bool allcall;
+    uint8_t reg[PCA9685_BUS_SIM_REGS];
+};
+
+struct pca9685_bus_sim
+{
+    uint32_t speed_hz;
+    uint8_t chip_count;
+    struct pca9685_bus_sim_chip chip[PCA9685_BUS_MAX_CHIPS];
+    uint64_t busy_ns;
+    uint32_t writes;
+    uint32_t bytes;
+};
+
+void pca9685_bus_sim_init(struct pca9685_bus_sim *sim, uint32_t speed_hz);
+void pca9685_bus_sim_add_chip(struct pca9685_bus_sim *sim, uint8_t address, bool allcall);
+/* Matches pca9685_bus_ops.write, context is the sim */
+SE_ret_t pca9685_bus_sim_write(void *context, uint8_t address, uint8_t reg, const uint8_t *data, size_t len);
+uint16_t pca9685_bus_sim_get_off(const struct pca9685_bus_sim *sim, uint8_t chip, uint8_t channel);
+#endif /*PCA9685_BUS_SIM_H*/
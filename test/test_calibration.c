@@ -0,0 +1,217 @@
+#include <stdbool.h>
+#include <string.h>
+
+#include "servo_easing.h"
+#include "SE_calibration.h"
+#include "SE_ticks.h"
+#include "SE_logging.h"
+#include "test_stub_controller.h"
+
+#define TEST_TICK_MS 10
+
+/* Two servos in one blob, servo 1 is stiff near its ends */
+static const uint8_t test_blob[] = {
+    'S', 'E', 'C', '1', 2,
+    0, 2, 0, 0x20, 0x02, 180, 0x60, 0x09,
+    1, 4, 0, 0x58, 0x02, 30, 0xb0, 0x04, 150, 0xd0, 0x07, 180, 0xf0, 0x08,
+};
+
+static bool test_decreasing;
+static bool test_reject_period;
+
+static void test_on_duty(struct test_stub *stub, uint8_t servo_id, uint32_t duty)
+{
+    if (duty < stub->duty[servo_id])
+    {
+        test_decreasing = true;
+    }
+}
+
+static SE_ret_t test_on_period(struct test_stub *stub, uint8_t servo_id, uint32_t period_us)
+{
+    return test_reject_period ? kSE_FAILED : kSE_SUCCESS;
+}
+
+static struct test_stub test_data = {
+    .info = TEST_STUB_INFO("Calibration test controller", 2),
+    .on_duty = test_on_duty,
+    .on_period = test_on_period,
+};
+static struct SE_controller test_controller = {TEST_STUB_OPS(test_data)};
+
+static int check_blob(SE_calibration_t *calibration)
+{
+    uint16_t lut[SE_CALIBRATION_LUT_SIZE];
+    if (SE_calibration_load(calibration, test_blob, sizeof(test_blob), 1) != kSE_SUCCESS ||
+        SE_calibration_compile(calibration, lut) != kSE_SUCCESS)
+    {
+        SE_ERROR("Load servo 1 failed, error %s", SE_get_error());
+        return -1;
+    }
+
+    /* Exact at the points, piecewise linear between them */
+    if (lut[0] != 600 || lut[30] != 1200 || lut[90] != 1600 || lut[150] != 2000 || lut[180] != 2288 || lut[15] != 900)
+    {
+        SE_ERROR("Lut is %u %u %u %u %u %u", lut[0], lut[15], lut[30], lut[90], lut[150], lut[180]);
+        return -1;
+    }
+
+    SE_calibration_t other;
+    if (SE_calibration_load(&other, test_blob, sizeof(test_blob), 2) == kSE_SUCCESS ||
+        SE_calibration_load(&other, test_blob, sizeof(test_blob) - 1, 1) == kSE_SUCCESS)
+    {
+        SE_ERROR("Missing servo or truncated table must be rejected");
+        return -1;
+    }
+
+    uint8_t bad_magic[sizeof(test_blob)];
+    memcpy(bad_magic, test_blob, sizeof(test_blob));
+    bad_magic[3] = '2';
+    if (SE_calibration_load(&other, bad_magic, sizeof(bad_magic), 0) == kSE_SUCCESS)
+    {
+        SE_ERROR("Unknown blob version must be rejected");
+        return -1;
+    }
+
+    other = *calibration;
+    other.point[2].angle = 20;
+    if (SE_calibration_compile(&other, lut) != kSE_OUT_OF_RANGE)
+    {
+        SE_ERROR("Angles out of order must be rejected");
+        return -1;
+    }
+    return 0;
+}
+
+static int check_move(const SE_calibration_t *calibration)
+{
+    SE_controller_register(&test_controller);
+    SE_servo_t servo;
+    SE_argument_t args = {
+        .controller_id = test_data.info.id,
+        .easing_type = eSE_EASE_QUARACTIC,
+        .move_type = eSE_MOV_IN_OUT,
+        .servo_id = 1,
+        .speed = 180,
+        .period_us = 20000,
+        .init_angle = 0,
+        .calibration = calibration,
+    };
+    if (SE_create_servo(&servo, args) != kSE_SUCCESS)
+    {
+        SE_ERROR("Create servo failed, error %s", SE_get_error());
+        return -1;
+    }
+
+    SE_servo_set_angle(&servo, 150);
+    SE_servo_start(&servo);
+    uint32_t ticks = 0;
+    do
+    {
+        SE_tick_update(TEST_TICK_MS);
+        SE_servo_update_all();
+        ticks++;
+    } while (SE_servo_is_moving(&servo) && ticks < 1000);
+
+    if (test_data.duty[1] != 2000 || test_decreasing)
+    {
+        SE_ERROR("Calibrated move ends at %u us", test_data.duty[1]);
+        return -1;
+    }
+
+    /* Back to the controller map, 0 degree is 100 units */
+    SE_servo_set_calibration(&servo, NULL);
+    SE_servo_set_angle(&servo, 0);
+    SE_servo_start(&servo);
+    ticks = 0;
+    do
+    {
+        SE_tick_update(TEST_TICK_MS);
+        SE_servo_update_all();
+        ticks++;
+    } while (SE_servo_is_moving(&servo) && ticks < 1000);
+
+    if (test_data.duty[1] != 100 * 500 / 100)
+    {
+        SE_ERROR("Linear move ends at %u us", test_data.duty[1]);
+        return -1;
+    }
+    return 0;
+}
+
+/* A rejected period write leaves the controller on its old period, the map must still be there */
+static int check_rejected_period(void)
+{
+    SE_servo_t servo;
+    SE_argument_t args = {
+        .controller_id = test_data.info.id,
+        .easing_type = eSE_EASE_QUARACTIC,
+        .move_type = eSE_MOV_IN_OUT,
+        .servo_id = 0,
+        .speed = 180,
+        .period_us = 20000,
+        .init_angle = 0,
+    };
+    test_reject_period = true;
+    SE_ret_t ret = SE_create_servo(&servo, args);
+    test_reject_period = false;
+    if (ret != kSE_SUCCESS)
+    {
+        SE_ERROR("Create servo failed, error %s", SE_get_error());
+        return -1;
+    }
+
+    SE_servo_set_angle(&servo, 90);
+    SE_servo_start(&servo);
+    uint32_t ticks = 0;
+    do
+    {
+        SE_tick_update(TEST_TICK_MS);
+        SE_servo_update(&servo);
+        ticks++;
+    } while (SE_servo_is_moving(&servo) && ticks < 1000);
+
+    if (test_data.duty[0] != 280 * 500 / 100)
+    {
+        SE_ERROR("Move after a rejected period ends at %u us", test_data.duty[0]);
+        return -1;
+    }
+    return 0;
+}
+
+/* A calibration the servo rejects fails the create and gives the channel back */
+static int check_rejected_calibration(const SE_calibration_t *calibration)
+{
+    SE_calibration_t bad = *calibration;
+    bad.point[2].angle = 20;
+    SE_servo_t servo;
+    SE_argument_t args = {
+        .controller_id = test_data.info.id,
+        .easing_type = eSE_EASE_QUARACTIC,
+        .move_type = eSE_MOV_IN_OUT,
+        .servo_id = 1,
+        .speed = 180,
+        .period_us = 20000,
+        .init_angle = 0,
+        .calibration = &bad,
+    };
+    uint32_t close_calls = test_data.close_calls;
+    if (SE_create_servo(&servo, args) == kSE_SUCCESS || test_data.close_calls != close_calls + 1)
+    {
+        SE_ERROR("Rejected calibration must fail the servo and close its channel, %u closes",
+                 test_data.close_calls - close_calls);
+        return -1;
+    }
+    return 0;
+}
+
+int main()
+{
+    SE_calibration_t calibration;
+    if (check_blob(&calibration) != 0 || check_move(&calibration) != 0 ||
+        check_rejected_calibration(&calibration) != 0)
+    {
+        return -1;
+    }
+    return check_rejected_period();
+}
@@ -0,0 +1,167 @@
+#include <stdbool.h>
+
+#include "servo_easing.h"
+#include "SE_def.h"
+#include "SE_output.h"
+#include "SE_ticks.h"
+#include "SE_logging.h"
+#include "test_stub_controller.h"
+
+#define TEST_BATCH_SERVO 3
+#define TEST_SINGLE_SERVO 2
+#define TEST_TICK_MS 10
+
+/* Two test controllers: one implements the batch entry, the other only set_duty and goes
+ * through the generic fallback */
+struct test_batch_data
+{
+    struct test_stub stub;
+    uint32_t batch_calls;
+    uint32_t batch_channels;
+    uint32_t max_batch;
+};
+
+static SE_ret_t test_set_duty_batch(struct SE_controller *controller, const uint8_t *servo_ids,
+                                    const uint32_t *duties_us, size_t count)
+{
+    struct test_batch_data *data = (struct test_batch_data *)controller->controller_data;
+    data->batch_calls++;
+    data->batch_channels += count;
+    if (count > data->max_batch)
+    {
+        data->max_batch = count;
+    }
+
+    for (size_t i = 0; i < count; i++)
+    {
+        data->stub.duty[servo_ids[i]] = duties_us[i];
+    }
+    return kSE_SUCCESS;
+}
+
+static struct test_batch_data batch_data = {.stub = {.info = TEST_STUB_INFO("Batch test controller", 16)}};
+static struct test_batch_data single_data = {.stub = {.info = TEST_STUB_INFO("Single test controller", 16)}};
+
+static struct SE_controller batch_controller = {
+    TEST_STUB_OPS(batch_data.stub),
+    .set_duty_batch = test_set_duty_batch,
+};
+
+static struct SE_controller single_controller = {TEST_STUB_OPS(single_data.stub)};
+
+static SE_servo_t servos[TEST_BATCH_SERVO + TEST_SINGLE_SERVO];
+
+static int create_servos(void)
+{
+    for (int i = 0; i < TEST_BATCH_SERVO + TEST_SINGLE_SERVO; i++)
+    {
+        struct SE_controller *controller = (i < TEST_BATCH_SERVO) ? &batch_controller : &single_controller;
+        SE_argument_t args = {
+            .controller_id = controller->get_info_ref(controller)->id,
+            .easing_type = eSE_EASE_QUARACTIC,
+            .move_type = eSE_MOV_IN_OUT,
+            .servo_id = i,
+            .speed = 90,
+            .period_us = 20000,
+            .init_angle = 0,
+        };
+        if (SE_create_servo(&servos[i], args) != kSE_SUCCESS)
+        {
+            SE_ERROR("Create servo %d failed, error %s", i, SE_get_error());
+            return -1;
+        }
+        /* Every frame must reach the controller, period decimation is checked on its own */
+        SE_servo_set_decimation(&servos[i], false);
+        SE_servo_set_angle(&servos[i], 90);
+        SE_servo_start(&servos[i]);
+    }
+    return 0;
+}
+
+static uint32_t run_frames(void)
+{
+    uint32_t frames = 0;
+    do
+    {
+        SE_tick_update(TEST_TICK_MS);
+        SE_servo_update_all();
+        frames++;
+    } while (SE_servo_is_moving(&servos[0]) && frames < 1000);
+    return frames;
+}
+
+static int check_sync_frames(void)
+{
+    uint32_t frames = run_frames();
+    SE_INFO("%u frames, %u batch calls carrying %u channels, %u single calls", frames, batch_data.batch_calls,
+            batch_data.batch_channels, single_data.stub.duty_calls);
+
+    /* The first frame only starts the moves, every later frame writes all servos */
+    if (batch_data.batch_calls != frames - 1 || batch_data.max_batch != TEST_BATCH_SERVO || batch_data.stub.duty_calls != 0)
+    {
+        SE_ERROR("Batch controller must get one call per frame carrying all of its servos");
+        return -1;
+    }
+
+    if (single_data.batch_calls != 0 || single_data.stub.duty_calls != (frames - 1) * TEST_SINGLE_SERVO)
+    {
+        SE_ERROR("Fallback must write every servo through set_duty");
+        return -1;
+    }
+
+    for (int i = 1; i < TEST_BATCH_SERVO; i++)
+    {
+        if (batch_data.stub.duty[i] != batch_data.stub.duty[0])
+        {
+            SE_ERROR("Servo %d ends at duty %u instead of %u", i, batch_data.stub.duty[i], batch_data.stub.duty[0]);
+            return -1;
+        }
+    }
+    return 0;
+}
+
+static int check_async_frames(void)
+{
+    if (SE_output_start_async(&batch_controller) != kSE_SUCCESS)
+    {
+        SE_INFO("Async output disabled, skip");
+        return 0;
+    }
+
+    batch_data.batch_calls = 0;
+    for (int i = 0; i < TEST_BATCH_SERVO + TEST_SINGLE_SERVO; i++)
+    {
+        SE_servo_set_angle(&servos[i], 0);
+        SE_servo_start(&servos[i]);
+    }
+    uint32_t frames = run_frames();
+    SE_output_stop_async(&batch_controller);
+
+    SE_output_stats_t stats = {0};
+    SE_output_get_stats(&batch_controller, 0, &stats);
+    SE_INFO("%u async frames, %u batch calls, published %u written %u dropped %u", frames, batch_data.batch_calls,
+            stats.published, stats.written, stats.dropped);
+    if (batch_data.stub.duty_calls != 0 || batch_data.batch_calls == 0 || batch_data.batch_calls > frames)
+    {
+        SE_ERROR("Async writer must drain frames through the batch entry");
+        return -1;
+    }
+
+    if (stats.written + stats.dropped != stats.published)
+    {
+        SE_ERROR("Frame values are lost");
+        return -1;
+    }
+    return 0;
+}
+
+int main()
+{
+    SE_controller_register(&batch_controller);
+    SE_controller_register(&single_controller);
+    if (create_servos() != 0 || check_sync_frames() != 0)
+    {
+        return -1;
+    }
+    return check_async_frames();
+}
@@ -0,0 +1,232 @@
+#define _GNU_SOURCE
+#include <ftw.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "servo_easing.h"
+#include "SE_pwmchip.h"
+#include "PCA9685_linux/pca9685_linux_controller.h"
+#include "SE_def.h"
+#include "SE_logging.h"
+
+#define TEST_BOARD_CHIP_A 3
+#define TEST_BOARD_CHIP_B 11
+#define TEST_GENERIC_CHIP 7
+/* Four boards of 16 channels, every channel driving a servo */
+#define TEST_BOARDS 4
+#define TEST_BOARD_SERVOS 16
+
+static char root[64] = "/tmp/se_instances_XXXXXX";
+
+/* Fake pwmchip with channel 0 already exported */
+static int make_chip(int chip, const char *compatible)
+{
+    char path[256] = "";
+    snprintf(path, sizeof(path), "%s/pwmchip%d/pwm0", root, chip);
+    char node[256] = "";
+    snprintf(node, sizeof(node), "%s/pwmchip%d/device/of_node", root, chip);
+    char *dirs[] = {path, node};
+    for (int d = 0; d < 2; d++)
+    {
+        for (char *p = strchr(dirs[d] + strlen(root) + 1, '/'); p != NULL; p = strchr(p + 1, '/'))
+        {
+            *p = '\0';
+            mkdir(dirs[d], 0755);
+            *p = '/';
+        }
+        mkdir(dirs[d], 0755);
+    }
+
+    strcat(node, "/compatible");
+    FILE *file = fopen(node, "w");
+    if (file == NULL)
+    {
+        return -1;
+    }
+    fputs(compatible, file);
+    fclose(file);
+    return 0;
+}
+
+static long read_duty(int chip)
+{
+    char path[256] = "";
+    snprintf(path, sizeof(path), "%s/pwmchip%d/pwm0/duty_cycle", root, chip);
+    FILE *file = fopen(path, "r");
+    long duty = -1;
+    if (file != NULL)
+    {
+        if (fscanf(file, "%ld", &duty) != 1)
+        {
+            duty = -1;
+        }
+        fclose(file);
+    }
+    return duty;
+}
+
+static int remove_entry(const char *path, const struct stat *sb, int flag, struct FTW *ftw)
+{
+    return remove(path);
+}
+
+/* Instances of one type are separate controllers with their own id and channel state */
+static int check_dummy_instances(void)
+{
+    struct SE_controller *first = SE_open_controller_instance(eSE_DUMMY_CONTROLLER, 0);
+    struct SE_controller *second = SE_open_controller_instance(eSE_DUMMY_CONTROLLER, 1);
+    if (first == NULL || second == NULL || first == second || SE_open_controller(eSE_DUMMY_CONTROLLER) != first)
+    {
+        SE_ERROR("Dummy instances must be distinct and instance 0 stays the default");
+        return -1;
+    }
+
+    if (first->get_info_ref(first)->id == second->get_info_ref(second)->id ||
+        SE_open_controller_instance(eSE_DUMMY_CONTROLLER, 0)->get_info_ref(first)->id != first->get_info_ref(first)->id)
+    {
+        SE_ERROR("Each instance needs its own controller id, kept on reopen");
+        return -1;
+    }
+
+    first->set_period(first, 0, 20000);
+    second->set_period(second, 0, 10000);
+    if (first->get_pulse_resolution(first, 0) == second->get_pulse_resolution(second, 0))
+    {
+        SE_ERROR("Instances share channel state");
+        return -1;
+    }
+
+    if (SE_open_controller_instance(eSE_DUMMY_CONTROLLER, SE_count_controller_instances(eSE_DUMMY_CONTROLLER)) != NULL)
+    {
+        SE_ERROR("Instance past the count must be refused");
+        return -1;
+    }
+    return 0;
+}
+
+static int check_servo_pool(void)
+{
+    static SE_servo_t servo[TEST_BOARDS * TEST_BOARD_SERVOS];
+    if (MAX_SERVO_INSTANCES < TEST_BOARDS * TEST_BOARD_SERVOS)
+    {
+        SE_INFO("Servo pool of %d is too small for %d boards, skip", MAX_SERVO_INSTANCES, TEST_BOARDS);
+        return 0;
+    }
+
+    int created = 0;
+    for (int b = 0; b < TEST_BOARDS; b++)
+    {
+        struct SE_controller *board = SE_open_controller_instance(eSE_DUMMY_CONTROLLER, b);
+        for (int i = 0; board != NULL && i < TEST_BOARD_SERVOS; i++)
+        {
+            SE_argument_t args = {
+                .controller_id = board->get_info_ref(board)->id,
+                .easing_type = eSE_EASE_QUARACTIC,
+                .move_type = eSE_MOV_IN_OUT,
+                .servo_id = i,
+                .speed = 90,
+                .period_us = 20000,
+            };
+            if (SE_create_servo(&servo[created], args) == kSE_SUCCESS)
+            {
+                created++;
+            }
+        }
+    }
+
+    for (int i = 0; i < created; i++)
+    {
+        SE_servo_deinit(&servo[i]);
+    }
+
+    if (created != TEST_BOARDS * TEST_BOARD_SERVOS)
+    {
+        SE_ERROR("Only %d servos created on %d boards", created, TEST_BOARDS);
+        return -1;
+    }
+    return 0;
+}
+
+static int check_pca9685_boards(void)
+{
+    if (make_chip(TEST_BOARD_CHIP_A, "nxp,pca9685-pwm\n") != 0 || make_chip(TEST_GENERIC_CHIP, "vendor,generic-pwm\n") != 0 ||
+        make_chip(TEST_BOARD_CHIP_B, "nxp,pca9685-pwm\n") != 0)
+    {
+        SE_ERROR("Unable to generate fake pwmchips");
+        return -1;
+    }
+    SE_pwmchip_set_root(root);
+
+    if (PCA9685_linux_count_devices() != 2)
+    {
+        SE_ERROR("Expect 2 boards, found %d", PCA9685_linux_count_devices());
+        return -1;
+    }
+
+    struct SE_controller *board[3];
+    for (int i = 0; i < 3; i++)
+    {
+        board[i] = PCA9685_linux_get_controller_instance(i);
+    }
+
+    if (board[0]->controller_init(board[0]) != kSE_SUCCESS || board[1]->controller_init(board[1]) != kSE_SUCCESS ||
+        board[2]->controller_init(board[2]) == kSE_SUCCESS)
+    {
+        SE_ERROR("Only discovered boards may init");
+        return -1;
+    }
+
+    char bind_path[128] = "";
+    snprintf(bind_path, sizeof(bind_path), "%s/pwmchip%d", root, TEST_BOARD_CHIP_A);
+    if (PCA9685_linux_bind(board[2], bind_path) != kSE_SUCCESS || board[2]->controller_init(board[2]) != kSE_SUCCESS)
+    {
+        SE_ERROR("Bound board must init on its pwmchip");
+        return -1;
+    }
+
+    int ret = 0;
+    for (int i = 0; i < 2 && ret == 0; i++)
+    {
+        if (board[i]->open_servo(board[i], 0) != kSE_SUCCESS || board[i]->set_duty(board[i], 0, 1000 + 500 * i) != kSE_SUCCESS)
+        {
+            SE_ERROR("Board %d unable to drive channel 0", i);
+            ret = -1;
+        }
+    }
+
+    if (ret == 0 && (read_duty(TEST_BOARD_CHIP_A) != 1000000 || read_duty(TEST_BOARD_CHIP_B) != 1500000))
+    {
+        SE_ERROR("Board duties landed on %ld and %ld", read_duty(TEST_BOARD_CHIP_A), read_duty(TEST_BOARD_CHIP_B));
+        ret = -1;
+    }
+
+    for (int i = 0; i < 3; i++)
+    {
+        board[i]->controller_deinit(board[i]);
+    }
+    return ret;
+}
+
+int main()
+{
+    if (mkdtemp(root) == NULL)
+    {
+        SE_ERROR("Unable to create fake sysfs root");
+        return -1;
+    }
+
+    int ret = check_dummy_instances();
+    if (ret == 0)
+    {
+        ret = check_servo_pool();
+    }
+    if (ret == 0)
+    {
+        ret = check_pca9685_boards();
+    }
+    nftw(root, remove_entry, 16, FTW_DEPTH | FTW_PHYS);
+    return ret;
+}
@@ -0,0 +1,158 @@
+#include <stdbool.h>
+#include <stdio.h>
+#include <unistd.h>
+
+#include "servo_easing.h"
+#include "SE_daemon.h"
+#include "SE_daemon_client.h"
+#include "SE_ticks.h"
+#include "SE_logging.h"
+#include "test_stub_controller.h"
+
+#define TEST_TICK_MS 10
+#define TEST_SERVO 4
+#define TEST_COMMANDS 300
+
+static struct test_stub test_data = {.info = TEST_STUB_INFO("Daemon test controller", 4)};
+static struct SE_controller test_controller = {TEST_STUB_OPS(test_data)};
+
+static SE_servo_t servo[TEST_SERVO];
+static SE_daemon_client_t client[2];
+
+static void run_until_still(void)
+{
+    uint32_t ticks = 0;
+    bool moving;
+    do
+    {
+        SE_daemon_poll(0);
+        SE_daemon_tick();
+        SE_tick_update(TEST_TICK_MS);
+        SE_servo_update_all();
+        moving = false;
+        for (int i = 0; i < TEST_SERVO; i++)
+        {
+            moving |= SE_servo_is_moving(&servo[i]);
+        }
+        ticks++;
+    } while (moving && ticks < 1000);
+}
+
+/* Both clients keep the daemon busy in the same tick, each on its own pair of servos */
+static int check_batched_clients(void)
+{
+    for (int i = 0; i < TEST_COMMANDS; i++)
+    {
+        for (int c = 0; c < 2; c++)
+        {
+            uint16_t angle = (i == TEST_COMMANDS - 1) ? 30 + 90 * c : i % 180;
+            SE_daemon_client_move(&client[c], 2 * c + i % 2, angle, 180, eSE_EASE_QUARACTIC, eSE_MOV_IN_OUT);
+        }
+    }
+    SE_daemon_client_flush(&client[0]);
+    SE_daemon_client_flush(&client[1]);
+
+    int queued = 0;
+    for (int i = 0; i < 10 && queued < 2 * TEST_COMMANDS; i++)
+    {
+        queued += SE_daemon_poll(100);
+    }
+    int applied = SE_daemon_tick();
+    if (queued != 2 * TEST_COMMANDS || applied != 2 * TEST_COMMANDS)
+    {
+        SE_ERROR("%d commands queued and %d applied out of %d", queued, applied, 2 * TEST_COMMANDS);
+        return -1;
+    }
+
+    run_until_still();
+    int expect[TEST_SERVO] = {(TEST_COMMANDS - 2) % 180, 30, (TEST_COMMANDS - 2) % 180, 120};
+    for (int i = 0; i < TEST_SERVO; i++)
+    {
+        if (SE_servo_get_angle(&servo[i]) != expect[i])
+        {
+            SE_ERROR("Servo %d at %d deg instead of %d", i, SE_servo_get_angle(&servo[i]), expect[i]);
+            return -1;
+        }
+    }
+    return 0;
+}
+
+static int check_bad_commands(void)
+{
+    SE_daemon_command_t command = {.op = eSE_DAEMON_OP_MOVE, .servo = TEST_SERVO, .angle = 90};
+    SE_daemon_client_queue(&client[0], &command);
+    command = (SE_daemon_command_t){.op = eSE_DAEMON_OP_SPEED, .servo = 0, .speed = 45};
+    SE_daemon_client_queue(&client[0], &command);
+    SE_daemon_client_flush(&client[0]);
+    SE_daemon_poll(100);
+    if (SE_daemon_tick() != 1 || SE_servo_get_speed(&servo[0]) != 45)
+    {
+        SE_ERROR("Only the command for a known servo must be applied");
+        return -1;
+    }
+    return 0;
+}
+
+/* Speed 0 would divide the next move by zero and take the daemon down with every servo */
+static int check_zero_speed(void)
+{
+    SE_daemon_command_t command = {.op = eSE_DAEMON_OP_SPEED, .servo = 0, .speed = 0};
+    SE_daemon_client_queue(&client[0], &command);
+    SE_daemon_client_move(&client[0], 0, 10, 0, eSE_EASE_QUARACTIC, eSE_MOV_IN_OUT);
+    SE_daemon_client_flush(&client[0]);
+    SE_daemon_poll(100);
+    if (SE_daemon_tick() != 1 || SE_servo_get_speed(&servo[0]) != 45)
+    {
+        SE_ERROR("Speed 0 must be rejected and the move keep the servo speed");
+        return -1;
+    }
+
+    run_until_still();
+    if (SE_servo_get_angle(&servo[0]) != 10)
+    {
+        SE_ERROR("Servo 0 at %d deg instead of 10", SE_servo_get_angle(&servo[0]));
+        return -1;
+    }
+    return 0;
+}
+
+int main()
+{
+    char path[64];
+    snprintf(path, sizeof(path), "/tmp/se_daemon_test_%d.sock", (int)getpid());
+    SE_controller_register(&test_controller);
+    for (int i = 0; i < TEST_SERVO; i++)
+    {
+        SE_argument_t args = {
+            .controller_id = test_data.info.id,
+            .easing_type = eSE_EASE_QUARACTIC,
+            .move_type = eSE_MOV_IN,
+            .servo_id = i,
+            .speed = 90,
+            .period_us = 20000,
+        };
+        SE_create_servo(&servo[i], args);
+    }
+
+    if (SE_daemon_client_connect(&client[0], path) == kSE_SUCCESS || SE_daemon_open(path, servo, TEST_SERVO) != kSE_SUCCESS ||
+        SE_daemon_client_connect(&client[0], path) != kSE_SUCCESS ||
+        SE_daemon_client_connect(&client[1], path) != kSE_SUCCESS)
+    {
+        SE_ERROR("Clients must connect only once the daemon listens");
+        return -1;
+    }
+
+    int ret = check_batched_clients();
+    if (ret == 0)
+    {
+        ret = check_bad_commands();
+    }
+    if (ret == 0)
+    {
+        ret = check_zero_speed();
+    }
+    SE_daemon_client_close(&client[0]);
+    SE_daemon_client_close(&client[1]);
+    SE_daemon_close();
+    return ret;
+}
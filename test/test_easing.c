@@ -0,0 +1,266 @@
+#include <math.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "servo_easing.h"
+#include "SE_easing.h"
+#include "SE_ticks.h"
+#include "SE_logging.h"
+#include "test_stub_controller.h"
+
+#define TEST_TICK_MS 10
+#define TEST_POINTS 1000
+/* Table spacing bounds the error of the straight lines between entries */
+#define TEST_TOLERANCE (SE_EASING_ONE / 500)
+#define TEST_BENCH_EVALS 1000000
+
+static struct test_stub test_data = {.info = TEST_STUB_INFO("Easing test controller", 1)};
+static struct SE_controller test_controller = {TEST_STUB_OPS(test_data)};
+
+static double bezier(double s, double p1, double p2)
+{
+    double r = 1.0 - s;
+    return 3 * r * r * s * p1 + 3 * r * s * s * p2 + s * s * s;
+}
+
+/* CSS cubic-bezier straight from its definition, x solved by bisection in doubles */
+static double reference(double x, const double *points)
+{
+    double low = 0.0;
+    double high = 1.0;
+    for (int i = 0; i < 60; i++)
+    {
+        double s = (low + high) / 2;
+        if (bezier(s, points[0], points[2]) < x)
+        {
+            low = s;
+        }
+        else
+        {
+            high = s;
+        }
+    }
+    return bezier((low + high) / 2, points[1], points[3]);
+}
+
+static int check_bezier(void)
+{
+    /* CSS ease-in-out and a back-like curve that overshoots both ends */
+    const double curves[][4] = {{0.42, 0.0, 0.58, 1.0}, {0.68, -0.55, 0.27, 1.55}};
+    for (size_t c = 0; c < sizeof(curves) / sizeof(curves[0]); c++)
+    {
+        const double *points = curves[c];
+        SE_easing_t type;
+        if (SE_easing_register_bezier(SE_EASING_FIXED(points[0]), SE_EASING_FIXED(points[1]),
+                                      SE_EASING_FIXED(points[2]), SE_EASING_FIXED(points[3]), &type) != kSE_SUCCESS)
+        {
+            SE_ERROR("Register curve %d failed, error %s", (int)c, SE_get_error());
+            return -1;
+        }
+
+        int32_t max_error = 0;
+        for (int i = 0; i <= TEST_POINTS; i++)
+        {
+            double x = (double)i / TEST_POINTS;
+            int32_t y = SE_easing_custom_eval(type, (int32_t)(x * SE_EASING_ONE));
+            int32_t error = abs(y - (int32_t)lround(reference(x, points) * SE_EASING_ONE));
+            max_error = (error > max_error) ? error : max_error;
+        }
+        SE_INFO("Curve %d registered as %d, max error %d/%d", (int)c, type, max_error, SE_EASING_ONE);
+        if (max_error > TEST_TOLERANCE || SE_easing_custom_eval(type, 0) != 0 ||
+            SE_easing_custom_eval(type, SE_EASING_ONE) != SE_EASING_ONE)
+        {
+            SE_ERROR("Curve drifts from the cubic-bezier reference");
+            return -1;
+        }
+        SE_easing_unregister(type);
+    }
+
+    SE_easing_t type;
+    if (SE_easing_register_bezier(SE_EASING_FIXED(1.5), 0, SE_EASING_FIXED(0.5), SE_EASING_ONE, &type) !=
+        kSE_OUT_OF_RANGE)
+    {
+        SE_ERROR("Control x out of 0..1 must be rejected");
+        return -1;
+    }
+    return 0;
+}
+
+static int check_registry(void)
+{
+    const int32_t samples[] = {0, SE_EASING_ONE / 2, SE_EASING_ONE};
+    SE_easing_t types[SE_EASING_MAX_CUSTOM];
+    for (int i = 0; i < SE_EASING_MAX_CUSTOM; i++)
+    {
+        if (SE_easing_register_table(samples, 3, &types[i]) != kSE_SUCCESS || !SE_easing_is_valid(types[i]))
+        {
+            SE_ERROR("Register table %d failed, error %s", i, SE_get_error());
+            return -1;
+        }
+    }
+
+    SE_easing_t extra;
+    if (SE_easing_register_table(samples, 3, &extra) != kSE_NO_MEM)
+    {
+        SE_ERROR("Registry must be full");
+        return -1;
+    }
+
+    int32_t quarter = SE_easing_custom_eval(types[0], SE_EASING_ONE / 4);
+    for (int i = 0; i < SE_EASING_MAX_CUSTOM; i++)
+    {
+        SE_easing_unregister(types[i]);
+    }
+
+    if (quarter != SE_EASING_ONE / 4 || SE_easing_is_valid(types[0]) || !SE_easing_is_valid(eSE_EASE_QUARACTIC))
+    {
+        SE_ERROR("Table curve or registry state is wrong, quarter at %d", quarter);
+        return -1;
+    }
+    return 0;
+}
+
+/* A straight table curve moves the servo at a constant speed, half way at half time */
+static int check_servo(void)
+{
+    const int32_t samples[] = {0, SE_EASING_ONE};
+    SE_easing_t type;
+    SE_easing_register_table(samples, 2, &type);
+    SE_controller_register(&test_controller);
+    SE_argument_t args = {
+        .controller_id = test_data.info.id,
+        .easing_type = type,
+        .move_type = eSE_MOV_IN,
+        .servo_id = 0,
+        .speed = 90,
+        .period_us = 20000,
+    };
+    SE_servo_t servo;
+    if (SE_create_servo(&servo, args) != kSE_SUCCESS)
+    {
+        SE_ERROR("Create servo failed, error %s", SE_get_error());
+        return -1;
+    }
+
+    SE_servo_set_angle(&servo, 90);
+    SE_servo_start(&servo);
+    uint32_t ticks = 0;
+    int middle = -1;
+    do
+    {
+        SE_tick_update(TEST_TICK_MS);
+        SE_servo_update_all();
+        ticks++;
+        middle = (ticks * TEST_TICK_MS == 510) ? SE_servo_get_angle(&servo) : middle;
+    } while (SE_servo_is_moving(&servo) && ticks < 1000);
+
+    SE_INFO("Custom curve move in %u ticks, %d deg at half time, end %d deg", ticks, middle,
+            SE_servo_get_angle(&servo));
+    if (abs(middle - 45) > 3 || SE_servo_get_angle(&servo) != 90)
+    {
+        SE_ERROR("Servo must follow the registered curve");
+        return -1;
+    }
+    SE_servo_deinit(&servo);
+    SE_easing_unregister(type);
+    return 0;
+}
+
+/* Runs the move to its end, keeping the lowest and highest duty written on the way */
+static void run_move(SE_servo_t *servo, uint32_t *low, uint32_t *high)
+{
+    *low = UINT32_MAX;
+    *high = 0;
+    uint32_t ticks = 0;
+    do
+    {
+        SE_tick_update(TEST_TICK_MS);
+        SE_servo_update_all();
+        *low = (test_data.duty[0] < *low) ? test_data.duty[0] : *low;
+        *high = (test_data.duty[0] > *high) ? test_data.duty[0] : *high;
+        ticks++;
+    } while (SE_servo_is_moving(servo) && ticks < 1000);
+}
+
+/* A back curve passes both ends of a move, next to 0 and 180 degree the servo holds at the end
+ * of its range instead of wrapping. The stub maps 0 degree to 500 us and 180 degree to 2300 us,
+ * 10 us per degree. */
+static int check_overshoot(void)
+{
+    const struct
+    {
+        int from;
+        int to;
+        SE_easing_mov_t move;
+    } moves[] = {{5, 0, eSE_MOV_OUT}, {0, 10, eSE_MOV_IN}, {175, 180, eSE_MOV_OUT}, {180, 170, eSE_MOV_IN}};
+    SE_easing_t back;
+    SE_easing_register_bezier(SE_EASING_FIXED(.68), SE_EASING_FIXED(-.55), SE_EASING_FIXED(.265),
+                              SE_EASING_FIXED(1.55), &back);
+    SE_argument_t args = {
+        .controller_id = test_data.info.id,
+        .easing_type = eSE_EASE_QUARACTIC,
+        .move_type = eSE_MOV_IN,
+        .servo_id = 0,
+        .speed = 90,
+        .period_us = 20000,
+    };
+    SE_servo_t servo;
+    if (SE_create_servo(&servo, args) != kSE_SUCCESS)
+    {
+        SE_ERROR("Create servo failed, error %s", SE_get_error());
+        return -1;
+    }
+
+    for (size_t i = 0; i < sizeof(moves) / sizeof(moves[0]); i++)
+    {
+        uint32_t low = 0;
+        uint32_t high = 0;
+        SE_servo_retarget(&servo, eSE_EASE_QUARACTIC, eSE_MOV_IN, 90, moves[i].from);
+        run_move(&servo, &low, &high);
+        SE_servo_retarget(&servo, back, moves[i].move, 10, moves[i].to);
+        run_move(&servo, &low, &high);
+
+        /* The curve passes each end by a tenth of the move at most */
+        int near = (moves[i].from < moves[i].to) ? moves[i].from : moves[i].to;
+        int far = (moves[i].from < moves[i].to) ? moves[i].to : moves[i].from;
+        SE_INFO("Back curve %d to %d deg between %u and %u us", moves[i].from, moves[i].to, low, high);
+        if (low < 500 + 10 * (uint32_t)(near > 2 ? near - 2 : 0) || high > 500 + 10 * (uint32_t)(far + 2) ||
+            SE_servo_get_angle(&servo) != moves[i].to)
+        {
+            SE_ERROR("Move must stay next to its ends and within the servo range");
+            return -1;
+        }
+    }
+    SE_servo_deinit(&servo);
+    SE_easing_unregister(back);
+    return 0;
+}
+
+static void bench_eval(void)
+{
+    SE_easing_t type;
+    SE_easing_register_bezier(SE_EASING_FIXED(0.25), SE_EASING_FIXED(0.1), SE_EASING_FIXED(0.25), SE_EASING_ONE, &type);
+    struct timespec start, end;
+    volatile int32_t sink = 0;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (uint32_t i = 0; i < TEST_BENCH_EVALS; i++)
+    {
+        sink += SE_easing_custom_eval(type, i & (SE_EASING_ONE - 1));
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    uint64_t elapse_ns = (uint64_t)(end.tv_sec - start.tv_sec) * 1000000000 + end.tv_nsec - start.tv_nsec;
+    SE_INFO("%u evaluations, %llu ns each", TEST_BENCH_EVALS, (unsigned long long)(elapse_ns / TEST_BENCH_EVALS));
+    SE_easing_unregister(type);
+}
+
+int main()
+{
+    if (check_bezier() != 0 || check_registry() != 0 || check_servo() != 0 || check_overshoot() != 0)
+    {
+        return -1;
+    }
+    bench_eval();
+    return 0;
+}
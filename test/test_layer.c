@@ -0,0 +1,178 @@
+#include <stdbool.h>
+#include <stdlib.h>
+
+#include "servo_easing.h"
+#include "SE_layer.h"
+#include "SE_ticks.h"
+#include "SE_logging.h"
+#include "test_stub_controller.h"
+
+#define TEST_TICK_MS 10
+#define TEST_BASE 90
+#define TEST_BREATH_MS 1000
+#define TEST_BREATH_DEG 4
+#define TEST_GESTURE_MS 600
+#define TEST_GESTURE_DEG 20
+
+#define DEG(angle) ((uint32_t)(angle) << SE_CALIBRATION_FRAC_BITS)
+
+/* Breathing swings the base pose, the gesture goes out and comes back on top of it */
+static const SE_layer_desc_t breath = {
+    .blend = eSE_LAYER_ADDITIVE,
+    .easing_type = eSE_EASE_QUARACTIC,
+    .move_type = eSE_MOV_IN_OUT,
+    .from = -TEST_BREATH_DEG,
+    .to = TEST_BREATH_DEG,
+    .duration_ms = TEST_BREATH_MS,
+    .weight = SE_LAYER_WEIGHT_ONE,
+    .loop = true,
+};
+
+static const SE_layer_desc_t gesture = {
+    .blend = eSE_LAYER_ADDITIVE,
+    .easing_type = eSE_EASE_QUARACTIC,
+    .move_type = eSE_MOV_BOUNCING_OUT_IN,
+    .from = 0,
+    .to = TEST_GESTURE_DEG,
+    .duration_ms = TEST_GESTURE_MS,
+    .weight = SE_LAYER_WEIGHT_ONE,
+};
+
+static struct test_stub test_data = {.info = TEST_STUB_INFO("Layer test controller", 1)};
+static struct SE_controller test_controller = {TEST_STUB_OPS(test_data)};
+
+static int check_blend(void)
+{
+    static SE_layer_stack_t stack;
+    SE_layer_init(&stack);
+    SE_layer_set_base(&stack, DEG(TEST_BASE));
+    if (SE_layer_eval(&stack, 0) != DEG(TEST_BASE))
+    {
+        SE_ERROR("Idle stack must hold the base pose");
+        return -1;
+    }
+
+    SE_layer_play(&stack, 0, &breath, 0);
+    uint32_t low = SE_layer_eval(&stack, 0);
+    uint32_t high = SE_layer_eval(&stack, TEST_BREATH_MS);
+    uint32_t back = SE_layer_eval(&stack, 2 * TEST_BREATH_MS);
+    if (low != DEG(TEST_BASE - TEST_BREATH_DEG) || high != DEG(TEST_BASE + TEST_BREATH_DEG) || back != low)
+    {
+        SE_ERROR("Breath swings %u, %u, %u", low, high, back);
+        return -1;
+    }
+
+    /* The gesture peaks at half time and adds to the breath under it */
+    SE_layer_play(&stack, 1, &gesture, 0);
+    uint32_t peak = SE_layer_eval(&stack, TEST_GESTURE_MS / 2);
+    SE_layer_stack_t reference = {.base = DEG(TEST_BASE), .active = 1, .layer = {stack.layer[0]}};
+    uint32_t breath_at_peak = SE_layer_eval(&reference, TEST_GESTURE_MS / 2);
+    if (peak != breath_at_peak + DEG(TEST_GESTURE_DEG))
+    {
+        SE_ERROR("Gesture peak %u over breath %u", peak, breath_at_peak);
+        return -1;
+    }
+
+    SE_layer_eval(&stack, TEST_GESTURE_MS);
+    if (stack.active != 1)
+    {
+        SE_ERROR("Gesture back at no offset must retire, active %x", stack.active);
+        return -1;
+    }
+
+    /* Half an override toward 30 degrees lands half way from the breathing pose */
+    SE_layer_desc_t look = {
+        .blend = eSE_LAYER_OVERRIDE,
+        .easing_type = eSE_EASE_QUARACTIC,
+        .move_type = eSE_MOV_IN,
+        .from = 30,
+        .to = 30,
+        .duration_ms = 100,
+        .weight = SE_LAYER_WEIGHT_ONE / 2,
+    };
+    SE_layer_play(&stack, 2, &look, TEST_BREATH_MS);
+    uint32_t looked = SE_layer_eval(&stack, TEST_BREATH_MS);
+    if (looked != (DEG(TEST_BASE + TEST_BREATH_DEG) + DEG(30)) / 2)
+    {
+        SE_ERROR("Half override at %u", looked);
+        return -1;
+    }
+
+    SE_layer_set_weight(&stack, 2, SE_LAYER_WEIGHT_ONE);
+    SE_layer_stop(&stack, 0);
+    if (SE_layer_eval(&stack, TEST_BREATH_MS + 500) != DEG(30))
+    {
+        SE_ERROR("Full override must take the pose");
+        return -1;
+    }
+
+    look.weight = SE_LAYER_WEIGHT_ONE + 1;
+    if (SE_layer_play(&stack, 3, &look, 0) != kSE_OUT_OF_RANGE ||
+        SE_layer_play(&stack, SE_LAYER_MAX, &breath, 0) != kSE_OUT_OF_RANGE)
+    {
+        SE_ERROR("Out of range layers must be rejected");
+        return -1;
+    }
+    return 0;
+}
+
+/* The servo plays the layers on its tick path and keeps running when they change */
+static int check_servo(void)
+{
+    static SE_layer_stack_t stack;
+    SE_layer_init(&stack);
+    SE_servo_t servo;
+    SE_argument_t args = {
+        .controller_id = test_data.info.id,
+        .easing_type = eSE_EASE_QUARACTIC,
+        .move_type = eSE_MOV_IN_OUT,
+        .servo_id = 0,
+        .speed = 90,
+        .period_us = 20000,
+        .init_angle = TEST_BASE,
+    };
+    if (SE_create_servo(&servo, args) != kSE_SUCCESS || SE_servo_set_layers(&servo, &stack) != kSE_SUCCESS)
+    {
+        SE_ERROR("Create servo failed, error %s", SE_get_error());
+        return -1;
+    }
+
+    SE_servo_set_decimation(&servo, false);
+    SE_servo_start(&servo);
+    SE_tick_update(TEST_TICK_MS);
+    SE_servo_update(&servo);
+    uint32_t start_ms = SE_tick_get_current_tick();
+    SE_layer_play(&stack, 0, &breath, start_ms);
+    uint8_t min_angle = 180;
+    uint8_t max_angle = 0;
+    for (uint32_t t = 0; t < 2 * TEST_BREATH_MS; t += TEST_TICK_MS)
+    {
+        SE_tick_update(TEST_TICK_MS);
+        SE_servo_update(&servo);
+        uint8_t angle = SE_servo_get_angle(&servo);
+        min_angle = (angle < min_angle) ? angle : min_angle;
+        max_angle = (angle > max_angle) ? angle : max_angle;
+    }
+
+    SE_INFO("Breathing servo swings %u..%u degrees", min_angle, max_angle);
+    if (!SE_servo_is_moving(&servo) || min_angle != TEST_BASE - TEST_BREATH_DEG ||
+        max_angle != TEST_BASE + TEST_BREATH_DEG)
+    {
+        SE_ERROR("Servo does not follow the breathing layer");
+        return -1;
+    }
+
+    SE_servo_stop(&servo);
+    SE_servo_update(&servo);
+    return SE_servo_set_layers(&servo, NULL) == kSE_SUCCESS ? 0 : -1;
+}
+
+int main()
+{
+    SE_controller_register(&test_controller);
+    if (check_blend() != 0)
+    {
+        return -1;
+    }
+    return check_servo();
+}
@@ -0,0 +1,115 @@
+#include <stdlib.h>
+
+#include "MTK_9050/mtk_9050_dc_pid.h"
+#include "MTK_9050/mtk_9050_dc_sim.h"
+#include "SE_logging.h"
+
+#define TEST_TICK_MS 10
+#define TEST_MOVE_MS 1500
+#define TEST_SETTLE_MS 500
+#define TEST_MOVE_COUNTS 1800
+#define TEST_MAX_TRACKING_ERROR 40
+#define TEST_MAX_FINAL_ERROR 3
+
+static const struct mtk_9050_dc_sim_params sim_params = {
+    .period = 40000,
+    .max_speed = 3600,
+    .time_constant_ms = 80,
+    .dead_duty = 4000,
+};
+
+static const struct mtk_9050_dc_pid_gains gains = {
+    .kp = MTK_9050_DC_PID_GAIN(300),
+    .ki = MTK_9050_DC_PID_GAIN(20),
+    .kd = MTK_9050_DC_PID_GAIN(400),
+    .kff = MTK_9050_DC_PID_GAIN(1111),
+    .integral_limit = 8000,
+    .output_limit = 40000,
+};
+
+/* Quadratic in out ease, same shape as eSE_EASE_QUARACTIC with eSE_MOV_IN_OUT */
+static int32_t eased_setpoint(uint32_t elapse_ms)
+{
+    if (elapse_ms >= TEST_MOVE_MS)
+    {
+        return TEST_MOVE_COUNTS;
+    }
+
+    int64_t t = (int64_t)elapse_ms * 2000 / TEST_MOVE_MS;
+    if (t <= 1000)
+    {
+        return (int32_t)(TEST_MOVE_COUNTS * t * t / 2000000);
+    }
+    t = 2000 - t;
+    return (int32_t)(TEST_MOVE_COUNTS - TEST_MOVE_COUNTS * t * t / 2000000);
+}
+
+static int check_tracking(void)
+{
+    struct mtk_9050_dc_sim sim;
+    struct mtk_9050_dc_pid pid;
+    mtk_9050_dc_sim_init(&sim, &sim_params);
+    mtk_9050_dc_pid_init(&pid, &gains);
+
+    int32_t max_error = 0;
+    int32_t duty = 0;
+    for (uint32_t ms = 0; ms <= TEST_MOVE_MS + TEST_SETTLE_MS; ms += TEST_TICK_MS)
+    {
+        mtk_9050_dc_sim_step(&sim, duty, TEST_TICK_MS);
+        struct counter_value counter;
+        mtk_9050_dc_sim_write_encoder(&sim, &counter);
+        int32_t measured = (int32_t)(counter.a_forward - counter.b_backward);
+        int32_t setpoint = eased_setpoint(ms);
+        duty = mtk_9050_dc_pid_update(&pid, setpoint, measured);
+        if (abs(setpoint - measured) > max_error)
+        {
+            max_error = abs(setpoint - measured);
+        }
+    }
+
+    int32_t final_error = abs(TEST_MOVE_COUNTS - mtk_9050_dc_sim_position(&sim));
+    SE_INFO("Tracking error max %d counts, final %d counts", max_error, final_error);
+    if (max_error > TEST_MAX_TRACKING_ERROR || final_error > TEST_MAX_FINAL_ERROR)
+    {
+        SE_ERROR("Motor does not follow the eased trajectory");
+        return -1;
+    }
+    return 0;
+}
+
+static int check_anti_windup(void)
+{
+    struct mtk_9050_dc_pid pid;
+    mtk_9050_dc_pid_init(&pid, &gains);
+
+    /* A stalled motor saturates the output, the integral must stay bounded */
+    for (int i = 0; i < 1000; i++)
+    {
+        mtk_9050_dc_pid_update(&pid, 1000, 0);
+    }
+
+    if (pid.integral > ((int64_t)gains.integral_limit << MTK_9050_DC_PID_SHIFT))
+    {
+        SE_ERROR("Integral wound up to %lld", (long long)(pid.integral >> MTK_9050_DC_PID_SHIFT));
+        return -1;
+    }
+
+    /* Once the motor reaches the target the output must not stay pinned at the limit */
+    int32_t duty = mtk_9050_dc_pid_update(&pid, 1000, 1000);
+    duty = mtk_9050_dc_pid_update(&pid, 1000, 1000);
+    if (duty > gains.integral_limit)
+    {
+        SE_ERROR("Output %d is still saturated after reaching target", duty);
+        return -1;
+    }
+    return 0;
+}
+
+int main()
+{
+    if (check_tracking() != 0)
+    {
+        return -1;
+    }
+    return check_anti_windup();
+}
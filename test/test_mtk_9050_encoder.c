@@ -0,0 +1,139 @@
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+
+#include "MTK_9050/mtk_9050_encoder.h"
+#include "SE_logging.h"
+
+#define TEST_SNAPSHOT_COUNT 200000
+
+static atomic_bool writer_running = true;
+
+/* Stand-in for the encoder driver: every counter of the region always holds the same
+ * value, updates are published through the sequence word like the driver seqlock */
+static void *encoder_writer(void *arg)
+{
+    struct encoder_region *region = (struct encoder_region *)arg;
+    volatile int64_t *counters = (volatile int64_t *)&region->data;
+    int64_t value = 0;
+    while (atomic_load(&writer_running))
+    {
+        value++;
+        __atomic_store_n(&region->sequence, region->sequence + 1, __ATOMIC_RELEASE);
+        for (size_t i = 0; i < sizeof(struct encoder_data) / sizeof(int64_t); i++)
+        {
+            counters[i] = value;
+        }
+        __atomic_store_n(&region->sequence, region->sequence + 1, __ATOMIC_RELEASE);
+        usleep(20);
+    }
+    return NULL;
+}
+
+static int check_snapshot(struct mtk_9050_encoder *encoder, int fd)
+{
+    struct encoder_data expect = {
+        .channel_a = {.a_forward = 1200, .b_backward = -3, .v_direction = 1},
+        .channel_f = {.a_forward = 77, .b_backward = 78, .v_direction = 0},
+    };
+    pwrite(fd, &expect, sizeof(expect), 0);
+
+    struct encoder_data snapshot;
+    if (mtk_9050_encoder_snapshot(encoder, &snapshot) != kSE_SUCCESS || memcmp(&snapshot, &expect, sizeof(expect)))
+    {
+        SE_ERROR("Snapshot does not match the file content");
+        return -1;
+    }
+
+    expect.channel_a.a_forward = 1300;
+    pwrite(fd, &expect, sizeof(expect), 0);
+    mtk_9050_encoder_snapshot(encoder, &snapshot);
+    if (snapshot.channel_a.a_forward != 1300)
+    {
+        SE_ERROR("Mapping is not refreshed, got %lld", (long long)snapshot.channel_a.a_forward);
+        return -1;
+    }
+    return 0;
+}
+
+static int check_consistency(struct mtk_9050_encoder *encoder, int fd)
+{
+    void *region = mmap(NULL, MTK_9050_ENCODER_MAP_SIZE, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (region == MAP_FAILED)
+    {
+        SE_ERROR("Unable to map writer region");
+        return -1;
+    }
+
+    memset(region, 0, sizeof(struct encoder_region));
+    pthread_t writer;
+    pthread_create(&writer, NULL, encoder_writer, region);
+    int torn = 0;
+    int retry = 0;
+    for (int i = 0; i < TEST_SNAPSHOT_COUNT; i++)
+    {
+        struct encoder_data snapshot;
+        if (mtk_9050_encoder_snapshot(encoder, &snapshot) != kSE_SUCCESS)
+        {
+            retry++;
+            continue;
+        }
+
+        const int64_t *counters = (const int64_t *)&snapshot;
+        for (size_t j = 1; j < sizeof(struct encoder_data) / sizeof(int64_t); j++)
+        {
+            if (counters[j] != counters[0])
+            {
+                torn++;
+                break;
+            }
+        }
+    }
+    atomic_store(&writer_running, false);
+    pthread_join(writer, NULL);
+    munmap(region, MTK_9050_ENCODER_MAP_SIZE);
+
+    SE_INFO("%d snapshots, %d torn, %d gave up", TEST_SNAPSHOT_COUNT, torn, retry);
+    return torn == 0 ? 0 : -1;
+}
+
+int main()
+{
+    char path[] = "/tmp/se_encoder_XXXXXX";
+    int fd = mkstemp(path);
+    if (fd < 0 || ftruncate(fd, MTK_9050_ENCODER_MAP_SIZE) != 0)
+    {
+        SE_ERROR("Unable to create encoder stand-in file");
+        return -1;
+    }
+
+    struct mtk_9050_encoder encoder;
+    int ret = -1;
+    if (mtk_9050_encoder_open(&encoder, path) == kSE_SUCCESS)
+    {
+        ret = check_snapshot(&encoder, fd);
+        if (ret == 0)
+        {
+            ret = check_consistency(&encoder, fd);
+        }
+        mtk_9050_encoder_close(&encoder);
+    }
+    else
+    {
+        SE_ERROR("Unable to open encoder stand-in file");
+    }
+
+    if (mtk_9050_encoder_is_open(&encoder))
+    {
+        SE_ERROR("Encoder must be unmapped after close");
+        ret = -1;
+    }
+
+    close(fd);
+    unlink(path);
+    return ret;
+}
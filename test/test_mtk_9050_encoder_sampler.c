@@ -0,0 +1,162 @@
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/mman.h>
+
+#include "MTK_9050/mtk_9050_encoder_sampler.h"
+#include "SE_logging.h"
+
+#define TEST_SAMPLE_US 1000
+#define TEST_SPEED 2000
+#define TEST_RUN_US 300000
+
+static atomic_bool writer_running = true;
+
+static uint64_t now_us(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+/* Stand-in for the encoder driver: channel c turns forward at TEST_SPEED counts/s */
+static void *encoder_writer(void *arg)
+{
+    struct encoder_region *region = (struct encoder_region *)arg;
+    uint64_t start = now_us();
+    while (atomic_load(&writer_running))
+    {
+        __atomic_store_n(&region->sequence, region->sequence + 1, __ATOMIC_RELEASE);
+        region->data.channel_c.a_forward = (int64_t)(now_us() - start) * TEST_SPEED / 1000000;
+        __atomic_store_n(&region->sequence, region->sequence + 1, __ATOMIC_RELEASE);
+        usleep(100);
+    }
+    return NULL;
+}
+
+/* Samples pushed with exact timestamps: channel b follows 3 * k^2 counts at k ms, channel f
+ * only turns backward, so velocity and acceleration have closed form values */
+static int check_estimates(void)
+{
+    static struct mtk_9050_encoder_sampler sampler;
+    memset(&sampler, 0, sizeof(sampler));
+    sampler.window = MTK_9050_SAMPLER_DEFAULT_WINDOW;
+
+    struct mtk_9050_encoder_state state;
+    if (mtk_9050_encoder_sampler_get_state(&sampler, 1, &state) != kSE_TRY_AGAIN)
+    {
+        SE_ERROR("Empty history must ask to try again");
+        return -1;
+    }
+
+    for (int64_t k = 0; k < 3 * MTK_9050_SAMPLER_HISTORY; k++)
+    {
+        struct encoder_data data = {
+            .channel_b = {.a_forward = 3 * k * k},
+            .channel_f = {.b_backward = 5 * k},
+        };
+        mtk_9050_encoder_sampler_push(&sampler, 1000000 + k * 1000, &data);
+    }
+
+    int64_t newest = 3 * MTK_9050_SAMPLER_HISTORY - 1;
+    int64_t center = newest - MTK_9050_SAMPLER_DEFAULT_WINDOW / 2;
+    mtk_9050_encoder_sampler_get_state(&sampler, 1, &state);
+    if (state.position != 3 * newest * newest || state.velocity != 6000 * center || state.acceleration != 6000000)
+    {
+        SE_ERROR("Channel b at %lld, %d counts/s, %d counts/s2", (long long)state.position, state.velocity,
+                 state.acceleration);
+        return -1;
+    }
+
+    mtk_9050_encoder_sampler_get_state(&sampler, 5, &state);
+    if (state.position != -5 * newest || state.velocity != -5000 || state.acceleration != 0)
+    {
+        SE_ERROR("Channel f at %lld, %d counts/s, %d counts/s2", (long long)state.position, state.velocity,
+                 state.acceleration);
+        return -1;
+    }
+
+    if (mtk_9050_encoder_sampler_get_state(&sampler, MTK_9050_ENCODER_CHANNELS, &state) != kSE_OUT_OF_RANGE)
+    {
+        SE_ERROR("Channel out of range must be rejected");
+        return -1;
+    }
+    return 0;
+}
+
+static int check_sampler_thread(const char *path, int fd)
+{
+    struct encoder_region *region = mmap(NULL, MTK_9050_ENCODER_MAP_SIZE, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (region == MAP_FAILED)
+    {
+        SE_ERROR("Unable to map writer region");
+        return -1;
+    }
+    memset(region, 0, sizeof(struct encoder_region));
+
+    struct mtk_9050_encoder encoder;
+    if (mtk_9050_encoder_open(&encoder, path) != kSE_SUCCESS)
+    {
+        SE_ERROR("Unable to open encoder stand-in file");
+        munmap(region, MTK_9050_ENCODER_MAP_SIZE);
+        return -1;
+    }
+
+    static struct mtk_9050_encoder_sampler sampler;
+    pthread_t writer;
+    pthread_create(&writer, NULL, encoder_writer, region);
+    int ret = mtk_9050_encoder_sampler_start(&sampler, &encoder, TEST_SAMPLE_US, 30);
+    usleep(TEST_RUN_US);
+
+    struct mtk_9050_encoder_state state = {0};
+    if (ret == kSE_SUCCESS)
+    {
+        ret = mtk_9050_encoder_sampler_get_state(&sampler, 2, &state);
+    }
+    unsigned int samples = atomic_load(&sampler.ring[2].head);
+    mtk_9050_encoder_sampler_stop(&sampler);
+    atomic_store(&writer_running, false);
+    pthread_join(writer, NULL);
+    mtk_9050_encoder_close(&encoder);
+    munmap(region, MTK_9050_ENCODER_MAP_SIZE);
+
+    SE_INFO("%u samples in %d ms, channel c at %lld, %d counts/s", samples, TEST_RUN_US / 1000,
+            (long long)state.position, state.velocity);
+    if (ret != kSE_SUCCESS || state.velocity < TEST_SPEED * 9 / 10 || state.velocity > TEST_SPEED * 11 / 10)
+    {
+        SE_ERROR("Sampled velocity does not match the encoder speed");
+        return -1;
+    }
+
+    if (samples < TEST_RUN_US / TEST_SAMPLE_US / 2)
+    {
+        SE_ERROR("Sampler does not keep its rate");
+        return -1;
+    }
+    return 0;
+}
+
+int main()
+{
+    if (check_estimates() != 0)
+    {
+        return -1;
+    }
+
+    char path[] = "/tmp/se_encoder_XXXXXX";
+    int fd = mkstemp(path);
+    if (fd < 0 || ftruncate(fd, MTK_9050_ENCODER_MAP_SIZE) != 0)
+    {
+        SE_ERROR("Unable to create encoder stand-in file");
+        return -1;
+    }
+
+    int ret = check_sampler_thread(path, fd);
+    close(fd);
+    unlink(path);
+    return ret;
+}
@@ -0,0 +1,97 @@
+#include <unistd.h>
+#include <stdbool.h>
+#include <time.h>
+
+#include "servo_easing.h"
+#include "SE_output.h"
+#include "SE_logging.h"
+
+#define TEST_PUBLISH_COUNT 1000
+#define TEST_SLOW_WRITE_US 2000
+
+static struct SE_controller_info slow_info = {
+    .name = "Slow test controller",
+    .id = 0,
+    .max_servo = 1,
+};
+
+static volatile uint32_t last_written = 0;
+
+static SE_ret_t slow_set_duty(struct SE_controller *controller, uint8_t servo_id, uint32_t duty)
+{
+    usleep(TEST_SLOW_WRITE_US);
+    last_written = duty;
+    return kSE_SUCCESS;
+}
+
+static SE_ret_t slow_set_id(struct SE_controller *controller, int id)
+{
+    slow_info.id = id;
+    return kSE_SUCCESS;
+}
+
+static const struct SE_controller_info *slow_get_info_ref(struct SE_controller *controller)
+{
+    return &slow_info;
+}
+
+static struct SE_controller slow_controller = {
+    .set_duty = slow_set_duty,
+    .set_id = slow_set_id,
+    .get_info_ref = slow_get_info_ref,
+};
+
+static uint64_t now_us(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+int main()
+{
+    SE_controller_register(&slow_controller);
+    SE_ret_t ret = SE_output_start_async(&slow_controller);
+    if (ret == kSE_NOT_SUPPORTED)
+    {
+        SE_INFO("Async output disabled, skip");
+        return 0;
+    }
+    if (ret != kSE_SUCCESS)
+    {
+        SE_ERROR("Start async output failed, error %s", SE_get_error());
+        return -1;
+    }
+
+    uint64_t start = now_us();
+    for (uint32_t i = 1; i <= TEST_PUBLISH_COUNT; i++)
+    {
+        SE_output_set_duty(&slow_controller, 0, i);
+    }
+    uint64_t publish_us = now_us() - start;
+    SE_output_stop_async(&slow_controller);
+
+    SE_output_stats_t stats = {0};
+    SE_output_get_stats(&slow_controller, 0, &stats);
+    SE_INFO("Publish took %llu us, published %u written %u dropped %u",
+            (unsigned long long)publish_us, stats.published, stats.written, stats.dropped);
+
+    if (publish_us >= (uint64_t)TEST_PUBLISH_COUNT * TEST_SLOW_WRITE_US / 10)
+    {
+        SE_ERROR("Publishing is stalled by the slow controller");
+        return -1;
+    }
+
+    if (stats.published != TEST_PUBLISH_COUNT || stats.written + stats.dropped != stats.published)
+    {
+        SE_ERROR("Stats mismatch");
+        return -1;
+    }
+
+    if (stats.dropped == 0 || last_written != TEST_PUBLISH_COUNT)
+    {
+        SE_ERROR("Latest value is not the one written, last %u", last_written);
+        return -1;
+    }
+    return 0;
+}
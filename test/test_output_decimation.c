@@ -0,0 +1,86 @@
+#include <stdbool.h>
+
+#include "servo_easing.h"
+#include "SE_output.h"
+#include "SE_ticks.h"
+#include "SE_logging.h"
+#include "test_stub_controller.h"
+
+#define TEST_TICK_MS 1
+#define TEST_PERIOD_US 20000
+#define TEST_MAX_TICKS 5000
+
+/* Records the latch of every write, a 20 ms servo can only latch one of them per period */
+static uint32_t test_last_latch;
+static bool test_same_latch;
+
+static void test_on_duty(struct test_stub *stub, uint8_t servo_id, uint32_t duty)
+{
+    uint32_t period_ms = TEST_PERIOD_US / 1000;
+    uint32_t latch = (SE_tick_get_current_tick() + period_ms - 1) / period_ms;
+    if (stub->duty_calls > 0 && latch == test_last_latch)
+    {
+        test_same_latch = true;
+    }
+    test_last_latch = latch;
+}
+
+static struct test_stub test_data = {
+    .info = TEST_STUB_INFO("Decimation test controller", 1),
+    .on_duty = test_on_duty,
+};
+static struct SE_controller test_controller = {TEST_STUB_OPS(test_data)};
+
+int main()
+{
+    SE_controller_register(&test_controller);
+    SE_servo_t servo;
+    SE_argument_t args = {
+        .controller_id = test_data.info.id,
+        .easing_type = eSE_EASE_QUARACTIC,
+        .move_type = eSE_MOV_IN_OUT,
+        .servo_id = 0,
+        .speed = 90,
+        .period_us = TEST_PERIOD_US,
+        .init_angle = 0,
+    };
+    if (SE_create_servo(&servo, args) != kSE_SUCCESS)
+    {
+        SE_ERROR("Create servo failed, error %s", SE_get_error());
+        return -1;
+    }
+
+    SE_servo_set_angle(&servo, 90);
+    SE_servo_start(&servo);
+    uint32_t ticks = 0;
+    do
+    {
+        SE_tick_update(TEST_TICK_MS);
+        SE_servo_update_all();
+        ticks++;
+    } while (SE_servo_is_moving(&servo) && ticks < TEST_MAX_TICKS);
+
+    SE_output_stats_t stats = {0};
+    SE_output_get_stats(&test_controller, 0, &stats);
+    SE_INFO("%u updates, %u writes, %u saved", ticks, test_data.duty_calls, stats.saved);
+
+    if (test_same_latch || test_data.duty_calls > ticks / (TEST_PERIOD_US / 1000) + 2)
+    {
+        SE_ERROR("More than one value emitted per PWM period");
+        return -1;
+    }
+
+    if (stats.saved == 0 || stats.written + stats.saved < ticks - 1)
+    {
+        SE_ERROR("Skipped updates are not counted as saved");
+        return -1;
+    }
+
+    uint32_t end_duty = (100 + 90 * 2) * test_stub_get_pulse_resolution(&test_controller, 0) / 100;
+    if (SE_servo_get_angle(&servo) != 90 || test_data.duty[0] != end_duty)
+    {
+        SE_ERROR("Move ends at duty %u instead of %u", test_data.duty[0], end_duty);
+        return -1;
+    }
+    return 0;
+}
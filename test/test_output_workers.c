@@ -0,0 +1,129 @@
+#include <unistd.h>
+#include <stdbool.h>
+#include <time.h>
+
+#include "servo_easing.h"
+#include "SE_output.h"
+#include "SE_logging.h"
+
+#define TEST_FRAMES 20
+#define TEST_SLOW_BUS_US 20000
+#define TEST_DEADLINE_US 4000
+
+/* A slow bus controller next to a fast on-chip one, both only count what they write */
+struct test_bus
+{
+    struct SE_controller_info info;
+    uint32_t write_us;
+    volatile uint32_t last_duty;
+};
+
+static SE_ret_t test_set_duty(struct SE_controller *controller, uint8_t servo_id, uint32_t duty)
+{
+    struct test_bus *bus = (struct test_bus *)controller->controller_data;
+    if (bus->write_us > 0)
+    {
+        usleep(bus->write_us);
+    }
+    bus->last_duty = duty;
+    return kSE_SUCCESS;
+}
+
+static SE_ret_t test_set_id(struct SE_controller *controller, int id)
+{
+    ((struct test_bus *)controller->controller_data)->info.id = id;
+    return kSE_SUCCESS;
+}
+
+static const struct SE_controller_info *test_get_info_ref(struct SE_controller *controller)
+{
+    return &((struct test_bus *)controller->controller_data)->info;
+}
+
+static struct test_bus slow_bus = {.info = {.name = "Slow I2C bus", .max_servo = 1}, .write_us = TEST_SLOW_BUS_US};
+static struct test_bus fast_bus = {.info = {.name = "Fast PWM", .max_servo = 1}, .write_us = 0};
+
+static struct SE_controller slow_controller = {
+    .set_duty = test_set_duty,
+    .set_id = test_set_id,
+    .get_info_ref = test_get_info_ref,
+    .controller_data = &slow_bus,
+};
+
+static struct SE_controller fast_controller = {
+    .set_duty = test_set_duty,
+    .set_id = test_set_id,
+    .get_info_ref = test_get_info_ref,
+    .controller_data = &fast_bus,
+};
+
+static uint64_t now_us(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+int main()
+{
+    SE_controller_register(&slow_controller);
+    SE_controller_register(&fast_controller);
+    SE_ret_t ret = SE_output_start_async_all();
+    if (ret == kSE_NOT_SUPPORTED)
+    {
+        SE_INFO("Async output disabled, skip");
+        return 0;
+    }
+    if (ret != kSE_SUCCESS)
+    {
+        SE_ERROR("Start output workers failed, error %s", SE_get_error());
+        return -1;
+    }
+
+    SE_output_set_frame_deadline(TEST_DEADLINE_US);
+    uint32_t timeouts = 0;
+    uint64_t start = now_us();
+    for (uint32_t frame = 1; frame <= TEST_FRAMES; frame++)
+    {
+        SE_output_frame_begin();
+        SE_output_set_duty(&slow_controller, 0, frame);
+        SE_output_set_duty(&fast_controller, 0, frame);
+        if (SE_output_frame_commit() == kSE_TIMEOUT)
+        {
+            timeouts++;
+        }
+    }
+    uint64_t elapse_us = now_us() - start;
+    SE_output_stop_async_all();
+    SE_output_set_frame_deadline(0);
+
+    SE_output_latency_t slow = {0};
+    SE_output_latency_t fast = {0};
+    SE_output_get_latency(&slow_controller, &slow);
+    SE_output_get_latency(&fast_controller, &fast);
+    SE_INFO("%d frames in %llu us, %u timeouts", TEST_FRAMES, (unsigned long long)elapse_us, timeouts);
+    SE_INFO("Slow bus: %u frames, avg %u us, max %u us, %u missed", slow.frames, slow.average_us, slow.max_us,
+            slow.deadline_missed);
+    SE_INFO("Fast PWM: %u frames, avg %u us, max %u us, %u missed", fast.frames, fast.average_us, fast.max_us,
+            fast.deadline_missed);
+
+    /* Frames are paced by the deadline, not by the slow bus */
+    if (elapse_us >= (uint64_t)TEST_FRAMES * TEST_SLOW_BUS_US / 2)
+    {
+        SE_ERROR("Slow controller stalls the frame loop");
+        return -1;
+    }
+
+    if (fast.frames != TEST_FRAMES || fast.deadline_missed != 0 || slow.deadline_missed == 0 || timeouts == 0)
+    {
+        SE_ERROR("Only the slow controller may miss the frame deadline");
+        return -1;
+    }
+
+    if (slow_bus.last_duty != TEST_FRAMES || fast_bus.last_duty != TEST_FRAMES)
+    {
+        SE_ERROR("Last frame is not written, slow %u fast %u", slow_bus.last_duty, fast_bus.last_duty);
+        return -1;
+    }
+    return 0;
+}
@@ -0,0 +1,179 @@
+#include <stdbool.h>
+#include <stdlib.h>
+
+#include "servo_easing.h"
+#include "SE_path.h"
+#include "SE_ticks.h"
+#include "SE_logging.h"
+#include "test_stub_controller.h"
+
+#define TEST_TICK_MS 10
+#define TEST_MAX_VELOCITY 200
+#define TEST_MAX_ACCELERATION 800
+/* Velocities are taken over a window, so the Q8 steps do not swamp the differences */
+#define TEST_WINDOW_MS 20
+#define TEST_REACH (1 << SE_TRACK_FRAC_BITS) / 2
+
+static const uint8_t test_waypoints[] = {0, 40, 90, 150, 100, 180};
+#define TEST_WAYPOINT_COUNT (sizeof(test_waypoints) / sizeof(test_waypoints[0]))
+
+static const SE_profile_limits_t test_limits = {
+    .max_velocity = TEST_MAX_VELOCITY,
+    .max_acceleration = TEST_MAX_ACCELERATION,
+};
+
+static struct test_stub test_data = {.info = TEST_STUB_INFO("Path test controller", 1)};
+static struct SE_controller test_controller = {TEST_STUB_OPS(test_data)};
+
+/* Degrees per second between two positions TEST_WINDOW_MS apart */
+static int32_t window_velocity(uint32_t from, uint32_t to)
+{
+    return ((int32_t)to - (int32_t)from) * 1000 / TEST_WINDOW_MS / (1 << SE_TRACK_FRAC_BITS);
+}
+
+static int check_limits(SE_track_t *track)
+{
+    uint32_t duration = SE_track_get_duration(track);
+    uint32_t waypoint = 0;
+    int32_t max_velocity = 0;
+    int32_t max_acceleration = 0;
+    int32_t last_velocity = 0;
+    uint32_t last = SE_track_eval(track, 0);
+    for (uint32_t t = TEST_WINDOW_MS; t <= duration + TEST_WINDOW_MS; t += TEST_WINDOW_MS)
+    {
+        uint32_t position = SE_track_eval(track, t);
+        int32_t velocity = window_velocity(last, position);
+        int32_t acceleration = (velocity - last_velocity) * 1000 / TEST_WINDOW_MS;
+        max_velocity = (abs(velocity) > max_velocity) ? abs(velocity) : max_velocity;
+        max_acceleration = (abs(acceleration) > max_acceleration) ? abs(acceleration) : max_acceleration;
+        last = position;
+        last_velocity = velocity;
+    }
+
+    /* Every waypoint is passed in order */
+    track->cursor = 0;
+    for (uint32_t t = 0; t <= duration && waypoint < TEST_WAYPOINT_COUNT; t++)
+    {
+        int32_t miss = (int32_t)SE_track_eval(track, t) - ((int32_t)test_waypoints[waypoint] << SE_TRACK_FRAC_BITS);
+        if (abs(miss) <= TEST_REACH)
+        {
+            waypoint++;
+        }
+    }
+
+    SE_INFO("Path takes %u ms, peaks at %d deg/s and %d deg/s2", duration, max_velocity, max_acceleration);
+    if (waypoint != TEST_WAYPOINT_COUNT)
+    {
+        SE_ERROR("Path misses waypoint %u", waypoint);
+        return -1;
+    }
+
+    /* A tenth over the limits leaves room for the whole ms phases and the window */
+    if (max_velocity > TEST_MAX_VELOCITY * 11 / 10 || max_acceleration > TEST_MAX_ACCELERATION * 11 / 10)
+    {
+        SE_ERROR("Path breaks the limits");
+        return -1;
+    }
+
+    /* Speeding up or slowing down most of the time, peaks below the limits mean time is lost */
+    if (max_velocity < TEST_MAX_VELOCITY * 9 / 10 || max_acceleration < TEST_MAX_ACCELERATION * 9 / 10)
+    {
+        SE_ERROR("Path does not use the limits");
+        return -1;
+    }
+    return 0;
+}
+
+/* The planned track plays on the servo tick path like any other track */
+static int check_servo(SE_track_t *track)
+{
+    SE_servo_t servo;
+    SE_argument_t args = {
+        .controller_id = test_data.info.id,
+        .easing_type = eSE_EASE_QUARACTIC,
+        .move_type = eSE_MOV_IN_OUT,
+        .servo_id = 0,
+        .speed = 90,
+        .period_us = 20000,
+        .init_angle = 0,
+    };
+    if (SE_create_servo(&servo, args) != kSE_SUCCESS || SE_servo_set_track(&servo, track) != kSE_SUCCESS)
+    {
+        SE_ERROR("Create servo failed, error %s", SE_get_error());
+        return -1;
+    }
+
+    SE_servo_start(&servo);
+    uint32_t start = SE_tick_get_current_tick();
+    do
+    {
+        SE_tick_update(TEST_TICK_MS);
+        SE_servo_update(&servo);
+    } while (SE_servo_is_moving(&servo) && SE_tick_get_current_tick() - start < 60000);
+
+    uint32_t elapse = SE_tick_get_current_tick() - start;
+    if (SE_servo_get_angle(&servo) != 180 || elapse > SE_track_get_duration(track) + 2 * TEST_TICK_MS)
+    {
+        SE_ERROR("Servo ends at %d after %u ms", SE_servo_get_angle(&servo), elapse);
+        return -1;
+    }
+    return 0;
+}
+
+static int check_errors(SE_track_t *track)
+{
+    static const uint8_t still[] = {40, 40, 40};
+    static const uint8_t many[SE_PATH_MAX_WAYPOINTS + 1] = {0};
+    SE_profile_limits_t no_acceleration = {.max_velocity = TEST_MAX_VELOCITY};
+    if (SE_path_plan(track, still, sizeof(still), &test_limits) != kSE_OUT_OF_RANGE ||
+        SE_path_plan(track, many, sizeof(many), &test_limits) != kSE_OUT_OF_RANGE ||
+        SE_path_plan(track, test_waypoints, TEST_WAYPOINT_COUNT, &no_acceleration) != kSE_OUT_OF_RANGE ||
+        SE_path_plan(track, NULL, TEST_WAYPOINT_COUNT, &test_limits) != kSE_NULL)
+    {
+        SE_ERROR("Invalid paths must be rejected");
+        return -1;
+    }
+    return 0;
+}
+
+/* Through 2 degree at just under the velocity cap, the speed up after it lasts 0.15 ms
+ * and rounds onto the waypoint time. The track still has a node exactly on the waypoint. */
+static int check_short_phase(void)
+{
+    static SE_track_t track;
+    const uint8_t waypoints[] = {0, 2, 180};
+    const SE_profile_limits_t limits = {.max_velocity = 200, .max_acceleration = 9850};
+    if (SE_path_plan(&track, waypoints, 3, &limits) != kSE_SUCCESS)
+    {
+        SE_ERROR("Short phase path plan failed, error %s", SE_get_error());
+        return -1;
+    }
+
+    uint32_t duration = SE_track_get_duration(&track);
+    for (uint32_t t = 0; t <= duration; t++)
+    {
+        if (SE_track_eval(&track, t) == 2 << SE_TRACK_FRAC_BITS)
+        {
+            return 0;
+        }
+    }
+    SE_ERROR("Short phase after the waypoint dropped its node");
+    return -1;
+}
+
+int main()
+{
+    static SE_track_t track;
+    SE_controller_register(&test_controller);
+    if (SE_path_plan(&track, test_waypoints, TEST_WAYPOINT_COUNT, &test_limits) != kSE_SUCCESS)
+    {
+        SE_ERROR("Path plan failed, error %s", SE_get_error());
+        return -1;
+    }
+
+    if (check_limits(&track) != 0 || check_servo(&track) != 0)
+    {
+        return -1;
+    }
+    return (check_errors(&track) != 0 || check_short_phase() != 0) ? -1 : 0;
+}
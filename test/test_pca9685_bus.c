@@ -0,0 +1,292 @@
+#include <stdbool.h>
+#include <stdio.h>
+
+#include "PCA9685/pca9685_bus.h"
+#include "PCA9685/pca9685_controller.h"
+#include "pca9685_bus_sim.h"
+#include "SE_logging.h"
+
+#define TEST_CHIPS 4
+#define TEST_BUS_HZ 400000
+#define TEST_FRAME_MS 20
+#define TEST_BUS_SHARE_US 2000
+/* 20 ms as the default prescale of 121 runs it */
+#define TEST_PERIOD_US pca9685_bus_actual_period(20000)
+#define TEST_MODE_LOG 16
+
+static struct pca9685_bus bus;
+static struct pca9685_bus_sim sim;
+static uint32_t now_ms;
+/* MODE1 values the controller wrote to 0x41, in order */
+static uint8_t mode_log[TEST_MODE_LOG];
+static uint8_t mode_count;
+
+static int setup(uint32_t budget, bool last_allcall)
+{
+    struct pca9685_bus_ops ops = {.write = pca9685_bus_sim_write, .context = &sim};
+    pca9685_bus_sim_init(&sim, TEST_BUS_HZ);
+    if (pca9685_bus_init(&bus, &ops, budget) != kSE_SUCCESS)
+    {
+        SE_ERROR("Bus init failed");
+        return -1;
+    }
+
+    for (int c = 0; c < TEST_CHIPS; c++)
+    {
+        bool allcall = (c < TEST_CHIPS - 1) || last_allcall;
+        pca9685_bus_sim_add_chip(&sim, 0x40 + c, allcall);
+        if (pca9685_bus_add_chip(&bus, 0x40 + c, allcall) != c)
+        {
+            SE_ERROR("Chip %d not added", c);
+            return -1;
+        }
+    }
+    now_ms = 0;
+    return 0;
+}
+
+/* Flushes frames until nothing is dirty, every frame must stay within the bus share */
+static int run_frames(int max_frames)
+{
+    int frames = 0;
+    while (pca9685_bus_pending(&bus) > 0 && frames < max_frames)
+    {
+        uint64_t busy_ns = sim.busy_ns;
+        pca9685_bus_flush(&bus, now_ms);
+        if (sim.busy_ns - busy_ns > (uint64_t)TEST_BUS_SHARE_US * 1000 * 11 / 10)
+        {
+            SE_ERROR("Frame %d holds the bus %llu ns", frames, (unsigned long long)(sim.busy_ns - busy_ns));
+            return -1;
+        }
+        now_ms += TEST_FRAME_MS;
+        frames++;
+    }
+    return frames;
+}
+
+static int check_values(uint16_t (*expect)(int chip, int channel))
+{
+    for (int c = 0; c < TEST_CHIPS; c++)
+    {
+        for (int ch = 0; ch < PCA9685_CHANNELS; ch++)
+        {
+            if (pca9685_bus_sim_get_off(&sim, c, ch) != expect(c, ch))
+            {
+                SE_ERROR("Chip %d channel %d at %d instead of %d", c, ch, pca9685_bus_sim_get_off(&sim, c, ch),
+                         expect(c, ch));
+                return -1;
+            }
+        }
+    }
+    return 0;
+}
+
+static uint16_t same_value(int chip, int channel)
+{
+    return pca9685_bus_duty_to_count(1500, 20000);
+}
+
+static uint16_t per_channel_value(int chip, int channel)
+{
+    return 200 + channel;
+}
+
+static uint16_t distinct_value(int chip, int channel)
+{
+    return 100 + chip * PCA9685_CHANNELS + channel;
+}
+
+static void set_all(uint16_t (*value)(int chip, int channel), uint32_t deadline_ms)
+{
+    for (int c = 0; c < TEST_CHIPS; c++)
+    {
+        for (int ch = 0; ch < PCA9685_CHANNELS; ch++)
+        {
+            pca9685_bus_set(&bus, c, ch, value(c, ch), deadline_ms, 0);
+        }
+    }
+}
+
+static int check_shared_writes(uint32_t budget)
+{
+    /* 64 equal channels leave in one ALLCALL write to the ALL_LED registers */
+    setup(budget, true);
+    set_all(same_value, TEST_FRAME_MS);
+    if (run_frames(4) != 1 || sim.writes != 1 || check_values(same_value) != 0)
+    {
+        SE_ERROR("Equal channels took %u writes", sim.writes);
+        return -1;
+    }
+
+    /* A chip without ALLCALL gets its own ALL_LED write */
+    setup(budget, false);
+    set_all(same_value, TEST_FRAME_MS);
+    if (run_frames(4) != 1 || sim.writes != 2 || bus.stats.shared_writes != 2 || check_values(same_value) != 0)
+    {
+        SE_ERROR("Equal channels without one ALLCALL chip took %u writes", sim.writes);
+        return -1;
+    }
+
+    /* Same count per channel index across chips, one ALLCALL write per channel */
+    setup(budget, true);
+    set_all(per_channel_value, TEST_FRAME_MS);
+    int frames = run_frames(4);
+    if (frames < 1 || sim.writes != PCA9685_CHANNELS || check_values(per_channel_value) != 0)
+    {
+        SE_ERROR("Per channel values took %u writes in %d frames", sim.writes, frames);
+        return -1;
+    }
+    return 0;
+}
+
+static int check_budget_carry(uint32_t budget)
+{
+    setup(budget, true);
+    set_all(distinct_value, TEST_FRAME_MS);
+    uint32_t naive_bytes = TEST_CHIPS * PCA9685_CHANNELS * (PCA9685_BUS_WRITE_OVERHEAD + PCA9685_LED_REG_SIZE);
+    int frames = run_frames(16);
+    SE_INFO("64 distinct channels: %d frames, %u writes, %u bytes (naive %u), %u carried, max %u bytes per frame",
+            frames, bus.stats.transactions, bus.stats.bytes, naive_bytes, bus.stats.carried, bus.stats.max_frame_bytes);
+    if (frames < 0 || bus.stats.max_frame_bytes > budget || bus.stats.carried == 0 || bus.stats.bytes >= naive_bytes)
+    {
+        SE_ERROR("Budget must hold and carry work over with fewer bytes than one write per channel");
+        return -1;
+    }
+    return check_values(distinct_value);
+}
+
+static int check_deadline_order(void)
+{
+    /* Room for two single channel writes per frame */
+    setup(2 * (PCA9685_BUS_WRITE_OVERHEAD + PCA9685_LED_REG_SIZE), true);
+    pca9685_bus_set(&bus, 0, 3, 1000, 100, 1);
+    pca9685_bus_set(&bus, 1, 5, 1001, 100, 5);
+    pca9685_bus_set(&bus, 2, 7, 1002, 100, 3);
+    pca9685_bus_set(&bus, 3, 9, 1003, 10, 0);
+    pca9685_bus_flush(&bus, 0);
+    if (pca9685_bus_sim_get_off(&sim, 3, 9) != 1003 || pca9685_bus_sim_get_off(&sim, 1, 5) != 1001 ||
+        pca9685_bus_pending(&bus) != 2)
+    {
+        SE_ERROR("Earliest deadline then highest priority must go first");
+        return -1;
+    }
+
+    pca9685_bus_flush(&bus, 200);
+    if (pca9685_bus_pending(&bus) != 0 || bus.stats.late != 2 || pca9685_bus_sim_get_off(&sim, 0, 3) != 1000)
+    {
+        SE_ERROR("Carried writes must land next frame and count as late, late %u", bus.stats.late);
+        return -1;
+    }
+    return 0;
+}
+
+static SE_ret_t mode_logged_write(void *context, uint8_t address, uint8_t reg, const uint8_t *data, size_t len)
+{
+    if (address == 0x41 && reg == PCA9685_REG_MODE1 && mode_count < TEST_MODE_LOG)
+    {
+        mode_log[mode_count++] = data[0];
+    }
+    return pca9685_bus_sim_write(context, address, reg, data, len);
+}
+
+/* Sleep, prescale, then awake with auto increment and ALLCALL */
+static int check_chip_programmed(const struct pca9685_bus_sim *ctrl_sim, uint8_t prescale)
+{
+    const uint8_t *reg = ctrl_sim->chip[1].reg;
+    uint8_t awake = PCA9685_MODE1_AI | PCA9685_MODE1_ALLCALL;
+    if (mode_count != 2 || mode_log[0] != (awake | PCA9685_MODE1_SLEEP) || mode_log[1] != awake ||
+        reg[PCA9685_REG_MODE1] != awake || reg[PCA9685_REG_PRE_SCALE] != prescale)
+    {
+        SE_ERROR("Chip MODE1 at 0x%02x after %d writes, PRE_SCALE at %d instead of %d", reg[PCA9685_REG_MODE1],
+                 mode_count, reg[PCA9685_REG_PRE_SCALE], prescale);
+        return -1;
+    }
+    mode_count = 0;
+    return 0;
+}
+
+static int check_controller(uint32_t budget)
+{
+    /* The controller owns a second bus, staged writes on the first one must not leak into it */
+    static struct pca9685_bus_sim ctrl_sim;
+    struct pca9685_bus_ops ops = {.write = mode_logged_write, .context = &ctrl_sim};
+    struct SE_controller *controller = PCA9685_get_controller();
+    pca9685_bus_sim_init(&ctrl_sim, TEST_BUS_HZ);
+    pca9685_bus_sim_add_chip(&ctrl_sim, 0x40, true);
+    pca9685_bus_sim_add_chip(&ctrl_sim, 0x41, true);
+    if (PCA9685_attach_bus(controller, &ops, budget) != kSE_SUCCESS ||
+        PCA9685_add_chip(controller, 0x40, true) != kSE_SUCCESS ||
+        PCA9685_add_chip(controller, 0x41, true) != kSE_SUCCESS || controller->controller_init(controller) != kSE_SUCCESS ||
+        controller->get_info_ref(controller)->max_servo != 2 * PCA9685_CHANNELS)
+    {
+        SE_ERROR("Controller setup failed");
+        return -1;
+    }
+
+    /* 25 MHz / (4096 * 50 Hz) rounds to 122 */
+    if (check_chip_programmed(&ctrl_sim, 121) != 0 || ctrl_sim.chip[0].reg[PCA9685_REG_PRE_SCALE] != 121)
+    {
+        return -1;
+    }
+
+    setup(budget, true);
+    set_all(distinct_value, TEST_FRAME_MS);
+    uint8_t ids[] = {0, 5, 17, 31};
+    uint32_t duties[] = {600, 1500, 2000, 2400};
+    for (int i = 0; i < 4; i++)
+    {
+        controller->open_servo(controller, ids[i]);
+    }
+    if (controller->set_duty(controller, 17, 1000) != kSE_SUCCESS ||
+        pca9685_bus_sim_get_off(&ctrl_sim, 1, 1) != pca9685_bus_duty_to_count(1000, TEST_PERIOD_US) || sim.writes != 0)
+    {
+        SE_ERROR("Controller duty did not land on its own bus only");
+        return -1;
+    }
+
+    if (controller->set_duty_batch(controller, ids, duties, 4) != kSE_SUCCESS || PCA9685_flush(controller) != 0)
+    {
+        SE_ERROR("Controller batch did not fit one frame");
+        return -1;
+    }
+    for (int i = 0; i < 4; i++)
+    {
+        uint16_t off = pca9685_bus_sim_get_off(&ctrl_sim, ids[i] / PCA9685_CHANNELS, ids[i] % PCA9685_CHANNELS);
+        if (off != pca9685_bus_duty_to_count(duties[i], TEST_PERIOD_US))
+        {
+            SE_ERROR("Servo %d at count %d", ids[i], off);
+            return -1;
+        }
+    }
+
+    /* A new period reprograms the chip of the servo only and keeps the pulse widths */
+    if (controller->set_period(controller, 17, 10000) != kSE_SUCCESS || check_chip_programmed(&ctrl_sim, 60) != 0 ||
+        ctrl_sim.chip[0].reg[PCA9685_REG_PRE_SCALE] != 121 ||
+        pca9685_bus_sim_get_off(&ctrl_sim, 1, 1) != pca9685_bus_duty_to_count(2000, pca9685_bus_actual_period(10000)) ||
+        controller->set_period(controller, 17, 100000) != kSE_OUT_OF_RANGE)
+    {
+        SE_ERROR("Period change must reprogram chip 1 and its counts");
+        return -1;
+    }
+
+    /* The first bus still holds everything it staged before the controller frames */
+    if (run_frames(16) < 0 || check_values(distinct_value) != 0 || controller->set_duty(controller, 32, 1000) == kSE_SUCCESS)
+    {
+        SE_ERROR("Interleaved buses interfered");
+        return -1;
+    }
+    controller->controller_deinit(controller);
+    return 0;
+}
+
+int main()
+{
+    uint32_t budget = pca9685_bus_budget(TEST_BUS_HZ, TEST_BUS_SHARE_US);
+    SE_INFO("Bus budget %u bytes per frame", budget);
+    if (check_shared_writes(budget) != 0 || check_budget_carry(budget) != 0 || check_deadline_order() != 0 ||
+        check_controller(budget) != 0)
+    {
+        return -1;
+    }
+    return 0;
+}
@@ -0,0 +1,190 @@
+#include <stdbool.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "servo_easing.h"
+#include "SE_plan.h"
+#include "SE_ticks.h"
+#include "SE_logging.h"
+#include "test_stub_controller.h"
+
+#define TEST_TICK_MS 10
+#define TEST_PLANS 40
+#define TEST_TIMES 256
+#define TEST_BENCH_ROUNDS 100
+
+#define DEG(angle) ((uint32_t)(angle) << SE_CALIBRATION_FRAC_BITS)
+
+static struct test_stub test_data = {.info = TEST_STUB_INFO("Plan test controller", 1)};
+static struct SE_controller test_controller = {TEST_STUB_OPS(test_data)};
+
+static uint64_t now_us(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+static int check_eval(void)
+{
+    SE_plan_t plan = {
+        .start_ms = 100,
+        .duration_ms = 1000,
+        .start_position = DEG(90),
+        .delta_position = -(int32_t)DEG(90),
+        .easing_type = eSE_EASE_QUARACTIC,
+        .move_type = eSE_MOV_IN_OUT,
+    };
+
+    /* Held before and after, half way at half time */
+    if (SE_plan_eval(&plan, 0) != DEG(90) || SE_plan_eval(&plan, 600) != DEG(45) ||
+        SE_plan_eval(&plan, 1100) != 0 || SE_plan_eval(&plan, 5000) != 0)
+    {
+        SE_ERROR("Plan at 0, 600, 1100, 5000 ms: %u %u %u %u", SE_plan_eval(&plan, 0), SE_plan_eval(&plan, 600),
+                 SE_plan_eval(&plan, 1100), SE_plan_eval(&plan, 5000));
+        return -1;
+    }
+
+    /* A jump has no start to hold, the single and the batch paths both sit at the end */
+    const uint32_t times[] = {0, 100, 5000};
+    uint32_t positions[3];
+    plan.duration_ms = 0;
+    SE_plan_eval_batch(&plan, 1, times, 3, positions);
+    for (int k = 0; k < 3; k++)
+    {
+        if (SE_plan_eval(&plan, times[k]) != 0 || positions[k] != 0)
+        {
+            SE_ERROR("Jump at %u ms: %u, batch %u", times[k], SE_plan_eval(&plan, times[k]), positions[k]);
+            return -1;
+        }
+    }
+    return 0;
+}
+
+/* The plan predicts every angle the engine steps through, and asking changes nothing */
+static int check_servo(void)
+{
+    SE_servo_t servo;
+    SE_argument_t args = {
+        .controller_id = test_data.info.id,
+        .easing_type = eSE_EASE_QUARACTIC,
+        .move_type = eSE_MOV_IN_OUT,
+        .servo_id = 0,
+        .speed = 90,
+        .period_us = 20000,
+        .init_angle = 30,
+    };
+    if (SE_create_servo(&servo, args) != kSE_SUCCESS)
+    {
+        SE_ERROR("Create servo failed, error %s", SE_get_error());
+        return -1;
+    }
+    SE_servo_set_decimation(&servo, false);
+
+    SE_plan_t plan;
+    SE_servo_get_plan(&servo, &plan);
+    if (plan.duration_ms != 0 || SE_plan_eval(&plan, 12345) != DEG(30))
+    {
+        SE_ERROR("Idle servo must hold its angle");
+        return -1;
+    }
+
+    SE_servo_set_angle(&servo, 120);
+    SE_servo_start(&servo);
+    SE_tick_update(TEST_TICK_MS);
+    SE_plan_t pending;
+    SE_servo_get_plan(&servo, &pending);
+    SE_servo_update(&servo);
+    SE_servo_get_plan(&servo, &plan);
+    if (pending.start_ms != plan.start_ms || plan.duration_ms != 1000 || plan.delta_position != (int32_t)DEG(90))
+    {
+        SE_ERROR("Plan of the started move: %u ms from %u, delta %d", plan.duration_ms, plan.start_ms,
+                 plan.delta_position);
+        return -1;
+    }
+
+    uint32_t steps = 0;
+    while (SE_servo_is_moving(&servo) && steps++ < 1000)
+    {
+        SE_tick_update(TEST_TICK_MS);
+        uint32_t now = SE_tick_get_current_tick();
+        uint32_t predicted = SE_plan_eval(&plan, now) >> SE_CALIBRATION_FRAC_BITS;
+        SE_plan_t again;
+        SE_servo_get_plan(&servo, &again);
+        SE_servo_update(&servo);
+        if (SE_servo_get_angle(&servo) != predicted || again.start_ms != plan.start_ms)
+        {
+            SE_ERROR("At %u ms the servo is at %d, the plan at %u", now - plan.start_ms, SE_servo_get_angle(&servo),
+                     predicted);
+            return -1;
+        }
+    }
+    return 0;
+}
+
+static int check_batch(void)
+{
+    static SE_plan_t plans[TEST_PLANS];
+    static uint32_t times[TEST_TIMES];
+    static uint32_t positions[TEST_PLANS * TEST_TIMES];
+    srand(11);
+    for (int p = 0; p < TEST_PLANS; p++)
+    {
+        uint32_t from = rand() % 181;
+        uint32_t to = rand() % 181;
+        plans[p] = (SE_plan_t){
+            .start_ms = 1000 + rand() % 2000,
+            .duration_ms = (p % 8 == 0) ? 0 : 200 + rand() % 3000,
+            .start_position = DEG(from),
+            .delta_position = (int32_t)DEG(to) - (int32_t)DEG(from),
+            .easing_type = (p & 1) ? eSE_EASE_QUARTIC : eSE_EASE_QUARACTIC,
+            .move_type = p % eSE_MOV_LAST,
+        };
+    }
+
+    for (int k = 0; k < TEST_TIMES; k++)
+    {
+        times[k] = k * 25;
+    }
+
+    if (SE_plan_eval_batch(plans, TEST_PLANS, times, TEST_TIMES, positions) != kSE_SUCCESS)
+    {
+        SE_ERROR("Batch failed, error %s", SE_get_error());
+        return -1;
+    }
+
+    for (int p = 0; p < TEST_PLANS; p++)
+    {
+        for (int k = 0; k < TEST_TIMES; k++)
+        {
+            if (positions[p * TEST_TIMES + k] != SE_plan_eval(&plans[p], times[k]))
+            {
+                SE_ERROR("Plan %d at %u ms: batch %u, single %u", p, times[k], positions[p * TEST_TIMES + k],
+                         SE_plan_eval(&plans[p], times[k]));
+                return -1;
+            }
+        }
+    }
+
+    /* Debug lines inside the easing code would dominate the measure */
+    log_set_level(LOG_INFO);
+    uint64_t start = now_us();
+    for (int r = 0; r < TEST_BENCH_ROUNDS; r++)
+    {
+        SE_plan_eval_batch(plans, TEST_PLANS, times, TEST_TIMES, positions);
+    }
+    uint64_t elapse_us = now_us() - start;
+    SE_INFO("%d plans at %d times: %llu ns per position", TEST_PLANS, TEST_TIMES,
+            (unsigned long long)(elapse_us * 1000 / ((uint64_t)TEST_BENCH_ROUNDS * TEST_PLANS * TEST_TIMES)));
+    return 0;
+}
+
+int main()
+{
+    SE_controller_register(&test_controller);
+    if (check_eval() != 0 || check_servo() != 0)
+    {
+        return -1;
+    }
+    return check_batch();
+}
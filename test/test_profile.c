@@ -0,0 +1,213 @@
+#include <stdbool.h>
+#include <stdlib.h>
+#include <math.h>
+
+#include "servo_easing.h"
+#include "SE_profile.h"
+#include "SE_ticks.h"
+#include "SE_logging.h"
+#include "test_stub_controller.h"
+
+#define TEST_TICK_MS 10
+/* Every phase is rounded up to a whole ms */
+#define TEST_SLACK_MS 4
+
+struct test_case
+{
+    SE_profile_limits_t limits;
+    uint32_t degree;
+};
+
+/* Trapezoid with and without cruise, then the four S-curve shapes */
+static const struct test_case test_cases[] = {
+    {.limits = {.max_velocity = 180, .max_acceleration = 360}, .degree = 180},
+    {.limits = {.max_velocity = 180, .max_acceleration = 360}, .degree = 20},
+    {.limits = {.max_velocity = 180, .max_acceleration = 720, .max_jerk = 3600}, .degree = 180},
+    {.limits = {.max_velocity = 180, .max_acceleration = 720, .max_jerk = 360}, .degree = 180},
+    {.limits = {.max_velocity = 300, .max_acceleration = 900, .max_jerk = 36000}, .degree = 30},
+    {.limits = {.max_velocity = 300, .max_acceleration = 900, .max_jerk = 3600}, .degree = 5},
+};
+#define TEST_CASE_COUNT (sizeof(test_cases) / sizeof(test_cases[0]))
+static struct test_stub test_data = {.info = TEST_STUB_INFO("Profile test controller", 1)};
+static struct SE_controller test_controller = {TEST_STUB_OPS(test_data)};
+
+/* Continuous minimum time in ms, in doubles straight from the textbook case split */
+static double reference_duration(const SE_profile_limits_t *limits, double distance)
+{
+    double v = limits->max_velocity;
+    double a = limits->max_acceleration;
+    double j = limits->max_jerk;
+    if (j == 0)
+    {
+        return 1000 * ((distance >= v * v / a) ? distance / v + v / a : 2 * sqrt(distance / a));
+    }
+
+    double tj = (v * j >= a * a) ? a / j : sqrt(v / j);
+    double ta = (v * j >= a * a) ? tj + v / a : 2 * tj;
+    if (distance >= v * ta)
+    {
+        return 1000 * (distance / v + ta);
+    }
+
+    tj = a / j;
+    ta = tj / 2 + sqrt(tj * tj / 4 + distance / a);
+    if (ta < 2 * tj)
+    {
+        ta = 2 * cbrt(distance / (2 * j));
+    }
+    return 1000 * 2 * ta;
+}
+
+/* Peaks of the scaled profile, from its phase lengths */
+static int check_peaks(const SE_profile_t *profile, const SE_profile_limits_t *limits)
+{
+    double distance = (double)profile->distance / (1 << SE_CALIBRATION_FRAC_BITS);
+    double ta = profile->accel_ms / 1000.0;
+    double tj = profile->jerk_ms / 1000.0;
+    double velocity = distance / (ta + profile->cruise_ms / 1000.0);
+    double acceleration = (tj > 0) ? velocity / (ta - tj) : velocity / ta;
+    double jerk = (tj > 0) ? acceleration / tj : 0;
+    SE_INFO("Peaks %.1f deg/s, %.1f deg/s2, %.1f deg/s3", velocity, acceleration, jerk);
+    if (velocity > limits->max_velocity * 1.001 || acceleration > limits->max_acceleration * 1.001 ||
+        (limits->max_jerk > 0 && jerk > limits->max_jerk * 1.001))
+    {
+        SE_ERROR("Profile exceeds its limits");
+        return -1;
+    }
+    return 0;
+}
+
+static int check_eval(const SE_profile_t *profile)
+{
+    uint32_t last = 0;
+    for (uint32_t t = 0; t <= profile->duration_ms; t++)
+    {
+        uint32_t covered = SE_profile_eval(profile, t);
+        if (covered < last)
+        {
+            SE_ERROR("Profile goes backward at %u ms", t);
+            return -1;
+        }
+        last = covered;
+    }
+
+    if (SE_profile_eval(profile, 0) != 0 || last != profile->distance)
+    {
+        SE_ERROR("Profile must start still and land on the distance, ends at %u of %u", last, profile->distance);
+        return -1;
+    }
+
+    /* Symmetric speed up and stop */
+    uint32_t half = profile->distance / 2;
+    uint32_t middle = SE_profile_eval(profile, profile->duration_ms / 2);
+    if (profile->duration_ms % 2 == 0 && abs((int32_t)middle - (int32_t)half) > 1)
+    {
+        SE_ERROR("Profile is not symmetric, %u at half time for %u", middle, half);
+        return -1;
+    }
+    return 0;
+}
+
+static int check_plans(void)
+{
+    for (size_t i = 0; i < TEST_CASE_COUNT; i++)
+    {
+        const struct test_case *test = &test_cases[i];
+        SE_profile_t profile;
+        if (SE_profile_plan(&profile, &test->limits, test->degree << SE_CALIBRATION_FRAC_BITS) != kSE_SUCCESS)
+        {
+            SE_ERROR("Plan %d failed, error %s", (int)i, SE_get_error());
+            return -1;
+        }
+
+        double expect = reference_duration(&test->limits, test->degree);
+        SE_INFO("Case %d: %u ms for %.1f ms, jerk %u accel %u cruise %u", (int)i, profile.duration_ms, expect,
+                profile.jerk_ms, profile.accel_ms, profile.cruise_ms);
+        if (profile.duration_ms + 1 < expect || profile.duration_ms > expect + TEST_SLACK_MS)
+        {
+            SE_ERROR("Profile is not the minimum time one");
+            return -1;
+        }
+
+        if (check_peaks(&profile, &test->limits) != 0 || check_eval(&profile) != 0)
+        {
+            return -1;
+        }
+    }
+
+    SE_profile_t profile;
+    SE_profile_limits_t no_velocity = {.max_acceleration = 100};
+    if (SE_profile_plan(&profile, &no_velocity, 256) != kSE_OUT_OF_RANGE)
+    {
+        SE_ERROR("Missing limit must be rejected");
+        return -1;
+    }
+    return 0;
+}
+
+static int check_servo(void)
+{
+    SE_controller_register(&test_controller);
+    SE_argument_t args = {
+        .controller_id = test_data.info.id,
+        .easing_type = eSE_EASE_QUARACTIC,
+        .move_type = eSE_MOV_IN_OUT,
+        .servo_id = 0,
+        .speed = 90,
+        .period_us = 20000,
+    };
+    SE_servo_t servo;
+    if (SE_create_servo(&servo, args) != kSE_SUCCESS || SE_servo_set_profile(&servo, &test_cases[2].limits) != kSE_SUCCESS)
+    {
+        SE_ERROR("Unable to set the profile");
+        return -1;
+    }
+
+    SE_servo_set_angle(&servo, 180);
+    SE_servo_start(&servo);
+    uint32_t duration = SE_servo_get_milis_to_complete_move(&servo);
+    uint32_t ticks = 0;
+    do
+    {
+        SE_tick_update(TEST_TICK_MS);
+        SE_servo_update_all();
+        ticks++;
+    } while (SE_servo_is_moving(&servo) && ticks < 1000);
+
+    SE_INFO("Profile move in %u ticks for %u ms, end %d deg", ticks, duration, SE_servo_get_angle(&servo));
+    if (duration > reference_duration(&test_cases[2].limits, 180) + TEST_SLACK_MS ||
+        ticks * TEST_TICK_MS < duration || ticks * TEST_TICK_MS > duration + 3 * TEST_TICK_MS ||
+        SE_servo_get_angle(&servo) != 180)
+    {
+        SE_ERROR("Servo must follow the profile and end on the set angle");
+        return -1;
+    }
+
+    /* Back down, then easing again without the profile */
+    SE_servo_set_angle(&servo, 90);
+    SE_servo_start(&servo);
+    do
+    {
+        SE_tick_update(TEST_TICK_MS);
+        SE_servo_update_all();
+    } while (SE_servo_is_moving(&servo));
+    SE_servo_set_profile(&servo, NULL);
+    SE_servo_set_angle(&servo, 0);
+    SE_servo_start(&servo);
+    if (SE_servo_get_angle(&servo) != 90 || SE_servo_get_milis_to_complete_move(&servo) != 90 * 1000 / args.speed)
+    {
+        SE_ERROR("Detached profile must go back to the easing speed");
+        return -1;
+    }
+    SE_servo_deinit(&servo);
+    return 0;
+}
+
+int main()
+{
+    if (check_plans() != 0 || check_servo() != 0)
+    {
+        return -1;
+    }
+    return 0;
+}
@@ -0,0 +1,160 @@
+#define _GNU_SOURCE
+#include <ftw.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "SE_pwmchip.h"
+#include "SE_logging.h"
+
+#define TEST_PWMCHIP_COUNT 96
+#define TEST_PWMCHIP_NO_NODE 12
+#define TEST_PCA9685_CHIP_A 5
+#define TEST_PCA9685_CHIP_B 80
+#define TEST_MTK_9050_CHIP 90
+
+static char root[64] = "/tmp/se_pwmchip_XXXXXX";
+
+static int make_chip(int chip, const char *compatible, size_t len)
+{
+    char path[256] = "";
+    snprintf(path, sizeof(path), "%s/pwmchip%d", root, chip);
+    mkdir(path, 0755);
+    if (compatible == NULL)
+    {
+        return 0;
+    }
+
+    strcat(path, "/device");
+    mkdir(path, 0755);
+    strcat(path, "/of_node");
+    mkdir(path, 0755);
+    strcat(path, "/compatible");
+    FILE *file = fopen(path, "w");
+    if (file == NULL)
+    {
+        return -1;
+    }
+    fwrite(compatible, 1, len, file);
+    fclose(file);
+    return 0;
+}
+
+static int remove_entry(const char *path, const struct stat *sb, int flag, struct FTW *ftw)
+{
+    return remove(path);
+}
+
+static uint64_t now_us(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+static int run_checks(void)
+{
+    static const char generic[] = "vendor,generic-pwm\n";
+    static const char pca9685[] = "nxp,pca9685-pwm\n";
+    static const char mtk_9050[] = "mstar,msc313-pwm\0mstar,pwm";
+
+    for (int i = 0; i < TEST_PWMCHIP_COUNT; i++)
+    {
+        int ret = 0;
+        if (i == TEST_PWMCHIP_NO_NODE)
+        {
+            ret = make_chip(i, NULL, 0);
+        }
+        else if (i == TEST_PCA9685_CHIP_A || i == TEST_PCA9685_CHIP_B)
+        {
+            ret = make_chip(i, pca9685, sizeof(pca9685) - 1);
+        }
+        else if (i == TEST_MTK_9050_CHIP)
+        {
+            ret = make_chip(i, mtk_9050, sizeof(mtk_9050));
+        }
+        else
+        {
+            ret = make_chip(i, generic, sizeof(generic) - 1);
+        }
+        if (ret != 0)
+        {
+            SE_ERROR("Unable to generate fake pwmchip %d", i);
+            return -1;
+        }
+    }
+
+    SE_pwmchip_set_root(root);
+    char dev_path[128] = "";
+    uint64_t start = now_us();
+    SE_ret_t ret = SE_pwmchip_find("nxp,pca9685-pwm", dev_path, sizeof(dev_path));
+    uint64_t scan_us = now_us() - start;
+
+    start = now_us();
+    char mtk_path[128] = "";
+    ret |= SE_pwmchip_find("mstar,pwm", mtk_path, sizeof(mtk_path));
+    ret |= SE_pwmchip_find("mstar,pwm", mtk_path, sizeof(mtk_path));
+    uint64_t lookup_us = now_us() - start;
+    SE_INFO("Scan %d pwmchip took %llu us, cached lookups took %llu us", TEST_PWMCHIP_COUNT,
+            (unsigned long long)scan_us, (unsigned long long)lookup_us);
+
+    if (ret != kSE_SUCCESS)
+    {
+        SE_ERROR("Lookup failed");
+        return -1;
+    }
+
+    char expect[128] = "";
+    snprintf(expect, sizeof(expect), "%s/pwmchip%d", root, TEST_PCA9685_CHIP_A);
+    if (strcmp(dev_path, expect))
+    {
+        SE_ERROR("Expect %s got %s", expect, dev_path);
+        return -1;
+    }
+
+    snprintf(expect, sizeof(expect), "%s/pwmchip%d", root, TEST_MTK_9050_CHIP);
+    if (strcmp(mtk_path, expect))
+    {
+        SE_ERROR("Expect %s got %s", expect, mtk_path);
+        return -1;
+    }
+
+    const char *all[4] = {NULL};
+    int found = SE_pwmchip_find_all("nxp,pca9685-pwm", all, 4);
+    snprintf(expect, sizeof(expect), "%s/pwmchip%d", root, TEST_PCA9685_CHIP_B);
+    if (found != 2 || strcmp(all[1], expect))
+    {
+        SE_ERROR("Expect 2 pca9685 chips sorted by number, found %d", found);
+        return -1;
+    }
+
+    if (SE_pwmchip_count() != TEST_PWMCHIP_COUNT - 1)
+    {
+        SE_ERROR("Chip without of_node must be skipped, count %d", SE_pwmchip_count());
+        return -1;
+    }
+
+    if (SE_pwmchip_find("ti,ehrpwm", dev_path, sizeof(dev_path)) == kSE_SUCCESS)
+    {
+        SE_ERROR("Unknown compatible must not match");
+        return -1;
+    }
+    return 0;
+}
+
+int main()
+{
+    if (mkdtemp(root) == NULL)
+    {
+        SE_ERROR("Unable to create fake sysfs root");
+        return -1;
+    }
+
+    int ret = run_checks();
+    nftw(root, remove_entry, 16, FTW_DEPTH | FTW_PHYS);
+    return ret;
+}
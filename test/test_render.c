@@ -0,0 +1,201 @@
+#include <stdbool.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "servo_easing.h"
+#include "SE_render.h"
+#include "SE_ticks.h"
+#include "SE_logging.h"
+#include "test_stub_controller.h"
+#include "Trace/trace_render.h"
+#include "Trace/trace_replay_controller.h"
+
+#define TEST_PERIOD_MS 20
+#define TEST_BENCH_CHANNELS 40
+#define TEST_BENCH_MS (3600 * 1000)
+#define TEST_BENCH_MOVES 2000
+#define TEST_BENCH_BUDGET_MS 1000
+
+static const SE_render_move_t test_moves[] = {
+    {.duration_ms = 1000, .angle = 90, .easing_type = eSE_EASE_QUARACTIC, .move_type = eSE_MOV_IN_OUT},
+    {.duration_ms = 500, .angle = 30, .easing_type = eSE_EASE_QUARTIC, .move_type = eSE_MOV_IN},
+};
+#define TEST_MOVE_COUNT (sizeof(test_moves) / sizeof(test_moves[0]))
+
+static struct test_stub test_data = {.info = TEST_STUB_INFO("Render test controller", 1)};
+static struct SE_controller test_controller = {TEST_STUB_OPS(test_data)};
+
+static uint64_t now_us(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+/* Duty of the controller wide map at a whole angle */
+static uint16_t angle_duty(const SE_render_t *render, uint8_t angle)
+{
+    return SE_calibration_lookup(render->lut[0], (uint32_t)angle << SE_CALIBRATION_FRAC_BITS);
+}
+
+static int check_frames(SE_render_t *render)
+{
+    /* The render keeps using its channels, check_trace renders them again */
+    static SE_render_channel_t channel = {
+        .servo_id = 0,
+        .start_angle = 0,
+        .moves = test_moves,
+        .move_count = TEST_MOVE_COUNT,
+    };
+    channel.controller_id = test_data.info.id;
+    if (SE_render_init(render, &channel, 1, TEST_PERIOD_MS) != kSE_SUCCESS)
+    {
+        SE_ERROR("Render init failed, error %s", SE_get_error());
+        return -1;
+    }
+
+    /* 1500 ms of moves, the last frame holds the last angle */
+    uint32_t frame_count = SE_render_get_frame_count(render);
+    uint16_t duties[128];
+    if (frame_count != 1500 / TEST_PERIOD_MS + 1 || SE_render_frames(render, duties, frame_count + 10) != kSE_SUCCESS)
+    {
+        SE_ERROR("Render of %u frames failed", frame_count);
+        return -1;
+    }
+
+    /* Quaractic in-out crosses half way at half time, each move ends on its angle */
+    if (duties[0] != angle_duty(render, 0) || duties[500 / TEST_PERIOD_MS] != angle_duty(render, 45) ||
+        duties[1000 / TEST_PERIOD_MS] != angle_duty(render, 90) || duties[frame_count + 9] != angle_duty(render, 30))
+    {
+        SE_ERROR("Duty at 0, 500, 1000 ms and held: %u %u %u %u", duties[0], duties[500 / TEST_PERIOD_MS],
+                 duties[1000 / TEST_PERIOD_MS], duties[frame_count + 9]);
+        return -1;
+    }
+
+    for (uint32_t f = 1; f < frame_count; f++)
+    {
+        bool rising = f <= 1000 / TEST_PERIOD_MS;
+        if ((rising && duties[f] < duties[f - 1]) || (!rising && duties[f] > duties[f - 1]))
+        {
+            SE_ERROR("Frame %u turns back, %u after %u", f, duties[f], duties[f - 1]);
+            return -1;
+        }
+    }
+
+    if (SE_render_get_time(render) != (frame_count + 10) * TEST_PERIOD_MS || SE_tick_get_current_tick() != 0 ||
+        test_data.duty_calls != 0)
+    {
+        SE_ERROR("Render must run on its own clock without writing the controller");
+        return -1;
+    }
+    return 0;
+}
+
+static int check_trace(SE_render_t *render)
+{
+    char path[] = "/tmp/se_render_XXXXXX";
+    int fd = mkstemp(path);
+    if (fd < 0)
+    {
+        SE_ERROR("Unable to create trace file");
+        return -1;
+    }
+    close(fd);
+
+    SE_render_rewind(render);
+    struct trace_replay replay;
+    SE_ret_t ret = trace_render_write(path, render, 0);
+    if (ret == kSE_SUCCESS)
+    {
+        ret = trace_replay_open(&replay, path, &test_controller);
+    }
+
+    if (ret != kSE_SUCCESS)
+    {
+        SE_ERROR("Rendered trace does not open, error %s", SE_get_error());
+        unlink(path);
+        return -1;
+    }
+
+    /* Only changes are recorded, the held frame repeats the last move end */
+    uint32_t frames = 1500 / TEST_PERIOD_MS + 1;
+    const struct trace_record *last = &replay.record[replay.count - 1];
+    SE_INFO("Rendered trace holds %u records for %u frames", replay.count, frames);
+    ret = (replay.count > 1 && replay.count <= frames && last->duty_us == angle_duty(render, 30) &&
+           last->period_us == TEST_PERIOD_MS * 1000) ? 0 : -1;
+    trace_replay_close(&replay);
+    unlink(path);
+    if (ret != 0)
+    {
+        SE_ERROR("Rendered trace does not match the frames");
+    }
+    return ret;
+}
+
+/* An hour of back to back moves on 40 channels */
+static int check_bench(SE_render_t *render)
+{
+    static SE_render_channel_t channels[TEST_BENCH_CHANNELS];
+    static SE_render_move_t moves[TEST_BENCH_CHANNELS][TEST_BENCH_MOVES];
+    srand(7);
+    for (int c = 0; c < TEST_BENCH_CHANNELS; c++)
+    {
+        for (int m = 0; m < TEST_BENCH_MOVES; m++)
+        {
+            moves[c][m] = (SE_render_move_t){
+                .duration_ms = TEST_BENCH_MS / TEST_BENCH_MOVES,
+                .angle = rand() % 181,
+                .easing_type = (m & 1) ? eSE_EASE_QUARTIC : eSE_EASE_QUARACTIC,
+                .move_type = rand() % eSE_MOV_LAST,
+            };
+        }
+        channels[c] = (SE_render_channel_t){
+            .controller_id = test_data.info.id,
+            .servo_id = c % 16,
+            .start_angle = 90,
+            .moves = moves[c],
+            .move_count = TEST_BENCH_MOVES,
+        };
+    }
+
+    if (SE_render_init(render, channels, TEST_BENCH_CHANNELS, TEST_PERIOD_MS) != kSE_SUCCESS)
+    {
+        SE_ERROR("Render init failed, error %s", SE_get_error());
+        return -1;
+    }
+
+    uint32_t frames = SE_render_get_frame_count(render);
+    uint16_t *duties = malloc((size_t)frames * TEST_BENCH_CHANNELS * sizeof(uint16_t));
+    if (duties == NULL)
+    {
+        SE_ERROR("Unable to allocate %u frames", frames);
+        return -1;
+    }
+
+    /* Debug lines inside the easing code would dominate the measure */
+    log_set_level(LOG_INFO);
+    uint64_t start = now_us();
+    SE_render_frames(render, duties, frames);
+    uint64_t elapse_us = now_us() - start;
+    free(duties);
+    SE_INFO("%u frames of %d channels rendered in %llu us", frames, TEST_BENCH_CHANNELS,
+            (unsigned long long)elapse_us);
+    if (elapse_us >= TEST_BENCH_BUDGET_MS * 1000)
+    {
+        SE_ERROR("An hour of motion takes more than %d ms to render", TEST_BENCH_BUDGET_MS);
+        return -1;
+    }
+    return 0;
+}
+
+int main()
+{
+    static SE_render_t render;
+    SE_controller_register(&test_controller);
+    if (check_frames(&render) != 0 || check_trace(&render) != 0)
+    {
+        return -1;
+    }
+    return check_bench(&render);
+}
@@ -0,0 +1,101 @@
+#include <fcntl.h>
+#include <stdio.h>
+#include <unistd.h>
+#include <sys/mman.h>
+
+#include "servo_easing.h"
+#include "SE_shm.h"
+#include "SE_shm_producer.h"
+#include "SE_ticks.h"
+#include "SE_logging.h"
+#include "test_stub_controller.h"
+
+#define TEST_TICK_MS 10
+
+static struct test_stub test_data = {.info = TEST_STUB_INFO("Shm test controller", 2)};
+static struct SE_controller test_controller = {TEST_STUB_OPS(test_data)};
+
+static SE_servo_t servo[2];
+
+static void run_until_still(void)
+{
+    uint32_t ticks = 0;
+    do
+    {
+        SE_shm_poll();
+        SE_tick_update(TEST_TICK_MS);
+        SE_servo_update_all();
+        ticks++;
+    } while ((SE_servo_is_moving(&servo[0]) || SE_servo_is_moving(&servo[1])) && ticks < 1000);
+}
+
+int main()
+{
+    char name[32];
+    snprintf(name, sizeof(name), "/se_shm_test_%d", (int)getpid());
+    SE_controller_register(&test_controller);
+    for (int i = 0; i < 2; i++)
+    {
+        SE_argument_t args = {
+            .controller_id = test_data.info.id,
+            .easing_type = eSE_EASE_QUARACTIC,
+            .move_type = eSE_MOV_IN,
+            .servo_id = i,
+            .speed = 90,
+            .period_us = 20000,
+        };
+        SE_create_servo(&servo[i], args);
+    }
+
+    /* The consumer caught between shm_open and ftruncate, the segment is still empty */
+    SE_shm_producer_t producer;
+    int fd = shm_open(name, O_RDWR | O_CREAT, 0660);
+    SE_ret_t empty_ret = SE_shm_producer_open(&producer, name);
+    close(fd);
+    if (empty_ret != kSE_TRY_AGAIN || SE_shm_create(name) != kSE_SUCCESS ||
+        SE_shm_producer_open(&producer, name) != kSE_SUCCESS)
+    {
+        SE_ERROR("Producer must wait for the consumer segment");
+        return -1;
+    }
+    SE_shm_attach(0, &servo[0]);
+    SE_shm_attach(1, &servo[1]);
+
+    /* Only the last block command of a slot is applied, every ring command is */
+    SE_shm_command_t command = {.slot = 0, .angle = 30, .speed = 180, .easing_type = eSE_EASE_QUARACTIC};
+    SE_shm_producer_set(&producer, &command);
+    command.angle = 45;
+    uint32_t last = SE_shm_producer_set(&producer, &command);
+    command.slot = 1;
+    command.angle = 120;
+    SE_shm_producer_push(&producer, &command);
+    if (SE_shm_poll() != 2)
+    {
+        SE_ERROR("Expected one block and one ring command");
+        return -1;
+    }
+    run_until_still();
+
+    uint64_t applied_ns = 0;
+    int ret = 0;
+    if (SE_servo_get_angle(&servo[0]) != 45 || SE_servo_get_angle(&servo[1]) != 120 ||
+        SE_shm_producer_get_applied(&producer, 0, &applied_ns) != last || applied_ns == 0)
+    {
+        SE_ERROR("Servos at %d and %d deg", SE_servo_get_angle(&servo[0]), SE_servo_get_angle(&servo[1]));
+        ret = -1;
+    }
+
+    for (int i = 0; i < SE_SHM_RING_SIZE; i++)
+    {
+        SE_shm_producer_push(&producer, &command);
+    }
+    if (SE_shm_producer_push(&producer, &command) != kSE_TRY_AGAIN || SE_shm_poll() != SE_SHM_RING_SIZE)
+    {
+        SE_ERROR("Full ring must push back and drain in one poll");
+        ret = -1;
+    }
+
+    SE_shm_producer_close(&producer);
+    SE_shm_destroy();
+    return ret;
+}
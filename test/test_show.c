@@ -0,0 +1,225 @@
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "servo_easing.h"
+#include "SE_show.h"
+#include "SE_ticks.h"
+#include "SE_logging.h"
+#include "test_stub_controller.h"
+
+#define TEST_TICK_MS 10
+#define TEST_SERVO 3
+/* Five minutes at 50 Hz on every servo instance */
+#define TEST_LONG_TRACKS 20
+#define TEST_LONG_KEYS 15000
+#define TEST_LONG_KEY_MS 20
+#define TEST_INDEX_MS 1000
+#define TEST_SEEKS 1000
+
+static struct test_stub test_data = {.info = TEST_STUB_INFO("Show test controller", TEST_LONG_TRACKS)};
+static struct SE_controller test_controller = {TEST_STUB_OPS(test_data)};
+
+static const SE_show_key_t short_keys[TEST_SERVO][3] = {
+    {{500, 90, eSE_EASE_QUARACTIC, eSE_MOV_IN_OUT}, {300, 90, eSE_EASE_QUARACTIC, eSE_MOV_IN_OUT},
+     {400, 10, eSE_EASE_QUARACTIC, eSE_MOV_IN}},
+    {{200, 180, eSE_EASE_QUARACTIC, eSE_MOV_OUT}, {600, 0, eSE_EASE_QUARACTIC, eSE_MOV_IN_OUT},
+     {400, 45, eSE_EASE_QUARACTIC, eSE_MOV_IN_OUT}},
+    {{1200, 120, eSE_EASE_QUARACTIC, eSE_MOV_IN_OUT}},
+};
+
+static SE_show_key_t long_keys[TEST_LONG_TRACKS][TEST_LONG_KEYS];
+static SE_servo_t servos[TEST_LONG_TRACKS];
+static SE_show_player_t player;
+static SE_show_player_t reference;
+
+static int create_servos(void)
+{
+    SE_controller_register(&test_controller);
+    for (int i = 0; i < TEST_LONG_TRACKS; i++)
+    {
+        SE_argument_t args = {
+            .controller_id = test_data.info.id,
+            .easing_type = eSE_EASE_QUARACTIC,
+            .move_type = eSE_MOV_IN_OUT,
+            .servo_id = i,
+            .speed = 90,
+            .period_us = 20000,
+        };
+        if (SE_create_servo(&servos[i], args) != kSE_SUCCESS)
+        {
+            SE_ERROR("Create servo %d failed, error %s", i, SE_get_error());
+            return -1;
+        }
+    }
+    return 0;
+}
+
+static int check_play(const char *path)
+{
+    SE_show_track_desc_t tracks[TEST_SERVO];
+    for (int i = 0; i < TEST_SERVO; i++)
+    {
+        tracks[i] = (SE_show_track_desc_t){
+            .controller_id = test_data.info.id,
+            .servo_id = i,
+            .keys = short_keys[i],
+            .key_count = (i < 2) ? 3 : 1,
+        };
+    }
+
+    if (SE_show_write(path, tracks, TEST_SERVO, 250) != kSE_SUCCESS || SE_show_open(&player, path) != kSE_SUCCESS)
+    {
+        SE_ERROR("Short show failed, error %s", SE_get_error());
+        return -1;
+    }
+
+    for (int i = 0; i < TEST_SERVO; i++)
+    {
+        SE_show_attach(&player, &servos[i]);
+    }
+
+    /* The first servo holds 90 degrees between 500 and 800 ms, float easing may stop a degree short */
+    int started = 0;
+    int hold_angle = -1;
+    for (uint32_t t = 0; t <= SE_show_get_duration(&player) + 20 * TEST_TICK_MS; t += TEST_TICK_MS)
+    {
+        started += SE_show_update(&player, t);
+        SE_tick_update(TEST_TICK_MS);
+        SE_servo_update_all();
+        hold_angle = (t == 700) ? SE_servo_get_angle(&servos[0]) : hold_angle;
+    }
+    SE_show_close(&player);
+
+    SE_INFO("Short show: %d segments started, ends %d %d %d deg, hold %d deg", started,
+            SE_servo_get_angle(&servos[0]), SE_servo_get_angle(&servos[1]), SE_servo_get_angle(&servos[2]), hold_angle);
+    if (started != 7 || SE_servo_get_angle(&servos[0]) != 10 || SE_servo_get_angle(&servos[1]) != 45 ||
+        SE_servo_get_angle(&servos[2]) != 120 || abs(hold_angle - 90) > 1)
+    {
+        SE_ERROR("Servos must follow the show keys");
+        return -1;
+    }
+    return 0;
+}
+
+static int check_seek(const char *path)
+{
+    SE_show_track_desc_t tracks[TEST_LONG_TRACKS];
+    for (int i = 0; i < TEST_LONG_TRACKS; i++)
+    {
+        for (int k = 0; k < TEST_LONG_KEYS; k++)
+        {
+            long_keys[i][k] = (SE_show_key_t){TEST_LONG_KEY_MS, (k * 7 + i * 13) % 181, eSE_EASE_QUARACTIC,
+                                              eSE_MOV_IN_OUT};
+        }
+        tracks[i] = (SE_show_track_desc_t){
+            .controller_id = test_data.info.id,
+            .servo_id = i,
+            .start_angle = 90,
+            .keys = long_keys[i],
+            .key_count = TEST_LONG_KEYS - i,
+        };
+    }
+
+    struct timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    if (SE_show_write(path, tracks, TEST_LONG_TRACKS, TEST_INDEX_MS) != kSE_SUCCESS ||
+        SE_show_open(&player, path) != kSE_SUCCESS)
+    {
+        SE_ERROR("Long show failed, error %s", SE_get_error());
+        return -1;
+    }
+
+    for (int i = 0; i < TEST_LONG_TRACKS; i++)
+    {
+        SE_show_attach(&player, &servos[i]);
+    }
+
+    /* Seeks against a linear walk from the start */
+    uint32_t duration = SE_show_get_duration(&player);
+    uint64_t seek_ns = 0;
+    for (int s = 0; s < TEST_SEEKS; s++)
+    {
+        uint32_t time_ms = (uint32_t)(((uint64_t)s * 7919 * TEST_LONG_KEY_MS + s) % (duration + TEST_INDEX_MS));
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        SE_show_seek(&player, time_ms);
+        clock_gettime(CLOCK_MONOTONIC, &end);
+        seek_ns += (uint64_t)(end.tv_sec - start.tv_sec) * 1000000000 + end.tv_nsec - start.tv_nsec;
+
+        if (s % 100 != 0)
+        {
+            continue;
+        }
+        SE_show_open(&reference, path);
+        for (int i = 0; i < TEST_LONG_TRACKS; i++)
+        {
+            SE_show_attach(&reference, &servos[i]);
+        }
+        SE_show_update(&reference, time_ms);
+        bool same = memcmp(reference.cursor, player.cursor, sizeof(player.cursor)) == 0;
+        SE_show_close(&reference);
+        if (!same)
+        {
+            SE_ERROR("Seek to %u ms lands on another segment than playing there", time_ms);
+            return -1;
+        }
+    }
+
+    SE_INFO("Long show: %u ms, %u segments, seek %llu ns", duration, player.header->segment_count,
+            (unsigned long long)(seek_ns / TEST_SEEKS));
+    SE_show_close(&player);
+    return 0;
+}
+
+static int check_invalid(const char *path)
+{
+    FILE *file = fopen(path, "r+b");
+    SE_show_header_t header;
+    if (file == NULL || fread(&header, sizeof(header), 1, file) != 1)
+    {
+        SE_ERROR("Unable to read back the show");
+        return -1;
+    }
+
+    header.segment_count += 1000;
+    fseek(file, 0, SEEK_SET);
+    fwrite(&header, sizeof(header), 1, file);
+    fclose(file);
+    if (SE_show_open(&player, path) != kSE_OUT_OF_RANGE)
+    {
+        SE_ERROR("Show past the end of the file must be rejected");
+        return -1;
+    }
+
+    SE_show_key_t bad_key = {0, 90, eSE_EASE_QUARACTIC, eSE_MOV_IN_OUT};
+    SE_show_track_desc_t bad_track = {.keys = &bad_key, .key_count = 1};
+    if (SE_show_write(path, &bad_track, 1, TEST_INDEX_MS) != kSE_OUT_OF_RANGE)
+    {
+        SE_ERROR("Zero length key must be rejected");
+        return -1;
+    }
+    return 0;
+}
+
+int main()
+{
+    char path[] = "/tmp/se_show_XXXXXX";
+    int fd = mkstemp(path);
+    if (fd < 0)
+    {
+        SE_ERROR("Unable to create show file");
+        return -1;
+    }
+    close(fd);
+
+    int ret = -1;
+    if (create_servos() == 0 && check_play(path) == 0 && check_seek(path) == 0 && check_invalid(path) == 0)
+    {
+        ret = 0;
+    }
+    unlink(path);
+    return ret;
+}
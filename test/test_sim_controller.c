@@ -0,0 +1,123 @@
+#include <stdbool.h>
+
+#include "servo_easing.h"
+#include "SE_ticks.h"
+#include "SE_logging.h"
+#include "Sim/sim_controller.h"
+
+#define TEST_PERIOD_US 20000
+#define TEST_MAX_TICKS 5000
+#define TEST_SETTLE_MS 500
+
+static SE_servo_t servo[3];
+
+/* One 0 to 90 deg move, updated every tick_ms, run until the plant reported the move */
+static int run_move(int id, uint32_t tick_ms, bool decimate, struct sim_move_stats *stats)
+{
+    SE_argument_t args = {
+        .controller_id = Sim_get_controller()->get_info_ref(Sim_get_controller())->id,
+        .easing_type = eSE_EASE_QUARACTIC,
+        .move_type = eSE_MOV_IN_OUT,
+        .servo_id = id,
+        .speed = 180,
+        .period_us = TEST_PERIOD_US,
+        .init_angle = 0,
+    };
+    if (SE_create_servo(&servo[id], args) != kSE_SUCCESS)
+    {
+        SE_ERROR("Create servo failed, error %s", SE_get_error());
+        return -1;
+    }
+
+    /* Park the horn at the start angle before moving */
+    SE_servo_set_decimation(&servo[id], decimate);
+    SE_servo_set_angle(&servo[id], 1);
+    SE_servo_start(&servo[id]);
+    for (uint32_t ticks = 0; ticks < TEST_SETTLE_MS / tick_ms; ticks++)
+    {
+        SE_tick_update(tick_ms);
+        SE_servo_update(&servo[id]);
+    }
+
+    struct sim_move_stats parked = {0};
+    sim_controller_get_move_stats(id, &parked);
+    SE_servo_set_angle(&servo[id], 90);
+    SE_servo_start(&servo[id]);
+    uint32_t ticks = 0;
+    do
+    {
+        SE_tick_update(tick_ms);
+        SE_servo_update(&servo[id]);
+        sim_controller_get_move_stats(id, stats);
+        ticks++;
+    } while (stats->moves == parked.moves && ticks < TEST_MAX_TICKS);
+
+    SE_INFO("%u ms updates%s: move %u ms, error max %u mean %u final %d mdeg", tick_ms, decimate ? " decimated" : "",
+            stats->duration_ms, stats->max_error_mdeg, stats->mean_error_mdeg, stats->final_error_mdeg);
+    if (stats->moves != parked.moves + 1)
+    {
+        SE_ERROR("Plant did not settle");
+        return -1;
+    }
+    return 0;
+}
+
+/* A pulse written mid period only moves the horn from the next period boundary */
+static int check_latch(void)
+{
+    struct SE_controller *sim = Sim_get_controller();
+    SE_tick_update(TEST_SETTLE_MS);
+    sim->set_period(sim, 0, TEST_PERIOD_US);
+    int32_t before = sim_controller_get_position(0);
+    SE_tick_update(TEST_PERIOD_US / 1000 / 2);
+    sim->set_duty(sim, 0, sim->get_pulse_resolution(sim, 0) * 300 / 100);
+    SE_tick_update(TEST_PERIOD_US / 1000 / 2 - 1);
+    sim_controller_advance(SE_tick_get_current_tick());
+    if (sim_controller_get_position(0) != before)
+    {
+        SE_ERROR("Horn moved before the pulse was latched");
+        return -1;
+    }
+
+    SE_tick_update(TEST_PERIOD_US / 1000);
+    sim_controller_advance(SE_tick_get_current_tick());
+    if (sim_controller_get_position(0) == before)
+    {
+        SE_ERROR("Horn did not follow the latched pulse");
+        return -1;
+    }
+    return 0;
+}
+
+int main()
+{
+    if (SE_open_controller(eSE_SIM_CONTROLLER) == NULL)
+    {
+        SE_ERROR("Sim controller is not built");
+        return -1;
+    }
+
+    struct sim_move_stats fine;
+    struct sim_move_stats decimated;
+    struct sim_move_stats coarse;
+    if (run_move(0, 1, false, &fine) != 0 || run_move(1, 1, true, &decimated) != 0 ||
+        run_move(2, 50, false, &coarse) != 0)
+    {
+        return -1;
+    }
+
+    /* Emitting once per period loses nothing the plant could have latched, slow updates do */
+    if (decimated.mean_error_mdeg > fine.mean_error_mdeg * 11 / 10 + 100 ||
+        coarse.max_error_mdeg <= fine.max_error_mdeg)
+    {
+        SE_ERROR("Tracking errors do not rank update modes");
+        return -1;
+    }
+
+    if (fine.final_error_mdeg > 1000 || fine.final_error_mdeg < -1000)
+    {
+        SE_ERROR("Plant settled outside its dead band");
+        return -1;
+    }
+    return check_latch();
+}
@@ -0,0 +1,227 @@
+#include <math.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include "servo_easing.h"
+#include "SE_stream.h"
+#include "SE_ticks.h"
+#include "SE_logging.h"
+#include "test_stub_controller.h"
+
+#define TEST_TICK_MS 10
+#define TEST_LATENCY_MS 150
+#define TEST_RUN_MS 6000
+#define TEST_PERIOD_MS 2000.0
+#define TEST_PRODUCER_SAMPLES 20000
+#define TEST_PRODUCER_STEP_MS 20
+#define TEST_Q8(degree) ((int32_t)((degree) * (1 << SE_CALIBRATION_FRAC_BITS) + 0.5))
+
+static struct test_stub test_data = {.info = TEST_STUB_INFO("Stream test controller", 1)};
+static struct SE_controller test_controller = {TEST_STUB_OPS(test_data)};
+
+/* The vision pipeline stand-in: a slow sweep sampled at an irregular 15 to 30 Hz */
+static double sweep(uint32_t time_ms)
+{
+    return 90.0 + 60.0 * sin(2.0 * M_PI * time_ms / TEST_PERIOD_MS);
+}
+
+static uint32_t next_sample_ms(uint32_t time_ms, uint32_t *seed)
+{
+    *seed = *seed * 1103515245 + 12345;
+    return time_ms + 33 + (*seed >> 16) % 34;
+}
+
+static int check_jitter(void)
+{
+    SE_stream_t stream;
+    SE_stream_init(&stream, TEST_LATENCY_MS, 0, 0);
+    uint32_t seed = 1;
+    uint32_t sample_ms = 0;
+    int32_t max_error = 0;
+    int32_t max_jerk = 0;
+    int32_t last[2] = {0, 0};
+    for (uint32_t now = 0; now <= TEST_RUN_MS; now += TEST_TICK_MS)
+    {
+        while (sample_ms <= now)
+        {
+            SE_stream_push(&stream, sample_ms, TEST_Q8(sweep(sample_ms)));
+            sample_ms = next_sample_ms(sample_ms, &seed);
+        }
+
+        int32_t output = SE_stream_eval(&stream, now);
+        if (now >= 2 * TEST_LATENCY_MS)
+        {
+            int32_t error = abs(output - TEST_Q8(sweep(now - TEST_LATENCY_MS)));
+            int32_t jerk = abs(output - 2 * last[0] + last[1]);
+            max_error = (error > max_error) ? error : max_error;
+            max_jerk = (jerk > max_jerk) ? jerk : max_jerk;
+        }
+        last[1] = last[0];
+        last[0] = output;
+    }
+
+    /* The sweep itself changes speed by up to 0.06 degree per tick */
+    SE_INFO("Jitter: max error %d/256 degree, max speed change %d/256 degree per tick, %u underruns", max_error,
+            max_jerk, stream.underruns);
+    if (max_error > TEST_Q8(0.5) || max_jerk > TEST_Q8(0.25) || stream.underruns != 0)
+    {
+        SE_ERROR("Stream does not follow the sweep smoothly");
+        return -1;
+    }
+    return 0;
+}
+
+static int check_clamp(void)
+{
+    SE_stream_t stream;
+    SE_stream_init(&stream, 0, 90, 360);
+    SE_stream_reset(&stream, 0, 0);
+    SE_stream_push(&stream, 0, TEST_Q8(180));
+    SE_stream_push(&stream, 10, TEST_Q8(180));
+
+    int32_t max_velocity = 0;
+    int32_t max_change = 0;
+    int32_t velocity = 0;
+    uint32_t arrive_ms = 0;
+    for (uint32_t now = TEST_TICK_MS; now <= 4000; now += TEST_TICK_MS)
+    {
+        uint32_t output = SE_stream_eval(&stream, now);
+        int32_t change = abs(stream.velocity - velocity);
+        velocity = stream.velocity;
+        max_velocity = (abs(velocity) > max_velocity) ? abs(velocity) : max_velocity;
+        max_change = (change > max_change) ? change : max_change;
+        arrive_ms = (arrive_ms == 0 && output == (uint32_t)TEST_Q8(180)) ? now : arrive_ms;
+    }
+
+    /* 180 degrees at 90 deg/s and 360 deg/s2 takes 2250 ms, each tick moving at its new speed
+     * gains a few ticks */
+    SE_INFO("Clamp: max %d/256 deg/s, max change %d/256 deg/s per tick, arrives at %u ms", max_velocity, max_change,
+            arrive_ms);
+    if (max_velocity > 90 << SE_CALIBRATION_FRAC_BITS ||
+        max_change > (360 << SE_CALIBRATION_FRAC_BITS) * TEST_TICK_MS / 1000 + 1 || arrive_ms < 2200 ||
+        arrive_ms > 2600)
+    {
+        SE_ERROR("Stream output breaks its limits or does not land on the step");
+        return -1;
+    }
+    return 0;
+}
+
+static SE_stream_t shared_stream;
+static volatile bool producer_done = false;
+
+/* Position k at k steps, any torn or lapped read shows off the line */
+static void *producer(void *arg)
+{
+    for (uint32_t k = 1; k <= TEST_PRODUCER_SAMPLES; k++)
+    {
+        SE_stream_push(&shared_stream, k * TEST_PRODUCER_STEP_MS, k);
+        if (k % 8 == 0)
+        {
+            usleep(50);
+        }
+    }
+    producer_done = true;
+    return NULL;
+}
+
+static int check_concurrent(void)
+{
+    SE_stream_init(&shared_stream, 3 * TEST_PRODUCER_STEP_MS, 0, 0);
+    pthread_t thread;
+    pthread_create(&thread, NULL, producer, NULL);
+    uint32_t evals = 0;
+    uint32_t bad = 0;
+    while (!producer_done)
+    {
+        uint32_t newest_ms = __atomic_load_n(&shared_stream.last_push_ms, __ATOMIC_RELAXED);
+        if (newest_ms < 4 * TEST_PRODUCER_STEP_MS)
+        {
+            continue;
+        }
+
+        uint32_t position = SE_stream_eval(&shared_stream, newest_ms);
+        uint32_t expect = (newest_ms - 3 * TEST_PRODUCER_STEP_MS) / TEST_PRODUCER_STEP_MS;
+        bad += (position + 1 < expect || position > expect + 1) ? 1 : 0;
+        evals++;
+    }
+    pthread_join(thread, NULL);
+
+    SE_INFO("Concurrent: %u evaluations, %u off the line", evals, bad);
+    if (bad > evals / 100)
+    {
+        SE_ERROR("Concurrent pushes corrupt the playback");
+        return -1;
+    }
+    return 0;
+}
+
+static int check_servo(void)
+{
+    SE_controller_register(&test_controller);
+    SE_argument_t args = {
+        .controller_id = test_data.info.id,
+        .easing_type = eSE_EASE_QUARACTIC,
+        .move_type = eSE_MOV_IN_OUT,
+        .servo_id = 0,
+        .speed = 90,
+        .period_us = 20000,
+        .init_angle = 90,
+    };
+    SE_servo_t servo;
+    SE_stream_t stream;
+    SE_stream_init(&stream, TEST_LATENCY_MS, 180, 0);
+    if (SE_create_servo(&servo, args) != kSE_SUCCESS || SE_servo_set_stream(&servo, &stream) != kSE_SUCCESS)
+    {
+        SE_ERROR("Unable to attach the stream");
+        return -1;
+    }
+
+    SE_servo_start(&servo);
+    uint32_t origin = SE_tick_get_current_tick();
+    uint32_t seed = 7;
+    uint32_t sample_ms = 0;
+    int max_error = 0;
+    for (uint32_t t = 0; t <= TEST_RUN_MS; t += TEST_TICK_MS)
+    {
+        while (sample_ms <= t)
+        {
+            SE_stream_push(&stream, origin + sample_ms, TEST_Q8(sweep(sample_ms)));
+            sample_ms = next_sample_ms(sample_ms, &seed);
+        }
+        SE_tick_update(TEST_TICK_MS);
+        SE_servo_update_all();
+        if (t >= 1000)
+        {
+            int error = abs(SE_servo_get_angle(&servo) - (int)sweep(SE_tick_get_current_tick() - origin - TEST_LATENCY_MS));
+            max_error = (error > max_error) ? error : max_error;
+        }
+    }
+
+    SE_INFO("Servo: max error %d deg, still moving %d", max_error, SE_servo_is_moving(&servo));
+    if (!SE_servo_is_moving(&servo) || max_error > 2)
+    {
+        SE_ERROR("Servo must keep following the stream");
+        return -1;
+    }
+
+    SE_servo_stop(&servo);
+    if (SE_servo_set_stream(&servo, NULL) != kSE_SUCCESS)
+    {
+        SE_ERROR("Unable to detach the stream");
+        return -1;
+    }
+    SE_servo_deinit(&servo);
+    return 0;
+}
+
+int main()
+{
+    if (check_jitter() != 0 || check_clamp() != 0 || check_concurrent() != 0 || check_servo() != 0)
+    {
+        return -1;
+    }
+    return 0;
+}
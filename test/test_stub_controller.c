@@ -0,0 +1,58 @@
+#include "test_stub_controller.h"
+
+#define TEST_STUB_RESOLUTION 500
+
+SE_ret_t test_stub_open_servo(struct SE_controller *controller, uint8_t servo_id)
+{
+    return kSE_SUCCESS;
+}
+
+SE_ret_t test_stub_close_servo(struct SE_controller *controller, uint8_t servo_id)
+{
+    ((struct test_stub *)controller->controller_data)->close_calls++;
+    return kSE_SUCCESS;
+}
+
+SE_ret_t test_stub_set_duty(struct SE_controller *controller, uint8_t servo_id, uint32_t duty)
+{
+    struct test_stub *stub = (struct test_stub *)controller->controller_data;
+    if (stub->on_duty != NULL)
+    {
+        stub->on_duty(stub, servo_id, duty);
+    }
+
+    /* Channels past the table are only counted */
+    if (servo_id < MAX_CONTROLLER_SERVO)
+    {
+        stub->duty[servo_id] = duty;
+    }
+    stub->duty_calls++;
+    return kSE_SUCCESS;
+}
+
+SE_ret_t test_stub_set_period(struct SE_controller *controller, uint8_t servo_id, uint32_t period_us)
+{
+    struct test_stub *stub = (struct test_stub *)controller->controller_data;
+    return (stub->on_period != NULL) ? stub->on_period(stub, servo_id, period_us) : kSE_SUCCESS;
+}
+
+SE_ret_t test_stub_set_id(struct SE_controller *controller, int id)
+{
+    ((struct test_stub *)controller->controller_data)->info.id = id;
+    return kSE_SUCCESS;
+}
+
+uint32_t test_stub_get_pulse_resolution(struct SE_controller *controller, uint8_t servo_id)
+{
+    return TEST_STUB_RESOLUTION;
+}
+
+const struct SE_controller_info *test_stub_get_info_ref(struct SE_controller *controller)
+{
+    return &((struct test_stub *)controller->controller_data)->info;
+}
+
+SE_ret_t test_stub_register_servo_event(void *servo)
+{
+    return kSE_SUCCESS;
+}
@@ -0,0 +1,48 @@
+#ifndef TEST_STUB_CONTROLLER_H
+#define TEST_STUB_CONTROLLER_H
+
+#include "SE_controller.h"
+#include "SE_def.h"
+
+/* In memory controller shared by the tests. It keeps the last duty of every channel and
+ * counts the writes, hooks let a test watch or fail writes on top of that. */
+struct test_stub
+{
+    struct SE_controller_info info;
+    uint32_t duty[MAX_CONTROLLER_SERVO];
+    uint32_t duty_calls;
+    uint32_t close_calls;
+    /* Called before the duty is stored, so duty[servo_id] still holds the previous one */
+    void (*on_duty)(struct test_stub *stub, uint8_t servo_id, uint32_t duty);
+    /* Its return is the set_period return, NULL accepts every period */
+    SE_ret_t (*on_period)(struct test_stub *stub, uint8_t servo_id, uint32_t period_us);
+};
+
+/* 0 degree at 100 and 180 degree at 460 units, at the stub resolution of 500 */
+#define TEST_STUB_INFO(stub_name, servo_count)                                                          \
+    {                                                                                                \
+        .name = stub_name, .max_servo = servo_count, .units_for_0_degree = 100, .units_for_180_degree = 460 \
+    }
+
+/* Designators for a struct SE_controller, a test may add or override entries after them */
+#define TEST_STUB_OPS(stub)                                     \
+    .open_servo = test_stub_open_servo,                         \
+    .close_servo = test_stub_close_servo,                       \
+    .set_duty = test_stub_set_duty,                             \
+    .set_period = test_stub_set_period,                         \
+    .set_id = test_stub_set_id,                                 \
+    .get_pulse_resolution = test_stub_get_pulse_resolution,     \
+    .get_info_ref = test_stub_get_info_ref,                     \
+    .register_servo_event = test_stub_register_servo_event,     \
+    .controller_data = &(stub)
+
+SE_ret_t test_stub_open_servo(struct SE_controller *controller, uint8_t servo_id);
+SE_ret_t test_stub_close_servo(struct SE_controller *controller, uint8_t servo_id);
+SE_ret_t test_stub_set_duty(struct SE_controller *controller, uint8_t servo_id, uint32_t duty);
+SE_ret_t test_stub_set_period(struct SE_controller *controller, uint8_t servo_id, uint32_t period_us);
+SE_ret_t test_stub_set_id(struct SE_controller *controller, int id);
+uint32_t test_stub_get_pulse_resolution(struct SE_controller *controller, uint8_t servo_id);
+const struct SE_controller_info *test_stub_get_info_ref(struct SE_controller *controller);
+SE_ret_t test_stub_register_servo_event(void *servo);
+
+#endif /*TEST_STUB_CONTROLLER_H*/
@@ -0,0 +1,174 @@
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "servo_easing.h"
+#include "SE_ticks.h"
+#include "SE_logging.h"
+#include "test_stub_controller.h"
+#include "Trace/trace_record_controller.h"
+#include "Trace/trace_replay_controller.h"
+
+#define TEST_TICK_MS 5
+#define TEST_MAX_WRITES 512
+#define TEST_SPEED_PERCENT 400
+/* Past MAX_CONTROLLER_SERVO, the second servo sits on a channel only a large target has */
+#define TEST_CHANNELS 24
+#define TEST_HIGH_CHANNEL 20
+
+/* Sinks log every write they get, replaying a trace into one must reproduce the other log */
+struct test_write
+{
+    uint8_t channel;
+    bool period;
+    uint32_t value;
+};
+
+struct test_sink
+{
+    struct test_stub stub;
+    struct test_write write[TEST_MAX_WRITES];
+    uint32_t count;
+};
+
+static void test_log(struct test_stub *stub, uint8_t channel, bool period, uint32_t value)
+{
+    struct test_sink *sink = (struct test_sink *)stub;
+    if (sink->count < TEST_MAX_WRITES)
+    {
+        sink->write[sink->count] = (struct test_write){.channel = channel, .period = period, .value = value};
+        sink->count++;
+    }
+}
+
+static SE_ret_t test_on_period(struct test_stub *stub, uint8_t servo_id, uint32_t period_us)
+{
+    test_log(stub, servo_id, true, period_us);
+    return kSE_SUCCESS;
+}
+
+static void test_on_duty(struct test_stub *stub, uint8_t servo_id, uint32_t duty)
+{
+    test_log(stub, servo_id, false, duty);
+}
+
+#define TEST_SINK_STUB(sink_name) \
+    {.info = TEST_STUB_INFO(sink_name, TEST_CHANNELS), .on_duty = test_on_duty, .on_period = test_on_period}
+
+static struct test_sink live_data = {.stub = TEST_SINK_STUB("Live sink")};
+static struct test_sink replay_data = {.stub = TEST_SINK_STUB("Replay sink")};
+static struct SE_controller live_controller = {TEST_STUB_OPS(live_data.stub)};
+static struct SE_controller replay_controller = {TEST_STUB_OPS(replay_data.stub)};
+
+static int record_moves(const char *path)
+{
+    struct SE_controller *recorder = trace_record_wrap(&live_controller);
+    if (trace_record_open(path, 0) != kSE_SUCCESS || recorder == NULL ||
+        SE_controller_register(recorder) != kSE_SUCCESS)
+    {
+        SE_ERROR("Unable to start recording, error %s", SE_get_error());
+        return -1;
+    }
+
+    SE_servo_t servo[2];
+    for (int i = 0; i < 2; i++)
+    {
+        SE_argument_t args = {
+            .controller_id = live_data.stub.info.id,
+            .easing_type = eSE_EASE_QUARACTIC,
+            .move_type = eSE_MOV_IN_OUT,
+            .servo_id = (i == 0) ? 0 : TEST_HIGH_CHANNEL,
+            .speed = 120,
+            .period_us = 20000,
+            .init_angle = 0,
+        };
+        if (SE_create_servo(&servo[i], args) != kSE_SUCCESS)
+        {
+            SE_ERROR("Create servo failed, error %s", SE_get_error());
+            return -1;
+        }
+        SE_servo_set_angle(&servo[i], 60 + 60 * i);
+        SE_servo_start(&servo[i]);
+    }
+
+    uint32_t ticks = 0;
+    do
+    {
+        SE_tick_update(TEST_TICK_MS);
+        SE_servo_update_all();
+        ticks++;
+    } while ((SE_servo_is_moving(&servo[0]) || SE_servo_is_moving(&servo[1])) && ticks < 1000);
+
+    uint32_t count = trace_record_get_count();
+    trace_record_close();
+    SE_INFO("Recorded %u writes in %u ms", count, ticks * TEST_TICK_MS);
+    uint32_t high_writes = 0;
+    for (uint32_t w = 0; w < live_data.count; w++)
+    {
+        high_writes += (live_data.write[w].channel == TEST_HIGH_CHANNEL);
+    }
+    if (count != live_data.count || trace_record_get_dropped() != 0 || high_writes == 0)
+    {
+        SE_ERROR("Trace holds %u records for %u writes, %u on channel %d", count, live_data.count, high_writes,
+                 TEST_HIGH_CHANNEL);
+        return -1;
+    }
+    return 0;
+}
+
+static int replay_moves(const char *path)
+{
+    struct trace_replay replay;
+    if (trace_replay_open(&replay, path, &replay_controller) != kSE_SUCCESS ||
+        trace_replay_start(&replay, SE_tick_get_current_tick(), TEST_SPEED_PERCENT) != kSE_SUCCESS)
+    {
+        SE_ERROR("Unable to replay trace, error %s", SE_get_error());
+        return -1;
+    }
+
+    uint32_t first_tick = replay.record[0].tick;
+    uint32_t last_tick = replay.record[replay.count - 1].tick;
+    uint32_t start = SE_tick_get_current_tick();
+    while (trace_replay_step(&replay, SE_tick_get_current_tick()) == kSE_TRY_AGAIN)
+    {
+        SE_tick_update(1);
+    }
+    uint32_t elapse = SE_tick_get_current_tick() - start;
+    trace_replay_close(&replay);
+
+    /* Four times faster, same writes in the same order */
+    if (elapse != (last_tick - first_tick) * 100 / TEST_SPEED_PERCENT)
+    {
+        SE_ERROR("Replay took %u ticks for %u recorded", elapse, last_tick - first_tick);
+        return -1;
+    }
+
+    if (replay_data.count != live_data.count ||
+        memcmp(replay_data.write, live_data.write, live_data.count * sizeof(struct test_write)) != 0)
+    {
+        SE_ERROR("Replay is not bit exact, %u writes for %u", replay_data.count, live_data.count);
+        return -1;
+    }
+    return 0;
+}
+
+int main()
+{
+    char path[] = "/tmp/se_trace_XXXXXX";
+    int fd = mkstemp(path);
+    if (fd < 0)
+    {
+        SE_ERROR("Unable to create trace file");
+        return -1;
+    }
+    close(fd);
+
+    int ret = record_moves(path);
+    if (ret == 0)
+    {
+        ret = replay_moves(path);
+    }
+    unlink(path);
+    return ret;
+}
@@ -0,0 +1,179 @@
+#include <stdbool.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "servo_easing.h"
+#include "SE_track.h"
+#include "SE_ticks.h"
+#include "SE_logging.h"
+#include "test_stub_controller.h"
+
+#define TEST_TICK_MS 10
+/* 0.1 degree against the double reference */
+#define TEST_TOLERANCE ((1 << SE_TRACK_FRAC_BITS) / 10)
+#define TEST_BENCH_EVALS 1000000
+
+static const SE_track_key_t test_keys[] = {
+    {.time_ms = 0, .angle = 0},
+    {.time_ms = 500, .angle = 90},
+    {.time_ms = 1000, .angle = 45},
+    {.time_ms = 1700, .angle = 180},
+    {.time_ms = 2000, .angle = 170},
+};
+#define TEST_KEY_COUNT (sizeof(test_keys) / sizeof(test_keys[0]))
+
+static struct test_stub test_data = {.info = TEST_STUB_INFO("Track test controller", 1)};
+static struct SE_controller test_controller = {TEST_STUB_OPS(test_data)};
+
+/* Catmull-Rom through the keys with still ends, straight from the Hermite basis */
+static double reference(uint32_t time_ms)
+{
+    size_t k = 0;
+    while (k < TEST_KEY_COUNT - 2 && time_ms >= test_keys[k + 1].time_ms)
+    {
+        k++;
+    }
+
+    double h = test_keys[k + 1].time_ms - test_keys[k].time_ms;
+    double s = (time_ms - test_keys[k].time_ms) / h;
+    double p0 = test_keys[k].angle;
+    double p1 = test_keys[k + 1].angle;
+    double m[2] = {0.0, 0.0};
+    for (int e = 0; e < 2; e++)
+    {
+        size_t i = k + e;
+        if (i > 0 && i < TEST_KEY_COUNT - 1)
+        {
+            m[e] = ((double)test_keys[i + 1].angle - test_keys[i - 1].angle) /
+                   (test_keys[i + 1].time_ms - test_keys[i - 1].time_ms) * h;
+        }
+    }
+    double s2 = s * s;
+    double s3 = s2 * s;
+    double degree = (2 * s3 - 3 * s2 + 1) * p0 + (s3 - 2 * s2 + s) * m[0] + (-2 * s3 + 3 * s2) * p1 + (s3 - s2) * m[1];
+    if (degree < 0)
+    {
+        degree = 0;
+    }
+    return (degree > 180 ? 180 : degree) * (1 << SE_TRACK_FRAC_BITS);
+}
+
+static int check_eval(SE_track_t *track)
+{
+    for (size_t k = 0; k < TEST_KEY_COUNT; k++)
+    {
+        if (SE_track_eval(track, test_keys[k].time_ms) != (uint32_t)test_keys[k].angle << SE_TRACK_FRAC_BITS)
+        {
+            SE_ERROR("Track misses key %d", (int)k);
+            return -1;
+        }
+    }
+
+    int32_t max_error = 0;
+    for (uint32_t t = 0; t <= SE_track_get_duration(track); t++)
+    {
+        int32_t error = abs((int32_t)SE_track_eval(track, t) - (int32_t)(reference(t) + 0.5));
+        max_error = (error > max_error) ? error : max_error;
+    }
+    SE_INFO("Max error against the reference %d/256 degree", max_error);
+    if (max_error > TEST_TOLERANCE)
+    {
+        SE_ERROR("Track drifts from the Catmull-Rom reference");
+        return -1;
+    }
+
+    SE_track_eval(track, 1500);
+    uint8_t cursor = track->cursor;
+    SE_track_eval(track, 250);
+    if (cursor != 2 || track->cursor != 0)
+    {
+        SE_ERROR("Cursor must follow the segments and restart on rewind");
+        return -1;
+    }
+    return 0;
+}
+
+static int check_servo(SE_track_t *track)
+{
+    SE_controller_register(&test_controller);
+    SE_argument_t args = {
+        .controller_id = test_data.info.id,
+        .easing_type = eSE_EASE_QUARACTIC,
+        .move_type = eSE_MOV_IN_OUT,
+        .servo_id = 0,
+        .speed = 90,
+        .period_us = 20000,
+    };
+    SE_servo_t servo;
+    if (SE_create_servo(&servo, args) != kSE_SUCCESS || SE_servo_set_track(&servo, track) != kSE_SUCCESS)
+    {
+        SE_ERROR("Unable to attach the track");
+        return -1;
+    }
+
+    SE_servo_start(&servo);
+    uint32_t ticks = 0;
+    int peak = 0;
+    do
+    {
+        SE_tick_update(TEST_TICK_MS);
+        SE_servo_update_all();
+        peak = (ticks * TEST_TICK_MS < 800 && SE_servo_get_angle(&servo) > peak) ? SE_servo_get_angle(&servo) : peak;
+        ticks++;
+    } while (SE_servo_is_moving(&servo) && ticks < 1000);
+
+    SE_INFO("Track played in %u ticks, first peak %d deg, end %d deg", ticks, peak, SE_servo_get_angle(&servo));
+    if (ticks * TEST_TICK_MS < SE_track_get_duration(track) || SE_servo_get_angle(&servo) != 170 || peak < 88)
+    {
+        SE_ERROR("Servo must follow the keys and end on the last one");
+        return -1;
+    }
+    SE_servo_deinit(&servo);
+    return 0;
+}
+
+static void bench_eval(SE_track_t *track)
+{
+    struct timespec start, end;
+    uint32_t duration = SE_track_get_duration(track);
+    volatile uint32_t sink = 0;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (uint32_t i = 0; i < TEST_BENCH_EVALS; i++)
+    {
+        sink += SE_track_eval(track, i % duration);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    uint64_t elapse_ns = (uint64_t)(end.tv_sec - start.tv_sec) * 1000000000 + end.tv_nsec - start.tv_nsec;
+    SE_INFO("%u evaluations, %llu ns each", TEST_BENCH_EVALS, (unsigned long long)(elapse_ns / TEST_BENCH_EVALS));
+}
+
+int main()
+{
+    SE_track_t track = {0};
+    SE_track_key_t bad_keys[] = {{.time_ms = 0, .angle = 10}, {.time_ms = 0, .angle = 20}};
+    if (SE_track_load(&track, bad_keys, 2) != kSE_OUT_OF_RANGE || SE_track_load(&track, test_keys, 1) != kSE_OUT_OF_RANGE)
+    {
+        SE_ERROR("Keys out of order or too few must be rejected");
+        return -1;
+    }
+
+    /* A rejected load leaves an empty track that holds its end angle */
+    if (SE_track_get_duration(&track) != 0 || SE_track_eval(&track, 10) != 0)
+    {
+        SE_ERROR("Empty track must have no duration");
+        return -1;
+    }
+
+    if (SE_track_load(&track, test_keys, TEST_KEY_COUNT) != kSE_SUCCESS)
+    {
+        SE_ERROR("Track load failed, error %s", SE_get_error());
+        return -1;
+    }
+
+    if (check_eval(&track) != 0 || check_servo(&track) != 0)
+    {
+        return -1;
+    }
+    bench_eval(&track);
+    return 0;
+}